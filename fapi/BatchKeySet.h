@@ -0,0 +1,214 @@
+/**
+ * @file BatchKeySet.h
+ *
+ * @date 15 June 2005
+ *
+ * @brief The BatchKeySet finds the keys that are used more than once in a
+ *        batch while the batch is checked by several threads.
+ *
+ * Every entry of a batch inserts its key and gets back the slot of the key.
+ * Entries that use the same key get the same slot, and the slot records the
+ * earliest entry that used the key, so after the batch has been checked
+ * an entry repeats an earlier key if First() of its slot is not the entry.
+ * When a batch is applied one entry at a time, Take() marks the key of an
+ * applied entry so a later entry with the same key can be rejected without
+ * looking it up in the tables again.
+ *
+ * Design Notes:
+ *    The set is an open addressed table at most half full, sized for the
+ *    batch by Reset(). A slot is claimed with a compare and swap on its
+ *    state and the earliest entry is kept with a compare and swap loop, so
+ *    Insert() takes no lock. Reset(), First(), Taken() and Take() must not
+ *    be called while other threads insert.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __BATCHKEYSET_H_
+#define __BATCHKEYSET_H_
+
+/**
+ * Standard defined include files required.
+ */
+#include <sched.h>
+#include <vector>
+using namespace std;
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Concurrent set of the keys used by a batch.
+ */
+class BatchKeySet
+{
+public:
+    BatchKeySet()
+    : m_mask(0)
+    {
+    }
+
+    ~BatchKeySet()
+    {
+    }
+
+    /**
+     * Empties the set and sizes it for a batch of 'numKeys' keys.
+     */
+    void Reset(unsigned int numKeys)
+    {
+        unsigned int size = 2;
+        while(size < (2 * numKeys))
+        {
+            size <<= 1;
+        }
+        keySlot empty;
+        empty.key = 0;
+        empty.state = SLOT_EMPTY;
+        empty.first = 0;
+        empty.taken = false;
+        m_slots.assign(size, empty);
+        m_mask = size - 1;
+    }
+
+    /**
+     * Adds the key of entry 'entry' and returns its slot. Safe to call from
+     * several threads at once.
+     */
+    unsigned int Insert(unsigned long long key, unsigned int entry)
+    {
+        unsigned int slot = (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & m_mask;
+        for(;;)
+        {
+            keySlot& find = m_slots[slot];
+            unsigned int state = __atomic_load_n(&find.state, __ATOMIC_ACQUIRE);
+            if(state == SLOT_EMPTY)
+            {
+                if(__atomic_compare_exchange_n(&find.state, &state, (unsigned int)SLOT_WRITING, false,
+                                               __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+                {
+                    find.key = key;
+                    find.first = entry;
+                    __atomic_store_n(&find.state, (unsigned int)SLOT_READY, __ATOMIC_RELEASE);
+                    return slot;
+                }
+            }
+            while(state == SLOT_WRITING)
+            {
+                sched_yield();
+                state = __atomic_load_n(&find.state, __ATOMIC_ACQUIRE);
+            }
+            if(find.key == key)
+            {
+                unsigned int first = __atomic_load_n(&find.first, __ATOMIC_RELAXED);
+                while((entry < first)&&
+                      (__atomic_compare_exchange_n(&find.first, &first, entry, false,
+                                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false))
+                {
+                }
+                return slot;
+            }
+            slot = (slot + 1) & m_mask;
+        }
+    }
+
+    /**
+     * Earliest entry that inserted the key of 'slot'.
+     */
+    unsigned int First(unsigned int slot) const
+    {
+        return m_slots[slot].first;
+    }
+
+    bool Taken(unsigned int slot) const
+    {
+        return m_slots[slot].taken;
+    }
+
+    void Take(unsigned int slot)
+    {
+        m_slots[slot].taken = true;
+    }
+
+private:
+    BatchKeySet(const BatchKeySet&);
+    BatchKeySet& operator =(const BatchKeySet&);
+
+    enum
+    {
+        SLOT_EMPTY,
+        SLOT_WRITING,
+        SLOT_READY
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef keySlot
+    *
+    * @brief Typedef of a slot of the set. key is valid once state is
+    *        SLOT_READY, taken is only used after the batch is checked.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long key;
+        unsigned int state;
+        unsigned int first;
+        bool taken;
+    } keySlot;
+
+    /**
+    * BatchKeySet Member Variables.
+    *
+    * m_slots - The slots, a power of two of them.
+    *
+    * m_mask - Number of slots minus one.
+    *
+    */
+    vector<keySlot> m_slots;
+    unsigned int m_mask;
+};
+#endif // #if !defined __BATCHKEYSET_H_
+/**
+ *@}
+ */
@@ -0,0 +1,198 @@
+/**
+ * @file BatchValidator.cpp
+ *
+ * @date 15 June 2005
+ *
+ * @brief The BatchValidator checks the entries of a large batch on a pool
+ *        of worker threads.
+ *
+ * Implementation of the worker threads and of the ranges of a batch they
+ * claim.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "BatchValidator.h"
+#include "TraceMacro.h"
+
+BatchValidator::BatchValidator()
+: m_check(0), m_context(0), m_numEntries(0), m_next(0), m_batch(0),
+  m_open(false), m_active(0), m_stopping(false), m_numThreads(0)
+{
+    pthread_mutex_init(&m_lock, 0);
+    pthread_cond_init(&m_startCond, 0);
+    pthread_cond_init(&m_doneCond, 0);
+    pthread_mutex_init(&m_runLock, 0);
+}
+
+BatchValidator::~BatchValidator()
+{
+    pthread_mutex_lock(&m_lock);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_startCond);
+    pthread_mutex_unlock(&m_lock);
+    for(unsigned int x = 0; x < m_numThreads; x++)
+    {
+        pthread_join(m_threads[x], 0);
+    }
+    pthread_mutex_destroy(&m_lock);
+    pthread_cond_destroy(&m_startCond);
+    pthread_cond_destroy(&m_doneCond);
+    pthread_mutex_destroy(&m_runLock);
+}
+
+BatchValidator& BatchValidator::instance()
+{
+    // Singleton Pattern
+    static BatchValidator instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Run(CheckFunc check, void* context,
+ *                          unsigned int numEntries)
+ */
+void BatchValidator::Run(CheckFunc check, void* context, unsigned int numEntries)
+{
+    if((numEntries < _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN)||(_IX_CC_ATM_FAPI_VALIDATE_THREADS == 0)||
+       (pthread_mutex_trylock(&m_runLock) != 0))
+    {
+        check(context, 0, numEntries);
+        return;
+    }
+    if((m_numThreads == 0)&&(StartThreads() == false))
+    {
+        pthread_mutex_unlock(&m_runLock);
+        check(context, 0, numEntries);
+        return;
+    }
+    APISimTrace(3,"Trace Level 3: BatchValidator::Run(%d)\n",numEntries);
+
+    pthread_mutex_lock(&m_lock);
+    m_check = check;
+    m_context = context;
+    m_numEntries = numEntries;
+    __atomic_store_n(&m_next, 0, __ATOMIC_RELAXED);
+    m_batch++;
+    m_open = true;
+    pthread_cond_broadcast(&m_startCond);
+    pthread_mutex_unlock(&m_lock);
+
+    CheckRanges();
+
+    // Every range has been claimed, workers that have not joined yet are
+    // kept out and the caller waits for those still checking a range.
+    pthread_mutex_lock(&m_lock);
+    m_open = false;
+    while(m_active != 0)
+    {
+        pthread_cond_wait(&m_doneCond, &m_lock);
+    }
+    pthread_mutex_unlock(&m_lock);
+    pthread_mutex_unlock(&m_runLock);
+}
+
+/**
+ * Function Definition: StartThreads()
+ */
+bool BatchValidator::StartThreads()
+{
+    for(m_numThreads = 0; m_numThreads < _IX_CC_ATM_FAPI_VALIDATE_THREADS; m_numThreads++)
+    {
+        if(pthread_create(&m_threads[m_numThreads], 0, ValidateThread, this) != 0)
+        {
+            APISimTrace(1,"Trace Level 1: BatchValidator::StartThreads - Thread Creation Failed!\n");
+            break;
+        }
+    }
+    return (m_numThreads != 0);
+}
+
+/**
+ * Function Definition: CheckRanges()
+ */
+void BatchValidator::CheckRanges()
+{
+    for(;;)
+    {
+        unsigned int first = __atomic_fetch_add(&m_next, _IX_CC_ATM_FAPI_VALIDATE_CHUNK, __ATOMIC_RELAXED);
+        if(first >= m_numEntries)
+        {
+            return;
+        }
+        unsigned int last = first + _IX_CC_ATM_FAPI_VALIDATE_CHUNK;
+        m_check(m_context, first, (last < m_numEntries) ? last : m_numEntries);
+    }
+}
+
+/**
+ * Function Definition: ValidateThread(void* arg)
+ */
+void* BatchValidator::ValidateThread(void* arg)
+{
+    BatchValidator* validator = static_cast<BatchValidator*>(arg);
+    unsigned long long seen = 0;
+
+    pthread_mutex_lock(&validator->m_lock);
+    for(;;)
+    {
+        while((validator->m_stopping == false)&&
+              ((validator->m_batch == seen)||(validator->m_open == false)))
+        {
+            pthread_cond_wait(&validator->m_startCond, &validator->m_lock);
+        }
+        if(validator->m_stopping == true)
+        {
+            break;
+        }
+        seen = validator->m_batch;
+        validator->m_active++;
+        pthread_mutex_unlock(&validator->m_lock);
+
+        validator->CheckRanges();
+
+        pthread_mutex_lock(&validator->m_lock);
+        validator->m_active--;
+        if(validator->m_active == 0)
+        {
+            pthread_cond_signal(&validator->m_doneCond);
+        }
+    }
+    pthread_mutex_unlock(&validator->m_lock);
+    return 0;
+}
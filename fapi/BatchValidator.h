@@ -0,0 +1,163 @@
+/**
+ * @file BatchValidator.h
+ *
+ * @date 15 June 2005
+ *
+ * @brief The BatchValidator checks the entries of a large batch on a pool
+ *        of worker threads.
+ *
+ * The BatchValidator is a singleton. The TableManager hands it the check
+ * of every entry of a batch of at least _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN
+ * entries, which the workers and the calling thread run on separate ranges
+ * of the batch. The checks only read the tables, under the locks the
+ * caller holds for the batch, and record their result per entry. The
+ * caller then applies the batch in order on its own thread.
+ *
+ * Design Notes:
+ *    The pool runs one batch at a time. A caller that finds it busy with
+ *    another batch, or a batch too small to be worth splitting, runs the
+ *    checks on its own thread instead of waiting. Ranges of
+ *    _IX_CC_ATM_FAPI_VALIDATE_CHUNK entries are claimed from a shared
+ *    counter, so a worker that is slow to wake up leaves its share to the
+ *    others. The worker threads are started by the first batch that uses
+ *    them.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __BATCHVALIDATOR_H_
+#define __BATCHVALIDATOR_H_
+
+/**
+ * User defined include files required.
+ */
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+
+class BatchValidator
+{
+public:
+    /**
+    * Checks the entries first..last-1 of a batch.
+    */
+    typedef void (*CheckFunc)(void* context, unsigned int first, unsigned int last);
+
+    virtual ~BatchValidator();
+
+    static BatchValidator& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Run(CheckFunc check, void* context, unsigned int numEntries)
+    *
+    * @brief Calls check on ranges that together cover the entries
+    *        0..numEntries-1 and returns when every range has been checked.
+    *
+    * @param check CheckFunc [in] - Checks a range of the batch. Ranges
+    *                                 may be checked at the same time on
+    *                                 different threads.
+    * @param context void* [in] - Passed to check.
+    * @param numEntries unsigned int [in] - Number of entries in the batch.
+    *
+    * @return None
+    */
+    void Run(CheckFunc check, void* context, unsigned int numEntries);
+
+private:
+    BatchValidator();
+    BatchValidator(const BatchValidator&);
+    BatchValidator& operator =(const BatchValidator&);
+
+    static void* ValidateThread(void* arg);
+
+    bool StartThreads();
+    void CheckRanges();
+
+    /**
+    * BatchValidator Member Variables.
+    *
+    * m_check, m_context, m_numEntries - The batch being checked.
+    *
+    * m_next - First entry not yet claimed by a thread.
+    *
+    * m_batch - Counts the batches run by the pool, a worker joins a batch
+    *           when it changes.
+    *
+    * m_open - Set while workers may join the current batch.
+    *
+    * m_active - Number of workers checking the current batch.
+    *
+    * m_stopping - Tells the workers to exit.
+    *
+    * m_lock, m_startCond, m_doneCond - Guard the fields above and wake the
+    *                                   workers and the caller.
+    *
+    * m_runLock - Held by the caller whose batch the pool is running.
+    *
+    * m_threads, m_numThreads - The worker threads.
+    *
+    */
+    CheckFunc m_check;
+    void* m_context;
+    unsigned int m_numEntries;
+    unsigned int m_next;
+    unsigned long long m_batch;
+    bool m_open;
+    unsigned int m_active;
+    bool m_stopping;
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_startCond;
+    pthread_cond_t m_doneCond;
+    pthread_mutex_t m_runLock;
+    pthread_t m_threads[_IX_CC_ATM_FAPI_VALIDATE_THREADS];
+    unsigned int m_numThreads;
+};
+#endif // #if !defined __BATCHVALIDATOR_H_
+/**
+ *@}
+ */
@@ -51,11 +51,13 @@
  */
 #include "CallBack.h"
 #include <iostream>
+#include "CallBackPool.h"
+#include "FAPIMetrics.h"
 #include "TraceMacro.h"
 
 CallBack::CallBack(NPF_userContext_t userContext,
                    NPF_F_ATM_ConfigMgr_CallBackFunc_t callbackFunc)
-                   :m_cbCorrelator(0), m_context(userContext), m_function(callbackFunc) 
+                   :m_context(userContext), m_function(callbackFunc), m_cbCorrelator(0), m_readyTime(0) 
 {
 }
 
@@ -69,9 +71,15 @@ CallBack::~CallBack()
 void CallBack::Fire()
 {
     APISimTrace(3,"Trace Level 3: CallBack::Fire()\n");
+    if(m_readyTime != 0)
+    {
+        FAPIMetrics::RecordLatency(NPF_F_ATM_CONFIGMGR_METRIC_CALLBACK_DISPATCH, FAPIMetrics::Now() - m_readyTime);
+    }
     // Invoke client function pointer. 
     m_function(m_context, m_cbCorrelator, m_data); 
-    delete [] m_data.resp; 
-    delete this;
+    // Hand the response buffer and this object back for reuse.
+    CallBackPool::instance().ReleaseResp(m_data.resp); 
+    m_data.resp = 0;
+    CallBackPool::instance().ReleaseCallBack(this);
 
 }
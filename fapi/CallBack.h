@@ -90,11 +90,15 @@ public:
      *          Contains information that is common among all functions,
      *          as well as information that is specific to a particular 
      *          function.
+     * 
+     * m_readyTime - FAPIMetrics::Now() when the responses were handed
+     *               over, the dispatch latency is measured from it.
     */
     NPF_userContext_t m_context;
     NPF_F_ATM_ConfigMgr_CallBackFunc_t m_function;
     NPF_correlator_t m_cbCorrelator;
     NPF_F_ATM_ConfigMgr_CallbackData_t m_data;
+    unsigned long long m_readyTime;
     
     /**
     * @ingroup FAPI Simulator
@@ -0,0 +1,412 @@
+/**
+ * @file CallBackDispatcher.cpp
+ *
+ * @date 9 May 2005
+ *
+ * @brief The CallBackDispatcher delivers completion callbacks on its own
+ *        threads.
+ *
+ * Implementation of the per handle callback rings and the dispatcher
+ * threads that drain them.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "CallBackDispatcher.h"
+#include "FAPIMetrics.h"
+#include "TraceMacro.h"
+
+/*
+ * System defined include files required.
+ */
+#include <sched.h>
+
+/*
+ * Callback handle the calling dispatcher thread is draining, 0 if none.
+ */
+static __thread NPF_callbackHandle_t t_drainingHandle = 0;
+
+CallBackDispatcher::CallBackDispatcher()
+: m_queueMask(0), m_readyHead(0), m_readyCount(0), m_numThreads(0),
+  m_running(0), m_inFlight(0), m_stopping(false)
+{
+    for(unsigned int x = 0; x < _ATM_FAPI_SIM_CB_HANDLE_MAX; x++)
+    {
+        m_queues[x].tail = 0;
+        m_queues[x].head = 0;
+        m_queues[x].scheduled = 0;
+        m_queues[x].cells = 0;
+    }
+    pthread_mutex_init(&m_readyLock, 0);
+    pthread_cond_init(&m_readyCond, 0);
+    pthread_mutex_init(&m_controlLock, 0);
+}
+
+CallBackDispatcher::~CallBackDispatcher()
+{
+    Stop();
+    for(unsigned int x = 0; x < _ATM_FAPI_SIM_CB_HANDLE_MAX; x++)
+    {
+        delete [] m_queues[x].cells;
+    }
+    pthread_mutex_destroy(&m_readyLock);
+    pthread_cond_destroy(&m_readyCond);
+    pthread_mutex_destroy(&m_controlLock);
+}
+
+CallBackDispatcher& CallBackDispatcher::instance()
+{
+    // Singleton Pattern
+    static CallBackDispatcher instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Start(NPF_uint32_t numThreads, NPF_uint32_t queueDepth)
+ */
+bool CallBackDispatcher::Start(NPF_uint32_t numThreads, NPF_uint32_t queueDepth)
+{
+    APISimTrace(3,"Trace Level 3: CallBackDispatcher::Start(%d,%d)\n",numThreads,queueDepth);
+    if((numThreads == 0)||(numThreads > _IX_CC_ATM_FAPI_DISPATCH_THREADS_MAX)||
+       (queueDepth == 0)||(queueDepth > _IX_CC_ATM_FAPI_DISPATCH_QUEUE_DEPTH_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: CallBackDispatcher::Start - Invalid Thread Count or Queue Depth!\n");
+        return false;
+    }
+
+    pthread_mutex_lock(&m_controlLock);
+    if(m_running != 0)
+    {
+        pthread_mutex_unlock(&m_controlLock);
+        return true;
+    }
+
+    unsigned int ringSize = 1;
+    while(ringSize < queueDepth)
+    {
+        ringSize <<= 1;
+    }
+
+    // The rings are empty while the dispatcher is stopped, so they can be
+    // resized here.
+    for(unsigned int x = 0; x < _ATM_FAPI_SIM_CB_HANDLE_MAX; x++)
+    {
+        if((m_queues[x].cells == 0)||(m_queueMask != (ringSize - 1)))
+        {
+            delete [] m_queues[x].cells;
+            m_queues[x].cells = new queueCell[ringSize];
+        }
+        for(unsigned int y = 0; y < ringSize; y++)
+        {
+            m_queues[x].cells[y].sequence = y;
+            m_queues[x].cells[y].callback = 0;
+        }
+        m_queues[x].tail = 0;
+        m_queues[x].head = 0;
+        m_queues[x].scheduled = 0;
+    }
+    m_queueMask = ringSize - 1;
+    m_stopping = false;
+
+    for(m_numThreads = 0; m_numThreads < numThreads; m_numThreads++)
+    {
+        if(pthread_create(&m_threads[m_numThreads], 0, DispatchThread, this) != 0)
+        {
+            APISimTrace(1,"Trace Level 1: CallBackDispatcher::Start - Thread Creation Failed!\n");
+            break;
+        }
+    }
+
+    if(m_numThreads != numThreads)
+    {
+        pthread_mutex_lock(&m_readyLock);
+        m_stopping = true;
+        pthread_cond_broadcast(&m_readyCond);
+        pthread_mutex_unlock(&m_readyLock);
+        for(unsigned int x = 0; x < m_numThreads; x++)
+        {
+            pthread_join(m_threads[x], 0);
+        }
+        m_numThreads = 0;
+        pthread_mutex_unlock(&m_controlLock);
+        return false;
+    }
+
+    __atomic_store_n(&m_running, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&m_controlLock);
+    return true;
+}
+
+/**
+ * Function Definition: Stop()
+ */
+void CallBackDispatcher::Stop()
+{
+    APISimTrace(3,"Trace Level 3: CallBackDispatcher::Stop()\n");
+    pthread_mutex_lock(&m_controlLock);
+    if(m_running == 0)
+    {
+        pthread_mutex_unlock(&m_controlLock);
+        return;
+    }
+
+    // New callbacks fire on the caller's thread from here on. Callbacks
+    // already being queued are let through before the threads are told
+    // to finish.
+    __atomic_store_n(&m_running, 0, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&m_inFlight, __ATOMIC_SEQ_CST) != 0)
+    {
+        sched_yield();
+    }
+
+    pthread_mutex_lock(&m_readyLock);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_readyCond);
+    pthread_mutex_unlock(&m_readyLock);
+
+    for(unsigned int x = 0; x < m_numThreads; x++)
+    {
+        pthread_join(m_threads[x], 0);
+    }
+    m_numThreads = 0;
+    pthread_mutex_unlock(&m_controlLock);
+}
+
+bool CallBackDispatcher::IsRunning()
+{
+    return (__atomic_load_n(&m_running, __ATOMIC_SEQ_CST) != 0);
+}
+
+/**
+ * Function Definition: Dispatch(NPF_callbackHandle_t cbHandle, CallBack* callback)
+ */
+void CallBackDispatcher::Dispatch(NPF_callbackHandle_t cbHandle, CallBack* callback)
+{
+    APISimTrace(3,"Trace Level 3: CallBackDispatcher::Dispatch(%d)\n",cbHandle);
+    __atomic_add_fetch(&m_inFlight, 1, __ATOMIC_SEQ_CST);
+
+    if((__atomic_load_n(&m_running, __ATOMIC_SEQ_CST) == 0)||
+       (cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        __atomic_sub_fetch(&m_inFlight, 1, __ATOMIC_SEQ_CST);
+        callback->Fire();
+        return;
+    }
+
+    unsigned int handleIndex = cbHandle - 1;
+    if(Enqueue(handleIndex, callback) == false)
+    {
+        APISimTrace(2,"Trace Level 2: CallBackDispatcher::Dispatch - Queue Full!\n");
+        if(t_drainingHandle == cbHandle)
+        {
+            // A callback of this handle called the FAPI on it again, and
+            // this thread is the only one that can empty the ring. Deliver
+            // the oldest queued callbacks here, in order, to make room.
+            do
+            {
+                CallBack* oldest = Dequeue(handleIndex);
+                if(oldest != 0)
+                {
+                    oldest->Fire();
+                }
+            }while(Enqueue(handleIndex, callback) == false);
+        }else
+        {
+            // The client has queueDepth callbacks outstanding, hold the
+            // provisioning thread back until the dispatcher catches up.
+            do
+            {
+                sched_yield();
+            }while(Enqueue(handleIndex, callback) == false);
+        }
+    }
+    Schedule(handleIndex);
+
+    __atomic_sub_fetch(&m_inFlight, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Function Definition: Enqueue(unsigned int handleIndex, CallBack* callback)
+ */
+bool CallBackDispatcher::Enqueue(unsigned int handleIndex, CallBack* callback)
+{
+    handleQueue& queue = m_queues[handleIndex];
+    unsigned int position = __atomic_load_n(&queue.tail, __ATOMIC_RELAXED);
+
+    for(;;)
+    {
+        queueCell& cell = queue.cells[position & m_queueMask];
+        unsigned int sequence = __atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE);
+        int difference = (int)(sequence - position);
+
+        if(difference == 0)
+        {
+            // The cell is free for this position, claim it.
+            if(__atomic_compare_exchange_n(&queue.tail, &position, position + 1, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                cell.callback = callback;
+                __atomic_store_n(&cell.sequence, position + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }else if(difference < 0)
+        {
+            // The consumer has not emptied this cell yet, the ring is full.
+            return false;
+        }else
+        {
+            position = __atomic_load_n(&queue.tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * Function Definition: Dequeue(unsigned int handleIndex)
+ */
+CallBack* CallBackDispatcher::Dequeue(unsigned int handleIndex)
+{
+    handleQueue& queue = m_queues[handleIndex];
+    unsigned int position = __atomic_load_n(&queue.head, __ATOMIC_RELAXED);
+    queueCell& cell = queue.cells[position & m_queueMask];
+
+    if(__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE) != (position + 1))
+    {
+        return 0;
+    }
+
+    CallBack* callback = cell.callback;
+    __atomic_store_n(&cell.sequence, position + m_queueMask + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&queue.head, position + 1, __ATOMIC_RELAXED);
+    return callback;
+}
+
+/**
+ * Function Definition: Schedule(unsigned int handleIndex)
+ */
+void CallBackDispatcher::Schedule(unsigned int handleIndex)
+{
+    unsigned int expected = 0;
+
+    // Pairs with the fence in Drain(), either the dispatcher sees the new
+    // callback or this thread sees the scheduled flag cleared.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_compare_exchange_n(&m_queues[handleIndex].scheduled, &expected, 1, false,
+                                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) == false)
+    {
+        // Already on the ready list or being drained.
+        return;
+    }
+
+    FAPIMetrics::Lock(&m_readyLock, NPF_F_ATM_CONFIGMGR_LOCK_DISPATCH);
+    m_ready[(m_readyHead + m_readyCount) % _ATM_FAPI_SIM_CB_HANDLE_MAX] = handleIndex;
+    m_readyCount++;
+    pthread_cond_signal(&m_readyCond);
+    pthread_mutex_unlock(&m_readyLock);
+}
+
+/**
+ * Function Definition: TakeReady(unsigned int* handleIndex)
+ */
+bool CallBackDispatcher::TakeReady(unsigned int* handleIndex)
+{
+    FAPIMetrics::Lock(&m_readyLock, NPF_F_ATM_CONFIGMGR_LOCK_DISPATCH);
+    while((m_readyCount == 0)&&(m_stopping == false))
+    {
+        pthread_cond_wait(&m_readyCond, &m_readyLock);
+    }
+    if(m_readyCount == 0)
+    {
+        // Stopping and nothing is left to deliver.
+        pthread_mutex_unlock(&m_readyLock);
+        return false;
+    }
+    *handleIndex = m_ready[m_readyHead];
+    m_readyHead = (m_readyHead + 1) % _ATM_FAPI_SIM_CB_HANDLE_MAX;
+    m_readyCount--;
+    pthread_mutex_unlock(&m_readyLock);
+    return true;
+}
+
+/**
+ * Function Definition: Drain(unsigned int handleIndex)
+ */
+void CallBackDispatcher::Drain(unsigned int handleIndex)
+{
+    handleQueue& queue = m_queues[handleIndex];
+    NPF_callbackHandle_t previousHandle = t_drainingHandle;
+    t_drainingHandle = handleIndex + 1;
+
+    // Deliver at most one ring's worth before letting other handles in.
+    for(unsigned int x = 0; x <= m_queueMask; x++)
+    {
+        CallBack* callback = Dequeue(handleIndex);
+        if(callback == 0)
+        {
+            break;
+        }
+        callback->Fire();
+    }
+    t_drainingHandle = previousHandle;
+
+    __atomic_store_n(&queue.scheduled, 0, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // A producer may have queued after the last Dequeue() but before the
+    // flag was cleared, and then found the handle still scheduled.
+    unsigned int position = __atomic_load_n(&queue.head, __ATOMIC_RELAXED);
+    queueCell& cell = queue.cells[position & m_queueMask];
+    if(__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE) == (position + 1))
+    {
+        Schedule(handleIndex);
+    }
+}
+
+/**
+ * Function Definition: DispatchThread(void* arg)
+ */
+void* CallBackDispatcher::DispatchThread(void* arg)
+{
+    CallBackDispatcher* dispatcher = static_cast<CallBackDispatcher*>(arg);
+    unsigned int handleIndex;
+
+    while(dispatcher->TakeReady(&handleIndex) == true)
+    {
+        dispatcher->Drain(handleIndex);
+    }
+    return 0;
+}
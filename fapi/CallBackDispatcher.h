@@ -0,0 +1,242 @@
+/**
+ * @file CallBackDispatcher.h
+ *
+ * @date 9 May 2005
+ *
+ * @brief The CallBackDispatcher delivers completion callbacks on its own
+ *        threads.
+ *
+ * The CallBackDispatcher is a singleton. When the CallBackHandler is in
+ * dispatch mode, every completed FAPI call is queued here instead of being
+ * fired on the caller's thread. A pool of dispatcher threads delivers the
+ * callbacks, so a slow client callback does not stall provisioning.
+ *
+ * Design Notes:
+ *    Every callback handle has a bounded multi producer, single consumer
+ *    ring of pending callbacks. A handle with work is put on a ready list
+ *    once, guarded by its scheduled flag, and only the dispatcher thread
+ *    that takes it from the list drains its ring. Callbacks for one handle
+ *    are therefore delivered in the order they were queued, while different
+ *    handles are delivered in parallel. A producer that finds its ring full
+ *    waits for the dispatcher to make room.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __CALLBACKDISPATCHER_H_
+#define __CALLBACKDISPATCHER_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "CallBack.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+
+class CallBackDispatcher
+{
+public:
+    virtual ~CallBackDispatcher();
+
+    static CallBackDispatcher& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Start(NPF_uint32_t numThreads, NPF_uint32_t queueDepth)
+    *
+    * @brief Starts the dispatcher threads.
+    *
+    * @param numThreads NPF_uint32_t [in] - Number of dispatcher threads,
+    *                                         at most
+    *                                         _IX_CC_ATM_FAPI_DISPATCH_THREADS_MAX.
+    * @param queueDepth NPF_uint32_t [in] - Callbacks each handle may have
+    *                                         pending, rounded up to a power
+    *                                         of two.
+    *
+    * Calling Start() while the dispatcher is running has no effect.
+    *
+    * @return bool - false if the parameters are out of range or a thread
+    *                could not be created.
+    */
+    bool Start(NPF_uint32_t numThreads, NPF_uint32_t queueDepth);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Stop()
+    *
+    * @brief Delivers every queued callback and stops the dispatcher threads.
+    *
+    * @return None
+    */
+    void Stop();
+
+    bool IsRunning();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Dispatch(NPF_callbackHandle_t cbHandle, CallBack* callback)
+    *
+    * @brief Queues a callback for delivery on a dispatcher thread.
+    *
+    * @param cbHandle NPF_callbackHandle_t [in] - Handle the callback was
+    *                                               retrieved with, callbacks
+    *                                               of one handle are
+    *                                               delivered in order.
+    * @param callback CallBack* [in] - The callback to fire. Ownership
+    *                                    passes to the dispatcher.
+    *
+    * If the dispatcher is not running the callback is fired on the calling
+    * thread. When the queue of the handle is full and the caller is the
+    * dispatcher thread delivering that handle, i.e. a callback called the
+    * FAPI on its own handle, the oldest queued callbacks are fired on the
+    * calling thread to make room rather than waiting on itself.
+    *
+    * @return None
+    */
+    void Dispatch(NPF_callbackHandle_t cbHandle, CallBack* callback);
+
+private:
+    CallBackDispatcher();
+    CallBackDispatcher(const CallBackDispatcher&);
+    CallBackDispatcher& operator =(const CallBackDispatcher&);
+
+    static void* DispatchThread(void* arg);
+
+    bool Enqueue(unsigned int handleIndex, CallBack* callback);
+    CallBack* Dequeue(unsigned int handleIndex);
+    void Schedule(unsigned int handleIndex);
+    bool TakeReady(unsigned int* handleIndex);
+    void Drain(unsigned int handleIndex);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef queueCell
+    *
+    * @brief Typedef of a ring entry, sequence tells producers and the
+    *        consumer whose turn it is to use the cell.
+    *
+    */
+    typedef struct
+    {
+        unsigned int sequence;
+        CallBack* callback;
+    } queueCell;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef handleQueue
+    *
+    * @brief Typedef of the pending callback ring of one callback handle.
+    *
+    * tail is claimed by producers, head is only advanced by the dispatcher
+    * thread that has the handle scheduled. scheduled is set while the
+    * handle is on the ready list or being drained.
+    *
+    */
+    typedef struct
+    {
+        unsigned int tail __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+        unsigned int head __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+        unsigned int scheduled;
+        queueCell* cells;
+    } handleQueue;
+
+    /**
+    * CallBackDispatcher Member Variables.
+    *
+    * m_queues - Pending callback ring of every callback handle, indexed by
+    *            handle minus one.
+    *
+    * m_queueMask - Ring size minus one.
+    *
+    * m_ready, m_readyHead, m_readyCount - Circular list of handles waiting
+    *                                      for a dispatcher thread, guarded
+    *                                      by m_readyLock.
+    *
+    * m_readyCond - Signalled when a handle is made ready or on Stop().
+    *
+    * m_threads, m_numThreads - The dispatcher threads.
+    *
+    * m_running - Set while the dispatcher accepts callbacks.
+    *
+    * m_inFlight - Number of Dispatch() calls that saw m_running set and
+    *              have not finished queueing, Stop() waits for it to drop
+    *              to zero before stopping the threads.
+    *
+    * m_stopping - Tells the dispatcher threads to exit once the ready list
+    *              is empty.
+    *
+    * m_controlLock - Serialises Start() and Stop().
+    *
+    */
+    handleQueue m_queues[_ATM_FAPI_SIM_CB_HANDLE_MAX];
+    unsigned int m_queueMask;
+
+    unsigned int m_ready[_ATM_FAPI_SIM_CB_HANDLE_MAX];
+    unsigned int m_readyHead;
+    unsigned int m_readyCount;
+    pthread_mutex_t m_readyLock;
+    pthread_cond_t m_readyCond;
+
+    pthread_t m_threads[_IX_CC_ATM_FAPI_DISPATCH_THREADS_MAX];
+    unsigned int m_numThreads;
+    unsigned int m_running;
+    unsigned int m_inFlight;
+    bool m_stopping;
+    pthread_mutex_t m_controlLock;
+};
+#endif // #if !defined __CALLBACKDISPATCHER_H_
+/**
+ *@}
+ */
@@ -52,11 +52,14 @@
 #include "CallBackHandler.h"
 #include "CallBack.h"
 #include "CallBackManager.h"
+#include "CallBackPool.h"
+#include "CallBackDispatcher.h"
+#include "FAPIMetrics.h"
 #include "EventScheduler.h"
 #include "TraceMacro.h"
 
 CallBackHandler::CallBackHandler()
-: m_eventSchedule(false)
+: m_mode(CB_MODE_SYNC), m_chunkSize(_IX_CC_ATM_FAPI_RESP_CHUNK_SIZE)
 {
 }
 
@@ -82,40 +85,112 @@ void CallBackHandler::AsyncCallback(NPF_callbackHandle_t cbHandle,
 {    
     APISimTrace(3,"Trace Level 3: CallBackHandler::AsyncCallback(%d,%d,..)\n",cbHandle,cbCorrelator);
     
-    CallBack* callbackTemp = CallBackManager::instance().RetrieveCallback(cbHandle);
-    
-    // If callback does not exist return a failure.
-    //if(callbackTemp==0)
-    //{
-     //  APISimTrace(1,"Trace Level 1: CallBackHandler::AsyncCallback - Callback does not exist!\n");
-      // return false;
-    //}
-    
-    // Given the callBackHandle, retrieve the relevant stored callBack entry.
-    CallBack* callback = new CallBack(*callbackTemp);
-    //callback.m_function = callbackTemp->m_function;
-
+    // Given the callBackHandle, retrieve a copy of the relevant stored 
+    // callBack entry.
+    CallBack* callback = CallBackPool::instance().AcquireCallBack();
     
+    // The handle may have been deregistered since the FAPI call validated
+    // it, in that case the response is dropped.
+    if(CallBackManager::instance().RetrieveCallback(cbHandle, *callback) == false)
+    {
+        APISimTrace(1,"Trace Level 1: CallBackHandler::AsyncCallback - Callback does not exist!\n");
+        CallBackPool::instance().ReleaseResp(data.resp);
+        CallBackPool::instance().ReleaseCallBack(callback);
+        return;
+    }
     
     // Store client info in callback object
     callback->m_cbCorrelator = cbCorrelator;
     callback->m_data = data;
+    callback->m_readyTime = FAPIMetrics::Now();
     
     // Trigger synchronous callback by calling fire function on 
     // retrieved callback entry.
-    if(m_eventSchedule == true)
+    switch(__atomic_load_n(&m_mode, __ATOMIC_ACQUIRE))
+    {
+        case CB_MODE_EVENT:
+            EventScheduler::instance().addEvent(*callback, 1);        
+        break;
+        case CB_MODE_DISPATCH:
+            // Queued behind earlier callbacks of the same handle.
+            CallBackDispatcher::instance().Dispatch(cbHandle, callback);
+        break;
+        default:
+            callback->Fire();        
+        break;
+    }
+    // Return success.    
+}
+
+/**
+ * Function Definition: Respond(NPF_callbackHandle_t cbHandle,
+ *                              NPF_correlator_t cbCorrelator,
+ *                              NPF_errorReporting_t errorReporting,
+ *                              NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+ *                              bool allOK)
+ */
+void CallBackHandler::Respond(NPF_callbackHandle_t cbHandle,
+                              NPF_correlator_t cbCorrelator,
+                              NPF_errorReporting_t errorReporting,
+                              NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+                              bool allOK)
+{
+    if((errorReporting == NPF_REPORT_ALL)||
+       ((errorReporting == NPF_REPORT_ERRORS)&&(allOK == false)))
     {
-        EventScheduler::instance().addEvent(*callback, 1);        
+        AsyncCallback(cbHandle, cbCorrelator, data);
     }else
     {
-        callback->Fire();        
+        // No callback will consume the responses.
+        CallBackPool::instance().ReleaseResp(data.resp);
     }
-    // Return success.    
+    data.resp = 0;
+}
+
+void CallBackHandler::setResponseChunkSize(NPF_uint32_t chunkSize)
+{
+    APISimTrace(3,"Trace Level 3: CallBackHandler::setResponseChunkSize(%d)\n",chunkSize);
+    __atomic_store_n(&m_chunkSize, chunkSize, __ATOMIC_RELAXED);
+}
+
+NPF_uint32_t CallBackHandler::GetResponseChunkSize(NPF_uint32_t numEntries)
+{
+    NPF_uint32_t chunkSize = __atomic_load_n(&m_chunkSize, __ATOMIC_RELAXED);
+    if((chunkSize == 0)||(chunkSize > numEntries))
+    {
+        return numEntries;
+    }
+    return chunkSize;
 }
 
 void CallBackHandler::setCallbackModeAsync()
 {
     APISimTrace(3,"Trace Level 3: CallBackHandler::setCallbackModeAsync()\n");
-    m_eventSchedule = true;   
+    __atomic_store_n(&m_mode, CB_MODE_EVENT, __ATOMIC_RELEASE);
+    CallBackDispatcher::instance().Stop();
+}
+
+/**
+ * Function Definition: setCallbackModeDispatch(NPF_uint32_t numThreads,
+ *                                              NPF_uint32_t queueDepth)
+ */
+bool CallBackHandler::setCallbackModeDispatch(NPF_uint32_t numThreads, NPF_uint32_t queueDepth)
+{
+    APISimTrace(3,"Trace Level 3: CallBackHandler::setCallbackModeDispatch(%d,%d)\n",numThreads,queueDepth);
+    if(CallBackDispatcher::instance().Start(numThreads, queueDepth) == false)
+    {
+        APISimTrace(1,"Trace Level 1: CallBackHandler::setCallbackModeDispatch - Dispatcher Not Started!\n");
+        return false;
+    }
+    __atomic_store_n(&m_mode, CB_MODE_DISPATCH, __ATOMIC_RELEASE);
+    return true;
+}
+
+void CallBackHandler::setCallbackModeSync()
+{
+    APISimTrace(3,"Trace Level 3: CallBackHandler::setCallbackModeSync()\n");
+    __atomic_store_n(&m_mode, CB_MODE_SYNC, __ATOMIC_RELEASE);
+    // Delivers whatever is still queued before returning.
+    CallBackDispatcher::instance().Stop();
 }
 
@@ -64,6 +64,7 @@
  */
 #include "npf.h"
 #include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "FAPIDefs.h"
 
 class CallBackHandler  
 {
@@ -107,13 +108,112 @@ public:
                        NPF_F_ATM_ConfigMgr_CallbackData_t& data);
                        
     void setCallbackModeAsync();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn setCallbackModeDispatch(NPF_uint32_t numThreads, 
+    *                             NPF_uint32_t queueDepth) 
+    *
+    * @brief Delivers callbacks on the CallBackDispatcher threads.
+    *
+    * @param numThreads NPF_uint32_t [in] - Number of dispatcher threads.
+    * @param queueDepth NPF_uint32_t [in] - Callbacks each callback handle
+    *                                         may have queued before the 
+    *                                         FAPI caller is held back.
+    *
+    * Callbacks of one callback handle are delivered in order, callbacks of
+    * different handles in parallel. A callback may call the FAPI again on
+    * its own handle: if that fills the queue of the handle, the queued
+    * callbacks are delivered, still in order, from within the FAPI call
+    * instead of holding it back. The previous mode is kept if the 
+    * dispatcher cannot be started.
+    *
+    * @return bool 
+    */
+    bool setCallbackModeDispatch(NPF_uint32_t numThreads = _IX_CC_ATM_FAPI_DISPATCH_THREADS,
+                                 NPF_uint32_t queueDepth = _IX_CC_ATM_FAPI_DISPATCH_QUEUE_DEPTH);
+                       
+    void setCallbackModeSync();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Respond(NPF_callbackHandle_t cbHandle,
+    *             NPF_correlator_t cbCorrelator,
+    *             NPF_errorReporting_t errorReporting,
+    *             NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+    *             bool allOK) 
+    *
+    * @brief Passes one chunk of responses to the client.
+    *
+    * @param errorReporting NPF_errorReporting_t [in] - The reporting 
+    *                                                     requested with the
+    *                                                     FAPI call, already
+    *                                                     validated.
+    * @param data NPF_F_ATM_ConfigMgr_CallbackData_t [in] - Responses of 
+    *                                                         the chunk, the
+    *                                                         resp buffer 
+    *                                                         comes from the
+    *                                                         CallBackPool.
+    * @param allOK bool [in] - false if any response in the chunk is an 
+    *                            error.
+    *
+    * The chunk is delivered through AsyncCallback() when errorReporting 
+    * asks for it, otherwise its response buffer is released.
+    *
+    * @return None 
+    */
+    void Respond(NPF_callbackHandle_t cbHandle,
+                 NPF_correlator_t cbCorrelator,
+                 NPF_errorReporting_t errorReporting,
+                 NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+                 bool allOK);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn setResponseChunkSize(NPF_uint32_t chunkSize) 
+    *
+    * @brief Sets the number of responses passed to one callback invocation.
+    *
+    * @param chunkSize NPF_uint32_t [in] - Responses per invocation, 0 
+    *                                        reports every FAPI call in a
+    *                                        single invocation.
+    *
+    * @return None 
+    */
+    void setResponseChunkSize(NPF_uint32_t chunkSize);
+
+    NPF_uint32_t GetResponseChunkSize(NPF_uint32_t numEntries);
                        
 private:
     CallBackHandler();
     CallBackHandler(const CallBackHandler&);
     CallBackHandler& operator =(const CallBackHandler&);
     
-    bool m_eventSchedule;
+    enum
+    {
+        CB_MODE_SYNC,
+        CB_MODE_EVENT,
+        CB_MODE_DISPATCH
+    };
+    
+    /**
+    * CallBackHandler Member Variables.
+    * 
+    * m_mode - How AsyncCallback() delivers a callback: on the calling 
+    *          thread, through the EventScheduler or through the 
+    *          CallBackDispatcher.
+    *
+    */
+    unsigned int m_mode;
+    
+    /**
+    * m_chunkSize - Responses passed to one callback invocation, 0 for no
+    *               limit.
+    */
+    NPF_uint32_t m_chunkSize;
     
 };
 #endif // #if !defined __CALLBACKHANDLER_H_
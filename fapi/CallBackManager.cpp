@@ -50,18 +50,26 @@
  * User defined include files required.
  */
 #include "CallBackManager.h"
+#include "FAPIMetrics.h"
 #include "APISimConfig.h"
 #include "TraceMacro.h"
 #include "FAPIDefs.h"
 
 CallBackManager::CallBackManager()
-: m_handleID(1)
 {
+    for(unsigned int x = 0; x < _ATM_FAPI_SIM_CB_HANDLE_MAX; x++)
+    {
+        m_callbackTable[x].state = 0;
+        m_callbackTable[x].context = 0;
+        m_callbackTable[x].function = 0;
+        m_callbackTable[x].batchMode = NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL;
+    }
+    pthread_mutex_init(&m_registerLock, 0);
 }
 
 CallBackManager::~CallBackManager()
 {
-
+    pthread_mutex_destroy(&m_registerLock);
 }
 
 CallBackManager& CallBackManager::instance()
@@ -83,49 +91,57 @@ NPF_error_t CallBackManager::RegisterCallBack(NPF_userContext_t userContext,
                                        NPF_callbackHandle_t *callbackHandle)
 {   
     APISimTrace(3,"Trace Level 3: CallBackManager::RegisterCallBack(%d,..,%d)\n",userContext, *callbackHandle); 
-    tableIterator tableIter;
+    unsigned int freeSlot = _ATM_FAPI_SIM_CB_HANDLE_MAX;
+    
+    // Writers are serialised, so the slots can be read directly here.
+    FAPIMetrics::Lock(&m_registerLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_REGISTER);
     
     // Check for duplicate registration of userContext and callbackFuntion
     // If found return stored handle and error message entry exists.
-    pthread_mutex_lock(&syncMutex);
-   
-    for(tableIter = m_callbackTable.begin(); tableIter != m_callbackTable.end(); ++tableIter)
+    for(unsigned int x = 0; x < _ATM_FAPI_SIM_CB_HANDLE_MAX; x++)
     {
-        if(tableIter->second.m_context == userContext)
+        callbackSlot& slot = m_callbackTable[x];
+        if((slot.state & CB_SLOT_LIVE) == 0)
         {
-            if(tableIter->second.m_function == callbackFunc)
+            if(freeSlot == _ATM_FAPI_SIM_CB_HANDLE_MAX)
             {
-                APISimTrace(1,"Trace Level 1: CallBackManager::RegisterCallBack - Callback already registered!\n");
-                *callbackHandle = tableIter->first;
-                return NPF_E_RESOURCE_EXISTS;
-            }    
+                freeSlot = x;
+            }
+            continue;
+        }
+        if((slot.context == userContext)&&(slot.function == callbackFunc))
+        {
+            APISimTrace(1,"Trace Level 1: CallBackManager::RegisterCallBack - Callback already registered!\n");
+            *callbackHandle = x + 1;
+            pthread_mutex_unlock(&m_registerLock);
+            return NPF_E_RESOURCE_EXISTS;
         }
     }
-        
-    pthread_mutex_unlock(&syncMutex);
-
-    // Create a callback entry object to be stored in the map.
-    // The callback object holds the userContext and callbackfunc.
-    CallBack entry = CallBack(userContext, callbackFunc);    
-    
-    // Insert entry into the map, with the current handleID value as key.
-    pthread_mutex_lock(&syncMutex);
     
     // Check to see we do not exceed max number of callbacks
-    if(m_callbackTable.size() == _ATM_FAPI_SIM_CB_HANDLE_MAX)
+    if(freeSlot == _ATM_FAPI_SIM_CB_HANDLE_MAX)
     {
         APISimTrace(1,"Trace Level 1: CallBackManager::RegisterCallBack - Max Number of Callbacks Reached!\n");
+        pthread_mutex_unlock(&m_registerLock);
         return NPF_E_UNKNOWN;      
     }
+
+    // Publish the entry: mark the slot busy, store the userContext and 
+    // callbackfunc, then make it live under the next generation.
+    callbackSlot& slot = m_callbackTable[freeSlot];
+    unsigned int generation = slot.state & ~(CB_SLOT_BUSY | CB_SLOT_LIVE);
+    __atomic_store_n(&slot.state, generation | CB_SLOT_BUSY, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&slot.context, userContext, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot.function, callbackFunc, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot.batchMode, NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot.state, (generation + CB_SLOT_GENERATION) | CB_SLOT_LIVE, __ATOMIC_RELEASE);
     
-    m_callbackTable.insert(callbackEntry(m_handleID, entry));
-    pthread_mutex_unlock(&syncMutex);
+    pthread_mutex_unlock(&m_registerLock);
     
     // Return callbackHandle of stored entry.
-    *callbackHandle = m_handleID;
+    *callbackHandle = freeSlot + 1;
     
-    // Increment callbackHandle value.
-    m_handleID++;    
     // Return success.
     return NPF_NO_ERROR;
 }
@@ -133,46 +149,121 @@ NPF_error_t CallBackManager::RegisterCallBack(NPF_userContext_t userContext,
 NPF_error_t CallBackManager::DeRegisterCallBack(NPF_callbackHandle_t cbHandle)
 {
     APISimTrace(3,"Trace Level 3: CallBackManager::DeRegisterCallBack(%d)\n",cbHandle);
-    if(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)
+    if((cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
     {
         APISimTrace(1,"Trace Level 1: CallBackManager::DeRegisterCallBack - Invalid CallBack Handle!\n");
         return NPF_E_BAD_CALLBACK_HANDLE;    
     } 
     
-    pthread_mutex_lock(&syncMutex);
-    tableFindIterator callbackIter = m_callbackTable.find(cbHandle);
-    pthread_mutex_unlock(&syncMutex);
+    FAPIMetrics::Lock(&m_registerLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_REGISTER);
+    callbackSlot& slot = m_callbackTable[cbHandle - 1];
     
-    if(callbackIter == m_callbackTable.end())
+    if((slot.state & CB_SLOT_LIVE) == 0)
     {
+        pthread_mutex_unlock(&m_registerLock);
         APISimTrace(1,"Trace Level 1: CallBackManager::DeRegisterCallBack - Callback Does Not Exist!\n");
         return NPF_E_BAD_CALLBACK_HANDLE; 
     }
     
-    pthread_mutex_lock(&syncMutex);
-    m_callbackTable.erase(cbHandle);
-    pthread_mutex_unlock(&syncMutex);
+    // Retract the entry. Advancing the generation invalidates any copy a 
+    // reader started before this point, even if the slot is reused.
+    unsigned int generation = slot.state & ~(CB_SLOT_BUSY | CB_SLOT_LIVE);
+    __atomic_store_n(&slot.state, generation + CB_SLOT_GENERATION, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&m_registerLock);
     
-    m_handleID--;
     return NPF_NO_ERROR;
     
        
 }
 /**
- * Function Definition: retrieveCallback(NPF_callbackHandle_t cbHandle)
+ * Function Definition: retrieveCallback(NPF_callbackHandle_t cbHandle, CallBack& callback)
  */
-CallBack* CallBackManager::RetrieveCallback(NPF_callbackHandle_t cbHandle)
+bool CallBackManager::RetrieveCallback(NPF_callbackHandle_t cbHandle, CallBack& callback)
 {
     APISimTrace(3,"Trace Level 3: CallBackManager::RetrieveCallback(%d)\n",cbHandle);
-    pthread_mutex_lock(&syncMutex);
-    tableFindIterator callbackIter = m_callbackTable.find(cbHandle);
-    pthread_mutex_unlock(&syncMutex);
-    if(callbackIter == m_callbackTable.end())
+    if((cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: CallBackManager::RetrieveCallback - Invalid CallBack Handle!\n");
+        return false;
+    }
+    
+    callbackSlot& slot = m_callbackTable[cbHandle - 1];
+    unsigned int before = __atomic_load_n(&slot.state, __ATOMIC_ACQUIRE);
+    if((before & (CB_SLOT_BUSY | CB_SLOT_LIVE)) != CB_SLOT_LIVE)
     {
         APISimTrace(1,"Trace Level 1: CallBackManager::RetrieveCallback - Callback Does Not Exist!\n");
         //CallBack does not exist
-        return 0; 
+        return false; 
+    }
+    
+    NPF_userContext_t context = __atomic_load_n(&slot.context, __ATOMIC_RELAXED);
+    NPF_F_ATM_ConfigMgr_CallBackFunc_t function = __atomic_load_n(&slot.function, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    
+    // If the state moved on, the entry was deregistered during the copy.
+    if(__atomic_load_n(&slot.state, __ATOMIC_RELAXED) != before)
+    {
+        APISimTrace(1,"Trace Level 1: CallBackManager::RetrieveCallback - Callback Deregistered!\n");
+        return false;
+    }
+    
+    callback.m_context = context;
+    callback.m_function = function;
+    return true;
+}
+
+/**
+ * Function Definition: IsRegistered(NPF_callbackHandle_t cbHandle)
+ */
+bool CallBackManager::IsRegistered(NPF_callbackHandle_t cbHandle)
+{
+    if((cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        return false;
     }
-    return &callbackIter->second;
+    unsigned int state = __atomic_load_n(&m_callbackTable[cbHandle - 1].state, __ATOMIC_ACQUIRE);
+    return ((state & (CB_SLOT_BUSY | CB_SLOT_LIVE)) == CB_SLOT_LIVE);
 }
 
+/**
+ * Function Definition: SetBatchMode(NPF_callbackHandle_t cbHandle, 
+ *                                   NPF_F_ATM_ConfigMgr_BatchMode_t batchMode)
+ */
+NPF_error_t CallBackManager::SetBatchMode(NPF_callbackHandle_t cbHandle, NPF_F_ATM_ConfigMgr_BatchMode_t batchMode)
+{
+    APISimTrace(3,"Trace Level 3: CallBackManager::SetBatchMode(%d,%d)\n",cbHandle,batchMode);
+    if((cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: CallBackManager::SetBatchMode - Invalid CallBack Handle!\n");
+        return NPF_E_BAD_CALLBACK_HANDLE;    
+    } 
+    
+    // Taken so the mode cannot land on a registration that replaced the
+    // one the caller meant.
+    FAPIMetrics::Lock(&m_registerLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_REGISTER);
+    callbackSlot& slot = m_callbackTable[cbHandle - 1];
+    
+    if((slot.state & CB_SLOT_LIVE) == 0)
+    {
+        pthread_mutex_unlock(&m_registerLock);
+        APISimTrace(1,"Trace Level 1: CallBackManager::SetBatchMode - Callback Does Not Exist!\n");
+        return NPF_E_BAD_CALLBACK_HANDLE; 
+    }
+    
+    __atomic_store_n(&slot.batchMode, (unsigned int)batchMode, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&m_registerLock);
+    
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function Definition: GetBatchMode(NPF_callbackHandle_t cbHandle)
+ */
+NPF_F_ATM_ConfigMgr_BatchMode_t CallBackManager::GetBatchMode(NPF_callbackHandle_t cbHandle)
+{
+    if((cbHandle == 0)||(cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        return NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL;
+    }
+    return (NPF_F_ATM_ConfigMgr_BatchMode_t)__atomic_load_n(&m_callbackTable[cbHandle - 1].batchMode, __ATOMIC_RELAXED);
+}
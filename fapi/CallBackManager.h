@@ -12,7 +12,10 @@
  * instance of a registered callback.
  *
  * Design Notes:
- *    <describe any non-obvious design decisions which impact this file>
+ *    Callback handles are small integers bounded by 
+ *    _ATM_FAPI_SIM_CB_HANDLE_MAX, so entries live in a fixed array indexed
+ *    by handle. Every FAPI call retrieves its callback, retrieval is wait 
+ *    free and copies the entry out so nothing refers back into the table.
  *
  * -- Intel Copyright Notice --
  *
@@ -65,12 +68,13 @@
 #include "npf.h"
 #include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
 #include "CallBack.h"
+#include "FAPIDefs.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
 
 /**
  * System defined include files required.
  */
-#include <map>
-using namespace std;
+#include <pthread.h>
 
 class CallBackManager  
 {
@@ -124,7 +128,7 @@ public:
     /**
     * @ingroup FAPI Simulator
     *
-    * @fn retrieveCallback(NPF_callbackHandle_t cbHandle) 
+    * @fn retrieveCallback(NPF_callbackHandle_t cbHandle, CallBack& callback) 
     *
     * @brief Retrieves registered callback information.
     *
@@ -132,73 +136,113 @@ public:
     *                                               for the registered 
     *                                               atmUserContext and 
     *                                               atmEventCallFunc pair.
+    * @param callback CallBack& [out] - Receives a copy of the stored 
+    *                                     callback entry.
     *
     *
-    * Given a valid callback handle the operation returns the relevant stored
+    * Given a valid callback handle the operation copies the relevant stored
     * callback entry. The callback entry contains a unique usercontext, 
-    * callbackfunc pair.
+    * callbackfunc pair. The copy stays valid if the handle is deregistered
+    * afterwards. A registration that is replaced while it is being read 
+    * is reported as not registered.
     *
-    * @return CallBack
+    * @return bool - false if the handle is not registered.
     */    
-    CallBack* RetrieveCallback(NPF_callbackHandle_t cbHandle);
-    
-    private:
-    CallBackManager();
-    CallBackManager(const CallBackManager&);
-    CallBackManager& operator =(const CallBackManager&);
+    bool RetrieveCallback(NPF_callbackHandle_t cbHandle, CallBack& callback);
 
     /**
     * @ingroup FAPI Simulator
-    * 
-    * @typedef callbackEntry
     *
-    * @brief Typedef of a typical entry for the callback MAP
+    * @fn IsRegistered(NPF_callbackHandle_t cbHandle) 
     *
-    */
-    typedef pair<unsigned int, CallBack> callbackEntry;
-    
+    * @brief Checks whether a callback handle is registered.
+    *
+    * @return bool
+    */    
+    bool IsRegistered(NPF_callbackHandle_t cbHandle);
+
     /**
     * @ingroup FAPI Simulator
-    * 
-    * @typedef callBackTable
     *
-    * @brief Typedef of a callBackTable
+    * @fn SetBatchMode(NPF_callbackHandle_t cbHandle, 
+    *                  NPF_F_ATM_ConfigMgr_BatchMode_t batchMode) 
+    *
+    * @brief Sets how the batched calls made with a handle are applied.
     *
+    * @param cbHandle NPF_callbackHandle_t [in] - A registered callback 
+    *                                               handle.
+    * @param batchMode NPF_F_ATM_ConfigMgr_BatchMode_t [in] - The mode to 
+    *                                                          use.
+    *
+    * The mode is reset to NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL whenever the 
+    * handle is registered.
+    *
+    * @return NPF_error_t - NPF_E_BAD_CALLBACK_HANDLE if the handle is not
+    *                       registered.
     */
-    typedef map<unsigned int, CallBack> callBackTable;
+    NPF_error_t SetBatchMode(NPF_callbackHandle_t cbHandle, NPF_F_ATM_ConfigMgr_BatchMode_t batchMode);
 
     /**
     * @ingroup FAPI Simulator
-    * 
-    * @typedef tableIterator
     *
-    * @brief Typedef of callBackTable iterator
+    * @fn GetBatchMode(NPF_callbackHandle_t cbHandle) 
+    *
+    * @brief Returns the batch mode of a handle, 
+    *        NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL if it is not registered.
     *
+    * @return NPF_F_ATM_ConfigMgr_BatchMode_t
     */
-    typedef map<unsigned int, CallBack>::const_iterator tableIterator;         
+    NPF_F_ATM_ConfigMgr_BatchMode_t GetBatchMode(NPF_callbackHandle_t cbHandle);
+    
+    private:
+    CallBackManager();
+    CallBackManager(const CallBackManager&);
+    CallBackManager& operator =(const CallBackManager&);
 
     /**
     * @ingroup FAPI Simulator
     * 
-    * @typedef tableFindIterator
+    * @typedef callbackSlot
+    *
+    * @brief Typedef of a typical entry for the callback table
     *
-    * @brief Typedef of callBackTable find iterator
+    * state holds a generation count shifted left by two, with 
+    * CB_SLOT_BUSY set while the slot is being written and CB_SLOT_LIVE 
+    * set while a callback is registered in it. Every registration and 
+    * deregistration advances the generation, so a reader that sees the 
+    * same state before and after copying the fields has a consistent copy
+    * of a registration that was live for the whole read. batchMode is 
+    * read on its own and needs no consistent copy.
     *
     */
-    typedef map<unsigned int, CallBack>::iterator tableFindIterator;        
+    typedef struct
+    {
+        unsigned int state;
+        NPF_userContext_t context;
+        NPF_F_ATM_ConfigMgr_CallBackFunc_t function;
+        unsigned int batchMode;
+    } callbackSlot;
+
+    enum
+    {
+        CB_SLOT_BUSY = 0x1,
+        CB_SLOT_LIVE = 0x2,
+        CB_SLOT_GENERATION = 0x4
+    };
         
     /**
     * CallBackManager Member Variables.
     * 
-    * m_handleID - A unique identifier assigned for the registered 
-    *              atmUserContext and atmEventCallFunc pair.
-    * 
-    * m_callbackTable - Map containing callback entries identified by a 
-    *                   callback handle key.
+    * m_callbackTable - Callback entries, the callback handle is the slot 
+    *                   index plus one. Entries are published and 
+    *                   retracted atomically through their state word, 
+    *                   retrievals do not lock.
+    *
+    * m_registerLock - Serialises registration and deregistration.
     *
     */
-    unsigned int m_handleID;
-    callBackTable m_callbackTable;
+    callbackSlot m_callbackTable[_ATM_FAPI_SIM_CB_HANDLE_MAX];
+    pthread_mutex_t m_registerLock;
 
 
 };
@@ -0,0 +1,273 @@
+/**
+ * @file CallBackPool.cpp
+ *
+ * @date 2 May 2005
+ *
+ * @brief The CallBackPool supplies CallBack objects and response buffers.
+ *
+ * Implementation of the CallBack object and response buffer free lists.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "CallBackPool.h"
+#include "FAPIMemory.h"
+#include "FAPIMetrics.h"
+#include "TraceMacro.h"
+
+/*
+ * System defined include files required.
+ */
+#include <new>
+
+CallBackPool::CallBackPool()
+{
+    pthread_mutex_init(&m_callBackLock, 0);
+    pthread_mutex_init(&m_respLock, 0);
+
+    m_callBacks.reserve(_IX_CC_ATM_FAPI_CALL_FL_SIZE);
+    m_callBackFree.reserve(_IX_CC_ATM_FAPI_CALL_FL_SIZE);
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_CALL_FL_SIZE; x++)
+    {
+        m_callBacks.push_back(new CallBack(0, 0));
+        m_callBackFree.push_back(m_callBacks.back());
+    }
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, _IX_CC_ATM_FAPI_CALL_FL_SIZE * sizeof(CallBack));
+
+    m_respLeases.reserve(_IX_CC_ATM_FAPI_RESP_FL_SIZE);
+    m_respFree[0].reserve(_IX_CC_ATM_FAPI_RESP_FL_SIZE);
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_RESP_FL_SIZE; x++)
+    {
+        m_respLeases.push_back(NewLease(0, _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX));
+        m_respFree[0].push_back(m_respLeases.back());
+        FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_RESP, LeaseBytes(m_respLeases.back()));
+    }
+}
+
+CallBackPool::~CallBackPool()
+{
+    for(size_t x = 0; x < m_callBacks.size(); x++)
+    {
+        delete m_callBacks[x];
+    }
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, -(long long)(m_callBackFree.size() * sizeof(CallBack)));
+    for(unsigned int x = 0; x <= RESP_CLASS_MAX; x++)
+    {
+        for(size_t y = 0; y < m_respFree[x].size(); y++)
+        {
+            FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_RESP, -(long long)LeaseBytes(m_respFree[x][y]));
+        }
+    }
+    for(size_t x = 0; x < m_respLeases.size(); x++)
+    {
+        ::operator delete(m_respLeases[x]);
+    }
+
+    pthread_mutex_destroy(&m_callBackLock);
+    pthread_mutex_destroy(&m_respLock);
+}
+
+CallBackPool& CallBackPool::instance()
+{
+    // Singleton Pattern
+    static CallBackPool instance;
+    return instance;
+}
+
+/**
+ * Function Definition: AcquireCallBack()
+ */
+CallBack* CallBackPool::AcquireCallBack()
+{
+    CallBack* callback = 0;
+
+    FAPIMetrics::Lock(&m_callBackLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL);
+    if(m_callBackFree.empty() == false)
+    {
+        callback = m_callBackFree.back();
+        m_callBackFree.pop_back();
+        FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, -(long long)sizeof(CallBack));
+    }else
+    {
+        // Every object is out, the pool grows by one and keeps it.
+        APISimTrace(2,"Trace Level 2: CallBackPool::AcquireCallBack - Free List Empty!\n");
+        callback = new CallBack(0, 0);
+        m_callBacks.push_back(callback);
+        m_callBackFree.reserve(m_callBacks.size());
+    }
+    pthread_mutex_unlock(&m_callBackLock);
+    FAPIMemory::Acquire(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, sizeof(CallBack));
+
+    // Reset whatever the previous user left behind.
+    callback->m_context = 0;
+    callback->m_function = 0;
+    callback->m_cbCorrelator = 0;
+    return callback;
+}
+
+/**
+ * Function Definition: ReleaseCallBack(CallBack* callback)
+ */
+void CallBackPool::ReleaseCallBack(CallBack* callback)
+{
+    if(callback == 0)
+    {
+        return;
+    }
+
+    FAPIMetrics::Lock(&m_callBackLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL);
+    m_callBackFree.push_back(callback);
+    pthread_mutex_unlock(&m_callBackLock);
+    FAPIMemory::Release(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, sizeof(CallBack));
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_CALLBACK, (long long)sizeof(CallBack));
+}
+
+/**
+ * Function Definition: Lease(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+ */
+CallBackPool::respLease* CallBackPool::Lease(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+{
+    return reinterpret_cast<respLease*>(resp) - 1;
+}
+
+/**
+ * Function Definition: NewLease(unsigned int sizeClass, NPF_uint32_t numEntries)
+ */
+CallBackPool::respLease* CallBackPool::NewLease(unsigned int sizeClass, NPF_uint32_t numEntries)
+{
+    respLease* lease = static_cast<respLease*>(
+        ::operator new(sizeof(respLease) + (sizeof(NPF_F_ATM_ConfigMgr_AsyncResponse_t) * numEntries)));
+    lease->lease.refs = 0;
+    lease->lease.sizeClass = sizeClass;
+    lease->lease.numEntries = numEntries;
+    return lease;
+}
+
+/**
+ * Function Definition: LeaseBytes(const respLease* lease)
+ */
+unsigned long long CallBackPool::LeaseBytes(const respLease* lease)
+{
+    return sizeof(respLease) + (sizeof(NPF_F_ATM_ConfigMgr_AsyncResponse_t) * lease->lease.numEntries);
+}
+
+/**
+ * Function Definition: AcquireResp(NPF_uint32_t numEntries)
+ */
+NPF_F_ATM_ConfigMgr_AsyncResponse_t* CallBackPool::AcquireResp(NPF_uint32_t numEntries)
+{
+    respLease* lease = 0;
+    unsigned int sizeClass = 0;
+
+    while((sizeClass <= RESP_CLASS_MAX)&&
+          (numEntries > ((NPF_uint32_t)_IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX << sizeClass)))
+    {
+        sizeClass++;
+    }
+
+    if(sizeClass > RESP_CLASS_MAX)
+    {
+        APISimTrace(2,"Trace Level 2: CallBackPool::AcquireResp(%d) - No Pooled Buffer!\n",numEntries);
+        lease = NewLease(RESP_CLASS_NONE, numEntries);
+    }else
+    {
+        FAPIMetrics::Lock(&m_respLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL);
+        if(m_respFree[sizeClass].empty() == false)
+        {
+            lease = m_respFree[sizeClass].back();
+            m_respFree[sizeClass].pop_back();
+            FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_RESP, -(long long)LeaseBytes(lease));
+        }else
+        {
+            // Every buffer of the class is out, the pool grows by one and
+            // keeps it.
+            lease = NewLease(sizeClass, (NPF_uint32_t)_IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX << sizeClass);
+            m_respLeases.push_back(lease);
+            m_respFree[sizeClass].reserve(m_respLeases.size());
+        }
+        pthread_mutex_unlock(&m_respLock);
+    }
+
+    FAPIMemory::Acquire(NPF_F_ATM_CONFIGMGR_MEM_RESP, LeaseBytes(lease));
+    __atomic_store_n(&lease->lease.refs, 1, __ATOMIC_RELAXED);
+    return reinterpret_cast<NPF_F_ATM_ConfigMgr_AsyncResponse_t*>(lease + 1);
+}
+
+/**
+ * Function Definition: HoldResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+ */
+bool CallBackPool::HoldResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+{
+    if(resp == 0)
+    {
+        return false;
+    }
+    __atomic_add_fetch(&Lease(resp)->lease.refs, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * Function Definition: ReleaseResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+ */
+void CallBackPool::ReleaseResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+{
+    if(resp == 0)
+    {
+        return;
+    }
+
+    respLease* lease = Lease(resp);
+    if(__atomic_sub_fetch(&lease->lease.refs, 1, __ATOMIC_ACQ_REL) != 0)
+    {
+        // Still held by the client.
+        return;
+    }
+
+    unsigned long long bytes = LeaseBytes(lease);
+    FAPIMemory::Release(NPF_F_ATM_CONFIGMGR_MEM_RESP, bytes);
+    if(lease->lease.sizeClass == RESP_CLASS_NONE)
+    {
+        ::operator delete(lease);
+        return;
+    }
+
+    FAPIMetrics::Lock(&m_respLock, NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL);
+    m_respFree[lease->lease.sizeClass].push_back(lease);
+    pthread_mutex_unlock(&m_respLock);
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_RESP, (long long)bytes);
+}
@@ -0,0 +1,242 @@
+/**
+ * @file CallBackPool.h
+ *
+ * @date 2 May 2005
+ *
+ * @brief The CallBackPool supplies CallBack objects and response buffers.
+ *
+ * The CallBackPool is a singleton. Every asynchronous FAPI call needs a
+ * response buffer for its callback data and a CallBack object to carry it to
+ * the client. Both are taken from free lists that are filled when the pool is
+ * created, so steady state configuration traffic does not call the allocator
+ * on the callback path.
+ *
+ * Design Notes:
+ *    _IX_CC_ATM_FAPI_CALL_FL_SIZE CallBack objects and
+ *    _IX_CC_ATM_FAPI_RESP_FL_SIZE response buffers of
+ *    _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX entries are preallocated. When a
+ *    free list is empty a new object or buffer is allocated, and it joins
+ *    the free list when it is released, so the pool grows to the number of
+ *    callbacks that are outstanding at once, which in dispatch mode is up
+ *    to the dispatcher queue depth, and stays there.
+ *
+ *    Response buffers come in size classes of
+ *    _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX entries times a power of two, so a
+ *    large batch is also reported from a pooled buffer. Only a batch beyond
+ *    the largest class is allocated and freed each time.
+ *
+ *    A response buffer is a lease with a reference count, kept in a header
+ *    in front of the entries. The buffer is passed to the client callback
+ *    as it was filled in, and goes back to the pool when the last reference
+ *    is released: normally when the callback returns, or later if the
+ *    client held it with NPF_F_ATM_ConfigMgr_RespHold().
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __CALLBACKPOOL_H_
+#define __CALLBACKPOOL_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "CallBack.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <vector>
+using namespace std;
+
+class CallBackPool
+{
+public:
+    virtual ~CallBackPool();
+
+    static CallBackPool& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn AcquireCallBack()
+    *
+    * @brief Returns an unused CallBack object.
+    *
+    * The object is constructed with a null user context and callback
+    * function. It is returned with ReleaseCallBack().
+    *
+    * @return CallBack*
+    */
+    CallBack* AcquireCallBack();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ReleaseCallBack(CallBack* callback)
+    *
+    * @brief Returns a CallBack object obtained from AcquireCallBack().
+    *
+    * @param callback CallBack* [in] - The object to release, may be NULL.
+    *
+    * @return None
+    */
+    void ReleaseCallBack(CallBack* callback);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn AcquireResp(NPF_uint32_t numEntries)
+    *
+    * @brief Returns a response buffer of at least numEntries entries.
+    *
+    * @param numEntries NPF_uint32_t [in] - Number of responses the buffer
+    *                                         must hold.
+    *
+    * @return NPF_F_ATM_ConfigMgr_AsyncResponse_t*
+    */
+    NPF_F_ATM_ConfigMgr_AsyncResponse_t* AcquireResp(NPF_uint32_t numEntries);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn HoldResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+    *
+    * @brief Adds a reference to a response buffer obtained from
+    *        AcquireResp(), it is then returned to the pool by one more
+    *        ReleaseResp().
+    *
+    * @param resp NPF_F_ATM_ConfigMgr_AsyncResponse_t* [in] - The buffer to
+    *                                                          hold.
+    *
+    * @return bool - false if resp is NULL.
+    */
+    bool HoldResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ReleaseResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+    *
+    * @brief Drops a reference to a response buffer obtained from
+    *        AcquireResp(), the last reference returns it to the pool.
+    *
+    * @param resp NPF_F_ATM_ConfigMgr_AsyncResponse_t* [in] - The buffer to
+    *                                                          release, may
+    *                                                          be NULL.
+    *
+    * @return None
+    */
+    void ReleaseResp(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp);
+
+private:
+    CallBackPool();
+    CallBackPool(const CallBackPool&);
+    CallBackPool& operator =(const CallBackPool&);
+
+    enum
+    {
+        // Response buffers hold _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX << class
+        // entries, the largest class covers a batch of every VC link.
+        RESP_CLASS_MAX = 7,
+        RESP_CLASS_NONE = 0xFF
+    };
+
+    typedef char RespClassCheck[((_IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX << RESP_CLASS_MAX) >= _IX_CC_ATM_FAPI_VC_LINK_MAX) ? 1 : -1];
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef respLease
+    *
+    * @brief Typedef of the header in front of the entries of a response
+    *        buffer. It is the size of one entry so the entries stay
+    *        aligned, numEntries is the number the buffer holds.
+    *
+    */
+    typedef union
+    {
+        struct
+        {
+            unsigned int refs;
+            unsigned int sizeClass;
+            NPF_uint32_t numEntries;
+        } lease;
+        NPF_F_ATM_ConfigMgr_AsyncResponse_t align;
+    } respLease;
+
+    static respLease* Lease(NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp);
+    static respLease* NewLease(unsigned int sizeClass, NPF_uint32_t numEntries);
+    static unsigned long long LeaseBytes(const respLease* lease);
+
+    /**
+    * CallBackPool Member Variables.
+    *
+    * m_callBacks - Every CallBack object the pool has allocated.
+    *
+    * m_callBackFree - Stack of unused CallBack objects.
+    *
+    * m_respLeases - Every pooled response buffer the pool has allocated.
+    *
+    * m_respFree - Stack of unused response buffers of each size class.
+    *
+    * m_callBackLock, m_respLock - Protect the CallBack and response
+    *                              buffer lists.
+    *
+    */
+    vector<CallBack*> m_callBacks;
+    vector<CallBack*> m_callBackFree;
+
+    vector<respLease*> m_respLeases;
+    vector<respLease*> m_respFree[RESP_CLASS_MAX + 1];
+
+    pthread_mutex_t m_callBackLock;
+    pthread_mutex_t m_respLock;
+};
+#endif // #if !defined __CALLBACKPOOL_H_
+/**
+ *@}
+ */
@@ -0,0 +1,408 @@
+/**
+ * @file ChangeNotifier.cpp
+ *
+ * @date 7 June 2005
+ *
+ * @brief The ChangeNotifier reports the changes made to the TableManager
+ *        tables to subscribed clients.
+ *
+ * Implementation of the change subscriptions and their delivery threads.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "ChangeNotifier.h"
+#include "FAPIMetrics.h"
+#include "TraceMacro.h"
+
+/*
+ * Changes collected by the calling thread, 0 until it first collects one.
+ */
+static __thread void* t_pendingChanges = 0;
+
+ChangeNotifier::ChangeNotifier()
+: m_numSubscribers(0), m_nextTicket(0), m_turn(0)
+{
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX; x++)
+    {
+        m_subscribers[x].active = false;
+        m_subscribers[x].stopping = false;
+        m_subscribers[x].ring = 0;
+        pthread_mutex_init(&m_subscribers[x].lock, 0);
+        pthread_cond_init(&m_subscribers[x].dataCond, 0);
+        pthread_cond_init(&m_subscribers[x].spaceCond, 0);
+    }
+    pthread_mutex_init(&m_publishLock, 0);
+    pthread_cond_init(&m_turnCond, 0);
+    pthread_key_create(&m_pendingKey, ReleasePending);
+    pthread_mutex_init(&m_controlLock, 0);
+}
+
+ChangeNotifier::~ChangeNotifier()
+{
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX; x++)
+    {
+        if(m_subscribers[x].active == true)
+        {
+            Unsubscribe(x + 1);
+        }
+        pthread_mutex_destroy(&m_subscribers[x].lock);
+        pthread_cond_destroy(&m_subscribers[x].dataCond);
+        pthread_cond_destroy(&m_subscribers[x].spaceCond);
+    }
+    pthread_mutex_destroy(&m_publishLock);
+    pthread_cond_destroy(&m_turnCond);
+    pthread_mutex_destroy(&m_controlLock);
+}
+
+ChangeNotifier& ChangeNotifier::instance()
+{
+    // Singleton Pattern
+    static ChangeNotifier instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Subscribe(NPF_userContext_t userContext,
+ *                                NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+ *                                NPF_uint32_t changeMask,
+ *                                NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+ *                                NPF_uint32_t queueDepth,
+ *                                NPF_callbackHandle_t* eventHandle)
+ */
+NPF_error_t ChangeNotifier::Subscribe(NPF_userContext_t userContext, NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+                                      NPF_uint32_t changeMask, NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+                                      NPF_uint32_t queueDepth, NPF_callbackHandle_t* eventHandle)
+{
+    APISimTrace(3,"Trace Level 3: ChangeNotifier::Subscribe(%p,..,0x%x,%d,%d,..)\n",userContext,changeMask,policy,queueDepth);
+    if(changeFunc == 0)
+    {
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Subscribe - Change Function Is Null!\n");
+        return NPF_E_BAD_CALLBACK_FUNCTION;
+    }
+    if((eventHandle == 0)||(changeMask == 0)||((changeMask & ~NPF_F_ATM_CONFIGMGR_CHANGE_ALL) != 0)||
+       ((policy != NPF_F_ATM_CONFIGMGR_CHANGE_DROP)&&(policy != NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK))||
+       (queueDepth == 0)||(queueDepth > _IX_CC_ATM_FAPI_CHANGE_QUEUE_DEPTH_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Subscribe - Invalid Parameter!\n");
+        return NPF_E_UNKNOWN;
+    }
+
+    pthread_mutex_lock(&m_controlLock);
+    unsigned int index = _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX;
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX; x++)
+    {
+        if(m_subscribers[x].active == false)
+        {
+            index = x;
+            break;
+        }
+    }
+    if(index == _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX)
+    {
+        pthread_mutex_unlock(&m_controlLock);
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Subscribe - No Free Event Handle!\n");
+        return NPF_E_UNKNOWN;
+    }
+
+    unsigned int ringSize = 1;
+    while(ringSize < queueDepth)
+    {
+        ringSize <<= 1;
+    }
+
+    // The subscriber is not seen by Publish() until it is made active, so
+    // it is set up without the publish lock.
+    subscriber& sub = m_subscribers[index];
+    sub.stopping = false;
+    sub.userContext = userContext;
+    sub.changeFunc = changeFunc;
+    sub.changeMask = changeMask;
+    sub.policy = policy;
+    sub.ring = new NPF_F_ATM_ConfigMgr_ChangeEvent_t[ringSize];
+    sub.mask = ringSize - 1;
+    sub.head = 0;
+    sub.tail = 0;
+    sub.dropped = 0;
+
+    if(pthread_create(&sub.thread, 0, DeliveryThread, &sub) != 0)
+    {
+        delete [] sub.ring;
+        sub.ring = 0;
+        pthread_mutex_unlock(&m_controlLock);
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Subscribe - Thread Creation Failed!\n");
+        return NPF_E_UNKNOWN;
+    }
+
+    FAPIMetrics::Lock(&m_publishLock, NPF_F_ATM_CONFIGMGR_LOCK_CHANGE_PUBLISH);
+    sub.active = true;
+    __atomic_add_fetch(&m_numSubscribers, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&m_publishLock);
+    pthread_mutex_unlock(&m_controlLock);
+
+    *eventHandle = index + 1;
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function Definition: Unsubscribe(NPF_callbackHandle_t eventHandle)
+ */
+NPF_error_t ChangeNotifier::Unsubscribe(NPF_callbackHandle_t eventHandle)
+{
+    APISimTrace(3,"Trace Level 3: ChangeNotifier::Unsubscribe(%d)\n",eventHandle);
+    if((eventHandle == 0)||(eventHandle > _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Unsubscribe - Invalid Event Handle!\n");
+        return NPF_E_BAD_CALLBACK_HANDLE;
+    }
+
+    pthread_mutex_lock(&m_controlLock);
+    subscriber& sub = m_subscribers[eventHandle - 1];
+    if((sub.active == false)||(pthread_equal(sub.thread, pthread_self()) != 0))
+    {
+        pthread_mutex_unlock(&m_controlLock);
+        APISimTrace(1,"Trace Level 1: ChangeNotifier::Unsubscribe - Event Handle Not Subscribed Or Called From Its Change Function!\n");
+        return NPF_E_BAD_CALLBACK_HANDLE;
+    }
+
+    // A publisher waiting for room in the ring gives up on the subscriber
+    // once it is stopping, so the publish lock is free to take below.
+    pthread_mutex_lock(&sub.lock);
+    sub.stopping = true;
+    pthread_cond_broadcast(&sub.dataCond);
+    pthread_cond_broadcast(&sub.spaceCond);
+    pthread_mutex_unlock(&sub.lock);
+    pthread_join(sub.thread, 0);
+
+    FAPIMetrics::Lock(&m_publishLock, NPF_F_ATM_CONFIGMGR_LOCK_CHANGE_PUBLISH);
+    sub.active = false;
+    __atomic_sub_fetch(&m_numSubscribers, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&m_publishLock);
+
+    delete [] sub.ring;
+    sub.ring = 0;
+    pthread_mutex_unlock(&m_controlLock);
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function Definition: Collect(const NPF_F_ATM_ConfigMgr_ChangeEvent_t& event)
+ */
+void ChangeNotifier::Collect(const NPF_F_ATM_ConfigMgr_ChangeEvent_t& event)
+{
+    if(__atomic_load_n(&m_numSubscribers, __ATOMIC_ACQUIRE) == 0)
+    {
+        return;
+    }
+
+    pendingChanges* pending = Pending();
+    if(pending->events.empty() == true)
+    {
+        pending->ticket = __atomic_fetch_add(&m_nextTicket, 1, __ATOMIC_SEQ_CST);
+    }
+    pending->events.push_back(event);
+}
+
+/**
+ * Function Definition: Publish()
+ */
+void ChangeNotifier::Publish()
+{
+    TakeTurn(true);
+}
+
+/**
+ * Function Definition: Discard()
+ */
+void ChangeNotifier::Discard()
+{
+    TakeTurn(false);
+}
+
+/**
+ * Function Definition: TakeTurn(bool publish)
+ */
+void ChangeNotifier::TakeTurn(bool publish)
+{
+    pendingChanges* pending = static_cast<pendingChanges*>(t_pendingChanges);
+    if((pending == 0)||(pending->events.empty() == true))
+    {
+        return;
+    }
+
+    // The ticket has to be used even when nothing is queued, later calls
+    // wait for it.
+    FAPIMetrics::Lock(&m_publishLock, NPF_F_ATM_CONFIGMGR_LOCK_CHANGE_PUBLISH);
+    while(m_turn != pending->ticket)
+    {
+        pthread_cond_wait(&m_turnCond, &m_publishLock);
+    }
+    if(publish == true)
+    {
+        for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX; x++)
+        {
+            if(m_subscribers[x].active == true)
+            {
+                Queue(m_subscribers[x], pending->events);
+            }
+        }
+    }
+    m_turn++;
+    pthread_cond_broadcast(&m_turnCond);
+    pthread_mutex_unlock(&m_publishLock);
+
+    pending->events.clear();
+}
+
+/**
+ * Function Definition: Queue(subscriber& sub,
+ *                            const vector<NPF_F_ATM_ConfigMgr_ChangeEvent_t>& events)
+ */
+void ChangeNotifier::Queue(subscriber& sub, const vector<NPF_F_ATM_ConfigMgr_ChangeEvent_t>& events)
+{
+    bool wake = false;
+    pthread_mutex_lock(&sub.lock);
+    for(unsigned int x = 0; (x < events.size())&&(sub.stopping == false); x++)
+    {
+        if((sub.changeMask & NPF_F_ATM_CONFIGMGR_CHANGE_BIT(events[x].type)) == 0)
+        {
+            continue;
+        }
+
+        while(((sub.tail - sub.head) > sub.mask)&&(sub.policy == NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK)&&
+              (sub.stopping == false))
+        {
+            pthread_cond_signal(&sub.dataCond);
+            pthread_cond_wait(&sub.spaceCond, &sub.lock);
+        }
+
+        if((sub.tail - sub.head) > sub.mask)
+        {
+            sub.dropped++;
+        }else
+        {
+            sub.ring[sub.tail & sub.mask] = events[x];
+            sub.tail++;
+        }
+        wake = true;
+    }
+    if(wake == true)
+    {
+        pthread_cond_signal(&sub.dataCond);
+    }
+    pthread_mutex_unlock(&sub.lock);
+}
+
+/**
+ * Function Definition: DeliveryThread(void* arg)
+ */
+void* ChangeNotifier::DeliveryThread(void* arg)
+{
+    ChangeNotifier& notifier = instance();
+    notifier.Deliver(static_cast<subscriber*>(arg) - notifier.m_subscribers);
+    return 0;
+}
+
+/**
+ * Function Definition: Deliver(unsigned int index)
+ */
+void ChangeNotifier::Deliver(unsigned int index)
+{
+    APISimTrace(3,"Trace Level 3: ChangeNotifier::Deliver(%d)\n",index);
+    subscriber& sub = m_subscribers[index];
+    NPF_F_ATM_ConfigMgr_ChangeEvent_t batch[_IX_CC_ATM_FAPI_CHANGE_BATCH_MAX];
+
+    pthread_mutex_lock(&sub.lock);
+    while(true)
+    {
+        while((sub.head == sub.tail)&&(sub.dropped == 0)&&(sub.stopping == false))
+        {
+            pthread_cond_wait(&sub.dataCond, &sub.lock);
+        }
+        if(sub.stopping == true)
+        {
+            break;
+        }
+
+        // The batch is copied out so the ring has room again while the
+        // client handles it.
+        unsigned int numEvents = sub.tail - sub.head;
+        if(numEvents > _IX_CC_ATM_FAPI_CHANGE_BATCH_MAX)
+        {
+            numEvents = _IX_CC_ATM_FAPI_CHANGE_BATCH_MAX;
+        }
+        for(unsigned int x = 0; x < numEvents; x++)
+        {
+            batch[x] = sub.ring[(sub.head + x) & sub.mask];
+        }
+        sub.head += numEvents;
+        unsigned int numDropped = sub.dropped;
+        sub.dropped = 0;
+        pthread_cond_broadcast(&sub.spaceCond);
+        pthread_mutex_unlock(&sub.lock);
+
+        sub.changeFunc(sub.userContext, index + 1, numDropped, numEvents, batch);
+
+        pthread_mutex_lock(&sub.lock);
+    }
+    pthread_mutex_unlock(&sub.lock);
+}
+
+/**
+ * Function Definition: Pending()
+ */
+ChangeNotifier::pendingChanges* ChangeNotifier::Pending()
+{
+    pendingChanges* pending = static_cast<pendingChanges*>(t_pendingChanges);
+    if(pending == 0)
+    {
+        pending = new pendingChanges;
+        pending->ticket = 0;
+        t_pendingChanges = pending;
+        pthread_setspecific(m_pendingKey, pending);
+    }
+    return pending;
+}
+
+/**
+ * Function Definition: ReleasePending(void* pending)
+ */
+void ChangeNotifier::ReleasePending(void* pending)
+{
+    delete static_cast<pendingChanges*>(pending);
+}
@@ -0,0 +1,274 @@
+/**
+ * @file ChangeNotifier.h
+ *
+ * @date 7 June 2005
+ *
+ * @brief The ChangeNotifier reports the changes made to the TableManager
+ *        tables to subscribed clients.
+ *
+ * The ChangeNotifier is a singleton. The TableManager passes it every
+ * interface, VC and cross connect it adds or removes, and the ChangeNotifier
+ * delivers them to each subscriber in batches, on a thread of the
+ * subscription. A client can keep a copy of the tables up to date from the
+ * changes instead of querying the tables over and over.
+ *
+ * Design Notes:
+ *    Collect() is called while the TableManager holds its table locks and
+ *    only appends the change to a list of the calling thread. Publish() is
+ *    called once the locks are released and copies the list to the queue of
+ *    every subscriber. Publishing is done in the order the changes were
+ *    collected: the first Collect() of a configuration call takes a ticket,
+ *    under the table locks, and Publish() waits for the turn of its ticket.
+ *    Calls that touch the same table entries hold the same write lock, so
+ *    their changes are published in the order they were made.
+ *
+ *    Each subscriber has a bounded ring of changes guarded by its own
+ *    mutex, and a thread that takes up to _IX_CC_ATM_FAPI_CHANGE_BATCH_MAX
+ *    changes at a time off the ring and passes them to the client. When the
+ *    ring is full a change is either dropped and counted or Publish() waits
+ *    for room, as chosen by the subscriber.
+ *
+ *    Nothing is collected while there are no subscribers.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __CHANGENOTIFIER_H_
+#define __CHANGENOTIFIER_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <vector>
+using namespace std;
+
+class ChangeNotifier
+{
+public:
+    virtual ~ChangeNotifier();
+
+    static ChangeNotifier& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Subscribe(NPF_userContext_t userContext,
+    *               NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+    *               NPF_uint32_t changeMask,
+    *               NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+    *               NPF_uint32_t queueDepth,
+    *               NPF_callbackHandle_t* eventHandle)
+    *
+    * @brief Adds a subscriber and starts its delivery thread.
+    *
+    * @param queueDepth NPF_uint32_t [in] - Changes the subscriber may
+    *                                         have queued, rounded up to a
+    *                                         power of two.
+    * @param eventHandle NPF_callbackHandle_t* [out] - Handle of the
+    *                                                    subscriber.
+    *
+    * See NPF_F_ATM_ConfigMgr_ChangeSubscribe() for the other parameters.
+    *
+    * @return NPF_error_t
+    */
+    NPF_error_t Subscribe(NPF_userContext_t userContext, NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+                          NPF_uint32_t changeMask, NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+                          NPF_uint32_t queueDepth, NPF_callbackHandle_t* eventHandle);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Unsubscribe(NPF_callbackHandle_t eventHandle)
+    *
+    * @brief Stops the delivery thread of a subscriber and removes it. Its
+    *        queued changes are discarded.
+    *
+    * @param eventHandle NPF_callbackHandle_t [in] - Handle of the
+    *                                                  subscriber.
+    *
+    * @return NPF_error_t
+    */
+    NPF_error_t Unsubscribe(NPF_callbackHandle_t eventHandle);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Collect(const NPF_F_ATM_ConfigMgr_ChangeEvent_t& event)
+    *
+    * @brief Keeps a change made by the calling thread until Publish().
+    *        Called with the table locks held.
+    *
+    * @param event const NPF_F_ATM_ConfigMgr_ChangeEvent_t& [in] - The
+    *                                                               change.
+    *
+    * @return None
+    */
+    void Collect(const NPF_F_ATM_ConfigMgr_ChangeEvent_t& event);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Publish()
+    *
+    * @brief Queues the changes collected by the calling thread for every
+    *        subscriber. Called once the table locks are released.
+    *
+    * @return None
+    */
+    void Publish();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Discard()
+    *
+    * @brief Forgets the changes collected by the calling thread, for
+    *        changes that were undone before the table locks were released.
+    *
+    * @return None
+    */
+    void Discard();
+
+private:
+    ChangeNotifier();
+    ChangeNotifier(const ChangeNotifier&);
+    ChangeNotifier& operator =(const ChangeNotifier&);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef pendingChanges
+    *
+    * @brief Typedef of the changes collected by one thread. ticket is only
+    *        valid while events is not empty.
+    *
+    */
+    typedef struct
+    {
+        vector<NPF_F_ATM_ConfigMgr_ChangeEvent_t> events;
+        unsigned long long ticket;
+    } pendingChanges;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef subscriber
+    *
+    * @brief Typedef of a subscriber and its ring of queued changes.
+    *
+    * head and tail count the changes taken off and put on the ring, ring
+    * holds mask + 1 changes. dropped counts the changes dropped since the
+    * last batch. lock guards head, tail, dropped and stopping.
+    *
+    */
+    typedef struct
+    {
+        bool active;
+        bool stopping;
+        NPF_userContext_t userContext;
+        NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc;
+        NPF_uint32_t changeMask;
+        NPF_F_ATM_ConfigMgr_ChangePolicy_t policy;
+        NPF_F_ATM_ConfigMgr_ChangeEvent_t* ring;
+        unsigned int mask;
+        unsigned int head;
+        unsigned int tail;
+        unsigned int dropped;
+        pthread_t thread;
+        pthread_mutex_t lock;
+        pthread_cond_t dataCond;
+        pthread_cond_t spaceCond;
+    } subscriber;
+
+    static void* DeliveryThread(void* arg);
+    void Deliver(unsigned int index);
+    void Queue(subscriber& sub, const vector<NPF_F_ATM_ConfigMgr_ChangeEvent_t>& events);
+    void TakeTurn(bool publish);
+    pendingChanges* Pending();
+    static void ReleasePending(void* pending);
+
+    /**
+    * ChangeNotifier Member Variables.
+    *
+    * m_subscribers - Subscribers indexed by event handle minus one.
+    *
+    * m_numSubscribers - Number of active subscribers, read without a lock
+    *                    by Collect().
+    *
+    * m_nextTicket - Ticket of the next configuration call to collect a
+    *                change.
+    *
+    * m_turn - Ticket whose changes are published next.
+    *
+    * m_publishLock - Guards m_turn and the active flag and parameters of
+    *                 every subscriber.
+    *
+    * m_turnCond - Signalled when m_turn moves on.
+    *
+    * m_pendingKey - Frees the pending changes of a thread when it exits.
+    *
+    * m_controlLock - Serialises Subscribe() and Unsubscribe().
+    *
+    */
+    subscriber m_subscribers[_IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX];
+    unsigned int m_numSubscribers;
+    unsigned long long m_nextTicket;
+    unsigned long long m_turn;
+    pthread_mutex_t m_publishLock;
+    pthread_cond_t m_turnCond;
+    pthread_key_t m_pendingKey;
+    pthread_mutex_t m_controlLock;
+};
+#endif // #if !defined __CHANGENOTIFIER_H_
+/**
+ *@}
+ */
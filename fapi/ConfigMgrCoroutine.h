@@ -0,0 +1,639 @@
+/**
+ * @file ConfigMgrCoroutine.h
+ *
+ * @date 23 June 2005
+ *
+ * @brief The ConfigMgrCoroutine lets C++20 coroutines await the completion
+ *        of FAPI calls.
+ *
+ * A ConfigMgrCoroutine registers a callback handle of its own. IfSet(),
+ * IfDelete(), VcSet(), VcLinkXcSet(), VcDelete() and VcLinkXcDelete() take
+ * the arguments of the FAPI call of the same name, less the callback
+ * handle and correlator, and return an Operation. A coroutine that awaits
+ * the Operation makes the call and is resumed once every completion
+ * callback of the call has been delivered, with a Response holding the
+ * NPF_F_ATM_ConfigMgr_CallbackData_t of the call. Coroutines are started
+ * with Spawn() and resumed by the threads that call Run(), so a client can
+ * keep thousands of calls in flight on a few threads.
+ *
+ *    ConfigMgrCoroutine::Task Provision(ConfigMgrCoroutine& coro, ...)
+ *    {
+ *        ConfigMgrCoroutine::Response response = co_await coro.VcSet(n, vcs);
+ *        if(response.AllOK() == false) ...
+ *    }
+ *
+ *    coro.Register();
+ *    coro.Spawn(Provision(coro, ...));
+ *    coro.Run();
+ *
+ * Design Notes:
+ *    The correlator of a call is the address of its Operation, which lives
+ *    in the frame of the awaiting coroutine until the coroutine is resumed.
+ *    A call may be reported in several chunks, or not at all depending on
+ *    errorReporting, so after the call returns the Operation queues a
+ *    fence with NPF_F_ATM_ConfigMgr_CallbackFence(). The fence is delivered
+ *    behind every callback of the call in each callback mode, the chunks
+ *    are gathered into the Response until it arrives. The correlator of the
+ *    fence is that of the call with FENCE_TAG set, an Operation is aligned
+ *    so the bit is clear in its address.
+ *
+ *    The callbacks only gather responses and queue the coroutine to be
+ *    resumed, the coroutine runs on a Run() thread. In dispatch mode a
+ *    coroutine resumed on a dispatcher thread could make a call whose
+ *    callbacks have to wait for that same thread, this way it cannot. In
+ *    sync mode the callbacks fire before the call returns and the
+ *    coroutine is queued before it has suspended, which is allowed as it
+ *    is only resumed by the Run() loop.
+ *
+ *    A single chunk is kept with NPF_F_ATM_ConfigMgr_RespHold() instead of
+ *    being copied, the responses of several chunks are copied into one
+ *    array.
+ *
+ *    The handle must not be deregistered while calls are in flight, their
+ *    fences would be dropped and their coroutines never resumed.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __CONFIGMGRCOROUTINE_H_
+#define __CONFIGMGRCOROUTINE_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <vector>
+
+class ConfigMgrCoroutine
+{
+public:
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @brief Result of an awaited FAPI call.
+    *
+    * Error() is what the call returned. When it is NPF_NO_ERROR, Data() is
+    * the callback data of the call: allOK is NPF_FALSE if any chunk
+    * reported an error and resp holds the responses of every chunk, valid
+    * as long as the Response. A call that is not reported, because
+    * errorReporting did not ask for it, has allOK NPF_TRUE and no
+    * responses.
+    */
+    class Response
+    {
+    public:
+        Response()
+        : m_error(NPF_NO_ERROR), m_held(0)
+        {
+            memset(&m_data, 0, sizeof(m_data));
+            m_data.allOK = NPF_TRUE;
+        }
+
+        Response(Response&& other)
+        : m_error(other.m_error), m_data(other.m_data), m_held(other.m_held),
+          m_copy(static_cast<std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t>&&>(other.m_copy))
+        {
+            other.m_held = 0;
+            other.m_data.n_resp = 0;
+            other.m_data.resp = 0;
+        }
+
+        ~Response()
+        {
+            if(m_held != 0)
+            {
+                NPF_F_ATM_ConfigMgr_RespRelease(m_held);
+            }
+        }
+
+        NPF_error_t Error() const
+        {
+            return m_error;
+        }
+
+        const NPF_F_ATM_ConfigMgr_CallbackData_t& Data() const
+        {
+            return m_data;
+        }
+
+        bool AllOK() const
+        {
+            return ((m_error == NPF_NO_ERROR)&&(m_data.allOK == NPF_TRUE));
+        }
+
+    private:
+        friend class ConfigMgrCoroutine;
+
+        Response(const Response&);
+        Response& operator =(const Response&);
+
+        /**
+         * Adds the responses of one chunk, called by the completion
+         * callback while data.resp is valid.
+         */
+        void Add(const NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+        {
+            m_data.type = data.type;
+            if(data.allOK == NPF_FALSE)
+            {
+                m_data.allOK = NPF_FALSE;
+            }
+            if(data.n_resp == 0)
+            {
+                return;
+            }
+            if((m_held == 0)&&(m_copy.empty() == true))
+            {
+                NPF_F_ATM_ConfigMgr_RespHold(data.resp);
+                m_held = data.resp;
+                m_data.resp = data.resp;
+                m_data.n_resp = data.n_resp;
+                return;
+            }
+            if(m_held != 0)
+            {
+                m_copy.assign(m_held, m_held + m_data.n_resp);
+                NPF_F_ATM_ConfigMgr_RespRelease(m_held);
+                m_held = 0;
+            }
+            m_copy.insert(m_copy.end(), data.resp, data.resp + data.n_resp);
+            m_data.resp = &m_copy[0];
+            m_data.n_resp = (NPF_uint32_t)m_copy.size();
+        }
+
+        /**
+        * Response Member Variables.
+        *
+        * m_error - Returned by the FAPI call.
+        *
+        * m_data - Callback data of the call, resp points to m_held or into
+        *          m_copy.
+        *
+        * m_held - Response buffer of a single chunk, held until the
+        *          Response is destroyed.
+        *
+        * m_copy - Responses of several chunks.
+        *
+        */
+        NPF_error_t m_error;
+        NPF_F_ATM_ConfigMgr_CallbackData_t m_data;
+        NPF_F_ATM_ConfigMgr_AsyncResponse_t* m_held;
+        std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t> m_copy;
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @brief Awaitable FAPI call, returned by IfSet() and the other calls.
+    *        The call is made when the Operation is awaited, the arrays
+    *        passed to it must stay valid until then.
+    */
+    class Operation
+    {
+    public:
+        bool await_ready() const
+        {
+            return false;
+        }
+
+        /**
+         * Makes the call, returns false to resume the coroutine at once
+         * when the call or its fence is rejected.
+         */
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            m_handle = handle;
+            NPF_correlator_t correlator = (NPF_correlator_t)(uintptr_t)this;
+            NPF_error_t error = Issue(correlator);
+            if(error == NPF_NO_ERROR)
+            {
+                // From here on the callbacks may resume the coroutine and
+                // end the life of this object.
+                error = NPF_F_ATM_ConfigMgr_CallbackFence(m_owner->m_cbHandle,
+                                                          (NPF_correlator_t)((uintptr_t)this | FENCE_TAG));
+                if(error == NPF_NO_ERROR)
+                {
+                    return true;
+                }
+            }
+            m_response.m_error = error;
+            return false;
+        }
+
+        Response await_resume()
+        {
+            return static_cast<Response&&>(m_response);
+        }
+
+    private:
+        friend class ConfigMgrCoroutine;
+
+        Operation(ConfigMgrCoroutine* owner, NPF_F_ATM_ConfigMgr_CallbackType_t type,
+                  NPF_errorReporting_t errorReporting, NPF_uint32_t numEntries, void* entries,
+                  NPF_boolean_t delContainedObjs = NPF_FALSE)
+        : m_owner(owner), m_type(type), m_errorReporting(errorReporting), m_numEntries(numEntries),
+          m_entries(entries), m_delContainedObjs(delContainedObjs)
+        {
+            m_response.m_data.type = type;
+        }
+
+        Operation(const Operation&);
+        Operation& operator =(const Operation&);
+
+        NPF_error_t Issue(NPF_correlator_t correlator)
+        {
+            NPF_callbackHandle_t cbHandle = m_owner->m_cbHandle;
+            switch(m_type)
+            {
+                case NPF_F_ATM_CONFIGMGR_IF_SET:
+                    return NPF_F_ATM_ConfigMgr_IfSet(cbHandle, correlator, m_errorReporting, 0, 0, m_numEntries,
+                                                     static_cast<NPF_F_ATM_ConfigMgr_IfCfg_t*>(m_entries));
+                case NPF_F_ATM_CONFIGMGR_IF_DELETE:
+                    return NPF_F_ATM_ConfigMgr_IfDelete(cbHandle, correlator, m_errorReporting, 0, 0,
+                                                        m_delContainedObjs, m_numEntries,
+                                                        static_cast<NPF_F_ATM_IfID_t*>(m_entries));
+                case NPF_F_ATM_CONFIGMGR_VC_SET:
+                    return NPF_F_ATM_ConfigMgr_VcSet(cbHandle, correlator, m_errorReporting, 0, 0, m_numEntries,
+                                                     static_cast<NPF_F_ATM_ConfigMgr_Vc_t*>(m_entries));
+                case NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_SET:
+                    return NPF_F_ATM_ConfigMgr_VcLinkXcSet(cbHandle, correlator, m_errorReporting, 0, 0, m_numEntries,
+                                                           static_cast<NPF_F_ATM_ConfigMgr_VcLinkXc_t*>(m_entries));
+                case NPF_F_ATM_CONFIGMGR_VC_DELETE:
+                    return NPF_F_ATM_ConfigMgr_VcDelete(cbHandle, correlator, m_errorReporting, 0, 0, m_numEntries,
+                                                        static_cast<NPF_F_ATM_VcLinkId_t*>(m_entries));
+                case NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_DELETE:
+                    return NPF_F_ATM_ConfigMgr_VcLinkXcDelete(cbHandle, correlator, m_errorReporting, 0, 0,
+                                                              m_numEntries,
+                                                              static_cast<NPF_F_ATM_VcXcId_t*>(m_entries));
+                default:
+                    return NPF_E_UNKNOWN;
+            }
+        }
+
+        /**
+        * Operation Member Variables.
+        *
+        * m_owner - The ConfigMgrCoroutine whose handle the call is made on.
+        *
+        * m_type, m_errorReporting, m_numEntries, m_entries,
+        * m_delContainedObjs - The call and its arguments.
+        *
+        * m_handle - The awaiting coroutine.
+        *
+        * m_response - Gathered by the completion callbacks.
+        *
+        */
+        ConfigMgrCoroutine* m_owner;
+        NPF_F_ATM_ConfigMgr_CallbackType_t m_type;
+        NPF_errorReporting_t m_errorReporting;
+        NPF_uint32_t m_numEntries;
+        void* m_entries;
+        NPF_boolean_t m_delContainedObjs;
+        std::coroutine_handle<> m_handle;
+        Response m_response;
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @brief Return type of a coroutine started with Spawn(). The coroutine
+    *        starts on a Run() thread, and its frame is freed when it
+    *        finishes.
+    */
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            promise_type() : m_owner(0) {}
+
+            Task get_return_object()
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return std::suspend_always();
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return std::suspend_never();
+            }
+
+            void return_void()
+            {
+                m_owner->TaskDone();
+            }
+
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
+
+            ConfigMgrCoroutine* m_owner;
+        };
+
+        Task(Task&& other)
+        : m_handle(other.m_handle)
+        {
+            other.m_handle = std::coroutine_handle<promise_type>();
+        }
+
+        ~Task()
+        {
+            // Only a task that was never spawned still owns its frame.
+            if(m_handle)
+            {
+                m_handle.destroy();
+            }
+        }
+
+    private:
+        friend class ConfigMgrCoroutine;
+
+        explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+        {
+        }
+
+        Task(const Task&);
+        Task& operator =(const Task&);
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    ConfigMgrCoroutine()
+    : m_cbHandle(0), m_tasks(0)
+    {
+        pthread_mutex_init(&m_lock, 0);
+        pthread_cond_init(&m_readyCond, 0);
+    }
+
+    virtual ~ConfigMgrCoroutine()
+    {
+        Deregister();
+        pthread_mutex_destroy(&m_lock);
+        pthread_cond_destroy(&m_readyCond);
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Register()
+    *
+    * @brief Registers the callback handle the calls are made on.
+    *
+    * @return NPF_error_t - As NPF_F_ATM_ConfigMgr_Register().
+    */
+    NPF_error_t Register()
+    {
+        return NPF_F_ATM_ConfigMgr_Register(this, Completion, &m_cbHandle);
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Deregister()
+    *
+    * @brief Deregisters the callback handle, once Run() has returned.
+    *
+    * @return NPF_error_t - As NPF_F_ATM_ConfigMgr_Deregister().
+    */
+    NPF_error_t Deregister()
+    {
+        if(m_cbHandle == 0)
+        {
+            return NPF_NO_ERROR;
+        }
+        NPF_error_t error = NPF_F_ATM_ConfigMgr_Deregister(m_cbHandle);
+        m_cbHandle = 0;
+        return error;
+    }
+
+    NPF_callbackHandle_t Handle() const
+    {
+        return m_cbHandle;
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Spawn(Task task)
+    *
+    * @brief Queues a coroutine to be started by Run().
+    *
+    * @return None
+    */
+    void Spawn(Task task)
+    {
+        std::coroutine_handle<Task::promise_type> handle = task.m_handle;
+        task.m_handle = std::coroutine_handle<Task::promise_type>();
+        handle.promise().m_owner = this;
+
+        pthread_mutex_lock(&m_lock);
+        m_tasks++;
+        m_ready.push_back(handle);
+        pthread_cond_signal(&m_readyCond);
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Run()
+    *
+    * @brief Resumes coroutines as their calls complete, until every spawned
+    *        coroutine has finished. Several threads may call Run() at once.
+    *
+    * @return None
+    */
+    void Run()
+    {
+        pthread_mutex_lock(&m_lock);
+        for(;;)
+        {
+            while((m_ready.empty() == true)&&(m_tasks != 0))
+            {
+                pthread_cond_wait(&m_readyCond, &m_lock);
+            }
+            if(m_ready.empty() == true)
+            {
+                break;
+            }
+            std::coroutine_handle<> handle = m_ready.front();
+            m_ready.pop_front();
+            pthread_mutex_unlock(&m_lock);
+
+            handle.resume();
+
+            pthread_mutex_lock(&m_lock);
+        }
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    Operation IfSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_IfCfg_t* cfgArray,
+                    NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_IF_SET, errorReporting, numEntries, cfgArray);
+    }
+
+    Operation IfDelete(NPF_boolean_t delContainedObjs, NPF_uint32_t numEntries, NPF_F_ATM_IfID_t* delArray,
+                       NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_IF_DELETE, errorReporting, numEntries, delArray,
+                         delContainedObjs);
+    }
+
+    Operation VcSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_Vc_t* cfgArray,
+                    NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_VC_SET, errorReporting, numEntries, cfgArray);
+    }
+
+    Operation VcLinkXcSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_VcLinkXc_t* cfgArray,
+                          NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_SET, errorReporting, numEntries, cfgArray);
+    }
+
+    Operation VcDelete(NPF_uint32_t numEntries, NPF_F_ATM_VcLinkId_t* delArray,
+                       NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_VC_DELETE, errorReporting, numEntries, delArray);
+    }
+
+    Operation VcLinkXcDelete(NPF_uint32_t numEntries, NPF_F_ATM_VcXcId_t* delArray,
+                             NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        return Operation(this, NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_DELETE, errorReporting, numEntries, delArray);
+    }
+
+private:
+    ConfigMgrCoroutine(const ConfigMgrCoroutine&);
+    ConfigMgrCoroutine& operator =(const ConfigMgrCoroutine&);
+
+    /**
+     * Set in the correlator of the fence queued behind a call, the rest of
+     * the correlator is the address of the Operation of the call.
+     */
+    static const uintptr_t FENCE_TAG = 1;
+    static_assert(alignof(Operation) > FENCE_TAG, "Operation addresses must leave FENCE_TAG clear");
+
+    /**
+     * Completion callback of the handle. The callbacks of one handle are
+     * delivered one at a time, so those of an Operation never overlap.
+     */
+    static void Completion(NPF_userContext_t userContext,
+                           NPF_correlator_t cbCorrelator,
+                           NPF_F_ATM_ConfigMgr_CallbackData_t data)
+    {
+        ConfigMgrCoroutine* owner = static_cast<ConfigMgrCoroutine*>(userContext);
+        uintptr_t tagged = (uintptr_t)cbCorrelator;
+        Operation* operation = (Operation*)(tagged & ~FENCE_TAG);
+        if((tagged & FENCE_TAG) == 0)
+        {
+            operation->m_response.Add(data);
+            return;
+        }
+        owner->Ready(operation->m_handle);
+    }
+
+    void Ready(std::coroutine_handle<> handle)
+    {
+        pthread_mutex_lock(&m_lock);
+        m_ready.push_back(handle);
+        pthread_cond_signal(&m_readyCond);
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    void TaskDone()
+    {
+        pthread_mutex_lock(&m_lock);
+        m_tasks--;
+        if(m_tasks == 0)
+        {
+            pthread_cond_broadcast(&m_readyCond);
+        }
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    /**
+    * ConfigMgrCoroutine Member Variables.
+    *
+    * m_cbHandle - Callback handle the calls are made on, 0 when not
+    *              registered.
+    *
+    * m_ready - Coroutines waiting to be started or resumed by Run().
+    *
+    * m_tasks - Spawned coroutines that have not finished.
+    *
+    * m_lock - Guards m_ready and m_tasks.
+    *
+    * m_readyCond - Signalled when a coroutine is queued or the last one
+    *               finishes.
+    *
+    */
+    NPF_callbackHandle_t m_cbHandle;
+    std::deque<std::coroutine_handle<> > m_ready;
+    unsigned int m_tasks;
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_readyCond;
+};
+#endif // #if !defined __CONFIGMGRCOROUTINE_H_
+/**
+ *@}
+ */
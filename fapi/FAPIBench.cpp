@@ -0,0 +1,524 @@
+/**
+ * @file FAPIBench.cpp
+ *
+ * @date 16 May 2005
+ *
+ * @brief Benchmark of the FAPI simulator configuration paths.
+ *
+ * Drives NPF_F_ATM_ConfigMgr_Register, IfSet, VcSet, VcLinkXcSet, IfDelete
+ * and Deregister from 1..N client threads, with the callbacks delivered on
+ * the calling thread (sync) or by the CallBackDispatcher (async). Every
+ * client thread repeatedly builds an interface with a batch of VCs and
+ * cross connects and deletes it again with delContainedObjs set.
+ *
+ * The results are written as JSON: calls per second, per call latency
+ * percentiles and heap allocations per call for every entry point.
+ *
+ * Usage: fapi_bench [--threads N] [--rounds R] [--batch B1,B2,..]
+ *                   [--mode sync|async|both] [--output FILE] [--metrics]
+ *
+ * With --metrics the simulator's own call, error, latency and lock
+ * counters for the whole run are written to stderr at the end.
+ *
+ * Simulator trace goes to stdout, run with stdout redirected when the
+ * JSON is written to stdout as well.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "CallBackHandler.h"
+#include "FAPIDefs.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+ * Allocation counting. Every operator new is counted globally, and per
+ * thread so allocations can be charged to the entry point that made them.
+ */
+static unsigned long long g_allocations = 0;
+static __thread unsigned long long t_allocations = 0;
+
+static void* CountedAlloc(size_t size)
+{
+    __atomic_add_fetch(&g_allocations, 1, __ATOMIC_RELAXED);
+    t_allocations++;
+    void* memory = malloc(size ? size : 1);
+    if(memory == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return malloc(size ? size : 1); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return malloc(size ? size : 1); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+
+/*
+ * Entry points measured, in the order a client round calls them.
+ */
+enum
+{
+    OP_REGISTER,
+    OP_IF_SET,
+    OP_VC_SET,
+    OP_XC_SET,
+    OP_IF_DELETE,
+    OP_DEREGISTER,
+    OP_COUNT
+};
+
+static const char* g_opNames[OP_COUNT] =
+{
+    "Register", "IfSet", "VcSet", "VcLinkXcSet", "IfDelete", "Deregister"
+};
+
+/*
+ * Run parameters and per thread results.
+ */
+typedef struct
+{
+    bool async;
+    unsigned int threads;
+    unsigned int batch;
+    unsigned int rounds;
+} BenchConfig;
+
+typedef struct
+{
+    unsigned int threadIndex;
+    const BenchConfig* config;
+    std::vector<unsigned long long> latency[OP_COUNT];
+    unsigned long long entries[OP_COUNT];
+    unsigned long long allocations[OP_COUNT];
+    unsigned int failures;
+} BenchThread;
+
+static unsigned long long g_callbacks = 0;
+static unsigned int g_startFlag = 0;
+static unsigned int g_readyThreads = 0;
+
+static unsigned long long NowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void BenchCallback(NPF_userContext_t,
+                          NPF_correlator_t,
+                          NPF_F_ATM_ConfigMgr_CallbackData_t)
+{
+    __atomic_add_fetch(&g_callbacks, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Times one call and charges its latency and allocations to an entry point.
+ */
+#define BENCH_CALL(thread, op, numEntries, call)                           \
+    do                                                                     \
+    {                                                                      \
+        unsigned long long allocBefore = t_allocations;                    \
+        unsigned long long start = NowNs();                                \
+        NPF_error_t benchError = (call);                                   \
+        unsigned long long stop = NowNs();                                 \
+        (thread)->latency[op].push_back(stop - start);                     \
+        (thread)->entries[op] += (numEntries);                             \
+        (thread)->allocations[op] += t_allocations - allocBefore;          \
+        if(benchError != NPF_NO_ERROR)                                     \
+        {                                                                  \
+            (thread)->failures++;                                          \
+        }                                                                  \
+    }while(0)
+
+static void* BenchClient(void* arg)
+{
+    BenchThread* thread = static_cast<BenchThread*>(arg);
+    const BenchConfig& config = *thread->config;
+    unsigned int batch = config.batch;
+    unsigned int numXCs = batch / 2;
+    NPF_F_ATM_IfID_t ifId = thread->threadIndex + 1;
+    // Every client owns a disjoint range of VC link and cross connect IDs.
+    unsigned int linkBase = thread->threadIndex * batch;
+
+    // All inputs are built before timing starts.
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifCfg;
+    memset(&ifCfg, 0, sizeof(ifCfg));
+    ifCfg.ifID = ifId;
+    ifCfg.ifType = NPF_F_ATM_IF_UNI;
+
+    std::vector<NPF_F_ATM_ConfigMgr_Vc_t> vcs(batch);
+    for(unsigned int x = 0; x < batch; x++)
+    {
+        memset(&vcs[x], 0, sizeof(vcs[x]));
+        vcs[x].vcLinkId = linkBase + x;
+        vcs[x].ifId = ifId;
+        vcs[x].vc.vpi = x >> 16;
+        vcs[x].vc.vci = x & 0xFFFF;
+        vcs[x].numLink_B = 0;
+        vcs[x].link_B = 0;
+    }
+
+    std::vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t> linkB(numXCs ? numXCs : 1);
+    std::vector<NPF_F_ATM_ConfigMgr_VcLinkXc_t> xcs(numXCs ? numXCs : 1);
+    for(unsigned int x = 0; x < numXCs; x++)
+    {
+        memset(&linkB[x], 0, sizeof(linkB[x]));
+        linkB[x].vcXcId = linkBase + (2 * x);
+        linkB[x].xcType = NPF_F_ATM_EXT_TO_EXT;
+        linkB[x].u.mapVcLink = linkBase + (2 * x) + 1;
+
+        memset(&xcs[x], 0, sizeof(xcs[x]));
+        xcs[x].link_A = linkBase + (2 * x);
+        xcs[x].numLink_B = 1;
+        xcs[x].link_B = &linkB[x];
+    }
+
+    for(unsigned int op = 0; op < OP_COUNT; op++)
+    {
+        thread->latency[op].reserve(config.rounds);
+    }
+
+    __atomic_add_fetch(&g_readyThreads, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&g_startFlag, __ATOMIC_ACQUIRE) == 0)
+    {
+        sched_yield();
+    }
+
+    for(unsigned int round = 0; round < config.rounds; round++)
+    {
+        NPF_callbackHandle_t cbHandle = 0;
+        NPF_userContext_t context = (NPF_userContext_t)(unsigned long)(thread->threadIndex + 1);
+        NPF_correlator_t correlator = (NPF_correlator_t)(uintptr_t)round;
+
+        BENCH_CALL(thread, OP_REGISTER, 1,
+                   NPF_F_ATM_ConfigMgr_Register(context, BenchCallback, &cbHandle));
+        BENCH_CALL(thread, OP_IF_SET, 1,
+                   NPF_F_ATM_ConfigMgr_IfSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0, 1, &ifCfg));
+        BENCH_CALL(thread, OP_VC_SET, batch,
+                   NPF_F_ATM_ConfigMgr_VcSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0, batch, &vcs[0]));
+        if(numXCs != 0)
+        {
+            BENCH_CALL(thread, OP_XC_SET, numXCs,
+                       NPF_F_ATM_ConfigMgr_VcLinkXcSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0, numXCs, &xcs[0]));
+        }
+        BENCH_CALL(thread, OP_IF_DELETE, 1,
+                   NPF_F_ATM_ConfigMgr_IfDelete(cbHandle, correlator, NPF_REPORT_ALL, 0, 0, NPF_TRUE, 1, &ifId));
+        BENCH_CALL(thread, OP_DEREGISTER, 1,
+                   NPF_F_ATM_ConfigMgr_Deregister(cbHandle));
+    }
+    return 0;
+}
+
+static unsigned long long Percentile(const std::vector<unsigned long long>& sorted, double fraction)
+{
+    if(sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+/*
+ * Runs one configuration and appends its JSON object to 'json'.
+ */
+static bool RunBench(const BenchConfig& config, std::string& json)
+{
+    if(config.async == true)
+    {
+        if(CallBackHandler::instance().setCallbackModeDispatch() == false)
+        {
+            fprintf(stderr, "fapi_bench: dispatcher could not be started\n");
+            return false;
+        }
+    }else
+    {
+        CallBackHandler::instance().setCallbackModeSync();
+    }
+
+    std::vector<BenchThread> threads(config.threads);
+    std::vector<pthread_t> ids(config.threads);
+    __atomic_store_n(&g_startFlag, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&g_readyThreads, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&g_callbacks, 0, __ATOMIC_SEQ_CST);
+
+    for(unsigned int x = 0; x < config.threads; x++)
+    {
+        threads[x].threadIndex = x;
+        threads[x].config = &config;
+        threads[x].failures = 0;
+        for(unsigned int op = 0; op < OP_COUNT; op++)
+        {
+            threads[x].entries[op] = 0;
+            threads[x].allocations[op] = 0;
+        }
+        pthread_create(&ids[x], 0, BenchClient, &threads[x]);
+    }
+    while(__atomic_load_n(&g_readyThreads, __ATOMIC_SEQ_CST) != config.threads)
+    {
+        sched_yield();
+    }
+
+    unsigned long long allocBefore = __atomic_load_n(&g_allocations, __ATOMIC_RELAXED);
+    unsigned long long start = NowNs();
+    __atomic_store_n(&g_startFlag, 1, __ATOMIC_RELEASE);
+
+    for(unsigned int x = 0; x < config.threads; x++)
+    {
+        pthread_join(ids[x], 0);
+    }
+
+    // Async runs finish when the dispatcher has delivered every callback,
+    // switching back to sync mode drains it.
+    CallBackHandler::instance().setCallbackModeSync();
+    unsigned long long wallNs = NowNs() - start;
+    unsigned long long allocTotal = __atomic_load_n(&g_allocations, __ATOMIC_RELAXED) - allocBefore;
+
+    unsigned long long totalCalls = 0;
+    unsigned long long totalEntries = 0;
+    unsigned int failures = 0;
+    char buffer[512];
+    std::string ops;
+
+    for(unsigned int op = 0; op < OP_COUNT; op++)
+    {
+        std::vector<unsigned long long> samples;
+        unsigned long long entries = 0;
+        unsigned long long allocations = 0;
+        for(unsigned int x = 0; x < config.threads; x++)
+        {
+            samples.insert(samples.end(), threads[x].latency[op].begin(), threads[x].latency[op].end());
+            entries += threads[x].entries[op];
+            allocations += threads[x].allocations[op];
+        }
+        if(samples.empty())
+        {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        unsigned long long sum = 0;
+        for(size_t x = 0; x < samples.size(); x++)
+        {
+            sum += samples[x];
+        }
+        totalCalls += samples.size();
+        totalEntries += entries;
+
+        snprintf(buffer, sizeof(buffer),
+                 "%s\"%s\":{\"calls\":%zu,\"entries\":%llu,\"calls_per_sec\":%.1f,"
+                 "\"latency_ns\":{\"mean\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,"
+                 "\"p999\":%llu,\"max\":%llu},\"allocs_per_call\":%.3f}",
+                 ops.empty() ? "" : ",", g_opNames[op], samples.size(), entries,
+                 samples.size() * 1e9 / wallNs, sum / samples.size(),
+                 Percentile(samples, 0.50), Percentile(samples, 0.90),
+                 Percentile(samples, 0.99), Percentile(samples, 0.999),
+                 samples.back(), (double)allocations / samples.size());
+        ops += buffer;
+    }
+    for(unsigned int x = 0; x < config.threads; x++)
+    {
+        failures += threads[x].failures;
+    }
+
+    snprintf(buffer, sizeof(buffer),
+             "%s{\"mode\":\"%s\",\"threads\":%u,\"batch\":%u,\"rounds\":%u,"
+             "\"wall_ns\":%llu,\"calls_per_sec\":%.1f,\"entries_per_sec\":%.1f,"
+             "\"allocs_per_call\":%.3f,\"callbacks\":%llu,\"failed_calls\":%u,\"ops\":{",
+             json.empty() ? "" : ",\n    ", config.async ? "async" : "sync",
+             config.threads, config.batch, config.rounds, wallNs,
+             totalCalls * 1e9 / wallNs, totalEntries * 1e9 / wallNs,
+             totalCalls ? (double)allocTotal / totalCalls : 0.0,
+             __atomic_load_n(&g_callbacks, __ATOMIC_RELAXED), failures);
+    json += buffer;
+    json += ops;
+    json += "}}";
+    return true;
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+            "usage: fapi_bench [--threads N] [--rounds R] [--batch B1,B2,..]\n"
+            "                  [--mode sync|async|both] [--output FILE] [--metrics]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int maxThreads = 4;
+    unsigned int rounds = 100;
+    bool runSync = true;
+    bool runAsync = true;
+    const char* output = "-";
+    bool metrics = false;
+    std::vector<unsigned int> batches;
+
+    for(int x = 1; x < argc; x++)
+    {
+        if((strcmp(argv[x], "--threads") == 0)&&(x + 1 < argc))
+        {
+            maxThreads = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--rounds") == 0)&&(x + 1 < argc))
+        {
+            rounds = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--batch") == 0)&&(x + 1 < argc))
+        {
+            char* list = argv[++x];
+            while(*list != '\0')
+            {
+                batches.push_back((unsigned int)strtoul(list, &list, 0));
+                if(*list == ',')
+                {
+                    list++;
+                }else if(*list != '\0')
+                {
+                    Usage();
+                    return 1;
+                }
+            }
+        }else if((strcmp(argv[x], "--mode") == 0)&&(x + 1 < argc))
+        {
+            x++;
+            runSync = (strcmp(argv[x], "async") != 0);
+            runAsync = (strcmp(argv[x], "sync") != 0);
+        }else if((strcmp(argv[x], "--output") == 0)&&(x + 1 < argc))
+        {
+            output = argv[++x];
+        }else if(strcmp(argv[x], "--metrics") == 0)
+        {
+            metrics = true;
+        }else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    // Interface IDs are 1..N and must stay below the interface maximum.
+    if((maxThreads == 0)||(maxThreads >= _IX_CC_ATM_FAPI_IFACE_MAX)||
+       (maxThreads > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(rounds == 0))
+    {
+        fprintf(stderr, "fapi_bench: --threads must be 1..%d and --rounds non zero\n",
+                (_IX_CC_ATM_FAPI_IFACE_MAX - 1) < _ATM_FAPI_SIM_CB_HANDLE_MAX ?
+                (_IX_CC_ATM_FAPI_IFACE_MAX - 1) : _ATM_FAPI_SIM_CB_HANDLE_MAX);
+        return 1;
+    }
+    if(batches.empty())
+    {
+        batches.push_back(1);
+        batches.push_back(64);
+        batches.push_back(_IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX);
+        batches.push_back(_IX_CC_ATM_FAPI_VC_LINK_MAX);
+    }
+
+    std::string json;
+    for(int mode = 0; mode < 2; mode++)
+    {
+        if(((mode == 0)&&(runSync == false))||((mode == 1)&&(runAsync == false)))
+        {
+            continue;
+        }
+        for(unsigned int threads = 1; threads <= maxThreads; threads++)
+        {
+            for(size_t b = 0; b < batches.size(); b++)
+            {
+                // All clients share the VC table, so a batch is capped at
+                // the per client share of _IX_CC_ATM_FAPI_VC_LINK_MAX.
+                unsigned int batch = batches[b];
+                if(batch > (_IX_CC_ATM_FAPI_VC_LINK_MAX / threads))
+                {
+                    batch = _IX_CC_ATM_FAPI_VC_LINK_MAX / threads;
+                }
+                if(batch == 0)
+                {
+                    continue;
+                }
+
+                BenchConfig config;
+                config.async = (mode == 1);
+                config.threads = threads;
+                config.batch = batch;
+                config.rounds = rounds;
+                if(RunBench(config, json) == false)
+                {
+                    return 1;
+                }
+            }
+        }
+    }
+
+    FILE* file = (strcmp(output, "-") == 0) ? stdout : fopen(output, "w");
+    if(file == 0)
+    {
+        fprintf(stderr, "fapi_bench: cannot open %s\n", output);
+        return 1;
+    }
+    fprintf(file, "{\"benchmark\":\"fapi_sim\",\"vc_link_max\":%d,\"resp_buf_max\":%d,\"table_shards\":%d,\n"
+                  "  \"results\":[\n    %s\n  ]}\n",
+            _IX_CC_ATM_FAPI_VC_LINK_MAX, _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX, _IX_CC_ATM_FAPI_TABLE_SHARDS, json.c_str());
+    if(file != stdout)
+    {
+        fclose(file);
+    }
+    if(metrics == true)
+    {
+        NPF_F_ATM_ConfigMgr_MetricsDump(stderr);
+    }
+    return 0;
+}
@@ -0,0 +1,368 @@
+/**
+ * @file FAPICoro.cpp
+ *
+ * @date 23 June 2005
+ *
+ * @brief Provisions VCs and cross connects from many coroutines at once
+ *        through the ConfigMgrCoroutine.
+ *
+ * Every task is a coroutine that sets up its own VCs, joins them in a cross
+ * connect, checks that the root cannot be deleted while it has legs, and
+ * tears everything down again, checking the Response of each call. The
+ * tasks share a few interfaces and one callback handle, and are resumed by
+ * --runners threads, so every call of every task is in flight at the same
+ * time. --chunk splits the responses of a call into several callbacks.
+ *
+ * Usage: fapi_coro [--tasks N] [--vcs V] [--chunk C] [--mode sync|async]
+ *                  [--runners R]
+ *
+ * The run fails if any Response is not the one expected or if the tables
+ * are not empty at the end.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "ConfigMgrCoroutine.h"
+#include "CallBackHandler.h"
+#include "FAPIDefs.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+enum
+{
+    CORO_IFACES = 8,
+    CORO_RUNNERS_MAX = 16
+};
+
+/*
+ * The VCs, cross connect and counters of one task.
+ */
+struct CoroTask
+{
+    unsigned int index;
+    std::vector<NPF_F_ATM_ConfigMgr_Vc_t> vcs;
+    std::vector<NPF_F_ATM_VcLinkId_t> vcIds;
+    std::vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t> legs;
+    std::vector<NPF_F_ATM_VcXcId_t> xcIds;
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xc;
+    unsigned int calls;
+    unsigned int failures;
+};
+
+static unsigned long long NowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*
+ * Counts a call and reports it if its Response is not the one expected:
+ * accepted, allOK as given and, unless numResp is ~0U, that many responses.
+ */
+static void Expect(CoroTask& task, const char* call, const ConfigMgrCoroutine::Response& response,
+                   bool allOK, NPF_uint32_t numResp)
+{
+    task.calls++;
+    const NPF_F_ATM_ConfigMgr_CallbackData_t& data = response.Data();
+    if((response.Error() == NPF_NO_ERROR)&&(response.AllOK() == allOK)&&
+       ((numResp == ~0U)||(data.n_resp == numResp)))
+    {
+        return;
+    }
+    if(task.failures++ == 0)
+    {
+        fprintf(stderr, "fapi_coro: task %u %s returned %u, allOK %u, %u responses\n", task.index, call,
+                (unsigned int)response.Error(), (unsigned int)data.allOK, (unsigned int)data.n_resp);
+    }
+}
+
+static void InitTask(CoroTask& task, unsigned int index, unsigned int numVCs)
+{
+    task.index = index;
+    task.calls = 0;
+    task.failures = 0;
+    task.vcs.resize(numVCs);
+    task.vcIds.resize(numVCs);
+    for(unsigned int v = 0; v < numVCs; v++)
+    {
+        // Each interface holds the VCs of every CORO_IFACES-th task, from
+        // VCI 32 of VPI 0.
+        unsigned int address = (index / CORO_IFACES) * numVCs + v;
+        NPF_F_ATM_ConfigMgr_Vc_t& vc = task.vcs[v];
+        memset(&vc, 0, sizeof(vc));
+        vc.vcLinkId = 1 + index * numVCs + v;
+        vc.ifId = 1 + index % CORO_IFACES;
+        vc.vc.vpi = address / (0x10000 - 32);
+        vc.vc.vci = 32 + (address % (0x10000 - 32));
+        vc.numLink_B = 0;
+        vc.link_B = 0;
+        task.vcIds[v] = vc.vcLinkId;
+    }
+
+    // The first VC is the root, every other one a leaf. The vcXcId of a
+    // leg is the VC link ID of its leaf.
+    task.legs.resize(numVCs - 1);
+    task.xcIds.resize(numVCs - 1);
+    for(unsigned int v = 1; v < numVCs; v++)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t& leg = task.legs[v - 1];
+        memset(&leg, 0, sizeof(leg));
+        leg.vcXcId = task.vcIds[v];
+        leg.xcType = NPF_F_ATM_EXT_TO_EXT;
+        leg.u.mapVcLink = task.vcIds[v];
+        task.xcIds[v - 1] = leg.vcXcId;
+    }
+    memset(&task.xc, 0, sizeof(task.xc));
+    task.xc.link_A = task.vcIds[0];
+    task.xc.numLink_B = numVCs - 1;
+    task.xc.link_B = &task.legs[0];
+}
+
+static ConfigMgrCoroutine::Task IfUp(ConfigMgrCoroutine& coro, CoroTask& task)
+{
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[CORO_IFACES];
+    memset(ifs, 0, sizeof(ifs));
+    for(unsigned int i = 0; i < CORO_IFACES; i++)
+    {
+        ifs[i].ifID = 1 + i;
+        ifs[i].ifType = NPF_F_ATM_IF_UNI;
+    }
+    ConfigMgrCoroutine::Response response = co_await coro.IfSet(CORO_IFACES, ifs);
+    Expect(task, "IfSet", response, true, CORO_IFACES);
+}
+
+static ConfigMgrCoroutine::Task IfDown(ConfigMgrCoroutine& coro, CoroTask& task)
+{
+    NPF_F_ATM_IfID_t ifIds[CORO_IFACES];
+    for(unsigned int i = 0; i < CORO_IFACES; i++)
+    {
+        ifIds[i] = 1 + i;
+    }
+    ConfigMgrCoroutine::Response response = co_await coro.IfDelete(NPF_TRUE, CORO_IFACES, ifIds);
+    Expect(task, "IfDelete", response, true, CORO_IFACES);
+}
+
+static ConfigMgrCoroutine::Task Provision(ConfigMgrCoroutine& coro, CoroTask& task)
+{
+    NPF_uint32_t numVCs = (NPF_uint32_t)task.vcs.size();
+
+    ConfigMgrCoroutine::Response added = co_await coro.VcSet(numVCs, &task.vcs[0]);
+    Expect(task, "VcSet", added, true, ~0U);
+
+    ConfigMgrCoroutine::Response connected = co_await coro.VcLinkXcSet(1, &task.xc);
+    Expect(task, "VcLinkXcSet", connected, true, ~0U);
+
+    // The root has legs, the delete must be refused.
+    ConfigMgrCoroutine::Response refused = co_await coro.VcDelete(1, &task.vcIds[0]);
+    Expect(task, "VcDelete root", refused, false, 1);
+    if((refused.Data().n_resp == 1)&&(refused.Data().resp[0].error != NPF_ATM_F_E_CONT_OBJS_EXIST))
+    {
+        task.failures++;
+    }
+
+    // Nothing is reported when every leg is deleted.
+    ConfigMgrCoroutine::Response disconnected =
+        co_await coro.VcLinkXcDelete(numVCs - 1, &task.xcIds[0], NPF_REPORT_ERRORS);
+    Expect(task, "VcLinkXcDelete", disconnected, true, 0);
+
+    ConfigMgrCoroutine::Response deleted = co_await coro.VcDelete(numVCs, &task.vcIds[0]);
+    Expect(task, "VcDelete", deleted, true, ~0U);
+}
+
+static void* Runner(void* arg)
+{
+    static_cast<ConfigMgrCoroutine*>(arg)->Run();
+    return 0;
+}
+
+/*
+ * Starts the spawned tasks on 'runners' threads and waits for them.
+ */
+static void RunAll(ConfigMgrCoroutine& coro, unsigned int runners)
+{
+    pthread_t threads[CORO_RUNNERS_MAX];
+    unsigned int started = 0;
+    while((started + 1 < runners)&&(pthread_create(&threads[started], 0, Runner, &coro) == 0))
+    {
+        started++;
+    }
+    coro.Run();
+    for(unsigned int x = 0; x < started; x++)
+    {
+        pthread_join(threads[x], 0);
+    }
+}
+
+static bool TablesEmpty()
+{
+    static const NPF_F_ATM_ConfigMgr_MemSite_t tables[] =
+    {
+        NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE, NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE, NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE
+    };
+    for(unsigned int x = 0; x < sizeof(tables) / sizeof(tables[0]); x++)
+    {
+        NPF_F_ATM_ConfigMgr_MemInfo_t info;
+        if((NPF_F_ATM_ConfigMgr_MemoryGet(tables[x], &info) != NPF_NO_ERROR)||(info.objects != 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+            "usage: fapi_coro [--tasks N] [--vcs V] [--chunk C] [--mode sync|async]\n"
+            "                 [--runners R]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int numTasks = 1000;
+    unsigned int numVCs = 4;
+    unsigned int chunk = 0;
+    unsigned int runners = 1;
+    bool async = false;
+
+    for(int x = 1; x < argc; x++)
+    {
+        if((strcmp(argv[x], "--tasks") == 0)&&(x + 1 < argc))
+        {
+            numTasks = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--vcs") == 0)&&(x + 1 < argc))
+        {
+            numVCs = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--chunk") == 0)&&(x + 1 < argc))
+        {
+            chunk = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--mode") == 0)&&(x + 1 < argc))
+        {
+            async = (strcmp(argv[++x], "async") == 0);
+        }else if((strcmp(argv[x], "--runners") == 0)&&(x + 1 < argc))
+        {
+            runners = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else
+        {
+            Usage();
+            return 1;
+        }
+    }
+    if((numTasks == 0)||(numVCs < 2)||(numVCs > _IX_CC_ATM_FAPI_XC_LEGS_MAX + 1)||
+       ((unsigned long long)numTasks * numVCs > _IX_CC_ATM_FAPI_VC_LINK_MAX)||
+       (runners == 0)||(runners > CORO_RUNNERS_MAX))
+    {
+        fprintf(stderr, "fapi_coro: --vcs must be 2..%d, --tasks times --vcs at most %d "
+                        "and --runners 1..%d\n", _IX_CC_ATM_FAPI_XC_LEGS_MAX + 1,
+                _IX_CC_ATM_FAPI_VC_LINK_MAX, CORO_RUNNERS_MAX);
+        return 1;
+    }
+
+    if(async == true)
+    {
+        if(CallBackHandler::instance().setCallbackModeDispatch() == false)
+        {
+            fprintf(stderr, "fapi_coro: dispatcher could not be started\n");
+            return 1;
+        }
+    }else
+    {
+        CallBackHandler::instance().setCallbackModeSync();
+    }
+    if(chunk != 0)
+    {
+        CallBackHandler::instance().setResponseChunkSize(chunk);
+    }
+
+    ConfigMgrCoroutine coro;
+    if(coro.Register() != NPF_NO_ERROR)
+    {
+        fprintf(stderr, "fapi_coro: callback handle could not be registered\n");
+        return 1;
+    }
+
+    std::vector<CoroTask> tasks(numTasks + 1);
+    for(unsigned int t = 0; t < numTasks; t++)
+    {
+        InitTask(tasks[t], t, numVCs);
+    }
+    CoroTask& setup = tasks[numTasks];
+    setup.index = numTasks;
+    setup.calls = 0;
+    setup.failures = 0;
+
+    unsigned long long start = NowNs();
+    coro.Spawn(IfUp(coro, setup));
+    RunAll(coro, runners);
+    for(unsigned int t = 0; t < numTasks; t++)
+    {
+        coro.Spawn(Provision(coro, tasks[t]));
+    }
+    RunAll(coro, runners);
+    coro.Spawn(IfDown(coro, setup));
+    RunAll(coro, runners);
+    unsigned long long wallNs = NowNs() - start;
+
+    // Switching back to sync mode drains the dispatcher.
+    CallBackHandler::instance().setCallbackModeSync();
+    coro.Deregister();
+
+    unsigned long long calls = 0;
+    unsigned int failed = 0;
+    for(unsigned int t = 0; t <= numTasks; t++)
+    {
+        calls += tasks[t].calls;
+        failed += (tasks[t].failures != 0) ? 1 : 0;
+    }
+    bool empty = TablesEmpty();
+    fprintf(stderr, "fapi_coro: %u tasks, %llu calls in %.3f ms, %u tasks failed, tables %s\n",
+            numTasks, calls, wallNs / 1e6, failed, (empty == true) ? "empty" : "not empty");
+    return ((failed == 0)&&(empty == true)) ? 0 : 1;
+}
@@ -54,24 +54,123 @@ extern "C" {
 /* Maximum number of VCs
    TBD: shoud be derived from values from dl_system_config.h? */
 #define _IX_CC_ATM_FAPI_VC_LINK_MAX 8192
+/* Number of bits in the (ifId, vpi, vci) VC address index hash.
+   The index holds twice _IX_CC_ATM_FAPI_VC_LINK_MAX slots. */
+#define _IX_CC_ATM_FAPI_VC_ADDR_INDEX_BITS 14
+/* Number of slots in the VC address index */
+#define _IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE (1 << _IX_CC_ATM_FAPI_VC_ADDR_INDEX_BITS)
 /* Maximum number of VPs
    TBD: shoud be derived from values from dl_system_config.h? */
 #define _IX_CC_ATM_FAPI_VP_LINK_MAX 512
 /* Number of ATM SAR CC VC handles */
 #define _IX_CC_ATM_FAPI_VC_HANDLE_MAX (64*1024)
+/* Maximum number of VC cross connects. Each leg of a point to multipoint
+   cross connect is one cross connect and uses up its own leaf VC link. */
+#define _IX_CC_ATM_FAPI_XC_MAX _IX_CC_ATM_FAPI_VC_LINK_MAX
+/* Maximum number of legs (link B VCs) of a point to multipoint cross connect */
+#define _IX_CC_ATM_FAPI_XC_LEGS_MAX 32
+/* Number of link B arrays of one size the LinkBPool allocates at a time */
+#define _IX_CC_ATM_FAPI_LINKB_POOL_GROW 64
+/* Link ID used to terminate the per-interface VC lists */
+#define _IX_CC_ATM_FAPI_NULL_LINK_ID 0xFFFFFFFF
+/* Cursor value the TableManager query functions return once a query is done */
+#define _IX_CC_ATM_FAPI_QUERY_END 0xFFFFFFFF
 /* Number of supported priority queues in AAL2 SSSAR */
 #define _IX_CC_ATM_FAPI_SSSAR_PRIO_NUM 4
 /* Maximum number of AAL2 Channels */
 #define _IX_CC_ATM_FAPI_CHANNEL_MAX (8*1024)
 
-/* Size of the call context free list */
+/* Initial size of the call context free list, it grows on demand */
 #define _IX_CC_ATM_FAPI_CALL_FL_SIZE 10
 /* Size of the multicall context free list */
 #define _IX_CC_ATM_FAPI_MULTICALL_FL_SIZE 10
-/* Size of the multicall context free list */
+/* Initial size of the response buffer free list, it grows on demand */
 #define _IX_CC_ATM_FAPI_RESP_FL_SIZE 10
 
-
+/* Default number of callback dispatcher threads */
+#define _IX_CC_ATM_FAPI_DISPATCH_THREADS 4
+/* Maximum number of callback dispatcher threads */
+#define _IX_CC_ATM_FAPI_DISPATCH_THREADS_MAX 16
+/* Default number of callbacks each callback handle may have queued
+   for the dispatcher threads */
+#define _IX_CC_ATM_FAPI_DISPATCH_QUEUE_DEPTH 64
+/* Maximum dispatcher queue depth per callback handle */
+#define _IX_CC_ATM_FAPI_DISPATCH_QUEUE_DEPTH_MAX 4096
+/* Default number of responses passed to one callback invocation, larger
+   batches are reported in several invocations. 0 reports every batch in
+   a single invocation. */
+#define _IX_CC_ATM_FAPI_RESP_CHUNK_SIZE _IX_CC_ATM_FAPI_ASYNC_RESP_BUF_MAX
+
+/* Number of worker threads that check large batches alongside the caller */
+#define _IX_CC_ATM_FAPI_VALIDATE_THREADS 3
+/* Batches of at least this many entries are checked in parallel */
+#define _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN 1024
+/* Number of entries a thread checks at a time */
+#define _IX_CC_ATM_FAPI_VALIDATE_CHUNK 256
+
+
+
+/* Cache line size used to align the flat table storage */
+#define _IX_CC_ATM_FAPI_CACHE_LINE 64
+
+/* Number of records in each thread's trace ring, must be a power of two */
+#define _IX_CC_ATM_FAPI_TRACE_RING_SIZE 512
+/* Maximum number of threads tracing at the same time */
+#define _IX_CC_ATM_FAPI_TRACE_THREADS_MAX 64
+/* Maximum number of arguments kept for one trace record */
+#define _IX_CC_ATM_FAPI_TRACE_ARGS_MAX 8
+/* Bytes of string arguments kept for one trace record */
+#define _IX_CC_ATM_FAPI_TRACE_TEXT_MAX 64
+/* Interval at which the trace drain thread writes out the rings */
+#define _IX_CC_ATM_FAPI_TRACE_DRAIN_MS 10
+
+/* Maximum number of threads keeping metrics at the same time */
+#define _IX_CC_ATM_FAPI_METRICS_THREADS_MAX 64
+/* Sub buckets of each power of two of nanoseconds in the latency
+   histograms, as a number of bits */
+#define _IX_CC_ATM_FAPI_METRICS_SUB_BITS 4
+/* Latencies of 2 to the power of this many nanoseconds (about 18 minutes)
+   or more are counted in the last bucket of the latency histograms */
+#define _IX_CC_ATM_FAPI_METRICS_RANGE_BITS 40
+
+/* Identifies a TableManager snapshot file, see TableSnapshot.h */
+#define _IX_CC_ATM_FAPI_SNAPSHOT_MAGIC "FAPISNAP"
+/* Snapshot layout version, raised whenever TableSnapshot.h changes */
+#define _IX_CC_ATM_FAPI_SNAPSHOT_VERSION 2
+/* Alignment of each section of a snapshot file */
+#define _IX_CC_ATM_FAPI_SNAPSHOT_ALIGN 8
+
+/* Identifies a TableManager change journal, see TableJournal.h */
+#define _IX_CC_ATM_FAPI_JOURNAL_MAGIC "FAPIJRNL"
+/* Journal layout version, raised whenever the journal records change */
+#define _IX_CC_ATM_FAPI_JOURNAL_VERSION 1
+/* Time the journal writer waits for more changes to join a group commit,
+   in milliseconds */
+#define _IX_CC_ATM_FAPI_JOURNAL_COMMIT_MS 2
+/* Bytes of queued changes that start a group commit without waiting */
+#define _IX_CC_ATM_FAPI_JOURNAL_GROUP_BYTES (64 * 1024)
+/* Bytes of changes that may wait for the journal writer before
+   configuration calls wait for it */
+#define _IX_CC_ATM_FAPI_JOURNAL_PENDING_MAX (4 * 1024 * 1024)
+
+/* Maximum number of changes a change subscription may have queued */
+#define _IX_CC_ATM_FAPI_CHANGE_QUEUE_DEPTH_MAX (64 * 1024)
+/* Maximum number of changes passed to one change notification call */
+#define _IX_CC_ATM_FAPI_CHANGE_BATCH_MAX 64
+
+/* Define to store the TableManager tables in preallocated slot arrays
+   (see TableStorage.h) instead of maps. Interface IDs must then be below
+   _IX_CC_ATM_FAPI_IFACE_MAX and VC link and cross connect IDs below
+   _IX_CC_ATM_FAPI_VC_HANDLE_MAX. */
+/* #define _IX_CC_ATM_FAPI_FLAT_TABLES */
+
+/* Number of shards the TableManager tables are split into. An interface
+   and its VCs are held by shard (ifID % _IX_CC_ATM_FAPI_TABLE_SHARDS),
+   each shard has its own locks so interfaces in different shards can be
+   configured at the same time. Must be below 255. */
+#if !defined(_IX_CC_ATM_FAPI_TABLE_SHARDS)
+#define _IX_CC_ATM_FAPI_TABLE_SHARDS 1
+#endif
 
 /* Default instance ID */
 #define _IX_CC_ATM_FAPI_INSTANCE_ID 0
@@ -0,0 +1,1430 @@
+/**
+ * @file FAPILoad.cpp
+ *
+ * @date 14 June 2005
+ *
+ * @brief Load generator and replay driver for the FAPI simulator.
+ *
+ * Generates a provisioning workload from a seed, or reads one from a trace
+ * recorded by an earlier run, and drives it through the NPF entry points
+ * from 1..N client threads sharing 1.._ATM_FAPI_SIM_CB_HANDLE_MAX callback
+ * handles. A generated workload is made of the phases
+ *
+ *    ifup       - every interface of a client is brought up.
+ *    vcstorm    - VCs are added in large batches until the client has
+ *                 three quarters of its share of _IX_CC_ATM_FAPI_VC_LINK_MAX.
+ *    xcchurn    - --ops steps that add cross connects, point-to-multipoint
+ *                 legs and VCs, delete legs and VCs that are in no cross
+ *                 connect, and flap interfaces, which deletes them with
+ *                 everything they contain and brings them up again.
+ *    massdelete - every interface of a client is deleted with
+ *                 delContainedObjs set.
+ *
+ * run in the order given by --phases, --cycles times. Each client owns its
+ * own interfaces, VC link IDs and cross connect IDs, so the tables a
+ * workload leaves behind do not depend on how the clients interleave. The
+ * generator keeps a model of the tables of every client and the run fails
+ * if the simulator's tables differ from it at the end. --retry resends
+ * that percentage of the set calls, which the simulator must reject.
+ *
+ * The results are written as JSON: calls, entries and failed calls per
+ * entry point, callbacks and error responses, and a digest of the VC and
+ * cross connect tables that a replay of the same trace must reproduce.
+ *
+ * Usage: fapi_load [--seed S] [--threads N] [--handles H] [--batch B]
+ *                  [--phases P1,P2,..] [--ops N] [--cycles C] [--retry PCT]
+ *                  [--strict] [--mode sync|async] [--record FILE]
+ *                  [--output FILE] [--metrics] [--memory]
+ *        fapi_load --replay FILE [--mode sync|async] [--expect DIGEST]
+ *                  [--output FILE] [--metrics] [--memory]
+ *
+ * --memory writes the memory counters to stderr at the end of the run,
+ * and each time the process receives SIGUSR1 while it runs.
+ *
+ * A trace is text. The first line is
+ *
+ *    FAPILOAD 1 threads N handles H strict 0|1 digest D
+ *
+ * where D is the digest of the tables the trace leaves behind, which a
+ * replay checks unless --expect gives another,
+ * and every other line is one call, in the order the client issues it:
+ *
+ *    T H IfSet n ifID/ifType ..
+ *    T H IfDelete n delContainedObjs ifID ..
+ *    T H VcSet n vcLinkId/ifId/vpi/vci ..
+ *    T H VcLinkXcSet n link_A:vcXcId/link_B/xcType,vcXcId/link_B/xcType ..
+ *    T H VcDelete n vcLinkId ..
+ *    T H VcLinkXcDelete n vcXcId ..
+ *
+ * where T is the client thread and H the callback handle, both from 0.
+ *
+ * Simulator trace goes to stdout, run with stdout redirected when the
+ * JSON is written to stdout as well.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "CallBackHandler.h"
+#include "TableManager.h"
+#include "FAPIDefs.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+/*
+ * Entry points driven.
+ */
+enum
+{
+    OP_IF_SET,
+    OP_IF_DELETE,
+    OP_VC_SET,
+    OP_XC_SET,
+    OP_VC_DELETE,
+    OP_XC_DELETE,
+    OP_COUNT
+};
+
+static const char* g_opNames[OP_COUNT] =
+{
+    "IfSet", "IfDelete", "VcSet", "VcLinkXcSet", "VcDelete", "VcLinkXcDelete"
+};
+
+/*
+ * Workload phases.
+ */
+enum
+{
+    PHASE_IF_UP,
+    PHASE_VC_STORM,
+    PHASE_XC_CHURN,
+    PHASE_MASS_DELETE,
+    PHASE_COUNT
+};
+
+static const char* g_phaseNames[PHASE_COUNT] =
+{
+    "ifup", "vcstorm", "xcchurn", "massdelete"
+};
+
+/*
+ * Part a VC plays in cross connects, as TableManager::VCInfo::xcRole.
+ */
+enum
+{
+    ROLE_NONE = TableManager::VC_XC_NONE,
+    ROLE_ROOT = TableManager::VC_XC_ROOT,
+    ROLE_LEAF = TableManager::VC_XC_LEAF
+};
+
+/*
+ * One NPF call. Only the entries of its own entry point are used, link_B
+ * of every cross connect points into legs once Seal() has been called.
+ * ids holds the VC link IDs or cross connect IDs of a delete.
+ */
+typedef struct
+{
+    unsigned int op;
+    unsigned int handle;
+    NPF_boolean_t delContainedObjs;
+    std::vector<NPF_F_ATM_ConfigMgr_IfCfg_t> ifs;
+    std::vector<NPF_F_ATM_IfID_t> ifIds;
+    std::vector<NPF_F_ATM_ConfigMgr_Vc_t> vcs;
+    std::vector<NPF_F_ATM_ConfigMgr_VcLinkXc_t> xcs;
+    std::vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t> legs;
+    std::vector<NPF_uint32_t> ids;
+} LoadCall;
+
+static unsigned int Entries(const LoadCall& call)
+{
+    switch(call.op)
+    {
+        case OP_IF_SET: return (unsigned int)call.ifs.size();
+        case OP_IF_DELETE: return (unsigned int)call.ifIds.size();
+        case OP_VC_SET: return (unsigned int)call.vcs.size();
+        case OP_VC_DELETE:
+        case OP_XC_DELETE: return (unsigned int)call.ids.size();
+        default: return (unsigned int)call.xcs.size();
+    }
+}
+
+static void Seal(LoadCall& call)
+{
+    unsigned int leg = 0;
+    for(size_t x = 0; x < call.xcs.size(); x++)
+    {
+        call.xcs[x].link_B = &call.legs[leg];
+        leg += call.xcs[x].numLink_B;
+    }
+}
+
+/*
+ * Run parameters.
+ */
+typedef struct
+{
+    unsigned long long seed;
+    unsigned int threads;
+    unsigned int handles;
+    unsigned int batch;
+    unsigned int ops;
+    unsigned int cycles;
+    unsigned int retry;
+    bool strict;
+    bool async;
+    std::vector<unsigned int> phases;
+} LoadConfig;
+
+/*
+ * A client thread: the calls it issues, the model of the tables its calls
+ * leave behind and the results of issuing them.
+ *
+ * The model is indexed by the VC link ID less linkBase. The vcXcId of a
+ * leg is the VC link ID of its link_B, which is unique as a VC is link_B
+ * of one leg at most.
+ */
+typedef struct
+{
+    unsigned int index;
+    std::vector<LoadCall> calls;
+
+    unsigned long long random;
+    unsigned int ifBase;
+    unsigned int numIfs;
+    unsigned int linkBase;
+    unsigned int numLinks;
+    unsigned int vcBudget;
+
+    std::vector<bool> ifUp;
+    std::vector<unsigned int> ifNextAddr;
+    std::vector<std::vector<unsigned int> > ifVCs;
+
+    std::vector<int> vcIf;
+    std::vector<NPF_F_ATM_VcAddr_t> vcAddr;
+    std::vector<unsigned char> vcRole;
+    std::vector<unsigned int> vcRoot;
+    std::vector<NPF_F_ATM_XcType_t> vcXcType;
+    std::vector<std::vector<unsigned int> > vcLegs;
+    std::vector<unsigned int> vcLivePos;
+    std::vector<unsigned int> vcStamp;
+    std::vector<unsigned int> live;
+    std::deque<unsigned int> freeLinks;
+    unsigned int stamp;
+
+    unsigned long long numCalls[OP_COUNT];
+    unsigned long long entries[OP_COUNT];
+    unsigned long long failures[OP_COUNT];
+} LoadThread;
+
+static NPF_callbackHandle_t g_handles[_ATM_FAPI_SIM_CB_HANDLE_MAX];
+static unsigned long long g_callbacks = 0;
+static unsigned long long g_errorResponses = 0;
+static unsigned int g_startFlag = 0;
+static unsigned int g_readyThreads = 0;
+
+static unsigned long long NowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void LoadCallback(NPF_userContext_t,
+                         NPF_correlator_t,
+                         NPF_F_ATM_ConfigMgr_CallbackData_t data)
+{
+    unsigned long long errors = 0;
+    for(NPF_uint32_t x = 0; x < data.n_resp; x++)
+    {
+        if(data.resp[x].error != NPF_NO_ERROR)
+        {
+            errors++;
+        }
+    }
+    __atomic_add_fetch(&g_callbacks, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_errorResponses, errors, __ATOMIC_RELAXED);
+}
+
+/*
+ * Random numbers, xorshift64* so a seed gives the same workload on every
+ * platform.
+ */
+static unsigned int Random(LoadThread& thread, unsigned int range)
+{
+    thread.random ^= thread.random >> 12;
+    thread.random ^= thread.random << 25;
+    thread.random ^= thread.random >> 27;
+    return (unsigned int)(((thread.random * 2685821657736338717ULL) >> 32) % range);
+}
+
+/*
+ * Table digest, FNV-1a over the VCs in VC link ID order and the legs of
+ * every root in vcXcId order.
+ */
+static void DigestAdd(unsigned long long& digest, unsigned int value)
+{
+    for(unsigned int x = 0; x < 4; x++)
+    {
+        digest ^= (value >> (8 * x)) & 0xFF;
+        digest *= 1099511628211ULL;
+    }
+}
+
+static void DigestVC(unsigned long long& digest, unsigned int vcLinkId, unsigned int ifId,
+                     unsigned int vpi, unsigned int vci, unsigned int role, unsigned int numLegs)
+{
+    DigestAdd(digest, vcLinkId);
+    DigestAdd(digest, ifId);
+    DigestAdd(digest, vpi);
+    DigestAdd(digest, vci);
+    DigestAdd(digest, role);
+    DigestAdd(digest, numLegs);
+}
+
+static void DigestLeg(unsigned long long& digest, unsigned int vcXcId, unsigned int linkB, unsigned int xcType)
+{
+    DigestAdd(digest, vcXcId);
+    DigestAdd(digest, linkB);
+    DigestAdd(digest, xcType);
+}
+
+static const unsigned long long DIGEST_START = 14695981039346656037ULL;
+
+static unsigned long long TableDigest(unsigned int& numVCs, unsigned int& numLegs)
+{
+    unsigned long long digest = DIGEST_START;
+    TableManager::VCInfo vcs[256];
+    TableManager::XCInfo legs[_IX_CC_ATM_FAPI_XC_LEGS_MAX];
+    unsigned int cursor = 0;
+    numVCs = 0;
+    numLegs = 0;
+    while(cursor != _IX_CC_ATM_FAPI_QUERY_END)
+    {
+        unsigned int found = TableManager::instance().QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, vcs, 256);
+        for(unsigned int x = 0; x < found; x++)
+        {
+            DigestVC(digest, vcs[x].vcLinkId, vcs[x].ifId, vcs[x].vc.vpi, vcs[x].vc.vci,
+                     vcs[x].xcRole, vcs[x].numLegs);
+            if(vcs[x].xcRole != TableManager::VC_XC_ROOT)
+            {
+                continue;
+            }
+            unsigned int legCursor = 0;
+            while(legCursor != _IX_CC_ATM_FAPI_QUERY_END)
+            {
+                unsigned int numFound = TableManager::instance().QueryLinkXCs(vcs[x].vcLinkId, legCursor,
+                                                                             legs, _IX_CC_ATM_FAPI_XC_LEGS_MAX);
+                for(unsigned int y = 0; y < numFound; y++)
+                {
+                    DigestLeg(digest, legs[y].vcXcId, legs[y].link_B, legs[y].xcType);
+                }
+                numLegs += numFound;
+            }
+        }
+        numVCs += found;
+    }
+    return digest;
+}
+
+static unsigned long long ModelDigest(std::vector<LoadThread>& threads)
+{
+    unsigned long long digest = DIGEST_START;
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        LoadThread& thread = threads[t];
+        for(unsigned int v = 0; v < thread.numLinks; v++)
+        {
+            if(thread.vcIf[v] < 0)
+            {
+                continue;
+            }
+            unsigned int numLegs = (thread.vcRole[v] == ROLE_LEAF) ? 1 : (unsigned int)thread.vcLegs[v].size();
+            DigestVC(digest, thread.linkBase + v, (unsigned int)thread.vcIf[v], thread.vcAddr[v].vpi,
+                     thread.vcAddr[v].vci, thread.vcRole[v], numLegs);
+            if(thread.vcRole[v] != ROLE_ROOT)
+            {
+                continue;
+            }
+            std::vector<unsigned int> leaves(thread.vcLegs[v]);
+            std::sort(leaves.begin(), leaves.end());
+            for(size_t y = 0; y < leaves.size(); y++)
+            {
+                DigestLeg(digest, thread.linkBase + leaves[y], thread.linkBase + leaves[y],
+                          thread.vcXcType[leaves[y]]);
+            }
+        }
+    }
+    return digest;
+}
+
+/*
+ * Workload generation. Every Gen function appends calls to a client and
+ * applies them to its model.
+ */
+static LoadCall& NewCall(LoadThread& thread, const LoadConfig& config, unsigned int op)
+{
+    thread.calls.push_back(LoadCall());
+    LoadCall& call = thread.calls.back();
+    call.op = op;
+    call.handle = Random(thread, config.handles);
+    call.delContainedObjs = NPF_FALSE;
+    return call;
+}
+
+static void MaybeRetry(LoadThread& thread, const LoadConfig& config)
+{
+    if((config.retry != 0)&&(Random(thread, 100) < config.retry))
+    {
+        LoadCall retry = thread.calls.back();
+        retry.handle = Random(thread, config.handles);
+        thread.calls.push_back(retry);
+    }
+}
+
+/*
+ * Removes the leg whose leaf is 'v', the root leaves the cross connect with
+ * its last leg.
+ */
+static void ModelDeleteLeg(LoadThread& thread, unsigned int v)
+{
+    std::vector<unsigned int>& legs = thread.vcLegs[thread.vcRoot[v]];
+    legs.erase(std::find(legs.begin(), legs.end(), v));
+    if(legs.empty())
+    {
+        thread.vcRole[thread.vcRoot[v]] = ROLE_NONE;
+    }
+    thread.vcRole[v] = ROLE_NONE;
+}
+
+static void ModelDeleteVC(LoadThread& thread, unsigned int v)
+{
+    if(thread.vcRole[v] == ROLE_ROOT)
+    {
+        for(size_t y = 0; y < thread.vcLegs[v].size(); y++)
+        {
+            thread.vcRole[thread.vcLegs[v][y]] = ROLE_NONE;
+        }
+        thread.vcLegs[v].clear();
+    }else if(thread.vcRole[v] == ROLE_LEAF)
+    {
+        ModelDeleteLeg(thread, v);
+    }
+    thread.vcRole[v] = ROLE_NONE;
+    thread.vcIf[v] = -1;
+
+    unsigned int last = thread.live.back();
+    thread.live[thread.vcLivePos[v]] = last;
+    thread.vcLivePos[last] = thread.vcLivePos[v];
+    thread.live.pop_back();
+    thread.freeLinks.push_back(v);
+}
+
+static void GenIfUp(LoadThread& thread, const LoadConfig& config)
+{
+    LoadCall* call = 0;
+    for(unsigned int i = 0; i < thread.numIfs; i++)
+    {
+        if(thread.ifUp[i] == true)
+        {
+            continue;
+        }
+        if((call == 0)||(call->ifs.size() == config.batch))
+        {
+            if(call != 0)
+            {
+                MaybeRetry(thread, config);
+            }
+            call = &NewCall(thread, config, OP_IF_SET);
+        }
+        NPF_F_ATM_ConfigMgr_IfCfg_t ifCfg;
+        memset(&ifCfg, 0, sizeof(ifCfg));
+        ifCfg.ifID = thread.ifBase + i;
+        ifCfg.ifType = (Random(thread, 4) == 0) ? NPF_F_ATM_IF_NNI : NPF_F_ATM_IF_UNI;
+        call->ifs.push_back(ifCfg);
+        thread.ifUp[i] = true;
+        thread.ifNextAddr[i] = 0;
+    }
+    if(call != 0)
+    {
+        MaybeRetry(thread, config);
+    }
+}
+
+static void GenIfDelete(LoadThread& thread, const LoadConfig& config, unsigned int first, unsigned int count)
+{
+    LoadCall* call = 0;
+    for(unsigned int i = first; i < first + count; i++)
+    {
+        if(thread.ifUp[i] == false)
+        {
+            continue;
+        }
+        if((call == 0)||(call->ifIds.size() == config.batch))
+        {
+            call = &NewCall(thread, config, OP_IF_DELETE);
+            call->delContainedObjs = NPF_TRUE;
+        }
+        call->ifIds.push_back(thread.ifBase + i);
+        for(size_t y = 0; y < thread.ifVCs[i].size(); y++)
+        {
+            ModelDeleteVC(thread, thread.ifVCs[i][y]);
+        }
+        thread.ifVCs[i].clear();
+        thread.ifUp[i] = false;
+    }
+}
+
+/*
+ * Adds one VcSet of up to --batch VCs, spread over the interfaces that are
+ * up, while the client has fewer than 'target' VCs. Returns false if no VC
+ * could be added.
+ */
+static bool GenVcSet(LoadThread& thread, const LoadConfig& config, unsigned int target)
+{
+    std::vector<unsigned int> upIfs;
+    for(unsigned int i = 0; i < thread.numIfs; i++)
+    {
+        if(thread.ifUp[i] == true)
+        {
+            upIfs.push_back(i);
+        }
+    }
+    if((upIfs.empty() == true)||(thread.live.size() >= target)||(thread.freeLinks.empty() == true))
+    {
+        return false;
+    }
+
+    unsigned int numVCs = 1 + Random(thread, config.batch);
+    numVCs = std::min(numVCs, target - (unsigned int)thread.live.size());
+    numVCs = std::min(numVCs, (unsigned int)thread.freeLinks.size());
+    LoadCall& call = NewCall(thread, config, OP_VC_SET);
+    for(unsigned int x = 0; x < numVCs; x++)
+    {
+        unsigned int i = upIfs[Random(thread, (unsigned int)upIfs.size())];
+        unsigned int v = thread.freeLinks.front();
+        thread.freeLinks.pop_front();
+
+        // Addresses are handed out in order from VCI 32 of VPI 0, the
+        // VCIs below 32 being reserved.
+        NPF_F_ATM_ConfigMgr_Vc_t vc;
+        memset(&vc, 0, sizeof(vc));
+        vc.vcLinkId = thread.linkBase + v;
+        vc.ifId = thread.ifBase + i;
+        vc.vc.vpi = thread.ifNextAddr[i] / (0x10000 - 32);
+        vc.vc.vci = 32 + (thread.ifNextAddr[i] % (0x10000 - 32));
+        vc.numLink_B = 0;
+        vc.link_B = 0;
+        call.vcs.push_back(vc);
+        thread.ifNextAddr[i]++;
+
+        thread.vcIf[v] = (int)vc.ifId;
+        thread.vcAddr[v] = vc.vc;
+        thread.vcRole[v] = ROLE_NONE;
+        thread.vcLivePos[v] = (unsigned int)thread.live.size();
+        thread.live.push_back(v);
+        thread.ifVCs[i].push_back(v);
+    }
+    MaybeRetry(thread, config);
+    return true;
+}
+
+/*
+ * Picks a VC of the client with the given role, not yet used by the call
+ * being built. Returns false if none was found in a few tries.
+ */
+static bool PickVC(LoadThread& thread, unsigned char role, unsigned int& v)
+{
+    for(unsigned int tries = 0; (tries < 16)&&(thread.live.empty() == false); tries++)
+    {
+        unsigned int pick = thread.live[Random(thread, (unsigned int)thread.live.size())];
+        if((thread.vcRole[pick] == role)&&(thread.vcStamp[pick] != thread.stamp)&&
+           ((role != ROLE_ROOT)||(thread.vcLegs[pick].size() < _IX_CC_ATM_FAPI_XC_LEGS_MAX)))
+        {
+            thread.vcStamp[pick] = thread.stamp;
+            v = pick;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Adds one VcLinkXcSet of up to --batch cross connects. Most connect two
+ * VCs that are in no cross connect, some add legs to an existing root.
+ */
+static void GenXcSet(LoadThread& thread, const LoadConfig& config)
+{
+    static const NPF_F_ATM_XcType_t types[] =
+    {
+        NPF_F_ATM_EXT_TO_EXT, NPF_F_ATM_EXT_TO_INT, NPF_F_ATM_EXT_TO_BACK, NPF_F_ATM_BACK_TO_INT
+    };
+    unsigned int numXCs = 1 + Random(thread, config.batch);
+    LoadCall call;
+    call.op = OP_XC_SET;
+    call.handle = Random(thread, config.handles);
+    call.delContainedObjs = NPF_FALSE;
+    thread.stamp++;
+
+    for(unsigned int x = 0; x < numXCs; x++)
+    {
+        unsigned int root = 0;
+        bool extend = (Random(thread, 4) == 0);
+        if(PickVC(thread, extend ? ROLE_ROOT : ROLE_NONE, root) == false)
+        {
+            break;
+        }
+        unsigned int wanted = (Random(thread, 5) == 0) ? 2 + Random(thread, 3) : 1;
+        wanted = std::min(wanted, (unsigned int)(_IX_CC_ATM_FAPI_XC_LEGS_MAX - thread.vcLegs[root].size()));
+
+        NPF_F_ATM_ConfigMgr_VcLinkXc_t xc;
+        memset(&xc, 0, sizeof(xc));
+        xc.link_A = thread.linkBase + root;
+        xc.numLink_B = 0;
+        for(unsigned int y = 0; y < wanted; y++)
+        {
+            unsigned int leaf = 0;
+            if(PickVC(thread, ROLE_NONE, leaf) == false)
+            {
+                break;
+            }
+            NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+            memset(&leg, 0, sizeof(leg));
+            leg.vcXcId = thread.linkBase + leaf;
+            leg.xcType = types[Random(thread, 4)];
+            leg.u.mapVcLink = thread.linkBase + leaf;
+            call.legs.push_back(leg);
+            xc.numLink_B++;
+
+            thread.vcRole[leaf] = ROLE_LEAF;
+            thread.vcRoot[leaf] = root;
+            thread.vcXcType[leaf] = leg.xcType;
+            thread.vcLegs[root].push_back(leaf);
+        }
+        if(xc.numLink_B == 0)
+        {
+            break;
+        }
+        thread.vcRole[root] = ROLE_ROOT;
+        call.xcs.push_back(xc);
+    }
+    if(call.xcs.empty() == false)
+    {
+        thread.calls.push_back(call);
+        MaybeRetry(thread, config);
+    }
+}
+
+/*
+ * Adds one VcLinkXcDelete of up to --batch legs. The vcXcId of a leg is the
+ * VC link ID of its leaf.
+ */
+static void GenXcDelete(LoadThread& thread, const LoadConfig& config)
+{
+    unsigned int numLegs = 1 + Random(thread, config.batch);
+    LoadCall call;
+    call.op = OP_XC_DELETE;
+    call.handle = Random(thread, config.handles);
+    call.delContainedObjs = NPF_FALSE;
+    thread.stamp++;
+
+    for(unsigned int x = 0; x < numLegs; x++)
+    {
+        unsigned int leaf = 0;
+        if(PickVC(thread, ROLE_LEAF, leaf) == false)
+        {
+            break;
+        }
+        call.ids.push_back(thread.linkBase + leaf);
+        ModelDeleteLeg(thread, leaf);
+    }
+    if(call.ids.empty() == false)
+    {
+        thread.calls.push_back(call);
+        MaybeRetry(thread, config);
+    }
+}
+
+/*
+ * Adds one VcDelete of up to --batch VCs that are in no cross connect.
+ */
+static void GenVcDelete(LoadThread& thread, const LoadConfig& config)
+{
+    unsigned int numVCs = 1 + Random(thread, config.batch);
+    LoadCall call;
+    call.op = OP_VC_DELETE;
+    call.handle = Random(thread, config.handles);
+    call.delContainedObjs = NPF_FALSE;
+    thread.stamp++;
+
+    for(unsigned int x = 0; x < numVCs; x++)
+    {
+        unsigned int v = 0;
+        if(PickVC(thread, ROLE_NONE, v) == false)
+        {
+            break;
+        }
+        call.ids.push_back(thread.linkBase + v);
+        std::vector<unsigned int>& vcs = thread.ifVCs[thread.vcIf[v] - thread.ifBase];
+        vcs.erase(std::find(vcs.begin(), vcs.end(), v));
+        ModelDeleteVC(thread, v);
+    }
+    if(call.ids.empty() == false)
+    {
+        thread.calls.push_back(call);
+        MaybeRetry(thread, config);
+    }
+}
+
+static void Generate(LoadThread& thread, const LoadConfig& config)
+{
+    for(unsigned int cycle = 0; cycle < config.cycles; cycle++)
+    {
+        for(size_t p = 0; p < config.phases.size(); p++)
+        {
+            switch(config.phases[p])
+            {
+                case PHASE_IF_UP:
+                    GenIfUp(thread, config);
+                break;
+                case PHASE_VC_STORM:
+                    while(GenVcSet(thread, config, (3 * thread.vcBudget) / 4) == true)
+                    {
+                    }
+                break;
+                case PHASE_XC_CHURN:
+                    for(unsigned int step = 0; step < config.ops; step++)
+                    {
+                        unsigned int choice = Random(thread, 10);
+                        if(choice < 5)
+                        {
+                            GenXcSet(thread, config);
+                        }else if(choice < 7)
+                        {
+                            GenVcSet(thread, config, thread.vcBudget);
+                        }else if(choice == 7)
+                        {
+                            GenXcDelete(thread, config);
+                        }else if(choice == 8)
+                        {
+                            GenVcDelete(thread, config);
+                        }else
+                        {
+                            GenIfDelete(thread, config, Random(thread, thread.numIfs), 1);
+                            GenIfUp(thread, config);
+                        }
+                    }
+                break;
+                case PHASE_MASS_DELETE:
+                    GenIfDelete(thread, config, 0, thread.numIfs);
+                break;
+            }
+        }
+    }
+    for(size_t x = 0; x < thread.calls.size(); x++)
+    {
+        Seal(thread.calls[x]);
+    }
+}
+
+/*
+ * Splits the interface IDs 1.._IX_CC_ATM_FAPI_IFACE_MAX-1, the VC link IDs
+ * and the VCs the tables can hold between the clients.
+ */
+static void InitThread(LoadThread& thread, unsigned int index, const LoadConfig& config)
+{
+    unsigned int ifShare = (_IX_CC_ATM_FAPI_IFACE_MAX - 1) / config.threads;
+    thread.index = index;
+    thread.random = (config.seed + index + 1) * 0x9E3779B97F4A7C15ULL;
+    if(thread.random == 0)
+    {
+        thread.random = 1;
+    }
+    thread.ifBase = 1 + index * ifShare;
+    thread.numIfs = ifShare;
+    thread.numLinks = _IX_CC_ATM_FAPI_VC_HANDLE_MAX / config.threads;
+    thread.linkBase = index * thread.numLinks;
+    thread.vcBudget = (_IX_CC_ATM_FAPI_VC_LINK_MAX - 1) / config.threads;
+
+    thread.ifUp.assign(thread.numIfs, false);
+    thread.ifNextAddr.assign(thread.numIfs, 0);
+    thread.ifVCs.assign(thread.numIfs, std::vector<unsigned int>());
+    thread.vcIf.assign(thread.numLinks, -1);
+    thread.vcAddr.resize(thread.numLinks);
+    thread.vcRole.assign(thread.numLinks, ROLE_NONE);
+    thread.vcRoot.assign(thread.numLinks, 0);
+    thread.vcXcType.assign(thread.numLinks, NPF_F_ATM_EXT_TO_EXT);
+    thread.vcLegs.assign(thread.numLinks, std::vector<unsigned int>());
+    thread.vcLivePos.assign(thread.numLinks, 0);
+    thread.vcStamp.assign(thread.numLinks, 0);
+    thread.stamp = 0;
+    for(unsigned int v = 0; v < thread.numLinks; v++)
+    {
+        thread.freeLinks.push_back(v);
+    }
+}
+
+/*
+ * Trace recording and reading.
+ */
+static bool WriteTrace(const char* path, const LoadConfig& config, const std::vector<LoadThread>& threads,
+                       unsigned long long digest)
+{
+    FILE* file = fopen(path, "w");
+    if(file == 0)
+    {
+        return false;
+    }
+    fprintf(file, "FAPILOAD 1 threads %u handles %u strict %u digest %016llx\n", config.threads, config.handles,
+            config.strict ? 1 : 0, digest);
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        for(size_t c = 0; c < threads[t].calls.size(); c++)
+        {
+            const LoadCall& call = threads[t].calls[c];
+            fprintf(file, "%u %u %s %u", (unsigned int)t, call.handle, g_opNames[call.op], Entries(call));
+            switch(call.op)
+            {
+                case OP_IF_SET:
+                    for(size_t x = 0; x < call.ifs.size(); x++)
+                    {
+                        fprintf(file, " %u/%u", (unsigned int)call.ifs[x].ifID, (unsigned int)call.ifs[x].ifType);
+                    }
+                break;
+                case OP_IF_DELETE:
+                    fprintf(file, " %u", (unsigned int)call.delContainedObjs);
+                    for(size_t x = 0; x < call.ifIds.size(); x++)
+                    {
+                        fprintf(file, " %u", (unsigned int)call.ifIds[x]);
+                    }
+                break;
+                case OP_VC_SET:
+                    for(size_t x = 0; x < call.vcs.size(); x++)
+                    {
+                        fprintf(file, " %u/%u/%u/%u", (unsigned int)call.vcs[x].vcLinkId,
+                                (unsigned int)call.vcs[x].ifId, (unsigned int)call.vcs[x].vc.vpi,
+                                (unsigned int)call.vcs[x].vc.vci);
+                    }
+                break;
+                case OP_XC_SET:
+                    for(size_t x = 0; x < call.xcs.size(); x++)
+                    {
+                        fprintf(file, " %u", (unsigned int)call.xcs[x].link_A);
+                        for(unsigned int y = 0; y < call.xcs[x].numLink_B; y++)
+                        {
+                            const NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t& leg = call.xcs[x].link_B[y];
+                            fprintf(file, "%c%u/%u/%u", (y == 0) ? ':' : ',', (unsigned int)leg.vcXcId,
+                                    (unsigned int)leg.u.mapVcLink, (unsigned int)leg.xcType);
+                        }
+                    }
+                break;
+                case OP_VC_DELETE:
+                case OP_XC_DELETE:
+                    for(size_t x = 0; x < call.ids.size(); x++)
+                    {
+                        fprintf(file, " %u", (unsigned int)call.ids[x]);
+                    }
+                break;
+            }
+            fprintf(file, "\n");
+        }
+    }
+    return (fclose(file) == 0);
+}
+
+/*
+ * Reads an unsigned number at 'text', skipping leading blanks, followed by
+ * 'separator' or, when separator is 0, a blank or the end of the line.
+ */
+static bool ReadNumber(char*& text, char separator, unsigned int& value)
+{
+    while((*text == ' ')||(*text == '\t'))
+    {
+        text++;
+    }
+    char* end = 0;
+    value = (unsigned int)strtoul(text, &end, 10);
+    if((end == text)||((separator != 0)&&(*end != separator))||
+       ((separator == 0)&&(*end != ' ')&&(*end != '\t')&&(*end != '\n')&&(*end != '\r')&&(*end != '\0')))
+    {
+        return false;
+    }
+    text = (separator != 0) ? end + 1 : end;
+    return true;
+}
+
+static bool ParseCall(char* text, const LoadConfig& config, std::vector<LoadThread>& threads)
+{
+    unsigned int t = 0;
+    unsigned int count = 0;
+    unsigned int value[4];
+    LoadCall call;
+    char name[16];
+    int used = 0;
+
+    if((ReadNumber(text, 0, t) == false)||(t >= config.threads)||
+       (ReadNumber(text, 0, call.handle) == false)||(call.handle >= config.handles)||
+       (sscanf(text, " %15s%n", name, &used) != 1))
+    {
+        return false;
+    }
+    text += used;
+    for(call.op = 0; (call.op < OP_COUNT)&&(strcmp(name, g_opNames[call.op]) != 0); call.op++)
+    {
+    }
+    if((call.op == OP_COUNT)||(ReadNumber(text, 0, count) == false))
+    {
+        return false;
+    }
+    call.delContainedObjs = NPF_FALSE;
+
+    switch(call.op)
+    {
+        case OP_IF_SET:
+            for(unsigned int x = 0; x < count; x++)
+            {
+                NPF_F_ATM_ConfigMgr_IfCfg_t ifCfg;
+                memset(&ifCfg, 0, sizeof(ifCfg));
+                if((ReadNumber(text, '/', value[0]) == false)||(ReadNumber(text, 0, value[1]) == false))
+                {
+                    return false;
+                }
+                ifCfg.ifID = value[0];
+                ifCfg.ifType = (NPF_F_ATM_IfType_t)value[1];
+                call.ifs.push_back(ifCfg);
+            }
+        break;
+        case OP_IF_DELETE:
+            if(ReadNumber(text, 0, value[0]) == false)
+            {
+                return false;
+            }
+            call.delContainedObjs = value[0] ? NPF_TRUE : NPF_FALSE;
+            for(unsigned int x = 0; x < count; x++)
+            {
+                if(ReadNumber(text, 0, value[0]) == false)
+                {
+                    return false;
+                }
+                call.ifIds.push_back(value[0]);
+            }
+        break;
+        case OP_VC_SET:
+            for(unsigned int x = 0; x < count; x++)
+            {
+                NPF_F_ATM_ConfigMgr_Vc_t vc;
+                memset(&vc, 0, sizeof(vc));
+                if((ReadNumber(text, '/', value[0]) == false)||(ReadNumber(text, '/', value[1]) == false)||
+                   (ReadNumber(text, '/', value[2]) == false)||(ReadNumber(text, 0, value[3]) == false))
+                {
+                    return false;
+                }
+                vc.vcLinkId = value[0];
+                vc.ifId = value[1];
+                vc.vc.vpi = value[2];
+                vc.vc.vci = value[3];
+                vc.numLink_B = 0;
+                vc.link_B = 0;
+                call.vcs.push_back(vc);
+            }
+        break;
+        case OP_XC_SET:
+            for(unsigned int x = 0; x < count; x++)
+            {
+                NPF_F_ATM_ConfigMgr_VcLinkXc_t xc;
+                memset(&xc, 0, sizeof(xc));
+                if(ReadNumber(text, ':', value[0]) == false)
+                {
+                    return false;
+                }
+                xc.link_A = value[0];
+                xc.numLink_B = 0;
+                for(bool more = true; more == true; )
+                {
+                    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+                    memset(&leg, 0, sizeof(leg));
+                    if((ReadNumber(text, '/', value[0]) == false)||(ReadNumber(text, '/', value[1]) == false))
+                    {
+                        return false;
+                    }
+                    more = (ReadNumber(text, ',', value[2]) == true);
+                    if((more == false)&&(ReadNumber(text, 0, value[2]) == false))
+                    {
+                        return false;
+                    }
+                    leg.vcXcId = value[0];
+                    leg.u.mapVcLink = value[1];
+                    leg.xcType = (NPF_F_ATM_XcType_t)value[2];
+                    call.legs.push_back(leg);
+                    xc.numLink_B++;
+                }
+                call.xcs.push_back(xc);
+            }
+        break;
+        case OP_VC_DELETE:
+        case OP_XC_DELETE:
+            for(unsigned int x = 0; x < count; x++)
+            {
+                if(ReadNumber(text, 0, value[0]) == false)
+                {
+                    return false;
+                }
+                call.ids.push_back(value[0]);
+            }
+        break;
+    }
+    threads[t].calls.push_back(call);
+    return true;
+}
+
+static bool ReadTrace(const char* path, LoadConfig& config, std::vector<LoadThread>& threads,
+                      unsigned long long& digest)
+{
+    FILE* file = fopen(path, "r");
+    if(file == 0)
+    {
+        fprintf(stderr, "fapi_load: cannot open %s\n", path);
+        return false;
+    }
+    unsigned int version = 0;
+    unsigned int strict = 0;
+    if((fscanf(file, "FAPILOAD %u threads %u handles %u strict %u digest %llx\n", &version,
+               &config.threads, &config.handles, &strict, &digest) != 5)||(version != 1)||
+       (config.threads == 0)||(config.threads >= _IX_CC_ATM_FAPI_IFACE_MAX)||
+       (config.handles == 0)||(config.handles > _ATM_FAPI_SIM_CB_HANDLE_MAX))
+    {
+        fprintf(stderr, "fapi_load: %s is not a trace\n", path);
+        fclose(file);
+        return false;
+    }
+    config.strict = (strict != 0);
+    threads.resize(config.threads);
+    for(unsigned int t = 0; t < config.threads; t++)
+    {
+        threads[t].index = t;
+    }
+
+    // Lines may hold a batch of thousands of entries.
+    char* line = 0;
+    size_t size = 0;
+    unsigned int lineNumber = 1;
+    bool ok = true;
+    while(getline(&line, &size, file) != -1)
+    {
+        lineNumber++;
+        if((line[0] == '\n')||(line[0] == '#'))
+        {
+            continue;
+        }
+        if(ParseCall(line, config, threads) == false)
+        {
+            fprintf(stderr, "fapi_load: %s:%u: bad call\n", path, lineNumber);
+            ok = false;
+            break;
+        }
+    }
+    free(line);
+    fclose(file);
+    for(unsigned int t = 0; ok && (t < config.threads); t++)
+    {
+        for(size_t x = 0; x < threads[t].calls.size(); x++)
+        {
+            Seal(threads[t].calls[x]);
+        }
+    }
+    return ok;
+}
+
+/*
+ * Issues the calls of a client.
+ */
+static void* LoadClient(void* arg)
+{
+    LoadThread* thread = static_cast<LoadThread*>(arg);
+
+    __atomic_add_fetch(&g_readyThreads, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&g_startFlag, __ATOMIC_ACQUIRE) == 0)
+    {
+        sched_yield();
+    }
+
+    for(size_t x = 0; x < thread->calls.size(); x++)
+    {
+        LoadCall& call = thread->calls[x];
+        NPF_callbackHandle_t cbHandle = g_handles[call.handle];
+        NPF_correlator_t correlator = (NPF_correlator_t)x;
+        unsigned int numEntries = Entries(call);
+        NPF_error_t error = NPF_NO_ERROR;
+        switch(call.op)
+        {
+            case OP_IF_SET:
+                error = NPF_F_ATM_ConfigMgr_IfSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                  numEntries, &call.ifs[0]);
+            break;
+            case OP_IF_DELETE:
+                error = NPF_F_ATM_ConfigMgr_IfDelete(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                     call.delContainedObjs, numEntries, &call.ifIds[0]);
+            break;
+            case OP_VC_SET:
+                error = NPF_F_ATM_ConfigMgr_VcSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                  numEntries, &call.vcs[0]);
+            break;
+            case OP_XC_SET:
+                error = NPF_F_ATM_ConfigMgr_VcLinkXcSet(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                        numEntries, &call.xcs[0]);
+            break;
+            case OP_VC_DELETE:
+                error = NPF_F_ATM_ConfigMgr_VcDelete(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                     numEntries, &call.ids[0]);
+            break;
+            case OP_XC_DELETE:
+                error = NPF_F_ATM_ConfigMgr_VcLinkXcDelete(cbHandle, correlator, NPF_REPORT_ALL, 0, 0,
+                                                           numEntries, &call.ids[0]);
+            break;
+        }
+        thread->numCalls[call.op]++;
+        thread->entries[call.op] += numEntries;
+        if(error != NPF_NO_ERROR)
+        {
+            thread->failures[call.op]++;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Registers the handles, runs every client and writes the results. The run
+ * fails if the tables left behind do not match 'expected'.
+ */
+static int RunLoad(const LoadConfig& config, std::vector<LoadThread>& threads,
+                   unsigned long long expected, const char* output)
+{
+    if(config.async == true)
+    {
+        if(CallBackHandler::instance().setCallbackModeDispatch() == false)
+        {
+            fprintf(stderr, "fapi_load: dispatcher could not be started\n");
+            return 1;
+        }
+    }else
+    {
+        CallBackHandler::instance().setCallbackModeSync();
+    }
+
+    for(unsigned int h = 0; h < config.handles; h++)
+    {
+        NPF_userContext_t context = (NPF_userContext_t)(unsigned long)(h + 1);
+        if((NPF_F_ATM_ConfigMgr_Register(context, LoadCallback, &g_handles[h]) != NPF_NO_ERROR)||
+           ((config.strict == true)&&
+            (NPF_F_ATM_ConfigMgr_SetBatchMode(g_handles[h], NPF_F_ATM_CONFIGMGR_BATCH_STRICT) != NPF_NO_ERROR)))
+        {
+            fprintf(stderr, "fapi_load: callback handle %u could not be registered\n", h);
+            return 1;
+        }
+    }
+
+    std::vector<pthread_t> ids(config.threads);
+    for(unsigned int t = 0; t < config.threads; t++)
+    {
+        for(unsigned int op = 0; op < OP_COUNT; op++)
+        {
+            threads[t].numCalls[op] = 0;
+            threads[t].entries[op] = 0;
+            threads[t].failures[op] = 0;
+        }
+        pthread_create(&ids[t], 0, LoadClient, &threads[t]);
+    }
+    while(__atomic_load_n(&g_readyThreads, __ATOMIC_SEQ_CST) != config.threads)
+    {
+        sched_yield();
+    }
+
+    unsigned long long start = NowNs();
+    __atomic_store_n(&g_startFlag, 1, __ATOMIC_RELEASE);
+    for(unsigned int t = 0; t < config.threads; t++)
+    {
+        pthread_join(ids[t], 0);
+    }
+    // Switching back to sync mode drains the dispatcher.
+    CallBackHandler::instance().setCallbackModeSync();
+    unsigned long long wallNs = NowNs() - start;
+    for(unsigned int h = 0; h < config.handles; h++)
+    {
+        NPF_F_ATM_ConfigMgr_Deregister(g_handles[h]);
+    }
+
+    unsigned int numVCs = 0;
+    unsigned int numLegs = 0;
+    unsigned long long digest = TableDigest(numVCs, numLegs);
+
+    unsigned long long totalCalls = 0;
+    unsigned long long totalEntries = 0;
+    char buffer[512];
+    std::string ops;
+    for(unsigned int op = 0; op < OP_COUNT; op++)
+    {
+        unsigned long long calls = 0;
+        unsigned long long entries = 0;
+        unsigned long long failures = 0;
+        for(unsigned int t = 0; t < config.threads; t++)
+        {
+            calls += threads[t].numCalls[op];
+            entries += threads[t].entries[op];
+            failures += threads[t].failures[op];
+        }
+        totalCalls += calls;
+        totalEntries += entries;
+        snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"calls\":%llu,\"entries\":%llu,\"failed_calls\":%llu}",
+                 ops.empty() ? "" : ",", g_opNames[op], calls, entries, failures);
+        ops += buffer;
+    }
+
+    FILE* file = (strcmp(output, "-") == 0) ? stdout : fopen(output, "w");
+    if(file == 0)
+    {
+        fprintf(stderr, "fapi_load: cannot open %s\n", output);
+        return 1;
+    }
+    fprintf(file, "{\"load\":\"fapi_sim\",\"threads\":%u,\"handles\":%u,\"strict\":%s,\"mode\":\"%s\","
+                  "\"table_shards\":%d,\n  \"wall_ns\":%llu,\"calls_per_sec\":%.1f,\"entries_per_sec\":%.1f,"
+                  "\"callbacks\":%llu,\"error_responses\":%llu,\n  \"ops\":{%s},\n"
+                  "  \"vcs\":%u,\"xc_legs\":%u,\"digest\":\"%016llx\",\"expected_digest\":\"%016llx\"}\n",
+            config.threads, config.handles, config.strict ? "true" : "false", config.async ? "async" : "sync",
+            _IX_CC_ATM_FAPI_TABLE_SHARDS, wallNs, totalCalls * 1e9 / wallNs, totalEntries * 1e9 / wallNs,
+            __atomic_load_n(&g_callbacks, __ATOMIC_RELAXED),
+            __atomic_load_n(&g_errorResponses, __ATOMIC_RELAXED), ops.c_str(), numVCs, numLegs, digest, expected);
+    if(file != stdout)
+    {
+        fclose(file);
+    }
+
+    if(digest != expected)
+    {
+        fprintf(stderr, "fapi_load: tables differ from the workload, digest %016llx expected %016llx\n",
+                digest, expected);
+        return 1;
+    }
+    return 0;
+}
+
+static bool ParsePhases(const char* list, std::vector<unsigned int>& phases)
+{
+    phases.clear();
+    while(*list != '\0')
+    {
+        size_t length = strcspn(list, ",");
+        unsigned int phase = 0;
+        while((phase < PHASE_COUNT)&&
+              ((strlen(g_phaseNames[phase]) != length)||(strncmp(list, g_phaseNames[phase], length) != 0)))
+        {
+            phase++;
+        }
+        if(phase == PHASE_COUNT)
+        {
+            return false;
+        }
+        phases.push_back(phase);
+        list += length;
+        if(*list == ',')
+        {
+            list++;
+        }
+    }
+    return (phases.empty() == false);
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+            "usage: fapi_load [--seed S] [--threads N] [--handles H] [--batch B]\n"
+            "                 [--phases ifup,vcstorm,xcchurn,massdelete] [--ops N] [--cycles C]\n"
+            "                 [--retry PCT] [--strict] [--mode sync|async] [--record FILE]\n"
+            "                 [--output FILE] [--metrics] [--memory]\n"
+            "       fapi_load --replay FILE [--mode sync|async] [--expect DIGEST]\n"
+            "                 [--output FILE] [--metrics] [--memory]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    LoadConfig config;
+    config.seed = 1;
+    config.threads = 4;
+    config.handles = 4;
+    config.batch = 256;
+    config.ops = 200;
+    config.cycles = 1;
+    config.retry = 0;
+    config.strict = false;
+    config.async = false;
+    ParsePhases("ifup,vcstorm,xcchurn,massdelete", config.phases);
+    const char* record = 0;
+    const char* replay = 0;
+    const char* expect = 0;
+    const char* output = "-";
+    bool metrics = false;
+    bool memory = false;
+
+    for(int x = 1; x < argc; x++)
+    {
+        if((strcmp(argv[x], "--seed") == 0)&&(x + 1 < argc))
+        {
+            config.seed = strtoull(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--threads") == 0)&&(x + 1 < argc))
+        {
+            config.threads = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--handles") == 0)&&(x + 1 < argc))
+        {
+            config.handles = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--batch") == 0)&&(x + 1 < argc))
+        {
+            config.batch = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--phases") == 0)&&(x + 1 < argc))
+        {
+            if(ParsePhases(argv[++x], config.phases) == false)
+            {
+                Usage();
+                return 1;
+            }
+        }else if((strcmp(argv[x], "--ops") == 0)&&(x + 1 < argc))
+        {
+            config.ops = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--cycles") == 0)&&(x + 1 < argc))
+        {
+            config.cycles = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if((strcmp(argv[x], "--retry") == 0)&&(x + 1 < argc))
+        {
+            config.retry = (unsigned int)strtoul(argv[++x], 0, 0);
+        }else if(strcmp(argv[x], "--strict") == 0)
+        {
+            config.strict = true;
+        }else if((strcmp(argv[x], "--mode") == 0)&&(x + 1 < argc))
+        {
+            config.async = (strcmp(argv[++x], "async") == 0);
+        }else if((strcmp(argv[x], "--record") == 0)&&(x + 1 < argc))
+        {
+            record = argv[++x];
+        }else if((strcmp(argv[x], "--replay") == 0)&&(x + 1 < argc))
+        {
+            replay = argv[++x];
+        }else if((strcmp(argv[x], "--expect") == 0)&&(x + 1 < argc))
+        {
+            expect = argv[++x];
+        }else if((strcmp(argv[x], "--output") == 0)&&(x + 1 < argc))
+        {
+            output = argv[++x];
+        }else if(strcmp(argv[x], "--metrics") == 0)
+        {
+            metrics = true;
+        }else if(strcmp(argv[x], "--memory") == 0)
+        {
+            memory = true;
+        }else
+        {
+            Usage();
+            return 1;
+        }
+    }
+    if(memory == true)
+    {
+        NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(SIGUSR1, stderr);
+    }
+
+    std::vector<LoadThread> threads;
+    unsigned long long digest = 0;
+    if(replay != 0)
+    {
+        if(ReadTrace(replay, config, threads, digest) == false)
+        {
+            return 1;
+        }
+    }else
+    {
+        // Every client needs an interface of its own.
+        if((config.threads == 0)||(config.threads >= _IX_CC_ATM_FAPI_IFACE_MAX)||
+           (config.handles == 0)||(config.handles > _ATM_FAPI_SIM_CB_HANDLE_MAX)||
+           (config.batch == 0)||(config.batch > _IX_CC_ATM_FAPI_VC_LINK_MAX)||(config.retry > 100))
+        {
+            fprintf(stderr, "fapi_load: --threads must be 1..%d, --handles 1..%d, --batch 1..%d "
+                            "and --retry 0..100\n", _IX_CC_ATM_FAPI_IFACE_MAX - 1,
+                    _ATM_FAPI_SIM_CB_HANDLE_MAX, _IX_CC_ATM_FAPI_VC_LINK_MAX);
+            return 1;
+        }
+        threads.resize(config.threads);
+        for(unsigned int t = 0; t < config.threads; t++)
+        {
+            InitThread(threads[t], t, config);
+            Generate(threads[t], config);
+        }
+        digest = ModelDigest(threads);
+        if((record != 0)&&(WriteTrace(record, config, threads, digest) == false))
+        {
+            fprintf(stderr, "fapi_load: cannot write %s\n", record);
+            return 1;
+        }
+    }
+    if(expect != 0)
+    {
+        digest = strtoull(expect, 0, 16);
+    }
+
+    int result = RunLoad(config, threads, digest, output);
+    if(metrics == true)
+    {
+        NPF_F_ATM_ConfigMgr_MetricsDump(stderr);
+    }
+    if(memory == true)
+    {
+        NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(0, 0);
+        NPF_F_ATM_ConfigMgr_MemoryDump(stderr);
+    }
+    return result;
+}
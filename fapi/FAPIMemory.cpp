@@ -0,0 +1,298 @@
+/**
+ * @file FAPIMemory.cpp
+ *
+ * @date 21 June 2005
+ *
+ * @brief The FAPIMemory accounts the memory held by the tables, the link_B
+ *        arrays and the callback and response pools of the FAPI simulator.
+ *
+ * Implementation of the counters, their dump and the thread that writes
+ * the dump when a signal is received.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPIMemory.h"
+#include "TraceMacro.h"
+
+/*
+ * System defined include files required.
+ */
+#include <errno.h>
+#include <string.h>
+
+static const char* const memNames[NPF_F_ATM_CONFIGMGR_MEM_COUNT] =
+{
+    "IfTable",
+    "VcTable",
+    "XcTable",
+    "LinkB",
+    "CallBack",
+    "Resp"
+};
+
+FAPIMemory::memCounts FAPIMemory::m_counts[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+sem_t FAPIMemory::m_dumpSem;
+
+FAPIMemory::FAPIMemory()
+: m_signum(0), m_out(0), m_threadStarted(false), m_stopping(false)
+{
+    memset(&m_previous, 0, sizeof(m_previous));
+    sem_init(&m_dumpSem, 0, 0);
+    pthread_mutex_init(&m_lock, 0);
+}
+
+FAPIMemory::~FAPIMemory()
+{
+    pthread_mutex_lock(&m_lock);
+    if(m_signum != 0)
+    {
+        sigaction(m_signum, &m_previous, 0);
+        m_signum = 0;
+    }
+    m_stopping = true;
+    pthread_mutex_unlock(&m_lock);
+    if(m_threadStarted == true)
+    {
+        sem_post(&m_dumpSem);
+        pthread_join(m_thread, 0);
+    }
+    // m_counts and m_dumpSem are left as they are, tables destroyed after
+    // this object still release into the counters.
+    pthread_mutex_destroy(&m_lock);
+}
+
+FAPIMemory& FAPIMemory::instance()
+{
+    // Singleton Pattern
+    static FAPIMemory instance;
+    return instance;
+}
+
+/**
+ * Function Definition: RaisePeak(unsigned long long& peak, unsigned long long value)
+ */
+void FAPIMemory::RaisePeak(unsigned long long& peak, unsigned long long value)
+{
+    unsigned long long current = __atomic_load_n(&peak, __ATOMIC_RELAXED);
+    while((value > current)&&
+          (__atomic_compare_exchange_n(&peak, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false))
+    {
+    }
+}
+
+/**
+ * Function Definition: Acquire(NPF_F_ATM_ConfigMgr_MemSite_t site,
+ *                              unsigned long long bytes)
+ */
+void FAPIMemory::Acquire(NPF_F_ATM_ConfigMgr_MemSite_t site, unsigned long long bytes)
+{
+    memCounts& counts = m_counts[site];
+    RaisePeak(counts.peakObjects, __atomic_add_fetch(&counts.objects, 1, __ATOMIC_RELAXED));
+    RaisePeak(counts.peakBytes, __atomic_add_fetch(&counts.bytes, bytes, __ATOMIC_RELAXED));
+    __atomic_add_fetch(&counts.allocs, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Function Definition: Release(NPF_F_ATM_ConfigMgr_MemSite_t site,
+ *                              unsigned long long bytes)
+ */
+void FAPIMemory::Release(NPF_F_ATM_ConfigMgr_MemSite_t site, unsigned long long bytes)
+{
+    memCounts& counts = m_counts[site];
+    __atomic_sub_fetch(&counts.objects, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&counts.bytes, bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counts.frees, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Function Definition: Reserve(NPF_F_ATM_ConfigMgr_MemSite_t site, long long bytes)
+ */
+void FAPIMemory::Reserve(NPF_F_ATM_ConfigMgr_MemSite_t site, long long bytes)
+{
+    __atomic_add_fetch(&m_counts[site].reservedBytes, (unsigned long long)bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * Function Definition: Get(NPF_F_ATM_ConfigMgr_MemSite_t site,
+ *                          NPF_F_ATM_ConfigMgr_MemInfo_t* info)
+ */
+bool FAPIMemory::Get(NPF_F_ATM_ConfigMgr_MemSite_t site, NPF_F_ATM_ConfigMgr_MemInfo_t* info)
+{
+    if(((unsigned int)site >= NPF_F_ATM_CONFIGMGR_MEM_COUNT)||(info == 0))
+    {
+        return false;
+    }
+    memCounts& counts = m_counts[site];
+    info->objects = __atomic_load_n(&counts.objects, __ATOMIC_RELAXED);
+    info->bytes = __atomic_load_n(&counts.bytes, __ATOMIC_RELAXED);
+    info->peakObjects = __atomic_load_n(&counts.peakObjects, __ATOMIC_RELAXED);
+    info->peakBytes = __atomic_load_n(&counts.peakBytes, __ATOMIC_RELAXED);
+    info->reservedBytes = __atomic_load_n(&counts.reservedBytes, __ATOMIC_RELAXED);
+    info->allocs = __atomic_load_n(&counts.allocs, __ATOMIC_RELAXED);
+    info->frees = __atomic_load_n(&counts.frees, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * Function Definition: Dump(FILE* out)
+ */
+void FAPIMemory::Dump(FILE* out)
+{
+    NPF_F_ATM_ConfigMgr_MemInfo_t info;
+    NPF_F_ATM_ConfigMgr_MemInfo_t total;
+    memset(&total, 0, sizeof(total));
+
+    fprintf(out, "%-18s %10s %12s %10s %12s %12s %10s %10s\n", "memory", "objects", "bytes",
+            "peak_obj", "peak_bytes", "reserved", "allocs", "frees");
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+    {
+        Get((NPF_F_ATM_ConfigMgr_MemSite_t)x, &info);
+        fprintf(out, "%-18s %10llu %12llu %10llu %12llu %12lld %10llu %10llu\n", memNames[x],
+                (unsigned long long)info.objects, (unsigned long long)info.bytes,
+                (unsigned long long)info.peakObjects, (unsigned long long)info.peakBytes,
+                (long long)info.reservedBytes, (unsigned long long)info.allocs,
+                (unsigned long long)info.frees);
+        total.objects += info.objects;
+        total.bytes += info.bytes;
+        total.reservedBytes += info.reservedBytes;
+    }
+    // The places peak at different times, their high water marks do not
+    // add up to one.
+    fprintf(out, "%-18s %10llu %12llu %10s %12s %12lld\n", "total", (unsigned long long)total.objects,
+            (unsigned long long)total.bytes, "-", "-", (long long)total.reservedBytes);
+    fflush(out);
+}
+
+/**
+ * Function Definition: ResetPeaks()
+ */
+void FAPIMemory::ResetPeaks()
+{
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+    {
+        memCounts& counts = m_counts[x];
+        __atomic_store_n(&counts.peakObjects, __atomic_load_n(&counts.objects, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+        __atomic_store_n(&counts.peakBytes, __atomic_load_n(&counts.bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Function Definition: DumpOnSignal(int signum, FILE* out)
+ */
+bool FAPIMemory::DumpOnSignal(int signum, FILE* out)
+{
+    pthread_mutex_lock(&m_lock);
+    if(m_signum != 0)
+    {
+        sigaction(m_signum, &m_previous, 0);
+        m_signum = 0;
+    }
+    if(signum == 0)
+    {
+        pthread_mutex_unlock(&m_lock);
+        return true;
+    }
+
+    if(m_threadStarted == false)
+    {
+        if(pthread_create(&m_thread, 0, DumpThread, this) != 0)
+        {
+            APISimTrace(1,"Trace Level 1: FAPIMemory::DumpOnSignal - Thread Creation Failed!\n");
+            pthread_mutex_unlock(&m_lock);
+            return false;
+        }
+        m_threadStarted = true;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if(sigaction(signum, &action, &m_previous) != 0)
+    {
+        APISimTrace(1,"Trace Level 1: FAPIMemory::DumpOnSignal - Signal %d Cannot Be Caught!\n",signum);
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    m_signum = signum;
+    m_out = out;
+    pthread_mutex_unlock(&m_lock);
+    return true;
+}
+
+/**
+ * Function Definition: SignalHandler(int)
+ */
+void FAPIMemory::SignalHandler(int)
+{
+    // sem_post() is one of the few calls a signal handler may make.
+    int savedErrno = errno;
+    sem_post(&m_dumpSem);
+    errno = savedErrno;
+}
+
+/**
+ * Function Definition: DumpThread(void* arg)
+ */
+void* FAPIMemory::DumpThread(void* arg)
+{
+    FAPIMemory* memory = static_cast<FAPIMemory*>(arg);
+    for(;;)
+    {
+        while((sem_wait(&m_dumpSem) != 0)&&(errno == EINTR))
+        {
+        }
+
+        pthread_mutex_lock(&memory->m_lock);
+        if(memory->m_stopping == true)
+        {
+            pthread_mutex_unlock(&memory->m_lock);
+            break;
+        }
+        FILE* out = (memory->m_signum != 0) ? memory->m_out : 0;
+        pthread_mutex_unlock(&memory->m_lock);
+
+        if(out != 0)
+        {
+            memory->Dump(out);
+        }
+    }
+    return 0;
+}
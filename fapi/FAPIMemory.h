@@ -0,0 +1,238 @@
+/**
+ * @file FAPIMemory.h
+ *
+ * @date 21 June 2005
+ *
+ * @brief The FAPIMemory accounts the memory held by the tables, the link_B
+ *        arrays and the callback and response pools of the FAPI simulator.
+ *
+ * The FAPIMemory is a singleton. The tables and pools report each object
+ * they take into and out of use with Acquire() and Release(), and the
+ * memory they hold for later use with Reserve(). For every place it keeps
+ * the objects and bytes in use, their high water marks and the reserved
+ * bytes, which are read through NPF_F_ATM_ConfigMgr_MemoryGet() or written
+ * out as text by Dump(), on request or when the process receives a signal.
+ *
+ * Design Notes:
+ *    The counters of a place are updated with atomic adds and kept on a
+ *    cache line of their own, the tables update them under the shard locks
+ *    they already hold. A high water mark is only written when it is
+ *    passed, which stops happening once a workload reaches its steady
+ *    state. The counters have static storage and no destructor, so tables
+ *    and pools destroyed at exit can still release into them.
+ *
+ *    A signal handler may not write to a stream. The handler installed by
+ *    DumpOnSignal() posts a semaphore and a thread started the first time
+ *    a signal is set writes the dump.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __FAPIMEMORY_H_
+#define __FAPIMEMORY_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+
+class FAPIMemory
+{
+public:
+    virtual ~FAPIMemory();
+
+    static FAPIMemory& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Acquire(NPF_F_ATM_ConfigMgr_MemSite_t site, unsigned long long bytes)
+    *
+    * @brief Counts an object of 'bytes' bytes taken into use at 'site'.
+    *        Release() counts one taken out of use.
+    *
+    * @param site NPF_F_ATM_ConfigMgr_MemSite_t [in] - The place.
+    * @param bytes unsigned long long [in] - Size of the object.
+    *
+    * @return None
+    */
+    static void Acquire(NPF_F_ATM_ConfigMgr_MemSite_t site, unsigned long long bytes);
+    static void Release(NPF_F_ATM_ConfigMgr_MemSite_t site, unsigned long long bytes);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Reserve(NPF_F_ATM_ConfigMgr_MemSite_t site, long long bytes)
+    *
+    * @brief Adds 'bytes' to the memory held for 'site' but not in use, a
+    *        negative value takes it off.
+    *
+    * @return None
+    */
+    static void Reserve(NPF_F_ATM_ConfigMgr_MemSite_t site, long long bytes);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Get(NPF_F_ATM_ConfigMgr_MemSite_t site,
+    *         NPF_F_ATM_ConfigMgr_MemInfo_t* info)
+    *
+    * @brief Reads the counters of a place.
+    *
+    * @return bool - false if site is not valid or info is NULL.
+    */
+    bool Get(NPF_F_ATM_ConfigMgr_MemSite_t site, NPF_F_ATM_ConfigMgr_MemInfo_t* info);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Dump(FILE* out)
+    *
+    * @brief Writes the counters of every place and their totals as text.
+    *
+    * @param out FILE* [in] - Stream the counters are written to.
+    *
+    * @return None
+    */
+    void Dump(FILE* out);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ResetPeaks()
+    *
+    * @brief Sets the high water marks of every place to what is in use now.
+    *
+    * @return None
+    */
+    void ResetPeaks();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DumpOnSignal(int signum, FILE* out)
+    *
+    * @brief Writes Dump() to 'out' each time the process receives
+    *        'signum', in place of the signal given before.
+    *
+    * @param signum int [in] - The signal, 0 to stop dumping.
+    * @param out FILE* [in] - Stream the counters are written to.
+    *
+    * @return bool - false if the signal cannot be caught or the dump
+    *                thread could not be started.
+    */
+    bool DumpOnSignal(int signum, FILE* out);
+
+private:
+    FAPIMemory();
+    FAPIMemory(const FAPIMemory&);
+    FAPIMemory& operator =(const FAPIMemory&);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef memCounts
+    *
+    * @brief Typedef of the counters of one place. reservedBytes wraps
+    *        below zero while an add and its matching take are in flight.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long objects;
+        unsigned long long bytes;
+        unsigned long long peakObjects;
+        unsigned long long peakBytes;
+        unsigned long long reservedBytes;
+        unsigned long long allocs;
+        unsigned long long frees;
+    } __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE))) memCounts;
+
+    static void RaisePeak(unsigned long long& peak, unsigned long long value);
+    static void SignalHandler(int signum);
+    static void* DumpThread(void* arg);
+
+    /**
+    * FAPIMemory Member Variables.
+    *
+    * m_counts - Counters of each place.
+    *
+    * m_dumpSem - Posted by the signal handler to wake the dump thread.
+    *
+    * m_signum, m_out - Signal that dumps the counters and the stream they
+    *                   are written to, m_signum is 0 when none is set.
+    *
+    * m_previous - Action of m_signum before DumpOnSignal() replaced it.
+    *
+    * m_thread, m_threadStarted - The dump thread.
+    *
+    * m_stopping - Tells the dump thread to exit.
+    *
+    * m_lock - Guards the signal, the stream and m_stopping.
+    *
+    */
+    static memCounts m_counts[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    static sem_t m_dumpSem;
+    int m_signum;
+    FILE* m_out;
+    struct sigaction m_previous;
+    pthread_t m_thread;
+    bool m_threadStarted;
+    bool m_stopping;
+    pthread_mutex_t m_lock;
+};
+#endif // #if !defined __FAPIMEMORY_H_
+/**
+ *@}
+ */
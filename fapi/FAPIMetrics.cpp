@@ -0,0 +1,539 @@
+/**
+ * @file FAPIMetrics.cpp
+ *
+ * @date 13 June 2005
+ *
+ * @brief The FAPIMetrics keeps call counts, error counts, latency
+ *        histograms and lock contention counters for the FAPI entry points.
+ *
+ * Implementation of the per thread counters, the latency histograms and
+ * the text dump.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPIMetrics.h"
+
+/*
+ * System defined include files required.
+ */
+#include <string.h>
+#include <time.h>
+
+/*
+ * Counters of the calling thread, 0 until it first records a metric.
+ */
+static __thread void* t_metricsShard = 0;
+
+static const char* const metricNames[NPF_F_ATM_CONFIGMGR_METRIC_COUNT] =
+{
+    "IfSet",
+    "IfDelete",
+    "VcSet",
+    "VcLinkXcSet",
+    "CallbackDispatch",
+    "VcDelete",
+    "VcLinkXcDelete"
+};
+
+static const char* const lockNames[NPF_F_ATM_CONFIGMGR_LOCK_COUNT] =
+{
+    "TableIf",
+    "TableVc",
+    "TableXc",
+    "CallbackRegister",
+    "CallbackPool",
+    "Dispatch",
+    "Journal",
+    "ChangePublish"
+};
+
+FAPIMetrics::FAPIMetrics()
+{
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_METRICS_THREADS_MAX; x++)
+    {
+        m_shards[x] = 0;
+    }
+    memset(&m_overflow, 0, sizeof(m_overflow));
+    m_overflow.owned = 1;
+    memset(&m_baseline, 0, sizeof(m_baseline));
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES; x++)
+    {
+        m_errorCodes[x] = NPF_NO_ERROR;
+    }
+    pthread_key_create(&m_shardKey, ReleaseShard);
+    pthread_mutex_init(&m_attachLock, 0);
+}
+
+FAPIMetrics::~FAPIMetrics()
+{
+    // The counters are left allocated, threads that outlive static
+    // destruction may still be recording into them.
+}
+
+FAPIMetrics& FAPIMetrics::instance()
+{
+    // Singleton Pattern
+    static FAPIMetrics instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Now()
+ */
+unsigned long long FAPIMetrics::Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Function Definition: Shard()
+ */
+FAPIMetrics::metricsShard* FAPIMetrics::Shard()
+{
+    metricsShard* shard = static_cast<metricsShard*>(t_metricsShard);
+    if(shard == 0)
+    {
+        shard = instance().AttachShard();
+    }
+    return shard;
+}
+
+/**
+ * Function Definition: AttachShard()
+ */
+FAPIMetrics::metricsShard* FAPIMetrics::AttachShard()
+{
+    metricsShard* shard = &m_overflow;
+
+    pthread_mutex_lock(&m_attachLock);
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_METRICS_THREADS_MAX; x++)
+    {
+        if(m_shards[x] == 0)
+        {
+            m_shards[x] = new metricsShard;
+            memset(m_shards[x], 0, sizeof(metricsShard));
+            shard = m_shards[x];
+            break;
+        }
+        // The counters of an exited thread are carried on by this one.
+        if(__atomic_load_n(&m_shards[x]->owned, __ATOMIC_ACQUIRE) == 0)
+        {
+            shard = m_shards[x];
+            break;
+        }
+    }
+    if(shard != &m_overflow)
+    {
+        __atomic_store_n(&shard->owned, 1, __ATOMIC_RELEASE);
+        pthread_setspecific(m_shardKey, shard);
+    }
+    t_metricsShard = shard;
+    pthread_mutex_unlock(&m_attachLock);
+    return shard;
+}
+
+/**
+ * Function Definition: ReleaseShard(void* shard)
+ */
+void FAPIMetrics::ReleaseShard(void* shard)
+{
+    // Called as the owning thread exits, its counts are kept.
+    __atomic_store_n(&static_cast<metricsShard*>(shard)->owned, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Function Definition: Bucket(unsigned long long ns)
+ */
+unsigned int FAPIMetrics::Bucket(unsigned long long ns)
+{
+    if(ns < SUB_BUCKETS)
+    {
+        return (unsigned int)ns;
+    }
+    unsigned int msb = 63 - __builtin_clzll(ns);
+    if(msb >= _IX_CC_ATM_FAPI_METRICS_RANGE_BITS)
+    {
+        return BUCKETS - 1;
+    }
+    // The power of two picks the group of buckets, the bits below the
+    // highest set bit pick the bucket within it.
+    return ((msb - _IX_CC_ATM_FAPI_METRICS_SUB_BITS + 1) << _IX_CC_ATM_FAPI_METRICS_SUB_BITS) +
+           (unsigned int)((ns >> (msb - _IX_CC_ATM_FAPI_METRICS_SUB_BITS)) & (SUB_BUCKETS - 1));
+}
+
+/**
+ * Function Definition: BucketLow(unsigned int bucket)
+ */
+unsigned long long FAPIMetrics::BucketLow(unsigned int bucket)
+{
+    if(bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    unsigned int msb = (bucket >> _IX_CC_ATM_FAPI_METRICS_SUB_BITS) + _IX_CC_ATM_FAPI_METRICS_SUB_BITS - 1;
+    return (unsigned long long)(SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << (msb - _IX_CC_ATM_FAPI_METRICS_SUB_BITS);
+}
+
+/**
+ * Function Definition: RecordLatency(NPF_F_ATM_ConfigMgr_Metric_t metric, unsigned long long ns)
+ */
+void FAPIMetrics::RecordLatency(NPF_F_ATM_ConfigMgr_Metric_t metric, unsigned long long ns)
+{
+    metricCounts& counts = Shard()->counts.metrics[metric];
+    __atomic_fetch_add(&counts.calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counts.totalNs, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counts.buckets[Bucket(ns)], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Function Definition: EndCall(NPF_F_ATM_ConfigMgr_Metric_t metric,
+ *                              unsigned long long start, NPF_error_t result)
+ */
+NPF_error_t FAPIMetrics::EndCall(NPF_F_ATM_ConfigMgr_Metric_t metric, unsigned long long start, NPF_error_t result)
+{
+    RecordLatency(metric, Now() - start);
+    if(result != NPF_NO_ERROR)
+    {
+        unsigned int slot = instance().ErrorSlot(result);
+        __atomic_fetch_add(&Shard()->counts.metrics[metric].errors[slot], 1, __ATOMIC_RELAXED);
+    }
+    return result;
+}
+
+/**
+ * Function Definition: CountResponses(NPF_F_ATM_ConfigMgr_Metric_t metric,
+ *                                     const NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+ */
+void FAPIMetrics::CountResponses(NPF_F_ATM_ConfigMgr_Metric_t metric, const NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+{
+    metricCounts& counts = Shard()->counts.metrics[metric];
+    for(NPF_uint32_t x = 0; x < data.n_resp; x++)
+    {
+        if(data.resp[x].error != NPF_NO_ERROR)
+        {
+            unsigned int slot = instance().ErrorSlot(data.resp[x].error);
+            __atomic_fetch_add(&counts.errors[slot], 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * Function Definition: ErrorSlot(NPF_error_t code)
+ */
+unsigned int FAPIMetrics::ErrorSlot(NPF_error_t code)
+{
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES; x++)
+    {
+        NPF_error_t slotCode = __atomic_load_n(&m_errorCodes[x], __ATOMIC_ACQUIRE);
+        if(slotCode == NPF_NO_ERROR)
+        {
+            // A free slot, claim it unless another thread got there first.
+            if(__atomic_compare_exchange_n(&m_errorCodes[x], &slotCode, code, false,
+                                           __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == true)
+            {
+                return x;
+            }
+        }
+        if(slotCode == code)
+        {
+            return x;
+        }
+    }
+    return NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES;
+}
+
+/**
+ * Function Definition: CountLock(NPF_F_ATM_ConfigMgr_Lock_t id, bool contended, unsigned long long start)
+ */
+void FAPIMetrics::CountLock(NPF_F_ATM_ConfigMgr_Lock_t id, bool contended, unsigned long long start)
+{
+    lockCounts& counts = Shard()->counts.locks[id];
+    __atomic_fetch_add(&counts.acquired, 1, __ATOMIC_RELAXED);
+    if(contended == true)
+    {
+        __atomic_fetch_add(&counts.contended, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&counts.waitNs, Now() - start, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Function Definition: Lock(pthread_mutex_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+ */
+void FAPIMetrics::Lock(pthread_mutex_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+{
+    if(pthread_mutex_trylock(lock) == 0)
+    {
+        CountLock(id, false, 0);
+        return;
+    }
+    unsigned long long start = Now();
+    pthread_mutex_lock(lock);
+    CountLock(id, true, start);
+}
+
+/**
+ * Function Definition: ReadLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+ */
+void FAPIMetrics::ReadLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+{
+    if(pthread_rwlock_tryrdlock(lock) == 0)
+    {
+        CountLock(id, false, 0);
+        return;
+    }
+    unsigned long long start = Now();
+    pthread_rwlock_rdlock(lock);
+    CountLock(id, true, start);
+}
+
+/**
+ * Function Definition: WriteLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+ */
+void FAPIMetrics::WriteLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+{
+    if(pthread_rwlock_trywrlock(lock) == 0)
+    {
+        CountLock(id, false, 0);
+        return;
+    }
+    unsigned long long start = Now();
+    pthread_rwlock_wrlock(lock);
+    CountLock(id, true, start);
+}
+
+/**
+ * Function Definition: Sum(metricsTotals& totals)
+ */
+void FAPIMetrics::Sum(metricsTotals& totals)
+{
+    // Called with m_attachLock held. Every counter is a count, so the
+    // counters are added and subtracted as one flat array.
+    const unsigned int numCounters = sizeof(metricsTotals) / sizeof(unsigned long long);
+    unsigned long long* sum = reinterpret_cast<unsigned long long*>(&totals);
+    const unsigned long long* baseline = reinterpret_cast<const unsigned long long*>(&m_baseline);
+
+    for(unsigned int y = 0; y < numCounters; y++)
+    {
+        sum[y] = __atomic_load_n(&reinterpret_cast<unsigned long long*>(&m_overflow.counts)[y], __ATOMIC_RELAXED) - baseline[y];
+    }
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_METRICS_THREADS_MAX; x++)
+    {
+        if(m_shards[x] == 0)
+        {
+            break;
+        }
+        const unsigned long long* counters = reinterpret_cast<const unsigned long long*>(&m_shards[x]->counts);
+        for(unsigned int y = 0; y < numCounters; y++)
+        {
+            sum[y] += __atomic_load_n(&counters[y], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * Function Definition: Percentile(const metricCounts& counts, unsigned long long total,
+ *                                 unsigned long long parts, unsigned long long of)
+ */
+unsigned long long FAPIMetrics::Percentile(const metricCounts& counts, unsigned long long total,
+                                           unsigned long long parts, unsigned long long of)
+{
+    unsigned long long rank = (total * parts + of - 1) / of;
+    unsigned long long seen = 0;
+
+    if(rank == 0)
+    {
+        rank = 1;
+    }
+    for(unsigned int x = 0; x < BUCKETS; x++)
+    {
+        seen += counts.buckets[x];
+        if(seen >= rank)
+        {
+            // Highest value of the bucket, the open ended last bucket
+            // reports where it starts.
+            return (x == (BUCKETS - 1)) ? BucketLow(x) : (BucketLow(x + 1) - 1);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Function Definition: Fill(const metricCounts& counts, NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+ */
+void FAPIMetrics::Fill(const metricCounts& counts, NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+{
+    unsigned long long total = 0;
+
+    memset(info, 0, sizeof(NPF_F_ATM_ConfigMgr_MetricInfo_t));
+    info->calls = counts.calls;
+    info->totalNs = counts.totalNs;
+    for(unsigned int x = 0; x < BUCKETS; x++)
+    {
+        if(counts.buckets[x] != 0)
+        {
+            if(total == 0)
+            {
+                info->minNs = BucketLow(x);
+            }
+            total += counts.buckets[x];
+        }
+    }
+    if(total != 0)
+    {
+        info->p50Ns = Percentile(counts, total, 50, 100);
+        info->p90Ns = Percentile(counts, total, 90, 100);
+        info->p99Ns = Percentile(counts, total, 99, 100);
+        info->p999Ns = Percentile(counts, total, 999, 1000);
+        info->maxNs = Percentile(counts, total, 1, 1);
+    }
+
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES; x++)
+    {
+        if(counts.errors[x] != 0)
+        {
+            info->errors[info->numErrorCodes].code = __atomic_load_n(&m_errorCodes[x], __ATOMIC_ACQUIRE);
+            info->errors[info->numErrorCodes].count = counts.errors[x];
+            info->numErrorCodes++;
+        }
+    }
+    info->otherErrors = counts.errors[NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES];
+}
+
+/**
+ * Function Definition: Get(NPF_F_ATM_ConfigMgr_Metric_t metric,
+ *                          NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+ */
+bool FAPIMetrics::Get(NPF_F_ATM_ConfigMgr_Metric_t metric, NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+{
+    if(((unsigned int)metric >= NPF_F_ATM_CONFIGMGR_METRIC_COUNT)||(info == 0))
+    {
+        return false;
+    }
+    pthread_mutex_lock(&m_attachLock);
+    Sum(m_sum);
+    Fill(m_sum.metrics[metric], info);
+    pthread_mutex_unlock(&m_attachLock);
+    return true;
+}
+
+/**
+ * Function Definition: GetLock(NPF_F_ATM_ConfigMgr_Lock_t id,
+ *                              NPF_F_ATM_ConfigMgr_LockInfo_t* info)
+ */
+bool FAPIMetrics::GetLock(NPF_F_ATM_ConfigMgr_Lock_t id, NPF_F_ATM_ConfigMgr_LockInfo_t* info)
+{
+    if(((unsigned int)id >= NPF_F_ATM_CONFIGMGR_LOCK_COUNT)||(info == 0))
+    {
+        return false;
+    }
+    pthread_mutex_lock(&m_attachLock);
+    Sum(m_sum);
+    info->acquired = m_sum.locks[id].acquired;
+    info->contended = m_sum.locks[id].contended;
+    info->waitNs = m_sum.locks[id].waitNs;
+    pthread_mutex_unlock(&m_attachLock);
+    return true;
+}
+
+/**
+ * Function Definition: Dump(FILE* out)
+ */
+void FAPIMetrics::Dump(FILE* out)
+{
+    NPF_F_ATM_ConfigMgr_MetricInfo_t info;
+
+    pthread_mutex_lock(&m_attachLock);
+    Sum(m_sum);
+
+    fprintf(out, "%-18s %10s %10s %10s %10s %10s %10s %10s %10s\n", "metric", "calls", "errors",
+            "mean_ns", "p50_ns", "p90_ns", "p99_ns", "p999_ns", "max_ns");
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_METRIC_COUNT; x++)
+    {
+        Fill(m_sum.metrics[x], &info);
+        unsigned long long errors = info.otherErrors;
+        for(unsigned int y = 0; y < info.numErrorCodes; y++)
+        {
+            errors += info.errors[y].count;
+        }
+        fprintf(out, "%-18s %10llu %10llu %10llu %10llu %10llu %10llu %10llu %10llu\n", metricNames[x],
+                (unsigned long long)info.calls, errors,
+                (info.calls != 0) ? (unsigned long long)(info.totalNs / info.calls) : 0ULL,
+                (unsigned long long)info.p50Ns, (unsigned long long)info.p90Ns, (unsigned long long)info.p99Ns,
+                (unsigned long long)info.p999Ns, (unsigned long long)info.maxNs);
+        for(unsigned int y = 0; y < info.numErrorCodes; y++)
+        {
+            fprintf(out, "    error %u: %llu\n", (unsigned int)info.errors[y].code,
+                    (unsigned long long)info.errors[y].count);
+        }
+        if(info.otherErrors != 0)
+        {
+            fprintf(out, "    other errors: %llu\n", (unsigned long long)info.otherErrors);
+        }
+    }
+
+    fprintf(out, "%-18s %10s %10s %10s\n", "lock", "acquired", "contended", "wait_ns");
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_LOCK_COUNT; x++)
+    {
+        fprintf(out, "%-18s %10llu %10llu %10llu\n", lockNames[x], m_sum.locks[x].acquired,
+                m_sum.locks[x].contended, m_sum.locks[x].waitNs);
+    }
+    fflush(out);
+    pthread_mutex_unlock(&m_attachLock);
+}
+
+/**
+ * Function Definition: Reset()
+ */
+void FAPIMetrics::Reset()
+{
+    pthread_mutex_lock(&m_attachLock);
+    Sum(m_sum);
+    // m_sum is what has been counted since the last reset, moving the
+    // baseline up by it brings every read back to zero.
+    const unsigned int numCounters = sizeof(metricsTotals) / sizeof(unsigned long long);
+    unsigned long long* baseline = reinterpret_cast<unsigned long long*>(&m_baseline);
+    const unsigned long long* sum = reinterpret_cast<const unsigned long long*>(&m_sum);
+    for(unsigned int y = 0; y < numCounters; y++)
+    {
+        baseline[y] += sum[y];
+    }
+    pthread_mutex_unlock(&m_attachLock);
+}
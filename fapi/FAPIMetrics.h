@@ -0,0 +1,345 @@
+/**
+ * @file FAPIMetrics.h
+ *
+ * @date 13 June 2005
+ *
+ * @brief The FAPIMetrics keeps call counts, error counts, latency
+ *        histograms and lock contention counters for the FAPI entry points.
+ *
+ * The FAPIMetrics is a singleton. The entry points time every call and
+ * pass the result to EndCall(), completion callbacks are timed from the
+ * responses being ready to the callback function being called, and the
+ * locks on the configuration path are taken through Lock(), ReadLock() and
+ * WriteLock() so waiting for them is counted. The counters are read through
+ * NPF_F_ATM_ConfigMgr_MetricsGet() and NPF_F_ATM_ConfigMgr_LockMetricsGet(),
+ * or written out as text by Dump().
+ *
+ * Design Notes:
+ *    Every thread that records a metric is given its own set of counters
+ *    the first time it does, so recording touches no shared cache line and
+ *    takes no lock. The counters of a thread are kept when it exits and
+ *    reused by the next thread to attach. Reading adds up the counters of
+ *    every thread. Reset() does not clear the counters, which other threads
+ *    are still writing, but records their current sum as a baseline that is
+ *    taken off later reads.
+ *
+ *    Latencies are counted in a log linear histogram: values below
+ *    2^_IX_CC_ATM_FAPI_METRICS_SUB_BITS ns have a bucket each, every power
+ *    of two above that is split into 2^_IX_CC_ATM_FAPI_METRICS_SUB_BITS
+ *    buckets. A bucket is found from the position of the highest set bit,
+ *    with no search, and percentiles are read back to the width of a
+ *    bucket.
+ *
+ *    A lock is first tried without waiting, the clock is only read when
+ *    that fails.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __FAPIMETRICS_H_
+#define __FAPIMETRICS_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <stdio.h>
+
+class FAPIMetrics
+{
+public:
+    virtual ~FAPIMetrics();
+
+    static FAPIMetrics& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Now()
+    *
+    * @brief Monotonic time in nanoseconds, the start time of a call.
+    *
+    * @return unsigned long long
+    */
+    static unsigned long long Now();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn EndCall(NPF_F_ATM_ConfigMgr_Metric_t metric,
+    *             unsigned long long start, NPF_error_t result)
+    *
+    * @brief Counts a call of an entry point that started at 'start' and
+    *        returns 'result', so an entry point can end with
+    *        return EndCall(..).
+    *
+    * @param metric NPF_F_ATM_ConfigMgr_Metric_t [in] - The entry point.
+    * @param start unsigned long long [in] - Now() when the call started.
+    * @param result NPF_error_t [in] - Value returned by the call.
+    *
+    * @return NPF_error_t - result.
+    */
+    static NPF_error_t EndCall(NPF_F_ATM_ConfigMgr_Metric_t metric, unsigned long long start, NPF_error_t result);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn CountResponses(NPF_F_ATM_ConfigMgr_Metric_t metric,
+    *                    const NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+    *
+    * @brief Counts the error of every failed entry of a batch.
+    *
+    * @param metric NPF_F_ATM_ConfigMgr_Metric_t [in] - The entry point.
+    * @param data const NPF_F_ATM_ConfigMgr_CallbackData_t& [in] - The
+    *                                                               responses.
+    *
+    * @return None
+    */
+    static void CountResponses(NPF_F_ATM_ConfigMgr_Metric_t metric, const NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn RecordLatency(NPF_F_ATM_ConfigMgr_Metric_t metric,
+    *                   unsigned long long ns)
+    *
+    * @brief Counts a call that took 'ns' nanoseconds.
+    *
+    * @return None
+    */
+    static void RecordLatency(NPF_F_ATM_ConfigMgr_Metric_t metric, unsigned long long ns);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Lock(pthread_mutex_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id)
+    *
+    * @brief pthread_mutex_lock() that counts waiting for the lock against
+    *        'id'. ReadLock() and WriteLock() do the same for a
+    *        reader/writer lock.
+    *
+    * @return None
+    */
+    static void Lock(pthread_mutex_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id);
+    static void ReadLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id);
+    static void WriteLock(pthread_rwlock_t* lock, NPF_F_ATM_ConfigMgr_Lock_t id);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Get(NPF_F_ATM_ConfigMgr_Metric_t metric,
+    *         NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+    *
+    * @brief Adds up the counters of an entry point over every thread.
+    *
+    * @return bool - false if metric is not valid.
+    */
+    bool Get(NPF_F_ATM_ConfigMgr_Metric_t metric, NPF_F_ATM_ConfigMgr_MetricInfo_t* info);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn GetLock(NPF_F_ATM_ConfigMgr_Lock_t id,
+    *             NPF_F_ATM_ConfigMgr_LockInfo_t* info)
+    *
+    * @brief Adds up the counters of a lock over every thread.
+    *
+    * @return bool - false if id is not valid.
+    */
+    bool GetLock(NPF_F_ATM_ConfigMgr_Lock_t id, NPF_F_ATM_ConfigMgr_LockInfo_t* info);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Dump(FILE* out)
+    *
+    * @brief Writes every entry point and lock counter as text.
+    *
+    * @param out FILE* [in] - Stream the counters are written to.
+    *
+    * @return None
+    */
+    void Dump(FILE* out);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Reset()
+    *
+    * @brief Starts every counter again from zero.
+    *
+    * @return None
+    */
+    void Reset();
+
+private:
+    FAPIMetrics();
+    FAPIMetrics(const FAPIMetrics&);
+    FAPIMetrics& operator =(const FAPIMetrics&);
+
+    enum
+    {
+        SUB_BUCKETS = (1 << _IX_CC_ATM_FAPI_METRICS_SUB_BITS),
+        BUCKETS = ((_IX_CC_ATM_FAPI_METRICS_RANGE_BITS - _IX_CC_ATM_FAPI_METRICS_SUB_BITS + 1) << _IX_CC_ATM_FAPI_METRICS_SUB_BITS),
+        // Errors past the first NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES
+        // codes are counted in the last slot.
+        ERROR_SLOTS = (NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES + 1)
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef metricCounts
+    *
+    * @brief Typedef of the counters of one entry point. errors is indexed
+    *        by the slot of the error code in m_errorCodes.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long calls;
+        unsigned long long totalNs;
+        unsigned long long errors[ERROR_SLOTS];
+        unsigned long long buckets[BUCKETS];
+    } metricCounts;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef lockCounts
+    *
+    * @brief Typedef of the counters of one lock.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long acquired;
+        unsigned long long contended;
+        unsigned long long waitNs;
+    } lockCounts;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef metricsTotals
+    *
+    * @brief Typedef of every counter, of one thread or added up.
+    *
+    */
+    typedef struct
+    {
+        metricCounts metrics[NPF_F_ATM_CONFIGMGR_METRIC_COUNT];
+        lockCounts locks[NPF_F_ATM_CONFIGMGR_LOCK_COUNT];
+    } metricsTotals;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef metricsShard
+    *
+    * @brief Typedef of the counters of a thread. Only the owning thread
+    *        adds to counts, except in m_overflow which every thread that
+    *        could not be given counters of its own shares.
+    *
+    */
+    typedef struct
+    {
+        metricsTotals counts;
+        unsigned int owned;
+    } metricsShard;
+
+    static metricsShard* Shard();
+    static void ReleaseShard(void* shard);
+    static unsigned int Bucket(unsigned long long ns);
+    static unsigned long long BucketLow(unsigned int bucket);
+    static void CountLock(NPF_F_ATM_ConfigMgr_Lock_t id, bool contended, unsigned long long start);
+    static unsigned long long Percentile(const metricCounts& counts, unsigned long long total,
+                                         unsigned long long parts, unsigned long long of);
+
+    metricsShard* AttachShard();
+    unsigned int ErrorSlot(NPF_error_t code);
+    void Sum(metricsTotals& totals);
+    void Fill(const metricCounts& counts, NPF_F_ATM_ConfigMgr_MetricInfo_t* info);
+
+    /**
+    * FAPIMetrics Member Variables.
+    *
+    * m_shards - Counters of each thread, allocated the first time a thread
+    *            records a metric.
+    *
+    * m_overflow - Counters shared by threads beyond
+    *              _IX_CC_ATM_FAPI_METRICS_THREADS_MAX.
+    *
+    * m_baseline - Sum of the counters at the last Reset().
+    *
+    * m_sum - Counters added up by the last read, guarded by m_attachLock.
+    *
+    * m_errorCodes - Error code counted in each error slot, NPF_NO_ERROR
+    *                while the slot is free.
+    *
+    * m_shardKey - Thread specific key whose destructor releases the
+    *              counters of an exiting thread.
+    *
+    * m_attachLock - Serialises attaching counters, reading and Reset().
+    *
+    */
+    metricsShard* m_shards[_IX_CC_ATM_FAPI_METRICS_THREADS_MAX];
+    metricsShard m_overflow;
+    metricsTotals m_baseline;
+    metricsTotals m_sum;
+    NPF_error_t m_errorCodes[NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES];
+    pthread_key_t m_shardKey;
+    pthread_mutex_t m_attachLock;
+};
+#endif // #if !defined __FAPIMETRICS_H_
+/**
+ *@}
+ */
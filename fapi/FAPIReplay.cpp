@@ -0,0 +1,202 @@
+/**
+ * @file FAPIReplay.cpp
+ *
+ * @date 3 June 2005
+ *
+ * @brief Rebuilds the TableManager tables from a snapshot and a change
+ *        journal.
+ *
+ * The tables are loaded from the snapshot, if one is given, and the
+ * changes of the journal that follow it are applied on top. The result can
+ * be written out as a new snapshot, which then replaces both files, or
+ * printed. With --list the journal is printed change by change instead,
+ * for auditing, and nothing is applied.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "TableManager.h"
+#include "TableJournal.h"
+#include "FAPIDefs.h"
+
+/*
+ * System defined include files required.
+ */
+#include <stdio.h>
+#include <string.h>
+
+static bool ListChange(const TableChange& change, void* context)
+{
+    FILE* out = static_cast<FILE*>(context);
+    switch(change.type)
+    {
+        case TABLE_CHANGE_IF_ADD:
+            fprintf(out, "%llu IfAdd ifID %u ifType %u\n", change.sequence,
+                    (unsigned int)change.u.ifCfg.ifID, (unsigned int)change.u.ifCfg.ifType);
+        break;
+        case TABLE_CHANGE_IF_DELETE:
+            fprintf(out, "%llu IfDelete ifID %u delContainedObjs %u\n", change.sequence,
+                    (unsigned int)change.u.ifDelete.ifId, (unsigned int)change.u.ifDelete.delContainedObjs);
+        break;
+        case TABLE_CHANGE_VC_ADD:
+            fprintf(out, "%llu VcAdd vcLinkId %u ifId %u vpi %u vci %u\n", change.sequence,
+                    (unsigned int)change.u.vcCfg.vcLinkId, (unsigned int)change.u.vcCfg.ifId,
+                    (unsigned int)change.u.vcCfg.vc.vpi, (unsigned int)change.u.vcCfg.vc.vci);
+        break;
+        case TABLE_CHANGE_XC_ADD:
+            fprintf(out, "%llu XcAdd vcXcId %u link_A %u link_B %u xcType %u\n", change.sequence,
+                    (unsigned int)change.u.xcLeg.leg.vcXcId, (unsigned int)change.u.xcLeg.link_A,
+                    (unsigned int)change.u.xcLeg.leg.u.mapVcLink, (unsigned int)change.u.xcLeg.leg.xcType);
+        break;
+        case TABLE_CHANGE_VC_DELETE:
+            fprintf(out, "%llu VcDelete vcLinkId %u ifId %u\n", change.sequence,
+                    (unsigned int)change.u.vcCfg.vcLinkId, (unsigned int)change.u.vcCfg.ifId);
+        break;
+        case TABLE_CHANGE_XC_DELETE:
+            fprintf(out, "%llu XcDelete vcXcId %u link_A %u link_B %u\n", change.sequence,
+                    (unsigned int)change.u.xcLeg.leg.vcXcId, (unsigned int)change.u.xcLeg.link_A,
+                    (unsigned int)change.u.xcLeg.leg.u.mapVcLink);
+        break;
+    }
+    return true;
+}
+
+static void Summary(FILE* out)
+{
+    TableManager::VCInfo vcs[256];
+    unsigned int cursor = 0;
+    unsigned int numVCs = 0;
+    unsigned int numLegs = 0;
+    while(cursor != _IX_CC_ATM_FAPI_QUERY_END)
+    {
+        unsigned int found = TableManager::instance().QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, vcs, 256);
+        for(unsigned int x = 0; x < found; x++)
+        {
+            if(vcs[x].xcRole == TableManager::VC_XC_ROOT)
+            {
+                numLegs += vcs[x].numLegs;
+            }
+        }
+        numVCs += found;
+    }
+    fprintf(out, "tables at change %llu: %u VCs, %u cross connect legs\n",
+            TableJournal::instance().GetSequence(), numVCs, numLegs);
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+            "usage: fapi_replay [--snapshot FILE] [--journal FILE] [--save FILE] [--dump]\n"
+            "       fapi_replay --list --journal FILE\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* snapshot = 0;
+    const char* journal = 0;
+    const char* save = 0;
+    bool list = false;
+    bool dump = false;
+
+    for(int x = 1; x < argc; x++)
+    {
+        if((strcmp(argv[x], "--snapshot") == 0)&&(x + 1 < argc))
+        {
+            snapshot = argv[++x];
+        }else if((strcmp(argv[x], "--journal") == 0)&&(x + 1 < argc))
+        {
+            journal = argv[++x];
+        }else if((strcmp(argv[x], "--save") == 0)&&(x + 1 < argc))
+        {
+            save = argv[++x];
+        }else if(strcmp(argv[x], "--list") == 0)
+        {
+            list = true;
+        }else if(strcmp(argv[x], "--dump") == 0)
+        {
+            dump = true;
+        }else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    if(list == true)
+    {
+        if(journal == 0)
+        {
+            Usage();
+            return 1;
+        }
+        return (TableJournal::Read(journal, ListChange, stdout) == true) ? 0 : 1;
+    }
+    if((snapshot == 0)&&(journal == 0))
+    {
+        Usage();
+        return 1;
+    }
+
+    TableManager& tables = TableManager::instance();
+    if((snapshot != 0)&&(tables.RestoreSnapshot(snapshot) == false))
+    {
+        fprintf(stderr, "fapi_replay: cannot load snapshot %s\n", snapshot);
+        return 1;
+    }
+    if((journal != 0)&&(tables.ReplayJournal(journal) == false))
+    {
+        fprintf(stderr, "fapi_replay: cannot replay journal %s\n", journal);
+        return 1;
+    }
+
+    Summary(stdout);
+    if(dump == true)
+    {
+        tables.printIf();
+        tables.printVc();
+        tables.printXc();
+    }
+    if((save != 0)&&(tables.SaveSnapshot(save) == false))
+    {
+        fprintf(stderr, "fapi_replay: cannot write snapshot %s\n", save);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file LinkBPool.cpp
+ *
+ * @date 27 May 2005
+ *
+ * @brief The LinkBPool supplies the link B arrays of point to multipoint
+ *        cross connect roots.
+ *
+ * Implementation of the size classed link B array free lists.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "LinkBPool.h"
+#include "FAPIMemory.h"
+#include "TraceMacro.h"
+
+LinkBPool::LinkBPool()
+{
+}
+
+LinkBPool::~LinkBPool()
+{
+    for(unsigned int x = LINKB_CLASS_MIN; x <= LINKB_CLASS_MAX; x++)
+    {
+        FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_LINK_B,
+                            -(long long)(m_free[x].size() * (1U << x) * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t)));
+    }
+    for(unsigned int x = 0; x < m_blocks.size(); x++)
+    {
+        delete [] m_blocks[x];
+    }
+}
+
+/**
+ * Function Definition: Capacity(unsigned int numLegs)
+ */
+unsigned int LinkBPool::Capacity(unsigned int numLegs)
+{
+    if(numLegs > _IX_CC_ATM_FAPI_XC_LEGS_MAX)
+    {
+        return 0;
+    }
+    unsigned int capacity = LINKB_CLASS_MIN;
+    while(capacity < numLegs)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * Function Definition: ClassIndex(unsigned int capacity)
+ */
+unsigned int LinkBPool::ClassIndex(unsigned int capacity)
+{
+    return __builtin_ctz(capacity);
+}
+
+/**
+ * Function Definition: Acquire(unsigned int numLegs)
+ */
+NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* LinkBPool::Acquire(unsigned int numLegs)
+{
+    unsigned int capacity = Capacity(numLegs);
+    if(capacity == 0)
+    {
+        APISimTrace(1,"Trace Level 1: LinkBPool::Acquire(%d) - Too Many Legs!\n",numLegs);
+        return 0;
+    }
+
+    vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t*>& freeList = m_free[ClassIndex(capacity)];
+    if(freeList.empty() == true)
+    {
+        APISimTrace(2,"Trace Level 2: LinkBPool::Acquire(%d) - Growing Class %d!\n",numLegs,capacity);
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* block = new NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t[capacity * _IX_CC_ATM_FAPI_LINKB_POOL_GROW];
+        m_blocks.push_back(block);
+        for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_LINKB_POOL_GROW; x++)
+        {
+            freeList.push_back(&block[x * capacity]);
+        }
+        FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_LINK_B,
+                            capacity * _IX_CC_ATM_FAPI_LINKB_POOL_GROW * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t));
+    }
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs = freeList.back();
+    freeList.pop_back();
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_LINK_B, -(long long)(capacity * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t)));
+    FAPIMemory::Acquire(NPF_F_ATM_CONFIGMGR_MEM_LINK_B, capacity * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t));
+    return legs;
+}
+
+/**
+ * Function Definition: Release(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs,
+ *                              unsigned int capacity)
+ */
+void LinkBPool::Release(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs, unsigned int capacity)
+{
+    if(legs == 0)
+    {
+        return;
+    }
+    m_free[ClassIndex(capacity)].push_back(legs);
+    FAPIMemory::Release(NPF_F_ATM_CONFIGMGR_MEM_LINK_B, capacity * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t));
+    FAPIMemory::Reserve(NPF_F_ATM_CONFIGMGR_MEM_LINK_B, (long long)(capacity * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t)));
+}
@@ -0,0 +1,159 @@
+/**
+ * @file LinkBPool.h
+ *
+ * @date 27 May 2005
+ *
+ * @brief The LinkBPool supplies the link B arrays of point to multipoint
+ *        cross connect roots.
+ *
+ * A VC that is the root (link A) of a cross connect lists every leg in its
+ * link_B array. A root with a single leg, and every leaf VC, keeps that array
+ * inline in its TableManager record. Roots with more legs take their array
+ * from a LinkBPool.
+ *
+ * Design Notes:
+ *    Arrays are handed out in power of two size classes from 2 up to
+ *    _IX_CC_ATM_FAPI_XC_LEGS_MAX legs. Each class has its own free list.
+ *    When a free list is empty, _IX_CC_ATM_FAPI_LINKB_POOL_GROW arrays of
+ *    that class are allocated in one block, and blocks are only returned
+ *    to the heap when the pool is destroyed. The pool does no locking, its
+ *    owner serialises access to it.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __LINKBPOOL_H_
+#define __LINKBPOOL_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <vector>
+using namespace std;
+
+class LinkBPool
+{
+public:
+    LinkBPool();
+    virtual ~LinkBPool();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Capacity(unsigned int numLegs)
+    *
+    * @brief Number of legs held by the array Acquire(numLegs) returns.
+    *
+    * @return unsigned int - 0 if numLegs is above
+    *                        _IX_CC_ATM_FAPI_XC_LEGS_MAX.
+    */
+    static unsigned int Capacity(unsigned int numLegs);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Acquire(unsigned int numLegs)
+    *
+    * @brief Returns an array of at least numLegs legs.
+    *
+    * @param numLegs unsigned int [in] - Number of legs the array must
+    *                                      hold, at most
+    *                                      _IX_CC_ATM_FAPI_XC_LEGS_MAX.
+    *
+    * @return NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* - 0 if numLegs is too
+    *                                               large.
+    */
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* Acquire(unsigned int numLegs);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Release(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs,
+    *             unsigned int capacity)
+    *
+    * @brief Returns an array obtained from Acquire().
+    *
+    * @param legs NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* [in] - The array.
+    * @param capacity unsigned int [in] - Capacity() of the array.
+    *
+    * @return None
+    */
+    void Release(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs, unsigned int capacity);
+
+private:
+    LinkBPool(const LinkBPool&);
+    LinkBPool& operator =(const LinkBPool&);
+
+    enum
+    {
+        LINKB_CLASS_MIN = 2,
+        LINKB_CLASS_MAX = 16
+    };
+
+    // Size classes are held in an array indexed by log2 of the class.
+    typedef char LegsMaxCheck[(_IX_CC_ATM_FAPI_XC_LEGS_MAX <= (1 << LINKB_CLASS_MAX)) ? 1 : -1];
+
+    static unsigned int ClassIndex(unsigned int capacity);
+
+    /**
+    * LinkBPool Member Variables.
+    *
+    * m_free - Stack of unused arrays for each size class.
+    *
+    * m_blocks - Blocks allocated for the arrays, freed with the pool.
+    *
+    */
+    vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t*> m_free[LINKB_CLASS_MAX + 1];
+    vector<NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t*> m_blocks;
+};
+#endif // #if !defined __LINKBPOOL_H_
+/**
+ *@}
+ */
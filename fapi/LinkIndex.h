@@ -0,0 +1,140 @@
+/**
+ * @file LinkIndex.h
+ *
+ * @date 20 June 2005
+ *
+ * @brief The LinkIndex maps VC link IDs straight to the records that hold
+ *        them.
+ *
+ * A cross connect names its VCs by link ID only, and setting one up or
+ * tearing it down looks up the root and every leaf, some of them more than
+ * once. The LinkIndex keeps a pointer to the record of every VC link ID
+ * below _IX_CC_ATM_FAPI_VC_HANDLE_MAX, so each of those lookups is a single
+ * array access whichever table backend holds the records.
+ *
+ * Design Notes:
+ *    The index takes no lock. The entry of an ID is set and cleared by the
+ *    TableManager while it holds the write lock of the shard the record is
+ *    in, and only read by a caller that holds a lock on that shard, see
+ *    TableManager::FindVC(). The records must not move while they are
+ *    indexed, which holds for both table backends as their records stay in
+ *    place until they are erased. IDs past the index are left to the
+ *    tables, Covers() tells the two apart.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __LINKINDEX_H_
+#define __LINKINDEX_H_
+
+/**
+ * User defined include files required.
+ */
+#include "FAPIDefs.h"
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Direct index from link ID to record.
+ */
+template<class Record>
+class LinkIndex
+{
+public:
+    LinkIndex()
+    {
+        for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_VC_HANDLE_MAX; x++)
+        {
+            m_records[x] = 0;
+        }
+    }
+
+    ~LinkIndex()
+    {
+    }
+
+    /**
+     * True if the record of 'key' is kept in the index.
+     */
+    bool Covers(unsigned int key) const
+    {
+        return (key < _IX_CC_ATM_FAPI_VC_HANDLE_MAX);
+    }
+
+    /**
+     * Record of 'key', or 0. 'key' must be covered by the index.
+     */
+    Record* Find(unsigned int key) const
+    {
+        return m_records[key];
+    }
+
+    void Set(unsigned int key, Record* record)
+    {
+        if(key < _IX_CC_ATM_FAPI_VC_HANDLE_MAX)
+        {
+            m_records[key] = record;
+        }
+    }
+
+    void Clear(unsigned int key)
+    {
+        Set(key, 0);
+    }
+
+private:
+    LinkIndex(const LinkIndex&);
+    LinkIndex& operator =(const LinkIndex&);
+
+    /**
+    * LinkIndex Member Variables.
+    *
+    * m_records - Record of every indexed ID, 0 when the ID is free.
+    *
+    */
+    Record* m_records[_IX_CC_ATM_FAPI_VC_HANDLE_MAX];
+};
+#endif // #if !defined __LINKINDEX_H_
+/**
+ *@}
+ */
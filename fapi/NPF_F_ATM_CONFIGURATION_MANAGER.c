@@ -49,12 +49,23 @@
  */
 #include "npf.h"
 #include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
 #include "CallBackManager.h"
 #include "TableManager.h"
+#include "TableJournal.h"
+#include "ChangeNotifier.h"
 #include "CallBackHandler.h"
+#include "CallBackPool.h"
+#include "FAPIMetrics.h"
+#include "FAPIMemory.h"
 #include "TraceMacro.h"
 #include "FAPIDefs.h"
 
+/*
+ * System defined include files required.
+ */
+#include <string.h>
+
 
 
 /*
@@ -117,7 +128,443 @@ NPF_error_t NPF_F_ATM_ConfigMgr_Deregister(
 
     return returnValue;    
 }
+
+/*
+ * Function definition: NPF_F_ATM_ConfigMgr_SetBatchMode(
+ *                          NPF_callbackHandle_t callbackHandle,
+ *                          NPF_F_ATM_ConfigMgr_BatchMode_t batchMode).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SetBatchMode(
+    NPF_IN NPF_callbackHandle_t callbackHandle,
+    NPF_IN NPF_F_ATM_ConfigMgr_BatchMode_t batchMode)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_SetBatchMode(%d,%d)\n",callbackHandle,batchMode);
+    
+    if((batchMode != NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL)&&(batchMode != NPF_F_ATM_CONFIGMGR_BATCH_STRICT))
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_SetBatchMode - Batch Mode Invalid!\n");
+        return NPF_E_UNKNOWN;
+    }
+    
+    NPF_error_t returnValue = CallBackManager::instance().SetBatchMode(callbackHandle, batchMode);
+
+    return returnValue;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_SnapshotSave(const char* path).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SnapshotSave(
+    NPF_IN const char* path)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_SnapshotSave(%s)\n",(path != NULL) ? path : "NULL");
+    
+    if(path == NULL)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_SnapshotSave - Path = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    
+    if(TableManager::instance().SaveSnapshot(path) == false)
+    {
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_SnapshotRestore(const char* path).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SnapshotRestore(
+    NPF_IN const char* path)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_SnapshotRestore(%s)\n",(path != NULL) ? path : "NULL");
+    
+    if(path == NULL)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_SnapshotRestore - Path = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    
+    if(TableManager::instance().RestoreSnapshot(path) == false)
+    {
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_JournalOpen(const char* path).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalOpen(
+    NPF_IN const char* path)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_JournalOpen(%s)\n",(path != NULL) ? path : "NULL");
+    
+    if(path == NULL)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_JournalOpen - Path = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    
+    if(TableJournal::instance().Open(path) == false)
+    {
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_JournalFlush().
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalFlush(void)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_JournalFlush()\n");
+    
+    if(TableJournal::instance().Flush() == false)
+    {
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_JournalClose().
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalClose(void)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_JournalClose()\n");
+    
+    TableJournal::instance().Close();
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_JournalReplay(const char* path).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalReplay(
+    NPF_IN const char* path)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_JournalReplay(%s)\n",(path != NULL) ? path : "NULL");
+    
+    if(path == NULL)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_JournalReplay - Path = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    
+    if(TableManager::instance().ReplayJournal(path) == false)
+    {
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_ChangeSubscribe(
+ *                          NPF_userContext_t userContext,
+ *                          NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+ *                          NPF_uint32_t changeMask,
+ *                          NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+ *                          NPF_uint32_t queueDepth,
+ *                          NPF_callbackHandle_t* eventHandle).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_ChangeSubscribe(
+    NPF_IN NPF_userContext_t userContext,
+    NPF_IN NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+    NPF_IN NPF_uint32_t changeMask,
+    NPF_IN NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+    NPF_IN NPF_uint32_t queueDepth,
+    NPF_OUT NPF_callbackHandle_t* eventHandle)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_ChangeSubscribe(%p,..,0x%x,%d,%d,..)\n",userContext,changeMask,policy,queueDepth);
+    
+    return ChangeNotifier::instance().Subscribe(userContext, changeFunc, changeMask, policy, queueDepth, eventHandle);
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_ChangeUnsubscribe(
+ *                          NPF_callbackHandle_t eventHandle).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_ChangeUnsubscribe(
+    NPF_IN NPF_callbackHandle_t eventHandle)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_ChangeUnsubscribe(%d)\n",eventHandle);
+    
+    return ChangeNotifier::instance().Unsubscribe(eventHandle);
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_RespHold(
+ *                          NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_RespHold(
+    NPF_IN NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_RespHold(%p)\n",resp);
+    
+    if(CallBackPool::instance().HoldResp(resp) == false)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_RespHold - Resp = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_RespRelease(
+ *                          NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_RespRelease(
+    NPF_IN NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_RespRelease(%p)\n",resp);
+    
+    if(resp == NULL)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_RespRelease - Resp = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    CallBackPool::instance().ReleaseResp(resp);
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_CallbackFence(
+ *                          NPF_callbackHandle_t cbHandle,
+ *                          NPF_correlator_t cbCorrelator).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_CallbackFence(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_CallbackFence(%d,%d)\n",cbHandle,cbCorrelator);
+    
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_CallbackFence - Invalid Callback Handle!\n");
+        return NPF_E_BAD_CALLBACK_HANDLE;
+    }
+    
+    // Goes through the same path as the responses of a FAPI call, so it is
+    // delivered after them in every callback mode.
+    NPF_F_ATM_ConfigMgr_CallbackData_t data;
+    memset(&data, 0, sizeof(data));
+    data.allOK = NPF_TRUE;
+    CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MetricsGet(
+ *                          NPF_F_ATM_ConfigMgr_Metric_t metric,
+ *                          NPF_F_ATM_ConfigMgr_MetricInfo_t* info).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_Metric_t metric,
+    NPF_OUT NPF_F_ATM_ConfigMgr_MetricInfo_t* info)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MetricsGet(%d,..)\n",metric);
+    
+    if(FAPIMetrics::instance().Get(metric, info) == false)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_MetricsGet - Metric Invalid or Info = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_LockMetricsGet(
+ *                          NPF_F_ATM_ConfigMgr_Lock_t lock,
+ *                          NPF_F_ATM_ConfigMgr_LockInfo_t* info).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_LockMetricsGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_Lock_t lock,
+    NPF_OUT NPF_F_ATM_ConfigMgr_LockInfo_t* info)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_LockMetricsGet(%d,..)\n",lock);
+    
+    if(FAPIMetrics::instance().GetLock(lock, info) == false)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_LockMetricsGet - Lock Invalid or Info = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MetricsDump(FILE* out).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsDump(
+    NPF_IN FILE* out)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MetricsDump(%p)\n",out);
+    
+    FAPIMetrics::instance().Dump((out != NULL) ? out : stdout);
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MetricsReset().
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsReset(void)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MetricsReset()\n");
+    
+    FAPIMetrics::instance().Reset();
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MemoryGet(
+ *                          NPF_F_ATM_ConfigMgr_MemSite_t site,
+ *                          NPF_F_ATM_ConfigMgr_MemInfo_t* info).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_MemSite_t site,
+    NPF_OUT NPF_F_ATM_ConfigMgr_MemInfo_t* info)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MemoryGet(%d,..)\n",site);
+    
+    if(FAPIMemory::instance().Get(site, info) == false)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_MemoryGet - Site Invalid or Info = Null!\n");
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MemoryDump(FILE* out).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryDump(
+    NPF_IN FILE* out)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MemoryDump(%p)\n",out);
+    
+    FAPIMemory::instance().Dump((out != NULL) ? out : stdout);
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MemoryResetPeaks().
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryResetPeaks(void)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MemoryResetPeaks()\n");
+    
+    FAPIMemory::instance().ResetPeaks();
+    return NPF_NO_ERROR;
+}
+
+/**
+ * Function definition: NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(int signum,
+ *                                                             FILE* out).
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(
+    NPF_IN int signum,
+    NPF_IN FILE* out)
+{
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(%d,%p)\n",signum,out);
+    
+    if(FAPIMemory::instance().DumpOnSignal(signum, (out != NULL) ? out : stderr) == false)
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal - Signal Cannot Be Set!\n");
+        return NPF_E_UNKNOWN;
+    }
+    return NPF_NO_ERROR;
+}
   
+/**
+ * Function Definition: ApplyBatch(
+ *                         NPF_F_ATM_ConfigMgr_Metric_t metric,
+ *                         unsigned long long   start,
+ *                         NPF_callbackHandle_t cbHandle,
+ *                         NPF_correlator_t     cbCorrelator,
+ *                         NPF_errorReporting_t errorReporting,
+ *                         NPF_uint32_t         numEntries,
+ *                         Entry                *entries,
+ *                         Apply                apply)
+ *
+ * Applies the entries of a batched call with apply(entries, numEntries, 
+ * data, strict), which returns false if an entry was rejected. The whole
+ * batch is applied by one TableManager call under one set of table locks,
+ * so other clients see either none or all of it. Only the responses are 
+ * split, a large number of them is passed to the client a chunk at a time
+ * so no invocation holds more than the response chunk size. A strict batch
+ * is reported in one piece.
+ */
+template<typename Entry, typename Apply>
+static NPF_error_t ApplyBatch(
+    NPF_F_ATM_ConfigMgr_Metric_t metric,
+    unsigned long long   start,
+    NPF_callbackHandle_t cbHandle,
+    NPF_correlator_t     cbCorrelator,
+    NPF_errorReporting_t errorReporting,
+    NPF_uint32_t         numEntries,
+    Entry                *entries,
+    Apply                apply)
+{
+    bool strict = (CallBackManager::instance().GetBatchMode(cbHandle) == NPF_F_ATM_CONFIGMGR_BATCH_STRICT);
+    NPF_F_ATM_ConfigMgr_CallbackData_t data;
+    
+    // Initialise callback data structure
+    data.resp = CallBackPool::instance().AcquireResp(numEntries);
+    
+    bool error = apply(entries, numEntries, data, strict);
+    if(error == false)
+    {
+        FAPIMetrics::CountResponses(metric, data);
+    }
+    
+    // Trigger a callback to the registered client callback function,
+    // as requested by errorReporting.
+    NPF_uint32_t chunkSize = strict ? data.n_resp : CallBackHandler::instance().GetResponseChunkSize(data.n_resp);
+    if(chunkSize >= data.n_resp)
+    {
+        CallBackHandler::instance().Respond(cbHandle, cbCorrelator, errorReporting, data, error);
+        return FAPIMetrics::EndCall(metric, start, NPF_NO_ERROR);
+    }
+    
+    // Each chunk gets a response buffer of its own, as the client may hold 
+    // the buffer of one chunk and release the others.
+    NPF_F_ATM_ConfigMgr_CallbackData_t chunk = data;
+    for(NPF_uint32_t offset = 0; offset < data.n_resp; offset += chunkSize)
+    {
+        chunk.n_resp = ((data.n_resp - offset) < chunkSize) ? (data.n_resp - offset) : chunkSize;
+        chunk.resp = CallBackPool::instance().AcquireResp(chunk.n_resp);
+        memcpy(chunk.resp, &data.resp[offset], chunk.n_resp * sizeof(NPF_F_ATM_ConfigMgr_AsyncResponse_t));
+        chunk.allOK = NPF_TRUE;
+        for(NPF_uint32_t x = 0; x < chunk.n_resp; x++)
+        {
+            if(chunk.resp[x].error != NPF_NO_ERROR)
+            {
+                chunk.allOK = NPF_FALSE;
+                break;
+            }
+        }
+        CallBackHandler::instance().Respond(cbHandle, cbCorrelator, errorReporting, chunk, chunk.allOK == NPF_TRUE);
+    }
+    CallBackPool::instance().ReleaseResp(data.resp);
+    
+    return FAPIMetrics::EndCall(metric, start, NPF_NO_ERROR);
+}
+
 /**
  * Function Definition: NPF_F_ATM_ConfigMgr_IfSet(
  *                         NPF_callbackHandle_t cbHandle,
@@ -140,60 +587,34 @@ NPF_error_t NPF_F_ATM_ConfigMgr_IfSet(
     APISimTrace(3,"\n\n");
     APISimTrace(3,"START OF A FAPI CALL THREAD\n");
     APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_IfSet(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
      
-    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().RetrieveCallback(cbHandle)==0)) 
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfSet - Invalid Callback Handle!\n");
-        return NPF_E_BAD_CALLBACK_HANDLE;
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_SET, start, NPF_E_BAD_CALLBACK_HANDLE);
     }
      
-    if((!numEntries > 0)||(cfgArray == NULL))
+    if((numEntries == 0)||(cfgArray == NULL))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfSet - Number Of Entries = 0 or I/F Array = Null!\n");
-        return NPF_E_UNKNOWN;   
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_SET, start, NPF_E_UNKNOWN);   
     }
     
-    // Initialise callback data structure
-    NPF_F_ATM_ConfigMgr_CallbackData_t data;
-    data.resp = new NPF_F_ATM_ConfigMgr_AsyncResponse_t[numEntries];
-    
-    bool error;
-    bool errorReportValid;
-    // Depending on the number of entries, loop through and add
-    // them to the interface table maintained by the tableManager.
-    error = TableManager::instance().AddATMIf(cfgArray, numEntries, data);
-   
-    switch(errorReporting)
-    {
-        case NPF_REPORT_ALL:  
-            // Trigger a callback to the registered client callback function. no delete b4 return
-            CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_NONE:
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_ERRORS:
-            // Trigger a callback to the registered client callback function.
-            if(error == false)
-            {
-                CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            }
-            errorReportValid = true;
-        break;
-        default:
-            errorReportValid = false;
-        break;
-    }
-       
-    if(errorReportValid == true)
-    {
-        return NPF_NO_ERROR;
-    }else 
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfSet - Error Reporting Invalid!\n");
-        return NPF_E_UNKNOWN;    
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_SET, start, NPF_E_UNKNOWN);    
     }
+    
+    // Depending on the number of entries, loop through and add
+    // them to the interface table maintained by the tableManager.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_IF_SET, start, cbHandle, cbCorrelator, errorReporting, numEntries, cfgArray,
+        [](NPF_F_ATM_ConfigMgr_IfCfg_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().AddATMIf(batch, batchEntries, data, strict);
+        });
 }
 
 /**
@@ -253,66 +674,35 @@ NPF_error_t NPF_F_ATM_ConfigMgr_IfDelete(
     APISimTrace(3,"\n\n");
     APISimTrace(3,"START OF A FAPI CALL THREAD\n");
     APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_IfDelete(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
      
-    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().RetrieveCallback(cbHandle)==0)) 
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfDelete - Invalid Callback Handle!\n");
-        return NPF_E_BAD_CALLBACK_HANDLE;
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE, start, NPF_E_BAD_CALLBACK_HANDLE);
     }
      
-    if((!numEntries > 0)||(delArray == NULL))
+    if((numEntries == 0)||(delArray == NULL))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfDelete - Number Of Entries = 0 or I/F Array = Null!\n");
-        return NPF_E_UNKNOWN;   
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE, start, NPF_E_UNKNOWN);   
     }   
     
-    if(delContainedObjs == true)
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
     {
-        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfDelete - Delete Sub Contained Objects Not Supported!\n");
-        return NPF_ATM_F_E_CMGR_FEATURE_NOT_SUPP;   
-    } 
-    
-    // Initialise callback data structure
-    NPF_F_ATM_ConfigMgr_CallbackData_t data;
-    data.resp = new NPF_F_ATM_ConfigMgr_AsyncResponse_t[numEntries];
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfDelete - Error Reporting Invalid!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE, start, NPF_E_UNKNOWN);    
+    }
     
-    bool error;
-    bool errorReportValid;
     // Depending on the number of entries, loop through and delete
     // them from the interface table maintained by the tableManager.
-    error = TableManager::instance().DeleteIf(delArray, numEntries, data);
-   
-    switch(errorReporting)
-    {
-        case NPF_REPORT_ALL:  
-            // Trigger a callback to the registered client callback function. no delete b4 return
-            CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_NONE:
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_ERRORS:
-            // Trigger a callback to the registered client callback function.
-            if(error == false)
-            {
-                CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            }
-            errorReportValid = true;
-        break;
-        default:
-            errorReportValid = false;
-        break;
-    }
-       
-    if(errorReportValid == true)
-    {
-        return NPF_NO_ERROR;
-    }else 
-    {
-        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_IfDelete - Error Reporting Invalid!\n");
-        return NPF_E_UNKNOWN;    
-    }
+    // Contained VCs and cross connects are removed when delContainedObjs is set.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE, start, cbHandle, cbCorrelator, errorReporting, numEntries, delArray,
+        [delContainedObjs](NPF_F_ATM_IfID_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().DeleteIf(batch, batchEntries, delContainedObjs, data, strict);
+        });
 }
 
 /**
@@ -337,62 +727,35 @@ NPF_error_t NPF_F_ATM_ConfigMgr_VcSet(
     APISimTrace(3,"\n\n");
     APISimTrace(3,"START OF A FAPI CALL THREAD\n");
     APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_VcSet(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
 
-    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().RetrieveCallback(cbHandle)==0)) 
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcSet - Invalid Callback Handle!\n");
-        return NPF_E_BAD_CALLBACK_HANDLE;
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_SET, start, NPF_E_BAD_CALLBACK_HANDLE);
     }
 
 
-    if((!numEntries > 0)||(cfgArray == NULL))
+    if((numEntries == 0)||(cfgArray == NULL))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcSet - Number Of Entries = 0 or VC Array = Null!\n");
-        return NPF_E_UNKNOWN;   
-    }
-    
-    // Initialise callback data structure
-    NPF_F_ATM_ConfigMgr_CallbackData_t data;
-    data.resp = new NPF_F_ATM_ConfigMgr_AsyncResponse_t[numEntries];
-    bool error;
-    bool errorReportValid;
-    
-    // Depending on the number of entries, loop through and add
-    // them to the vc table maintained by the tableManager.    
-    error = TableManager::instance().AddATMVC(cfgArray, numEntries, data);
- 
-    switch(errorReporting)
-    {
-        case NPF_REPORT_ALL:  
-            // Trigger a callback to the registered client callback function.
-            CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_NONE:
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_ERRORS:
-            // Trigger a callback to the registered client callback function.
-            if(error == false)
-            {
-                CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            }
-            errorReportValid = true;
-        break;
-        default:
-            errorReportValid = false;
-        break;
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_SET, start, NPF_E_UNKNOWN);   
     }
     
-    if(errorReportValid == true)
-    {
-        return NPF_NO_ERROR;
-    }else 
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcSet - Error Reporting Invalid!\n");
-        return NPF_E_UNKNOWN;    
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_SET, start, NPF_E_UNKNOWN);    
     }
- 
+    
+    // Depending on the number of entries, loop through and add
+    // them to the vc table maintained by the tableManager.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_VC_SET, start, cbHandle, cbCorrelator, errorReporting, numEntries, cfgArray,
+        [](NPF_F_ATM_ConfigMgr_Vc_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().AddATMVC(batch, batchEntries, data, strict);
+        });
 }
 
 /**
@@ -417,59 +780,175 @@ NPF_error_t NPF_F_ATM_ConfigMgr_VcLinkXcSet (
     APISimTrace(3,"\n\n");
     APISimTrace(3,"START OF A FAPI CALL THREAD\n");
     APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_VcLinkXcSet(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
  
-    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().RetrieveCallback(cbHandle)==0)) 
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcSet - Invalid Callback Handle!\n");
-        return NPF_E_BAD_CALLBACK_HANDLE;
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET, start, NPF_E_BAD_CALLBACK_HANDLE);
     }   
 
     
-    if((!numEntries > 0)||(vcLinkXc == NULL))
+    if((numEntries == 0)||(vcLinkXc == NULL))
     {
         APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcSet - Number Of Entries = 0 or XC Array = Null!\n");
-        return NPF_E_UNKNOWN;   
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET, start, NPF_E_UNKNOWN);   
+    }
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcSet - Error Reporting Invalid!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET, start, NPF_E_UNKNOWN);    
     }
-    // Initialise callback data structure
-    NPF_F_ATM_ConfigMgr_CallbackData_t data;
-    data.resp = new NPF_F_ATM_ConfigMgr_AsyncResponse_t[numEntries];
-    bool error;
-    bool errorReportValid;
-    // Depending on the number of entries, loop through and add
-    // them to the vc table maintained by the tableManager.    
-    error = TableManager::instance().AddATMXC(vcLinkXc, numEntries, data);
- 
-    switch(errorReporting)
-    {
-        case NPF_REPORT_ALL:  
-            // Trigger a callback to the registered client callback function.
-            CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_NONE:
-            errorReportValid = true;
-        break;
-        case NPF_REPORT_ERRORS:
-            // Trigger a callback to the registered client callback function.
-            if(error == false)
-            {
-                CallBackHandler::instance().AsyncCallback(cbHandle, cbCorrelator, data);
-            }
-            errorReportValid = true;
-        break;
-        default:
-            errorReportValid = false;
-        break;
-    }  
     
-    if(errorReportValid == true)
+    // Depending on the number of entries, loop through and add
+    // them to the xc table maintained by the tableManager.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET, start, cbHandle, cbCorrelator, errorReporting, numEntries, vcLinkXc,
+        [](NPF_F_ATM_ConfigMgr_VcLinkXc_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().AddATMXC(batch, batchEntries, data, strict);
+        });
+}
+
+/**
+ * Delete ATM VC Links.
+ * This function deletes one or more VC links. All cross connects established on
+ * a VC link should be deleted before the VC link is deleted.
+ * @param cbhandle - IN The callback handle returned by NPF_F_ATM_ConfigMgr_Register()
+ * @param cbCorrelator - IN A unique application invocation value that will be
+ *        supplied to the asynchronous completion callback routine.
+ * @param errorReporting - IN An indication of whether the application desires to
+ *        receive an asynchronous completion callback for this function call.
+ * @param feHandle - IN The FE Handle returned by NPF_F_ATM_topologyGetFEInfoList ()
+ *        call.
+ * @param blockId - IN The unique identification of the ATM Configuration Manager.
+ * @param numEntries - IN Number of VC links to delete
+ * @param delArray - IN Pointer to an array of link IDs of VC links to delete
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The operation is in progress.
+ * - NPF_E_UNKNOWN - Failure due to problems encountered when handling the input
+ *        parameters.
+ * - NPF_E_BAD_CALLBACK_HANDLE - The VC links were not deleted because the
+ *        callback handle was invalid.
+ * @callback A total of numEntries asynchronous (NPF_F_ATM_ConfigMgr_AsyncResponse_t)
+ * responses are passed to the callback function, in one or more invocations. Each
+ * response contains a link ID in the objId member of the response structure and
+ * a success code or a possible error code for that VC link. The following
+ * error codes could be returned:
+ * - NPF_NO_ERROR - Operation successful.
+ * - NPF_ATM_F_E_CONT_OBJS_EXIST - Specified VC link could not be deleted as it is
+ *        still part of a cross connect.
+ * - NPF_E_RESOURCE_NONEXISTENT - Specified VC link does not exist
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_VcDelete(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator,
+    NPF_IN NPF_errorReporting_t errorReporting,
+    NPF_IN NPF_FE_Handle_t feHandle,
+    NPF_IN NPF_BlockId_t blockId,
+    NPF_IN NPF_uint32_t numEntries,
+    NPF_IN NPF_F_ATM_VcLinkId_t *delArray)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_VcDelete(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
+     
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
     {
-        return NPF_NO_ERROR;
-    }else 
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcDelete - Invalid Callback Handle!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE, start, NPF_E_BAD_CALLBACK_HANDLE);
+    }
+     
+    if((numEntries == 0)||(delArray == NULL))
     {
-        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcSet - Error Reporting Invalid!\n");
-        return NPF_E_UNKNOWN;    
-    } 
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcDelete - Number Of Entries = 0 or VC Array = Null!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE, start, NPF_E_UNKNOWN);   
+    }   
     
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcDelete - Error Reporting Invalid!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE, start, NPF_E_UNKNOWN);    
+    }
+    
+    // Depending on the number of entries, loop through and delete
+    // them from the vc table maintained by the tableManager.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE, start, cbHandle, cbCorrelator, errorReporting, numEntries, delArray,
+        [](NPF_F_ATM_VcLinkId_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().DeleteVC(batch, batchEntries, data, strict);
+        });
 }
 
+/**
+ * Delete ATM VC Link Cross Connects.
+ * This function deletes one or more cross connect legs. Each leg joins the root
+ * VC link of a cross connect to one leaf VC link, the cross connect goes away
+ * with its last leg.
+ * @param cbhandle - IN The callback handle returned by NPF_F_ATM_ConfigMgr_Register()
+ * @param cbCorrelator - IN A unique application invocation value that will be
+ *        supplied to the asynchronous completion callback routine.
+ * @param errorReporting - IN An indication of whether the application desires to
+ *        receive an asynchronous completion callback for this function call.
+ * @param feHandle - IN The FE Handle returned by NPF_F_ATM_topologyGetFEInfoList ()
+ *        call.
+ * @param blockId - IN The unique identification of the ATM Configuration Manager.
+ * @param numEntries - IN Number of cross connect legs to delete
+ * @param delArray - IN Pointer to an array of cross connect IDs of legs to delete
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The operation is in progress.
+ * - NPF_E_UNKNOWN - Failure due to problems encountered when handling the input
+ *        parameters.
+ * - NPF_E_BAD_CALLBACK_HANDLE - The cross connects were not deleted because the
+ *        callback handle was invalid.
+ * @callback A total of numEntries asynchronous (NPF_F_ATM_ConfigMgr_AsyncResponse_t)
+ * responses are passed to the callback function, in one or more invocations. Each
+ * response contains a cross connect ID in the objId member of the response structure
+ * and a success code or a possible error code for that leg. The following
+ * error codes could be returned:
+ * - NPF_NO_ERROR - Operation successful.
+ * - NPF_E_RESOURCE_NONEXISTENT - Specified cross connect does not exist
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_VcLinkXcDelete(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator,
+    NPF_IN NPF_errorReporting_t errorReporting,
+    NPF_IN NPF_FE_Handle_t feHandle,
+    NPF_IN NPF_BlockId_t blockId,
+    NPF_IN NPF_uint32_t numEntries,
+    NPF_IN NPF_F_ATM_VcXcId_t *delArray)
+{
+    APISimTrace(3,"\n\n");
+    APISimTrace(3,"START OF A FAPI CALL THREAD\n");
+    APISimTrace(3,"Trace Level 3: NPF_F_ATM_ConfigMgr_VcLinkXcDelete(%d,%d,%d,..,..,%d,..)\n",cbHandle, cbCorrelator, errorReporting,numEntries); 
+    unsigned long long start = FAPIMetrics::Now();
+     
+    if((cbHandle > _ATM_FAPI_SIM_CB_HANDLE_MAX)||(CallBackManager::instance().IsRegistered(cbHandle)==false)) 
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcDelete - Invalid Callback Handle!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE, start, NPF_E_BAD_CALLBACK_HANDLE);
+    }
+     
+    if((numEntries == 0)||(delArray == NULL))
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcDelete - Number Of Entries = 0 or XC Array = Null!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE, start, NPF_E_UNKNOWN);   
+    }   
+    
+    if((errorReporting != NPF_REPORT_ALL)&&(errorReporting != NPF_REPORT_NONE)&&
+       (errorReporting != NPF_REPORT_ERRORS))
+    {
+        APISimTrace(1,"Trace Level 1: NPF_F_ATM_ConfigMgr_VcLinkXcDelete - Error Reporting Invalid!\n");
+        return FAPIMetrics::EndCall(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE, start, NPF_E_UNKNOWN);    
+    }
+    
+    // Depending on the number of entries, loop through and delete
+    // them from the xc table maintained by the tableManager.
+    return ApplyBatch(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE, start, cbHandle, cbCorrelator, errorReporting, numEntries, delArray,
+        [](NPF_F_ATM_VcXcId_t* batch, NPF_uint32_t batchEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+        {
+            return TableManager::instance().DeleteXC(batch, batchEntries, data, strict);
+        });
+}
@@ -0,0 +1,655 @@
+/*******************************************************************************
+
+  INTEL CONFIDENTIAL
+
+  Copyright 2000 - 2005 Intel Corporation All Rights Reserved.
+
+  The source code contained or described herein and all documents related to
+  the source code ("Material") are owned by Intel Corporation or its
+  suppliers or licensors.
+
+  Title to the Material remains with Intel Corporation or its suppliers and
+  licensors. The Material contains trade secrets and proprietary and
+  confidential information of Intel or its suppliers and licensors.
+  The Material is protected by worldwide copyright and trade secret laws and
+  treaty provisions. No part of the Material may be used, copied, reproduced,
+  modified, published, uploaded, posted, transmitted, distributed,
+  or disclosed in any way without Intel's prior express written permission.
+
+  No license under any patent, copyright, trade secret or other intellectual
+  property right is granted to or conferred upon you by disclosure
+  or delivery of the Materials, either expressly, by implication, inducement,
+  estoppel or otherwise. Any license under such intellectual property rights
+  must be express and approved by Intel in writing.
+
+*******************************************************************************/
+#ifndef _NPF_F_ATM_CONFIGMGR_EXT_H_
+#define _NPF_F_ATM_CONFIGMGR_EXT_H_
+
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include <stdio.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* end defined(__cplusplus) */
+
+
+/******************************************************************************
+ *              SIMULATOR EXTENSIONS TO THE ATM CONFIGURATION MANAGER
+ *****************************************************************************/
+
+/**
+ * Batch application modes.
+ * NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL - Every valid entry of a batch is applied
+ *        and an error is reported for each invalid one. A large batch is
+ *        applied at once and its responses are reported a chunk at a time.
+ *        This is the default.
+ * NPF_F_ATM_CONFIGMGR_BATCH_STRICT - The whole batch is validated first and
+ *        is only applied if every entry is valid. When any entry fails
+ *        nothing is applied, allOK is NPF_FALSE and only the failed entries
+ *        are reported. The batch is applied and reported in one piece.
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL = 0,
+    NPF_F_ATM_CONFIGMGR_BATCH_STRICT = 1
+} NPF_F_ATM_ConfigMgr_BatchMode_t;
+
+/**
+ * Set the Batch Mode of a Callback Handle.
+ * Selects how the IfSet, IfDelete, VcSet, VcDelete, VcLinkXcSet and
+ * VcLinkXcDelete calls made with the callback handle apply their cfgArray
+ * or delArray. The mode applies to calls made
+ * after this function returns and is reset to
+ * NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL when the handle is registered.
+ * NPF_F_ATM_ConfigMgr_SetBatchMode() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param callbackHandle - IN The callback handle returned by
+ *        NPF_F_ATM_ConfigMgr_Register()
+ * @param batchMode - IN The batch mode to use.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The batch mode was set.
+ * - NPF_E_UNKNOWN - batchMode is not a valid mode.
+ * - NPF_E_BAD_CALLBACK_HANDLE - The function does not recognize the callback
+ *        handle.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SetBatchMode(
+    NPF_IN NPF_callbackHandle_t callbackHandle,
+    NPF_IN NPF_F_ATM_ConfigMgr_BatchMode_t batchMode);
+
+/**
+ * @brief Deletes one or more VC links. A VC link that is still part of a
+ * cross connect is not deleted and is reported with
+ * NPF_ATM_F_E_CONT_OBJS_EXIST, its legs are deleted first with
+ * NPF_F_ATM_ConfigMgr_VcLinkXcDelete().
+ * Each response carries a VC link ID in its objId member.
+ * @param cbHandle - IN The callback handle returned by
+ *        NPF_F_ATM_ConfigMgr_Register()
+ * @param cbCorrelator - IN Supplied to the completion callback.
+ * @param errorReporting - IN Which responses the completion callback receives.
+ * @param feHandle - IN The FE Handle.
+ * @param blockId - IN The ATM Configuration Manager.
+ * @param numEntries - IN Number of VC links to delete
+ * @param delArray - IN Pointer to an array of link IDs of VC links to delete
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The operation is in progress.
+ * - NPF_E_UNKNOWN - numEntries is 0, delArray is NULL or errorReporting is
+ *        not valid.
+ * - NPF_E_BAD_CALLBACK_HANDLE - The function does not recognize the callback
+ *        handle.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_VcDelete(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator,
+    NPF_IN NPF_errorReporting_t errorReporting,
+    NPF_IN NPF_FE_Handle_t feHandle,
+    NPF_IN NPF_BlockId_t blockId,
+    NPF_IN NPF_uint32_t numEntries,
+    NPF_IN NPF_F_ATM_VcLinkId_t *delArray);
+
+/**
+ * @brief Deletes one or more cross connect legs, a cross connect goes away
+ * with its last leg. A leg that does not exist, or is named a second time
+ * in the same delArray, is reported with NPF_E_RESOURCE_NONEXISTENT.
+ * The other parameters and the return values are those of
+ * NPF_F_ATM_ConfigMgr_VcDelete(), each response carries a cross connect ID
+ * in its objId member.
+ * @param numEntries - IN Number of cross connect legs to delete
+ * @param delArray - IN Pointer to an array of cross connect IDs of legs to
+ *        delete
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_VcLinkXcDelete(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator,
+    NPF_IN NPF_errorReporting_t errorReporting,
+    NPF_IN NPF_FE_Handle_t feHandle,
+    NPF_IN NPF_BlockId_t blockId,
+    NPF_IN NPF_uint32_t numEntries,
+    NPF_IN NPF_F_ATM_VcXcId_t *delArray);
+
+/**
+ * @brief Writes the interface, VC and cross connect tables to a snapshot
+ * file. The file at path is replaced only once the new snapshot has been
+ * written completely. Configuration calls that arrive while the snapshot is
+ * written wait for it to finish.
+ * NPF_F_ATM_ConfigMgr_SnapshotSave() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param path - IN The snapshot file to write.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The snapshot was written.
+ * - NPF_E_UNKNOWN - path is NULL or the file could not be written.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SnapshotSave(
+    NPF_IN const char* path);
+
+/**
+ * @brief Loads the interface, VC and cross connect tables from a snapshot
+ * file written by NPF_F_ATM_ConfigMgr_SnapshotSave(). The tables must be
+ * empty. The snapshot is checked in full before it is loaded, and if any
+ * record is rejected the tables are left empty.
+ * NPF_F_ATM_ConfigMgr_SnapshotRestore() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param path - IN The snapshot file to load.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The tables were loaded.
+ * - NPF_E_UNKNOWN - path is NULL, the tables are not empty, or the file is
+ *        not a valid snapshot for this build.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_SnapshotRestore(
+    NPF_IN const char* path);
+
+/**
+ * @brief Starts recording every change made to the configuration tables in
+ * an append only journal file. The changes are written to disk in groups by
+ * a thread of the journal, configuration calls do not wait for the disk.
+ * An existing journal is appended to, it must end with the last change held
+ * by the tables, so it is replayed with NPF_F_ATM_ConfigMgr_JournalReplay()
+ * first. NPF_F_ATM_ConfigMgr_JournalOpen() is a synchronous function and has
+ * no completion callback associated with it.
+ * @param path - IN The journal file, created if it does not exist.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - Changes are being recorded.
+ * - NPF_E_UNKNOWN - path is NULL, a journal is already open or the file is
+ *        not a journal of these tables.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalOpen(
+    NPF_IN const char* path);
+
+/**
+ * @brief Waits until every change recorded so far is on disk. 
+ * NPF_F_ATM_ConfigMgr_JournalFlush() is a synchronous function and has no
+ * completion callback associated with it.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The changes are on disk, or no journal is open.
+ * - NPF_E_UNKNOWN - The journal could not be written.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalFlush(void);
+
+/**
+ * @brief Writes every recorded change to disk and stops recording changes.
+ * NPF_F_ATM_ConfigMgr_JournalClose() is a synchronous function and has no
+ * completion callback associated with it.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The journal was closed.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalClose(void);
+
+/**
+ * @brief Applies the changes of a journal file that follow the last change
+ * held by the configuration tables, normally after the tables have been
+ * loaded with NPF_F_ATM_ConfigMgr_SnapshotRestore(). No journal may be open.
+ * NPF_F_ATM_ConfigMgr_JournalReplay() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param path - IN The journal file to replay.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - Every following change was applied.
+ * - NPF_E_UNKNOWN - path is NULL, a journal is open, the file is not a
+ *        journal of these tables, or a change does not follow on from the
+ *        tables or could not be applied.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_JournalReplay(
+    NPF_IN const char* path);
+
+/**
+ * Kinds of change reported to change subscribers.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED - An interface was added, u.ifCfg.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED - An interface was deleted, u.ifId.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED - A VC link was added, u.vcCfg.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED - A VC link was deleted, u.vcCfg.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED - A cross connect leg was added,
+ *        u.xcLeg.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED - A cross connect leg was deleted,
+ *        u.xcLeg.
+ * VCs and cross connects deleted together with their interface are
+ * reported one by one, before the interface.
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED = 1,
+    NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED = 2,
+    NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED = 3,
+    NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED = 4,
+    NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED = 5,
+    NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED = 6
+} NPF_F_ATM_ConfigMgr_ChangeType_t;
+
+/* Bit of a change type in the changeMask of a subscription */
+#define NPF_F_ATM_CONFIGMGR_CHANGE_BIT(type) (1 << (type))
+/* changeMask selecting every kind of change */
+#define NPF_F_ATM_CONFIGMGR_CHANGE_ALL 0x7E
+
+/**
+ * What happens to a change when the queue of a subscriber is full.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_DROP - The change is dropped and counted, the
+ *        count is passed with the next batch delivered to the subscriber.
+ * NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK - The configuration call that made the
+ *        change waits until the subscriber has taken changes off its queue.
+ *        Its table locks are already released, other calls are only held up
+ *        when they have changes to report themselves.
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_CHANGE_DROP = 0,
+    NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK = 1
+} NPF_F_ATM_ConfigMgr_ChangePolicy_t;
+
+/**
+ * A change to the configuration tables. type selects the member of u that
+ * describes it. vcCfg.link_B is always NULL, the cross connects of a VC
+ * are reported as changes of their own.
+ */
+typedef struct
+{
+    NPF_F_ATM_ConfigMgr_ChangeType_t type;
+    union
+    {
+        NPF_F_ATM_ConfigMgr_IfCfg_t ifCfg;
+        NPF_F_ATM_IfID_t ifId;
+        NPF_F_ATM_ConfigMgr_Vc_t vcCfg;
+        struct
+        {
+            NPF_uint32_t link_A;
+            NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+        } xcLeg;
+    } u;
+} NPF_F_ATM_ConfigMgr_ChangeEvent_t;
+
+/**
+ * Change notification function.
+ * Called on a thread of the subscription with a batch of changes, in the
+ * order they were made to the tables. The events array is only valid for
+ * the duration of the call.
+ * @param userContext - IN The context given to
+ *        NPF_F_ATM_ConfigMgr_ChangeSubscribe().
+ * @param eventHandle - IN The handle of the subscription.
+ * @param numDropped - IN Changes dropped since the previous batch because
+ *        the queue of the subscription was full.
+ * @param numEvents - IN Number of changes in events.
+ * @param events - IN The changes.
+ */
+typedef void (*NPF_F_ATM_ConfigMgr_ChangeFunc_t)(
+    NPF_IN NPF_userContext_t userContext,
+    NPF_IN NPF_callbackHandle_t eventHandle,
+    NPF_IN NPF_uint32_t numDropped,
+    NPF_IN NPF_uint32_t numEvents,
+    NPF_IN NPF_F_ATM_ConfigMgr_ChangeEvent_t* events);
+
+/**
+ * @brief Subscribes to the changes made to the interface, VC and cross
+ * connect tables. Every change of a kind selected by changeMask that is
+ * made after this function returns is queued for the subscriber and
+ * delivered in batches to changeFunc on a thread of the subscription.
+ * Changes are queued once the configuration call that made them has
+ * released the table locks. A snapshot restore is not reported.
+ * A changeFunc of a subscription with NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK
+ * must not make configuration calls, it could wait on its own queue.
+ * NPF_F_ATM_ConfigMgr_ChangeSubscribe() is a synchronous function and has
+ * no completion callback associated with it.
+ * @param userContext - IN Passed to changeFunc.
+ * @param changeFunc - IN Called with each batch of changes.
+ * @param changeMask - IN NPF_F_ATM_CONFIGMGR_CHANGE_BIT() of each kind of
+ *        change to report, or NPF_F_ATM_CONFIGMGR_CHANGE_ALL.
+ * @param policy - IN What to do with a change when the queue is full.
+ * @param queueDepth - IN Changes the subscription may have queued, at most
+ *        _IX_CC_ATM_FAPI_CHANGE_QUEUE_DEPTH_MAX.
+ * @param eventHandle - OUT The handle of the subscription.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The subscription was made.
+ * - NPF_E_BAD_CALLBACK_FUNCTION - changeFunc is NULL.
+ * - NPF_E_UNKNOWN - A parameter is out of range, eventHandle is NULL or
+ *        _IX_CC_ATM_FAPI_EVENT_CB_HANDLE_MAX subscriptions exist.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_ChangeSubscribe(
+    NPF_IN NPF_userContext_t userContext,
+    NPF_IN NPF_F_ATM_ConfigMgr_ChangeFunc_t changeFunc,
+    NPF_IN NPF_uint32_t changeMask,
+    NPF_IN NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+    NPF_IN NPF_uint32_t queueDepth,
+    NPF_OUT NPF_callbackHandle_t* eventHandle);
+
+/**
+ * @brief Ends a subscription made with
+ * NPF_F_ATM_ConfigMgr_ChangeSubscribe(). Changes still queued are
+ * discarded. Once the function returns changeFunc is no longer called.
+ * It must not be called from changeFunc.
+ * NPF_F_ATM_ConfigMgr_ChangeUnsubscribe() is a synchronous function and
+ * has no completion callback associated with it.
+ * @param eventHandle - IN The handle of the subscription.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The subscription was ended.
+ * - NPF_E_BAD_CALLBACK_HANDLE - eventHandle is not a subscription, or the
+ *        function was called from changeFunc.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_ChangeUnsubscribe(
+    NPF_IN NPF_callbackHandle_t eventHandle);
+
+/**
+ * @brief Keeps the resp array of a completion callback after the callback
+ * returns. The array passed to a callback in data.resp is the buffer the
+ * simulator filled in, not a copy, and is normally reused once the callback
+ * returns. A callback that wants to look at the responses later, for
+ * instance on another thread, holds the array instead of copying it and
+ * gives it back with NPF_F_ATM_ConfigMgr_RespRelease(). An array may be held
+ * more than once, it is reused after the matching number of releases.
+ * NPF_F_ATM_ConfigMgr_RespHold() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param resp - IN data.resp of a completion callback that has not yet
+ *        returned, or of an array that is still held.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The array is held.
+ * - NPF_E_UNKNOWN - resp is NULL.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_RespHold(
+    NPF_IN NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp);
+
+/**
+ * @brief Gives back a resp array held with NPF_F_ATM_ConfigMgr_RespHold().
+ * The array must not be used after the last release.
+ * NPF_F_ATM_ConfigMgr_RespRelease() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param resp - IN The held array.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The array was released.
+ * - NPF_E_UNKNOWN - resp is NULL.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_RespRelease(
+    NPF_IN NPF_F_ATM_ConfigMgr_AsyncResponse_t* resp);
+
+/**
+ * @brief Queues a completion callback behind every callback already queued
+ * for a callback handle. The callback function of the handle is called with
+ * cbCorrelator, allOK NPF_TRUE, n_resp 0, resp NULL and data.type 0, which
+ * is no NPF callback type, after the callbacks of every FAPI call
+ * made with the handle before this function was called. A FAPI call has
+ * queued all of its callbacks when it returns, however many chunks its
+ * responses were split into and whatever errorReporting asked for, so a
+ * fence queued after the call returns tells the client the call is
+ * finished. The fence is told apart from the callbacks of the calls by
+ * cbCorrelator, a client that needs to do so passes a correlator none of
+ * its calls uses.
+ * NPF_F_ATM_ConfigMgr_CallbackFence() is a synchronous function, its
+ * completion callback is the fence itself.
+ * @param cbHandle - IN The callback handle returned by
+ *        NPF_F_ATM_ConfigMgr_Register()
+ * @param cbCorrelator - IN Passed to the callback function.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The fence was queued.
+ * - NPF_E_BAD_CALLBACK_HANDLE - The function does not recognize the callback
+ *        handle.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_CallbackFence(
+    NPF_IN NPF_callbackHandle_t cbHandle,
+    NPF_IN NPF_correlator_t cbCorrelator);
+
+/**
+ * Operations the simulator keeps call counts, error counts and latency
+ * histograms for.
+ * NPF_F_ATM_CONFIGMGR_METRIC_IF_SET - NPF_F_ATM_ConfigMgr_IfSet().
+ * NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE - NPF_F_ATM_ConfigMgr_IfDelete().
+ * NPF_F_ATM_CONFIGMGR_METRIC_VC_SET - NPF_F_ATM_ConfigMgr_VcSet().
+ * NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET -
+ *        NPF_F_ATM_ConfigMgr_VcLinkXcSet().
+ * NPF_F_ATM_CONFIGMGR_METRIC_CALLBACK_DISPATCH - Completion callbacks, the
+ *        latency is the time from the responses being ready to the
+ *        callback function being called.
+ * NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE - NPF_F_ATM_ConfigMgr_VcDelete().
+ * NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE -
+ *        NPF_F_ATM_ConfigMgr_VcLinkXcDelete().
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_METRIC_IF_SET = 0,
+    NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE = 1,
+    NPF_F_ATM_CONFIGMGR_METRIC_VC_SET = 2,
+    NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET = 3,
+    NPF_F_ATM_CONFIGMGR_METRIC_CALLBACK_DISPATCH = 4,
+    NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE = 5,
+    NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE = 6,
+    NPF_F_ATM_CONFIGMGR_METRIC_COUNT = 7
+} NPF_F_ATM_ConfigMgr_Metric_t;
+
+/**
+ * Locks the simulator keeps contention counters for.
+ * NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF - Interface table locks.
+ * NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC - VC table locks.
+ * NPF_F_ATM_CONFIGMGR_LOCK_TABLE_XC - Cross connect table locks.
+ * NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_REGISTER - Callback registrations.
+ * NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL - Callback and response buffers.
+ * NPF_F_ATM_CONFIGMGR_LOCK_DISPATCH - Ready list of the callback
+ *        dispatcher threads.
+ * NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL - Change journal queue.
+ * NPF_F_ATM_CONFIGMGR_LOCK_CHANGE_PUBLISH - Change notification ordering.
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF = 0,
+    NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC = 1,
+    NPF_F_ATM_CONFIGMGR_LOCK_TABLE_XC = 2,
+    NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_REGISTER = 3,
+    NPF_F_ATM_CONFIGMGR_LOCK_CALLBACK_POOL = 4,
+    NPF_F_ATM_CONFIGMGR_LOCK_DISPATCH = 5,
+    NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL = 6,
+    NPF_F_ATM_CONFIGMGR_LOCK_CHANGE_PUBLISH = 7,
+    NPF_F_ATM_CONFIGMGR_LOCK_COUNT = 8
+} NPF_F_ATM_ConfigMgr_Lock_t;
+
+/* Number of distinct error codes counted for each operation */
+#define NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES 8
+
+/**
+ * Counters and latencies of an operation since the simulator started or
+ * the metrics were last reset. Latencies are in nanoseconds and are taken
+ * from a histogram that keeps them to within about 6%. Error counts cover
+ * both the value returned by a call and the error reported for each entry
+ * of a batch. The first NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES codes seen
+ * are counted one by one, later ones in otherErrors.
+ */
+typedef struct
+{
+    NPF_uint64_t calls;
+    NPF_uint64_t totalNs;
+    NPF_uint64_t minNs;
+    NPF_uint64_t p50Ns;
+    NPF_uint64_t p90Ns;
+    NPF_uint64_t p99Ns;
+    NPF_uint64_t p999Ns;
+    NPF_uint64_t maxNs;
+    NPF_uint32_t numErrorCodes;
+    struct
+    {
+        NPF_error_t code;
+        NPF_uint64_t count;
+    } errors[NPF_F_ATM_CONFIGMGR_METRIC_ERROR_CODES];
+    NPF_uint64_t otherErrors;
+} NPF_F_ATM_ConfigMgr_MetricInfo_t;
+
+/**
+ * Contention counters of a lock since the simulator started or the
+ * metrics were last reset. A lock counts as contended when it could not be
+ * taken straight away, waitNs is the time spent waiting for it.
+ */
+typedef struct
+{
+    NPF_uint64_t acquired;
+    NPF_uint64_t contended;
+    NPF_uint64_t waitNs;
+} NPF_F_ATM_ConfigMgr_LockInfo_t;
+
+/**
+ * @brief Reads the counters and latencies of an operation. The counters
+ * are kept per thread and added up when they are read, a call that is in
+ * progress may or may not be counted.
+ * NPF_F_ATM_ConfigMgr_MetricsGet() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param metric - IN The operation.
+ * @param info - OUT The counters and latencies.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - info was filled in.
+ * - NPF_E_UNKNOWN - metric is not valid or info is NULL.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_Metric_t metric,
+    NPF_OUT NPF_F_ATM_ConfigMgr_MetricInfo_t* info);
+
+/**
+ * @brief Reads the contention counters of a lock.
+ * NPF_F_ATM_ConfigMgr_LockMetricsGet() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param lock - IN The lock.
+ * @param info - OUT The counters.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - info was filled in.
+ * - NPF_E_UNKNOWN - lock is not valid or info is NULL.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_LockMetricsGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_Lock_t lock,
+    NPF_OUT NPF_F_ATM_ConfigMgr_LockInfo_t* info);
+
+/**
+ * @brief Writes every operation and lock counter as text, one line each.
+ * NPF_F_ATM_ConfigMgr_MetricsDump() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param out - IN The stream to write to, stdout when NULL.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The counters were written.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsDump(
+    NPF_IN FILE* out);
+
+/**
+ * @brief Starts every counter and histogram again from zero. Calls in
+ * progress may be counted on either side of the reset.
+ * NPF_F_ATM_ConfigMgr_MetricsReset() is a synchronous function and has no
+ * completion callback associated with it.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The counters were reset.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MetricsReset(void);
+
+/**
+ * Places the simulator accounts memory to.
+ * NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE - Interface table entries.
+ * NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE - VC table entries.
+ * NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE - Cross connect table entries, one per
+ *        leg.
+ * NPF_F_ATM_CONFIGMGR_MEM_LINK_B - link_B arrays of roots with more than
+ *        one leg, the arrays not in use are held by the link_B pools.
+ * NPF_F_ATM_CONFIGMGR_MEM_CALLBACK - CallBack objects carrying the
+ *        responses of a call to its completion callback.
+ * NPF_F_ATM_CONFIGMGR_MEM_RESP - Response buffers leased to calls and
+ *        callbacks.
+ */
+typedef enum
+{
+    NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE = 0,
+    NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE = 1,
+    NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE = 2,
+    NPF_F_ATM_CONFIGMGR_MEM_LINK_B = 3,
+    NPF_F_ATM_CONFIGMGR_MEM_CALLBACK = 4,
+    NPF_F_ATM_CONFIGMGR_MEM_RESP = 5,
+    NPF_F_ATM_CONFIGMGR_MEM_COUNT = 6
+} NPF_F_ATM_ConfigMgr_MemSite_t;
+
+/**
+ * Memory of one place since the simulator started. objects and bytes are
+ * in use now, peakObjects and peakBytes are their highest values since the
+ * start or the last NPF_F_ATM_ConfigMgr_MemoryResetPeaks(). reservedBytes
+ * is held for the place but not in use, such as the unused entries of a
+ * pool or of a preallocated table. allocs and frees count the objects
+ * taken into and out of use. Table entries kept in maps are counted with
+ * the bytes of a map node.
+ */
+typedef struct
+{
+    NPF_uint64_t objects;
+    NPF_uint64_t bytes;
+    NPF_uint64_t peakObjects;
+    NPF_uint64_t peakBytes;
+    NPF_uint64_t reservedBytes;
+    NPF_uint64_t allocs;
+    NPF_uint64_t frees;
+} NPF_F_ATM_ConfigMgr_MemInfo_t;
+
+/**
+ * @brief Reads the memory accounted to a place.
+ * NPF_F_ATM_ConfigMgr_MemoryGet() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param site - IN The place.
+ * @param info - OUT The counters.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - info was filled in.
+ * - NPF_E_UNKNOWN - site is not valid or info is NULL.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryGet(
+    NPF_IN NPF_F_ATM_ConfigMgr_MemSite_t site,
+    NPF_OUT NPF_F_ATM_ConfigMgr_MemInfo_t* info);
+
+/**
+ * @brief Writes the memory of every place as text, one line each, and
+ * their totals.
+ * NPF_F_ATM_ConfigMgr_MemoryDump() is a synchronous function and has no
+ * completion callback associated with it.
+ * @param out - IN The stream to write to, stdout when NULL.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The counters were written.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryDump(
+    NPF_IN FILE* out);
+
+/**
+ * @brief Starts the high water marks of every place again from the memory
+ * in use now.
+ * NPF_F_ATM_ConfigMgr_MemoryResetPeaks() is a synchronous function and has
+ * no completion callback associated with it.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The high water marks were reset.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryResetPeaks(void);
+
+/**
+ * @brief Writes the memory of every place, as
+ * NPF_F_ATM_ConfigMgr_MemoryDump() does, each time the process receives a
+ * signal. The dump is written by a thread of the simulator, not by the
+ * signal handler. Only one signal dumps at a time, a new call replaces the
+ * signal and stream of the previous one.
+ * NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal() is a synchronous function and
+ * has no completion callback associated with it.
+ * @param signum - IN The signal, such as SIGUSR1. 0 stops dumping and
+ *        restores the previous handler of the signal.
+ * @param out - IN The stream to write to, stderr when NULL.
+ * @return Possible return values are:
+ * - NPF_NO_ERROR - The dump is written on the signal, or no longer is.
+ * - NPF_E_UNKNOWN - The signal cannot be caught or the dump thread could not
+ *        be started.
+ */
+NPF_error_t NPF_F_ATM_ConfigMgr_MemoryDumpOnSignal(
+    NPF_IN int signum,
+    NPF_IN FILE* out);
+
+
+#if defined(__cplusplus)
+}
+#endif /* end defined(__cplusplus) */
+
+#endif //_NPF_F_ATM_CONFIGMGR_EXT_H_
@@ -0,0 +1,227 @@
+/**
+ * @file ShardDirectory.h
+ *
+ * @date 10 June 2005
+ *
+ * @brief The ShardDirectory records which TableManager shard holds each VC
+ *        link or cross connect.
+ *
+ * The interface of a VC decides its shard, but a VC link ID or cross
+ * connect ID on its own does not. The ShardDirectory maps those IDs to the
+ * shard that holds them so a cross connect, which names its VCs by link ID
+ * only, can find and lock the shards it needs.
+ *
+ * Design Notes:
+ *    An entry is claimed by the TableManager while it holds the write lock
+ *    of the shard the entry goes into, and released under the same lock,
+ *    so an entry found in a shard that the caller has locked stays valid
+ *    for as long as the lock is held. Find() may be called with no lock
+ *    held, the shard it returns is only a hint until that shard is locked.
+ *
+ *    IDs below _IX_CC_ATM_FAPI_VC_HANDLE_MAX have a byte each, claimed
+ *    with a compare and swap, so finding the shard of a VC or cross 
+ *    connect is a single array access. The map backed tables take IDs of
+ *    any size, the directory keeps the larger ones in a map guarded by a
+ *    reader/writer lock of its own.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __SHARDDIRECTORY_H_
+#define __SHARDDIRECTORY_H_
+
+/**
+ * User defined include files required.
+ */
+#include "FAPIDefs.h"
+
+/**
+ * Standard defined include files required.
+ */
+#include <map>
+#include <pthread.h>
+using namespace std;
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Maps VC link and cross connect IDs to the shard that holds them.
+ */
+class ShardDirectory
+{
+public:
+    /**
+    * Returned by Find() for an ID that is not in any shard.
+    */
+    enum
+    {
+        NONE = 0xFFFFFFFF
+    };
+
+    ShardDirectory()
+    {
+        for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_VC_HANDLE_MAX; x++)
+        {
+            m_shards[x] = 0;
+        }
+#if !defined(_IX_CC_ATM_FAPI_FLAT_TABLES)
+        pthread_rwlock_init(&m_lock, 0);
+#endif
+    }
+
+    ~ShardDirectory()
+    {
+#if !defined(_IX_CC_ATM_FAPI_FLAT_TABLES)
+        pthread_rwlock_destroy(&m_lock);
+#endif
+    }
+
+    unsigned int Find(unsigned int key) const
+    {
+        if(key >= _IX_CC_ATM_FAPI_VC_HANDLE_MAX)
+        {
+            return FindLarge(key);
+        }
+        unsigned char shard = __atomic_load_n(&m_shards[key], __ATOMIC_ACQUIRE);
+        return (shard == 0) ? (unsigned int)NONE : (unsigned int)(shard - 1);
+    }
+
+    /**
+     * Records that 'key' is held by 'shard'. Returns false if the key is
+     * already held by a shard or is outside the range of the tables.
+     */
+    bool Claim(unsigned int key, unsigned int shard)
+    {
+        if(key >= _IX_CC_ATM_FAPI_VC_HANDLE_MAX)
+        {
+            return ClaimLarge(key, shard);
+        }
+        unsigned char expected = 0;
+        return __atomic_compare_exchange_n(&m_shards[key], &expected, (unsigned char)(shard + 1), false,
+                                           __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    void Release(unsigned int key)
+    {
+        if(key >= _IX_CC_ATM_FAPI_VC_HANDLE_MAX)
+        {
+            ReleaseLarge(key);
+            return;
+        }
+        __atomic_store_n(&m_shards[key], (unsigned char)0, __ATOMIC_RELEASE);
+    }
+
+private:
+    ShardDirectory(const ShardDirectory&);
+    ShardDirectory& operator =(const ShardDirectory&);
+
+    // Shards are stored in a byte, the array adds one to tell
+    // them from a free entry.
+    typedef char ShardCountCheck[((_IX_CC_ATM_FAPI_TABLE_SHARDS >= 1)&&(_IX_CC_ATM_FAPI_TABLE_SHARDS < 0xFF)) ? 1 : -1];
+
+#if defined(_IX_CC_ATM_FAPI_FLAT_TABLES)
+    // The flat tables hold no IDs past the directory.
+    unsigned int FindLarge(unsigned int key) const
+    {
+        return NONE;
+    }
+
+    bool ClaimLarge(unsigned int key, unsigned int shard)
+    {
+        return false;
+    }
+
+    void ReleaseLarge(unsigned int key)
+    {
+    }
+#else
+    unsigned int FindLarge(unsigned int key) const
+    {
+        unsigned int shard = NONE;
+        pthread_rwlock_rdlock(&m_lock);
+        map<unsigned int, unsigned char>::const_iterator findIter = m_large.find(key);
+        if(findIter != m_large.end())
+        {
+            shard = findIter->second;
+        }
+        pthread_rwlock_unlock(&m_lock);
+        return shard;
+    }
+
+    bool ClaimLarge(unsigned int key, unsigned int shard)
+    {
+        pthread_rwlock_wrlock(&m_lock);
+        bool claimed = m_large.insert(pair<unsigned int, unsigned char>(key, (unsigned char)shard)).second;
+        pthread_rwlock_unlock(&m_lock);
+        return claimed;
+    }
+
+    void ReleaseLarge(unsigned int key)
+    {
+        pthread_rwlock_wrlock(&m_lock);
+        m_large.erase(key);
+        pthread_rwlock_unlock(&m_lock);
+    }
+#endif
+
+    /**
+    * ShardDirectory Member Variables.
+    *
+    * m_shards - Shard plus one of every ID below 
+    *            _IX_CC_ATM_FAPI_VC_HANDLE_MAX, 0 when the ID is free.
+    *
+    * m_large - Shard of every larger ID held by a map backed shard.
+    *
+    * m_lock - Guards m_large.
+    *
+    */
+    unsigned char m_shards[_IX_CC_ATM_FAPI_VC_HANDLE_MAX];
+#if !defined(_IX_CC_ATM_FAPI_FLAT_TABLES)
+    map<unsigned int, unsigned char> m_large;
+    mutable pthread_rwlock_t m_lock;
+#endif
+};
+#endif // #if !defined __SHARDDIRECTORY_H_
+/**
+ *@}
+ */
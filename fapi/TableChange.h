@@ -0,0 +1,121 @@
+/**
+ * @file TableChange.h
+ *
+ * @date 3 June 2005
+ *
+ * @brief A change made to the TableManager tables.
+ *
+ * Every interface, VC and cross connect the TableManager adds or deletes
+ * for a configuration call is described by a TableChange. The TableJournal
+ * writes them to the change journal and replays them from it.
+ *
+ * Design Notes:
+ *    A change carries what is needed to apply it again, not its effect.
+ *    An interface deleted with delContainedObjs set is one change, the VCs
+ *    and cross connects removed with it are not recorded separately. A
+ *    point to multipoint cross connect entry is one change per leg.
+ *    sequence numbers every change in the order it was applied.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __TABLECHANGE_H_
+#define __TABLECHANGE_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Kinds of TableChange.
+ */
+enum
+{
+    TABLE_CHANGE_IF_ADD = 1,
+    TABLE_CHANGE_IF_DELETE,
+    TABLE_CHANGE_VC_ADD,
+    TABLE_CHANGE_XC_ADD,
+    TABLE_CHANGE_VC_DELETE,
+    TABLE_CHANGE_XC_DELETE
+};
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @typedef TableChange
+ *
+ * @brief Typedef of a change to the TableManager tables. type selects the
+ *        member of u that describes it, vcCfg.link_B is always 0. A
+ *        TABLE_CHANGE_VC_DELETE keeps the VC it removed in vcCfg and a
+ *        TABLE_CHANGE_XC_DELETE the leg it removed in xcLeg.
+ *
+ */
+typedef struct
+{
+    unsigned long long sequence;
+    unsigned int type;
+    union
+    {
+        NPF_F_ATM_ConfigMgr_IfCfg_t ifCfg;
+        struct
+        {
+            NPF_F_ATM_IfID_t ifId;
+            NPF_boolean_t delContainedObjs;
+        } ifDelete;
+        NPF_F_ATM_ConfigMgr_Vc_t vcCfg;
+        struct
+        {
+            NPF_uint32_t link_A;
+            NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+        } xcLeg;
+    } u;
+} TableChange;
+
+#endif // #if !defined __TABLECHANGE_H_
+/**
+ *@}
+ */
@@ -0,0 +1,534 @@
+/**
+ * @file TableJournal.cpp
+ *
+ * @date 3 June 2005
+ *
+ * @brief The TableJournal records every change made to the TableManager
+ *        tables in an append only file.
+ *
+ * Implementation of the change journal and its group commit writer thread.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "TableJournal.h"
+#include "FAPIMetrics.h"
+#include "TraceMacro.h"
+
+/*
+ * System defined include files required.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+TableJournal::TableJournal()
+: m_fd(-1), m_open(false), m_stopping(false), m_failed(false),
+  m_sequence(0), m_queued(0), m_durable(0)
+{
+    pthread_mutex_init(&m_lock, 0);
+    pthread_cond_init(&m_pendingCond, 0);
+    pthread_cond_init(&m_durableCond, 0);
+    pthread_cond_init(&m_spaceCond, 0);
+    pthread_mutex_init(&m_controlLock, 0);
+}
+
+TableJournal::~TableJournal()
+{
+    Close();
+    pthread_mutex_destroy(&m_lock);
+    pthread_cond_destroy(&m_pendingCond);
+    pthread_cond_destroy(&m_durableCond);
+    pthread_cond_destroy(&m_spaceCond);
+    pthread_mutex_destroy(&m_controlLock);
+}
+
+TableJournal& TableJournal::instance()
+{
+    // Singleton Pattern
+    static TableJournal instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Open(const char* path)
+ */
+bool TableJournal::Open(const char* path)
+{
+    APISimTrace(3,"Trace Level 3: TableJournal::Open(%s)\n",path);
+    if(path == 0)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&m_controlLock);
+    if(m_fd >= 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Open - Journal Already Open!\n");
+        pthread_mutex_unlock(&m_controlLock);
+        return false;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if((fd < 0)||(fstat(fd, &info) != 0))
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Open - Cannot Open %s!\n",path);
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        pthread_mutex_unlock(&m_controlLock);
+        return false;
+    }
+
+    bool usable = true;
+    size_t validEnd = sizeof(journalHeader);
+    unsigned long long lastSequence = 0;
+    if(info.st_size == 0)
+    {
+        journalHeader header;
+        MakeHeader(header);
+        usable = WriteAll(fd, &header, sizeof(header))&&(fdatasync(fd) == 0);
+    }else
+    {
+        usable = Scan(fd, 0, 0, validEnd, lastSequence);
+        if((usable == true)&&(validEnd < (size_t)info.st_size))
+        {
+            APISimTrace(2,"Trace Level 2: TableJournal::Open - Dropping Partly Written Tail Of %s!\n",path);
+            usable = (ftruncate(fd, validEnd) == 0);
+        }
+    }
+    usable = usable && (lseek(fd, validEnd, SEEK_SET) == (off_t)validEnd);
+
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    if((usable == true)&&(lastSequence != 0)&&(lastSequence != m_sequence))
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Open - Journal Ends At %llu, Tables At %llu!\n",lastSequence,m_sequence);
+        usable = false;
+    }
+    if(usable == true)
+    {
+        m_fd = fd;
+        m_open = true;
+        m_stopping = false;
+        m_failed = false;
+        m_queued = m_sequence;
+        m_durable = m_sequence;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if((usable == true)&&(pthread_create(&m_writer, 0, WriterThread, this) != 0))
+    {
+        FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+        m_fd = -1;
+        m_open = false;
+        pthread_mutex_unlock(&m_lock);
+        usable = false;
+    }
+    if(usable == false)
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Open - Cannot Use %s!\n",path);
+        close(fd);
+    }
+    pthread_mutex_unlock(&m_controlLock);
+    return usable;
+}
+
+/**
+ * Function Definition: Close()
+ */
+void TableJournal::Close()
+{
+    pthread_mutex_lock(&m_controlLock);
+    if(m_fd < 0)
+    {
+        pthread_mutex_unlock(&m_controlLock);
+        return;
+    }
+
+    // Changes recorded from here on are numbered but not queued, the
+    // writer thread exits once the queued ones are on disk.
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    m_open = false;
+    m_stopping = true;
+    pthread_cond_signal(&m_pendingCond);
+    pthread_cond_broadcast(&m_spaceCond);
+    pthread_mutex_unlock(&m_lock);
+
+    pthread_join(m_writer, 0);
+    close(m_fd);
+
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    m_fd = -1;
+    pthread_cond_broadcast(&m_durableCond);
+    pthread_mutex_unlock(&m_lock);
+    pthread_mutex_unlock(&m_controlLock);
+}
+
+/**
+ * Function Definition: Flush()
+ */
+bool TableJournal::Flush()
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    unsigned long long target = m_queued;
+    while((m_fd >= 0)&&(m_failed == false)&&(m_durable < target))
+    {
+        // Cuts the commit window of the group short.
+        pthread_cond_signal(&m_pendingCond);
+        pthread_cond_wait(&m_durableCond, &m_lock);
+    }
+    bool flushed = (m_failed == false);
+    pthread_mutex_unlock(&m_lock);
+    return flushed;
+}
+
+bool TableJournal::IsOpen()
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    bool open = m_open;
+    pthread_mutex_unlock(&m_lock);
+    return open;
+}
+
+/**
+ * Function Definition: Record(TableChange& change)
+ */
+unsigned long long TableJournal::Record(TableChange& change)
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    change.sequence = ++m_sequence;
+
+    while((m_open == true)&&(m_failed == false)&&(m_pending.size() >= _IX_CC_ATM_FAPI_JOURNAL_PENDING_MAX))
+    {
+        pthread_cond_wait(&m_spaceCond, &m_lock);
+    }
+
+    if((m_open == true)&&(m_failed == false))
+    {
+        journalRecord record;
+        record.sequence = change.sequence;
+        record.type = (unsigned short)change.type;
+        record.length = (unsigned short)PayloadLength(change.type);
+        record.checksum = Checksum(record, &change.u);
+
+        bool wasEmpty = m_pending.empty();
+        const unsigned char* header = reinterpret_cast<const unsigned char*>(&record);
+        const unsigned char* payload = reinterpret_cast<const unsigned char*>(&change.u);
+        m_pending.insert(m_pending.end(), header, header + sizeof(record));
+        m_pending.insert(m_pending.end(), payload, payload + record.length);
+        m_queued = change.sequence;
+
+        if((wasEmpty == true)||(m_pending.size() >= _IX_CC_ATM_FAPI_JOURNAL_GROUP_BYTES))
+        {
+            pthread_cond_signal(&m_pendingCond);
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+    return change.sequence;
+}
+
+/**
+ * Function Definition: GetSequence()
+ */
+unsigned long long TableJournal::GetSequence()
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    unsigned long long sequence = m_sequence;
+    pthread_mutex_unlock(&m_lock);
+    return sequence;
+}
+
+/**
+ * Function Definition: SetSequence(unsigned long long sequence)
+ */
+bool TableJournal::SetSequence(unsigned long long sequence)
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    bool set = (m_fd < 0);
+    if(set == true)
+    {
+        m_sequence = sequence;
+        m_queued = sequence;
+        m_durable = sequence;
+    }
+    pthread_mutex_unlock(&m_lock);
+    return set;
+}
+
+/**
+ * Function Definition: Read(const char* path, TableChangeVisitor visitor,
+ *                           void* context)
+ */
+bool TableJournal::Read(const char* path, TableChangeVisitor visitor, void* context)
+{
+    APISimTrace(3,"Trace Level 3: TableJournal::Read(%s)\n",path);
+    int fd = (path != 0) ? open(path, O_RDONLY) : -1;
+    if(fd < 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Read - Cannot Open %s!\n",path);
+        return false;
+    }
+
+    size_t validEnd = 0;
+    unsigned long long lastSequence = 0;
+    bool read = Scan(fd, visitor, context, validEnd, lastSequence);
+    close(fd);
+    return read;
+}
+
+/**
+ * Function Definition: WriterThread(void* arg)
+ */
+void* TableJournal::WriterThread(void* arg)
+{
+    static_cast<TableJournal*>(arg)->WriteGroups();
+    return 0;
+}
+
+/**
+ * Function Definition: WriteGroups()
+ */
+void TableJournal::WriteGroups()
+{
+    FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+    for(;;)
+    {
+        while((m_pending.empty() == true)&&(m_stopping == false))
+        {
+            pthread_cond_wait(&m_pendingCond, &m_lock);
+        }
+        if(m_pending.empty() == true)
+        {
+            break;
+        }
+
+        // Give the changes of other calls a moment to join the group.
+        if((m_stopping == false)&&(m_pending.size() < _IX_CC_ATM_FAPI_JOURNAL_GROUP_BYTES))
+        {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += _IX_CC_ATM_FAPI_JOURNAL_COMMIT_MS * 1000000L;
+            if(deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&m_pendingCond, &m_lock, &deadline);
+        }
+
+        m_writing.swap(m_pending);
+        unsigned long long groupEnd = m_queued;
+        pthread_cond_broadcast(&m_spaceCond);
+        pthread_mutex_unlock(&m_lock);
+
+        bool written = WriteAll(m_fd, &m_writing[0], m_writing.size())&&(fdatasync(m_fd) == 0);
+        m_writing.clear();
+
+        FAPIMetrics::Lock(&m_lock, NPF_F_ATM_CONFIGMGR_LOCK_JOURNAL);
+        if(written == true)
+        {
+            m_durable = groupEnd;
+        }else
+        {
+            APISimTrace(1,"Trace Level 1: TableJournal::WriteGroups - Journal Write Failed, errno %d!\n",errno);
+            m_failed = true;
+            m_pending.clear();
+            pthread_cond_broadcast(&m_spaceCond);
+        }
+        pthread_cond_broadcast(&m_durableCond);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+/**
+ * Function Definition: MakeHeader(journalHeader& header)
+ */
+void TableJournal::MakeHeader(journalHeader& header)
+{
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, _IX_CC_ATM_FAPI_JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = _IX_CC_ATM_FAPI_JOURNAL_VERSION;
+    header.headerSize = sizeof(journalHeader);
+    header.ifRecordSize = sizeof(NPF_F_ATM_ConfigMgr_IfCfg_t);
+    header.vcRecordSize = sizeof(NPF_F_ATM_ConfigMgr_Vc_t);
+    header.legRecordSize = sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t);
+}
+
+/**
+ * Function Definition: PayloadLength(unsigned int type)
+ */
+unsigned int TableJournal::PayloadLength(unsigned int type)
+{
+    TableChange change;
+    switch(type)
+    {
+        case TABLE_CHANGE_IF_ADD:
+            return sizeof(change.u.ifCfg);
+        case TABLE_CHANGE_IF_DELETE:
+            return sizeof(change.u.ifDelete);
+        case TABLE_CHANGE_VC_ADD:
+        case TABLE_CHANGE_VC_DELETE:
+            return sizeof(change.u.vcCfg);
+        case TABLE_CHANGE_XC_ADD:
+        case TABLE_CHANGE_XC_DELETE:
+            return sizeof(change.u.xcLeg);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Function Definition: Checksum(const journalRecord& record,
+ *                               const void* payload)
+ */
+unsigned int TableJournal::Checksum(const journalRecord& record, const void* payload)
+{
+    // 32 bit FNV-1a over the record header, less the checksum, and the
+    // payload.
+    unsigned int hash = 2166136261U;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+    for(size_t x = 0; x < offsetof(journalRecord, checksum); x++)
+    {
+        hash = (hash ^ bytes[x]) * 16777619U;
+    }
+    bytes = static_cast<const unsigned char*>(payload);
+    for(unsigned int x = 0; x < record.length; x++)
+    {
+        hash = (hash ^ bytes[x]) * 16777619U;
+    }
+    return hash;
+}
+
+/**
+ * Function Definition: WriteAll(int fd, const void* data, size_t length)
+ */
+bool TableJournal::WriteAll(int fd, const void* data, size_t length)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    while(length > 0)
+    {
+        ssize_t written = write(fd, bytes, length);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        length -= written;
+    }
+    return true;
+}
+
+/**
+ * Function Definition: Scan(int fd, TableChangeVisitor visitor,
+ *                           void* context, size_t& validEnd,
+ *                           unsigned long long& lastSequence)
+ */
+bool TableJournal::Scan(int fd, TableChangeVisitor visitor, void* context, size_t& validEnd, unsigned long long& lastSequence)
+{
+    struct stat info;
+    if((fstat(fd, &info) != 0)||((size_t)info.st_size < sizeof(journalHeader)))
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Scan - Journal Truncated!\n");
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void* image = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(image == MAP_FAILED)
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Scan - Cannot Map Journal!\n");
+        return false;
+    }
+    const unsigned char* bytes = static_cast<const unsigned char*>(image);
+
+    journalHeader expected;
+    MakeHeader(expected);
+    if(memcmp(bytes, &expected, sizeof(expected)) != 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableJournal::Scan - Journal Layout Does Not Match!\n");
+        munmap(image, size);
+        return false;
+    }
+
+    bool completed = true;
+    size_t offset = sizeof(journalHeader);
+    lastSequence = 0;
+    while((size - offset) >= sizeof(journalRecord))
+    {
+        journalRecord record;
+        memcpy(&record, bytes + offset, sizeof(record));
+        unsigned int length = PayloadLength(record.type);
+        if((length == 0)||(record.length != length)||((size - offset - sizeof(record)) < length)||
+           ((lastSequence != 0)&&(record.sequence != lastSequence + 1)))
+        {
+            break;
+        }
+
+        TableChange change;
+        memset(&change, 0, sizeof(change));
+        change.sequence = record.sequence;
+        change.type = record.type;
+        memcpy(&change.u, bytes + offset + sizeof(record), length);
+        if(Checksum(record, &change.u) != record.checksum)
+        {
+            break;
+        }
+
+        if((visitor != 0)&&(visitor(change, context) == false))
+        {
+            completed = false;
+            break;
+        }
+        offset += sizeof(record) + length;
+        lastSequence = record.sequence;
+    }
+
+    validEnd = offset;
+    munmap(image, size);
+    return completed;
+}
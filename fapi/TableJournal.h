@@ -0,0 +1,337 @@
+/**
+ * @file TableJournal.h
+ *
+ * @date 3 June 2005
+ *
+ * @brief The TableJournal records every change made to the TableManager
+ *        tables in an append only file.
+ *
+ * The TableJournal is a singleton. The TableManager hands it a TableChange
+ * for every change it makes, while it still holds its table locks, so the
+ * journal holds the changes in the order they were applied. The changes are
+ * written and synced to disk by a writer thread of the journal, several at
+ * a time, so configuration calls do not wait for the disk. Together with a
+ * snapshot (see TableSnapshot.h) the journal lets the tables be rebuilt
+ * after a restart.
+ *
+ * Design Notes:
+ *    The file starts with a journalHeader. Each change follows as a
+ *    journalRecord and length bytes of the member of TableChange::u named
+ *    by type. checksum is a 32 bit FNV-1a hash of the sequence, type and
+ *    length fields and the payload. Sequence numbers run on by one from
+ *    record to record.
+ *
+ *    Record() numbers a change and appends it to a pending buffer. The
+ *    writer thread waits up to _IX_CC_ATM_FAPI_JOURNAL_COMMIT_MS for more
+ *    changes to arrive, unless _IX_CC_ATM_FAPI_JOURNAL_GROUP_BYTES are
+ *    already pending, then writes the whole buffer with one write and one
+ *    fdatasync (group commit). Record() only waits for the writer when
+ *    _IX_CC_ATM_FAPI_JOURNAL_PENDING_MAX bytes are pending.
+ *
+ *    A crash can leave the last group partly written. Reading stops at the
+ *    first record whose checksum or sequence does not match, and Open()
+ *    cuts such a tail off before appending to the file.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __TABLEJOURNAL_H_
+#define __TABLEJOURNAL_H_
+
+/**
+ * User defined include files required.
+ */
+#include "TableChange.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <stddef.h>
+#include <vector>
+using namespace std;
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @typedef TableChangeVisitor
+ *
+ * @brief Typedef of the function TableJournal::Read() passes every change
+ *        to. Returning false stops the read.
+ *
+ */
+typedef bool (*TableChangeVisitor)(const TableChange& change, void* context);
+
+class TableJournal
+{
+public:
+    virtual ~TableJournal();
+
+    static TableJournal& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Open(const char* path)
+    *
+    * @brief Starts recording changes to a journal file.
+    *
+    * @param path const char* [in] - Journal file. It is created if it
+    *                                  does not exist.
+    *
+    * An existing journal is appended to. Its last change must be the last
+    * change applied to the tables, so a journal is replayed with
+    * TableManager::ReplayJournal() before it is opened again.
+    *
+    * @return bool - false if the file cannot be used or a journal is
+    *                already open.
+    */
+    bool Open(const char* path);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Close()
+    *
+    * @brief Writes every recorded change to disk and closes the journal.
+    *
+    * @return None
+    */
+    void Close();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Flush()
+    *
+    * @brief Waits until every change recorded so far is on disk.
+    *
+    * @return bool - false if the journal could not be written.
+    */
+    bool Flush();
+
+    bool IsOpen();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Record(TableChange& change)
+    *
+    * @brief Numbers a change and, if the journal is open, queues it for
+    *        the writer thread.
+    *
+    * @param change TableChange& [in/out] - The change, its sequence is
+    *                                         set.
+    *
+    * Changes are numbered whether or not the journal is open, so a
+    * snapshot can name the last change it holds.
+    *
+    * @return unsigned long long - Sequence number of the change.
+    */
+    unsigned long long Record(TableChange& change);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn GetSequence()
+    *
+    * @brief Sequence number of the last change recorded.
+    *
+    * @return unsigned long long
+    */
+    unsigned long long GetSequence();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn SetSequence(unsigned long long sequence)
+    *
+    * @brief Sets the sequence number of the last change, when the tables
+    *        are loaded from a snapshot or a journal.
+    *
+    * @return bool - false if the journal is open.
+    */
+    bool SetSequence(unsigned long long sequence);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Read(const char* path, TableChangeVisitor visitor, void* context)
+    *
+    * @brief Passes every change in a journal file to visitor, in order.
+    *
+    * @param path const char* [in] - Journal file.
+    * @param visitor TableChangeVisitor [in] - Called for each change.
+    * @param context void* [in] - Passed to visitor.
+    *
+    * A partly written tail is ignored.
+    *
+    * @return bool - false if the file is not a journal or visitor stopped
+    *                the read.
+    */
+    static bool Read(const char* path, TableChangeVisitor visitor, void* context);
+
+private:
+    TableJournal();
+    TableJournal(const TableJournal&);
+    TableJournal& operator =(const TableJournal&);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef journalHeader
+    *
+    * @brief Typedef of the header at the start of a journal file. The
+    *        record sizes reject a journal written by a build with a
+    *        different layout.
+    *
+    */
+    typedef struct
+    {
+        char magic[8];
+        unsigned int version;
+        unsigned int headerSize;
+        unsigned int ifRecordSize;
+        unsigned int vcRecordSize;
+        unsigned int legRecordSize;
+        unsigned int reserved;
+    } journalHeader;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef journalRecord
+    *
+    * @brief Typedef of the header of each change in a journal file.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long sequence;
+        unsigned short type;
+        unsigned short length;
+        unsigned int checksum;
+    } journalRecord;
+
+    static void* WriterThread(void* arg);
+    void WriteGroups();
+
+    static void MakeHeader(journalHeader& header);
+    static unsigned int PayloadLength(unsigned int type);
+    static unsigned int Checksum(const journalRecord& record, const void* payload);
+    static bool WriteAll(int fd, const void* data, size_t length);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Scan(int fd, TableChangeVisitor visitor, void* context,
+    *          size_t& validEnd, unsigned long long& lastSequence)
+    *
+    * @brief Checks the header of a journal file and reads its changes.
+    *
+    * @param validEnd size_t& [out] - Offset just past the last whole
+    *                                   change.
+    * @param lastSequence unsigned long long& [out] - Sequence of the last
+    *                                                   change, 0 if there
+    *                                                   is none.
+    *
+    * @return bool - false if the header does not match or visitor stopped
+    *                the read.
+    */
+    static bool Scan(int fd, TableChangeVisitor visitor, void* context, size_t& validEnd, unsigned long long& lastSequence);
+
+    /**
+    * TableJournal Member Variables.
+    *
+    * m_fd - The open journal file, -1 when closed.
+    *
+    * m_open - Set while Record() queues changes.
+    *
+    * m_stopping - Tells the writer thread to exit once m_pending is
+    *              written.
+    *
+    * m_failed - Set when a write or sync failed, later changes are not
+    *            queued.
+    *
+    * m_pending - Encoded changes waiting for the writer thread.
+    *
+    * m_writing - Group being written by the writer thread.
+    *
+    * m_sequence - Sequence of the last change recorded.
+    *
+    * m_queued - Sequence of the last change queued in m_pending.
+    *
+    * m_durable - Sequence of the last change synced to disk.
+    *
+    * m_lock - Guards everything above except m_writing.
+    *
+    * m_pendingCond - Signalled when changes are queued or on Close().
+    *
+    * m_durableCond - Signalled when a group has been written.
+    *
+    * m_spaceCond - Signalled when the writer takes m_pending.
+    *
+    * m_controlLock - Serialises Open() and Close().
+    *
+    */
+    int m_fd;
+    bool m_open;
+    bool m_stopping;
+    bool m_failed;
+    vector<unsigned char> m_pending;
+    vector<unsigned char> m_writing;
+    unsigned long long m_sequence;
+    unsigned long long m_queued;
+    unsigned long long m_durable;
+    pthread_t m_writer;
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_pendingCond;
+    pthread_cond_t m_durableCond;
+    pthread_cond_t m_spaceCond;
+    pthread_mutex_t m_controlLock;
+};
+#endif // #if !defined __TABLEJOURNAL_H_
+/**
+ *@}
+ */
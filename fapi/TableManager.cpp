@@ -49,30 +49,48 @@
  * User defined include files required.
  */
 #include "TableManager.h"
+#include "FAPIMetrics.h"
+#include "TableSnapshot.h"
+#include "TableJournal.h"
+#include "ChangeNotifier.h"
+#include "BatchValidator.h"
 #include "pthread.h"
 #include "APISimConfig.h"
 #include "TraceMacro.h"
 
+/*
+ * System defined include files required.
+ */
+#include <algorithm>
+#include <string>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 TableManager::TableManager()
+: m_numVCs(0)
 {    
 }
 
 TableManager::~TableManager()
 {
-    VCIterator atmVCIter = m_ATMVCTable.begin();
-    for(atmVCIter = m_ATMVCTable.begin(); atmVCIter != m_ATMVCTable.end(); atmVCIter++)
-    {
-        NPF_F_ATM_ConfigMgr_Vc_t vc = atmVCIter->second;
-        if(vc.link_B != 0)delete [] vc.link_B;      
-    }
-    
-    XCIterator atmXCIter = m_ATMXCTable.begin();
-    for(atmXCIter = m_ATMXCTable.begin(); atmXCIter != m_ATMXCTable.end(); atmXCIter++)
-    {
-        NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = atmXCIter->second;
-        if(xc.link_B !=0)delete [] xc.link_B;
-    }
+}
+
+TableManager::TableShard::TableShard()
+{
+    pthread_rwlock_init(&ifLock, 0);
+    pthread_rwlock_init(&vcLock, 0);
+    pthread_rwlock_init(&xcLock, 0);
+}
+
+TableManager::TableShard::~TableShard()
+{
+    // Link B arrays are held inline or by the LinkBPool, which frees them.
+    pthread_rwlock_destroy(&xcLock);
+    pthread_rwlock_destroy(&vcLock);
+    pthread_rwlock_destroy(&ifLock);
 }
 
 TableManager& TableManager::instance()
@@ -85,7 +103,7 @@ TableManager& TableManager::instance()
 /**
  * Function Definition: addATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t atmInterface)
  */
-bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
 {  
     APISimTrace(3,"Trace Level 3: TableManager::AddATMIf(..,%d,..)\n",numEntries);
     data.type = NPF_F_ATM_CONFIGMGR_IF_SET;
@@ -93,11 +111,49 @@ bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint3
     bool returnFlag = true;
     bool badInterfaceType = true;
     
+    // The whole batch is applied under the write locks of the shards of its
+    // interfaces, other clients see either none or all of its interfaces.
+    ShardLocks locks;
+    SetLocks(locks, 0);
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        locks.mode[ShardOf(atmInterface[x].ifID)] |= LOCK_IF_WRITE;
+    }
+    LockShards(locks);
+    
+    // A strict batch is checked as a whole first and only the failed 
+    // entries are reported if it cannot be applied.
+    if((strict == true)&&(ValidateIf(atmInterface, numEntries, data) == false))
+    {
+        UnlockShards(locks);
+        data.allOK = NPF_FALSE;
+        return false;
+    }
+    
+    // The entries of a large partial batch are checked in parallel first, 
+    // so applying them in order only has to catch the IDs that an earlier
+    // entry of the batch took.
+    vector<IFCheck> checks;
+    BatchKeySet keys;
+    if((strict == false)&&(numEntries >= _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN))
+    {
+        CheckIfs(atmInterface, numEntries, checks, keys);
+    }
+    
     for(unsigned int x = 0; x < numEntries; x++)
     {
         data.n_resp += 1;
         badInterfaceType = false;
         
+        if((checks.empty() == false)&&((checks[x].error != NPF_NO_ERROR)||(keys.Taken(checks[x].keySlot) == true)))
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMIf - Interface, %d, Cannot Be Added!\n",atmInterface[x].ifID);
+            data.resp[(data.n_resp - 1)].error = (checks[x].error != NPF_NO_ERROR) ? checks[x].error : NPF_E_RESOURCE_EXISTS;
+            data.resp[(data.n_resp - 1)].objId.ifID = atmInterface[x].ifID;
+            returnFlag = false;
+            continue;
+        }
+        
         if((atmInterface[x].ifType != NPF_F_ATM_IF_UNI)&&(atmInterface[x].ifType != NPF_F_ATM_IF_NNI))
         {
             APISimTrace(1,"Trace Level 1: TableManager::AddATMIf - Invalid Interface Type!\n");
@@ -109,11 +165,21 @@ bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint3
         
         if(badInterfaceType == false)
         {
-            pthread_mutex_lock(&syncMutex);       
-            InterfaceInsertPair insertReturn = m_ATMInterfaceTable.insert(InterfaceEntry(atmInterface[x].ifID, atmInterface[x]));        
-            pthread_mutex_unlock(&syncMutex);
+            IFRecord atmIf;
+            atmIf.cfg = atmInterface[x];
+            atmIf.firstVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+            atmIf.numVCs = 0;
+            
+            InterfaceInsertPair insertReturn = m_shards[ShardOf(atmInterface[x].ifID)].ifTable.Insert(atmInterface[x].ifID, atmIf);        
         
-            if(!insertReturn.second)
+            if(insertReturn.first == 0)
+            {
+                // Interface ID is outside the range held by the table
+                APISimTrace(1,"Trace Level 1: TableManager::AddATMIf - Invalid Interface ID!\n");
+                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE; 
+                data.resp[(data.n_resp - 1)].objId.ifID = atmInterface[x].ifID;
+                returnFlag = false;  
+            }else if(!insertReturn.second)
             {
                 // Entry already exists
                 //cfen: do we support an interface been updated, if so should
@@ -126,10 +192,27 @@ bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint3
             {
                 data.resp[(data.n_resp - 1)].error = NPF_NO_ERROR;
                 data.resp[(data.n_resp - 1)].objId.ifID = atmInterface[x].ifID;    
+                if(checks.empty() == false)
+                {
+                    keys.Take(checks[x].keySlot);
+                }
+                
+                TableChange change;
+                change.type = TABLE_CHANGE_IF_ADD;
+                change.u.ifCfg = atmInterface[x];
+                TableJournal::instance().Record(change);
+                
+                NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+                event.type = NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED;
+                event.u.ifCfg = atmInterface[x];
+                ChangeNotifier::instance().Collect(event);
             }
         }
     }
     
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
+    
     if(returnFlag == false)
     {
         data.allOK = NPF_FALSE;
@@ -142,65 +225,77 @@ bool TableManager::AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint3
 }
 
 /**
- * Function Definition: DeleteIf(NPF_F_ATM_ConfigMgr_IfCfg_t atmInterface)
+ * Function Definition: DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries,
+ *                               NPF_boolean_t delContainedObjs,
+ *                               NPF_F_ATM_ConfigMgr_CallbackData_t& data)
  */
-bool TableManager::DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+bool TableManager::DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_boolean_t delContainedObjs, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
 {  
-    APISimTrace(3,"Trace Level 3: TableManager::DeleteIf(..,%d,..)\n",numEntries);
+    APISimTrace(3,"Trace Level 3: TableManager::DeleteIf(..,%d,%d,..)\n",numEntries,delContainedObjs);
     data.type = NPF_F_ATM_CONFIGMGR_IF_DELETE;
     data.n_resp = 0;
     bool returnFlag = true;
     bool removeInterface = true;
     int n;
     
+    // Lock order is interface, VC, cross connect. The VC and cross connect
+    // tables are only written when contained objects are deleted, and then
+    // in every shard, as the VCs may be cross connected to any shard.
+    ShardLocks locks;
+    SetLocks(locks, (delContainedObjs == NPF_TRUE) ? (LOCK_VC_WRITE | LOCK_XC_WRITE) : 0);
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        locks.mode[ShardOf(delArray[x])] |= (delContainedObjs == NPF_TRUE) ? LOCK_IF_WRITE : (LOCK_IF_WRITE | LOCK_VC_READ);
+    }
+    LockShards(locks);
+    
+    if((strict == true)&&(ValidateIfDelete(delArray, numEntries, delContainedObjs, data) == false))
+    {
+        UnlockShards(locks);
+        data.allOK = NPF_FALSE;
+        return false;
+    }
+    
     for(unsigned int x = 0; x < numEntries; x++)
     {
         removeInterface = true;
         data.n_resp += 1;
         n = 0;
         
-        // Check if Interface has VC sub objects
-        VCIterator subObjVCFindIter;
-        
-        pthread_mutex_lock(&syncMutex);
-        for(subObjVCFindIter = m_ATMVCTable.begin(); subObjVCFindIter != m_ATMVCTable.end(); subObjVCFindIter++)
+        // Check if Interface has VC sub objects. The interface record heads
+        // the list of its own VCs, so no other table entries are visited.
+        IFTable& ifTable = m_shards[ShardOf(delArray[x])].ifTable;
+        IFRecord* atmIf = ifTable.Find(delArray[x]);
+        if((atmIf != 0)&&(atmIf->numVCs != 0))
         {
-            if(subObjVCFindIter->second.ifId == delArray[x])
+            if(delContainedObjs == NPF_FALSE)
             {
                 APISimTrace(1,"Trace Level 1: TableManager::DeleteIf - Interface, %d, Has Sub Objects!\n",delArray[x]); 
                 data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_CONT_OBJS_EXIST; 
                 data.resp[(data.n_resp - 1)].objId.ifID = delArray[x]; 
                 returnFlag = false;
                 removeInterface = false;
+            }else
+            {
+                APISimTrace(3,"Trace Level 3: TableManager::DeleteIf - Deleting %d Sub Objects Of Interface, %d\n",atmIf->numVCs,delArray[x]);
+                // DeleteVCEntry unlinks the VC from the head of the list.
+                while(atmIf->firstVC != _IX_CC_ATM_FAPI_NULL_LINK_ID)
+                {
+                    DeleteVCEntry(atmIf->firstVC, locks);
+                }
             }
-
         }
-        pthread_mutex_lock(&syncMutex);
                 
-//        // Check if Interface had VP sub objects
-//        VPIterator subObjVPFindIter;
-//        
-//        pthread_mutex_lock(&syncMutex);
-//        for(subObjVPFindIter = m_ATMVPTable.begin(); subObjVPFindIter != m_ATMVPTable.end(); subObjVPFindIter++)
-//        {
-//            if(subObjVPFindIter->second.ifId == delArray[x])
-//            {
-//                APISimTrace(1,"Trace Level 1: TableManager::DeleteIf - Interface, %d, Has Sub Objects!\n",delArray[x]); 
-//                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_CONT_OBJS_EXIST; 
-//                data.resp[(data.n_resp - 1)].objId.ifID = delArray[x]; 
-//                returnFlag = false;
-//                removeInterface = false;
-//            }
-//
-//        }
-//        pthread_mutex_lock(&syncMutex);
+        // VP links are not stored by the simulator. When they are, they
+        // belong in a per-interface list of their own.
+    
+        if(removeInterface == true)
+        {
+            n = ifTable.Erase(delArray[x]) ? 1 : 0;   
+        }
     
         if(removeInterface == true)
         {
-            pthread_mutex_lock(&syncMutex);    
-            n = m_ATMInterfaceTable.erase(delArray[x]);   
-            pthread_mutex_unlock(&syncMutex);
-            
             if(n == 0)
             {
                 APISimTrace(1,"Trace Level 1: TableManager::DeleteIf - Interface, %d, does not exist!\n",delArray[x]); 
@@ -212,9 +307,23 @@ bool TableManager::DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries,
             {
                 data.resp[(data.n_resp - 1)].error = NPF_NO_ERROR; 
                 data.resp[(data.n_resp - 1)].objId.ifID = delArray[x];                
+                
+                TableChange change;
+                change.type = TABLE_CHANGE_IF_DELETE;
+                change.u.ifDelete.ifId = delArray[x];
+                change.u.ifDelete.delContainedObjs = delContainedObjs;
+                TableJournal::instance().Record(change);
+                
+                NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+                event.type = NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED;
+                event.u.ifId = delArray[x];
+                ChangeNotifier::instance().Collect(event);
             }
         }
     }
+    
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
 
     if(returnFlag == false)
     {
@@ -230,7 +339,7 @@ bool TableManager::DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries,
 /**
  * Function Definition: addATMVC(NPF_F_ATM_ConfigMgr_Vc_t atmVC, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
  */
-bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
 {
     //HAVE TO UPDATE Response structure to correspond with ITP
     
@@ -242,17 +351,44 @@ bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEnt
     bool vcErrored;
     NPF_error_t errorCode;
 
+    // The interface tables are only read. The VC list kept in each interface
+    // record is protected by the VC table lock, which is held for the whole
+    // batch. A strict batch locks every shard, so the VC Link IDs it checks
+    // cannot be taken by another shard before it is applied.
+    ShardLocks locks;
+    SetLocks(locks, (strict == true) ? (LOCK_IF_READ | LOCK_VC_WRITE) : 0);
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        locks.mode[ShardOf(atmVC[x].ifId)] |= (LOCK_IF_READ | LOCK_VC_WRITE);
+    }
+    LockShards(locks);
+
+    if((strict == true)&&(ValidateVC(atmVC, numEntries, data, locks) == false))
+    {
+        UnlockShards(locks);
+        data.allOK = NPF_FALSE;
+        return false;
+    }
+
+    // The interfaces and addresses of a large partial batch are looked up
+    // in parallel first. Applying the batch in order then only has to 
+    // catch the addresses that an earlier entry of the batch took.
+    vector<VCCheck> checks;
+    BatchKeySet addresses;
+    BatchKeySet links;
+    if((strict == false)&&(numEntries >= _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN))
+    {
+        CheckVCs(atmVC, numEntries, false, locks, checks, addresses, links);
+    }
+
     for(unsigned int x = 0; x < numEntries; x++)
     {    
         vcErrored = false;
+        TableShard& shard = m_shards[ShardOf(atmVC[x].ifId)];
         // Check if interface exists
-        pthread_mutex_lock(&syncMutex); 
-          
-        IFIterator findIF = m_ATMInterfaceTable.find(atmVC[x].ifId);
-
-        pthread_mutex_unlock(&syncMutex);
+        IFRecord* findIF = (checks.empty() == true) ? shard.ifTable.Find(atmVC[x].ifId) : checks[x].atmIf;
         
-        if(findIF == m_ATMInterfaceTable.end())
+        if(findIF == 0)
         {
             APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Interface Does Not Exist!\n");
             errorCode = NPF_E_UNKNOWN;
@@ -260,44 +396,89 @@ bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEnt
             returnFlag = false;
         }
 
-        // Check if same vpi/vci pair exist under the specified interface in ATMVC entry
+        // Check if same vpi/vci pair exist under the specified interface in ATMVC entry.
+        // The address check, the link insert and the index update are done in one
+        // critical section so two callers cannot add the same address.
         if(vcErrored == false)
         {
-            pthread_mutex_lock(&syncMutex);
-            
-            VCIterator checkAddressIFMatch;
-            for(checkAddressIFMatch = m_ATMVCTable.begin(); checkAddressIFMatch != m_ATMVCTable.end(); checkAddressIFMatch++)
+            bool addressUsed = (checks.empty() == true) ?
+                               shard.addressIndex.Find(atmVC[x].ifId, atmVC[x].vc.vpi, atmVC[x].vc.vci, 0) :
+                               ((checks[x].addressUsed == true)||(addresses.Taken(checks[x].addressSlot) == true));
+            if(addressUsed == true)
+            {
+                APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Interface, VPI, VCI Entry Exists!\n");
+                errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS;
+                vcErrored = true;
+                returnFlag = false;           
+            }else if(__atomic_add_fetch(&m_numVCs, 1, __ATOMIC_SEQ_CST) > _IX_CC_ATM_FAPI_VC_LINK_MAX)
+            {
+                // The limit covers every shard, the VC is counted before it
+                // is added and uncounted if it is not.
+                __atomic_sub_fetch(&m_numVCs, 1, __ATOMIC_SEQ_CST);
+                APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - VC Table Full!\n");
+                errorCode = NPF_E_UNKNOWN;
+                vcErrored = true;
+                returnFlag = false;
+            }else
             {
-                if(checkAddressIFMatch->second.ifId == atmVC[x].ifId)
+                // Check if there is a similar virt link entry existing in table
+                VCRecord atmVCEntry;
+                atmVCEntry.cfg = atmVC[x];
+                atmVCEntry.prevVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+                atmVCEntry.nextVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+                // A new VC is not cross connected, the client's link_B 
+                // array is not kept.
+                atmVCEntry.cfg.numLink_B = 0;
+                atmVCEntry.cfg.link_B = 0;
+                atmVCEntry.xcRole = VC_XC_NONE;
+                atmVCEntry.linkBSize = 0;
+                VCInsertPair insertReturn = shard.vcTable.Insert(atmVC[x].vcLinkId, atmVCEntry);
+            
+                if(insertReturn.first == 0)
                 {
-                    if((checkAddressIFMatch->second.vc.vci == atmVC[x].vc.vci)&&
-                       (checkAddressIFMatch->second.vc.vpi == atmVC[x].vc.vpi))
+                    APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Invalid Virtual Link Id!\n");
+                    errorCode = NPF_ATM_F_E_INVALID_ATTRIBUTE; 
+                    vcErrored = true;
+                    returnFlag =  false;               
+                }else if(!insertReturn.second)
+                {
+                    APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Virtual Link Id Exists!\n");
+                    errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS; 
+                    vcErrored = true;
+                    returnFlag =  false;               
+                }else if((_IX_CC_ATM_FAPI_TABLE_SHARDS > 1)&&(m_vcShards.Claim(atmVC[x].vcLinkId, ShardOf(atmVC[x].ifId)) == false))
+                {
+                    // The VC Link ID is held by another shard.
+                    shard.vcTable.Erase(atmVC[x].vcLinkId);
+                    APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Virtual Link Id Exists!\n");
+                    errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS; 
+                    vcErrored = true;
+                    returnFlag =  false;               
+                }else
+                {
+                    shard.addressIndex.Insert(atmVC[x].ifId, atmVC[x].vc.vpi, atmVC[x].vc.vci, atmVC[x].vcLinkId);
+                    m_vcIndex.Set(atmVC[x].vcLinkId, insertReturn.first);
+                    LinkVC(findIF, insertReturn.first);
+                    if(checks.empty() == false)
                     {
-                        APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Interface, VPI, VCI Entry Exists!\n");
-                        errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS;
-                        vcErrored = true;
-                        returnFlag = false;           
-                    } 
+                        addresses.Take(checks[x].addressSlot);
+                    }
+                    
+                    TableChange change;
+                    change.type = TABLE_CHANGE_VC_ADD;
+                    change.u.vcCfg = insertReturn.first->cfg;
+                    TableJournal::instance().Record(change);
+                    
+                    NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+                    event.type = NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED;
+                    event.u.vcCfg = insertReturn.first->cfg;
+                    ChangeNotifier::instance().Collect(event);
+                }
+                
+                if(vcErrored == true)
+                {
+                    __atomic_sub_fetch(&m_numVCs, 1, __ATOMIC_SEQ_CST);
                 }
-            }
-            pthread_mutex_unlock(&syncMutex);
-        }
-        
-        // Check if there is a similar virt link entry existing in table
-        if(vcErrored == false)
-        {
-            pthread_mutex_lock(&syncMutex);
-            
-            VCInsertPair insertReturn = m_ATMVCTable.insert(VCEntry(atmVC[x].vcLinkId, atmVC[x]));
-            
-           pthread_mutex_unlock(&syncMutex);
-            
-            if(!insertReturn.second)
-            {
-                APISimTrace(1,"Trace Level 1: TableManager::AddATMVC - Virtual Link Id Exists!\n");
-                errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS; 
-                vcErrored = true;
-                returnFlag =  false;               
             }
         }       
         
@@ -311,6 +492,9 @@ bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEnt
         }
     }
     
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
+    
     if(returnFlag == false)
     {
         return false;        
@@ -324,7 +508,7 @@ bool TableManager::AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEnt
 /**
  * Function Definition: addATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t atmXC, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
  */
-bool TableManager::AddATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+bool TableManager::AddATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
 {
     //HAVE TO UPDATE Response structure to correspond with ITP
     
@@ -332,214 +516,2064 @@ bool TableManager::AddATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t
     data.type = NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_SET;
     data.n_resp = 0;
     bool returnFlag = true;
-    bool xcErrored;
     
-    for(unsigned int x = 0; x < numEntries; x++)
-    {    
-        xcErrored = false;
-        // Check if the cross connect type is valid
-        if(xcErrored == false)
-        {          
-            if((atmXC[x].link_B[0].xcType != NPF_F_ATM_EXT_TO_EXT)&&(atmXC[x].link_B[0].xcType != NPF_F_ATM_EXT_TO_INT)&&
-            (atmXC[x].link_B[0].xcType != NPF_F_ATM_EXT_TO_BACK)&&(atmXC[x].link_B[0].xcType != NPF_F_ATM_BACK_TO_INT))
+    // Both VC endpoints and the cross connect table are updated, the batch 
+    // holds both write locks, in the shard of every VC it names, so the 
+    // link lookups stay valid until the entries are written. The shards 
+    // are looked up before they are locked, so they are looked up again 
+    // once they are, and the batch starts over with the shards it missed.
+    // A VC added to a shard that is not locked is taken not to exist yet.
+    // A strict batch locks every shard.
+    ShardLocks locks;
+    if((strict == true)||(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1))
+    {
+        SetLocks(locks, LOCK_VC_WRITE | LOCK_XC_WRITE);
+        LockShards(locks);
+    }else
+    {
+        SetLocks(locks, 0);
+        AddXCShards(atmXC, numEntries, locks);
+        for(;;)
+        {
+            LockShards(locks);
+            ShardLocks needed = locks;
+            if(AddXCShards(atmXC, numEntries, needed) == false)
             {
-                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Invlaid Cross Connection Type!\n");
-                data.n_resp += 1;
-                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_A;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                xcErrored = true;
-                returnFlag = false;        
+                break;
             }
+            UnlockShards(locks);
+            locks = needed;
         }
-        
-        // Check to see if link A and link B match
-        if(xcErrored ==false)
+    }
+    
+    if((strict == true)&&(ValidateXC(atmXC, numEntries, data, locks) == false))
+    {
+        UnlockShards(locks);
+        data.allOK = NPF_FALSE;
+        return false;
+    }
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {    
+        // Each entry is checked in full before any of its legs is added.
+        if((CheckXCEntry(atmXC[x], 0, data.resp[data.n_resp], locks) == false)||
+           (ClaimXCEntry(atmXC[x], data.resp[data.n_resp]) == false))
         {
-            if(atmXC[x].link_A == atmXC[x].link_B[0].u.mapVcLink)
-            {
-                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A and Link B Are The Same!\n");
-                data.n_resp += 1;
-                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_A;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                xcErrored = true;
-                returnFlag = false;                
-            }       
-        }    
-        
-        // Check if link A exists and it is not part of any other cross connect
-        pthread_mutex_lock(&syncMutex);
-        
-        VCIterator findLinkA = m_ATMVCTable.find(atmXC[x].link_A); 
-        
-        pthread_mutex_unlock(&syncMutex);
-        
-        if(xcErrored == false)
+            data.n_resp += 1;
+            returnFlag = false;
+            continue;
+        }
+        AddXCEntry(atmXC[x], locks);
+    }
+    
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
+    
+    if(returnFlag == false)
+    {
+        data.allOK = NPF_FALSE;
+        return false;
+    }else
+    {
+        data.allOK = NPF_TRUE;
+        data.n_resp = 0;
+        return true;
+    }
+}
+
+/**
+ * Function Definition: DeleteVC(NPF_uint32_t* delArray, NPF_uint32_t numEntries,
+ *                               NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+ */
+bool TableManager::DeleteVC(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::DeleteVC(..,%d,..)\n",numEntries);
+    data.type = NPF_F_ATM_CONFIGMGR_VC_DELETE;
+    data.n_resp = 0;
+    bool returnFlag = true;
+    
+    // The shard of a VC is looked up before it is locked, so it is looked
+    // up again once it is, and the batch starts over with the shards it 
+    // missed. A strict batch locks every shard.
+    ShardLocks locks;
+    if((strict == true)||(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1))
+    {
+        SetLocks(locks, LOCK_IF_READ | LOCK_VC_WRITE);
+        LockShards(locks);
+    }else
+    {
+        SetLocks(locks, 0);
+        DeleteVCShards(delArray, numEntries, locks);
+        for(;;)
         {
-            if(findLinkA == m_ATMVCTable.end())
-            {
-                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A Does Not Exist!\n");
-                data.n_resp += 1;
-                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_A;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                xcErrored = true;
-                returnFlag = false;     
-            }else
+            LockShards(locks);
+            ShardLocks needed = locks;
+            if(DeleteVCShards(delArray, numEntries, needed) == false)
             {
-                if(findLinkA->second.numLink_B != 0)
-                {
-                    APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A Is Already Part Of A Cross Connect!\n");
-                    data.n_resp += 1;
-                    data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                    data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_A;
-                    data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                    xcErrored = true;
-                    returnFlag = false;
-                }                
+                break;
             }
+            UnlockShards(locks);
+            locks = needed;
+        }
+    }
+    
+    if((strict == true)&&(ValidateVCDelete(delArray, numEntries, data, locks) == false))
+    {
+        UnlockShards(locks);
+        data.allOK = NPF_FALSE;
+        return false;
+    }
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        data.n_resp += 1;
+        VCRecord* findVC = FindVC(delArray[x], locks);
+        if(findVC == 0)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::DeleteVC - Virtual Link, %d, Does Not Exist!\n",delArray[x]);
+            returnFlag = RejectLink(data.resp[(data.n_resp - 1)], NPF_E_RESOURCE_NONEXISTENT, delArray[x]);
+            continue;
+        }
+        if(findVC->xcRole != VC_XC_NONE)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::DeleteVC - Virtual Link, %d, Is Cross Connected!\n",delArray[x]);
+            returnFlag = RejectLink(data.resp[(data.n_resp - 1)], NPF_ATM_F_E_CONT_OBJS_EXIST, delArray[x]);
+            continue;
         }
         
-        // Check if link B exists and it is not part of any other cross connect
-        pthread_mutex_lock(&syncMutex);
+        TableChange change;
+        change.type = TABLE_CHANGE_VC_DELETE;
+        change.u.vcCfg = findVC->cfg;
+        change.u.vcCfg.numLink_B = 0;
+        change.u.vcCfg.link_B = 0;
         
-        VCIterator findLinkB = m_ATMVCTable.find(atmXC[x].link_B[0].u.mapVcLink); 
+        DeleteVCEntry(delArray[x], locks);
+        TableJournal::instance().Record(change);
         
-        pthread_mutex_unlock(&syncMutex);       
-        if(xcErrored == false)
-        {
+        data.resp[(data.n_resp - 1)].error = NPF_NO_ERROR;
+        data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = delArray[x];
+        data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
+    }
     
-            if(findLinkB == m_ATMVCTable.end())
-            {
-                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link B Does Not Exist!\n");
-                data.n_resp += 1;
-                data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_B[0].u.mapVcLink;
-                data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                xcErrored = true;
-                returnFlag = false;         
-            }else
-            {
-                if(findLinkB->second.numLink_B != 0)
-                {
-                    data.n_resp += 1;
-                    data.resp[(data.n_resp - 1)].error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
-                    data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmXC[x].link_B[0].u.mapVcLink;
-                    data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
-                    xcErrored = true;
-                    returnFlag = false;                    
-                }       
-            }
-        }
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
     
-        // Check if XC already exists, if not add a new entry.
-        if(xcErrored == false)
-        {
-            //atmXC.link_B = new NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t[1];
-            pthread_mutex_lock(&syncMutex);
-            pair<map<unsigned int, NPF_F_ATM_ConfigMgr_VcLinkXc_t>::iterator, bool> insertReturn = m_ATMXCTable.insert(XCEntry(atmXC[x].link_B[0].vcXcId, atmXC[x]));
-            
-            pthread_mutex_unlock(&syncMutex);
-            
-            if(!insertReturn.second)
-            {
-                map<unsigned int, NPF_F_ATM_ConfigMgr_VcLinkXc_t>::iterator iter = insertReturn.first;
-                data.n_resp += 1;
-                data.resp[(data.n_resp - 1)].error = NPF_E_RESOURCE_EXISTS;
-                data.resp[(data.n_resp - 1)].objId.vcXcId = iter->second.link_B[0].vcXcId;
-                // this method shows that the entry exists, this may be modified
-                // for new functionality as it is now obsolete
-                // no point to multi point functionality   
-                xcErrored = true;
-                returnFlag = false;   
-            }
-        
+    data.allOK = (returnFlag == true) ? NPF_TRUE : NPF_FALSE;
+    return returnFlag;
+}
+
+/**
+ * Function Definition: DeleteXC(NPF_uint32_t* delArray, NPF_uint32_t numEntries,
+ *                               NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+ */
+bool TableManager::DeleteXC(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::DeleteXC(..,%d,..)\n",numEntries);
+    data.type = NPF_F_ATM_CONFIGMGR_VC_CROSSCONNECT_DELETE;
+    data.n_resp = 0;
+    bool returnFlag = true;
     
-            if(xcErrored == false)
+    // A leg is held by the shard of its root, its leaf can be in any 
+    // shard. The shard of the leaf is only read from the leg once the 
+    // shard of the leg is locked, so the batch may have to start over 
+    // twice. A strict batch locks every shard.
+    ShardLocks locks;
+    if((strict == true)||(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1))
+    {
+        SetLocks(locks, LOCK_VC_WRITE | LOCK_XC_WRITE);
+        LockShards(locks);
+    }else
+    {
+        ShardLocks none;
+        SetLocks(none, 0);
+        SetLocks(locks, 0);
+        DeleteXCShards(delArray, numEntries, none, locks);
+        for(;;)
+        {
+            LockShards(locks);
+            ShardLocks needed = locks;
+            if(DeleteXCShards(delArray, numEntries, locks, needed) == false)
             {
-                pthread_mutex_lock(&syncMutex);
-                
-                insertReturn.first->second.link_B = new NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t[1];
-                insertReturn.first->second.link_B[0] = atmXC[x].link_B[0]; 
-    
-                findLinkA->second.link_B = new NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t[1];
-                findLinkA->second.numLink_B = 1;
-                findLinkA->second.link_B[0].vcXcId = atmXC[x].link_B[0].vcXcId;
-                findLinkA->second.link_B[0].xcType = NPF_F_ATM_EXT_TO_EXT;
-                findLinkA->second.link_B[0].u.mapVcLink = atmXC[x].link_B[0].u.mapVcLink;
- 
-                findLinkB->second.link_B = new NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t[1];   
-                findLinkB->second.numLink_B = 1;
-                findLinkB->second.link_B[0].vcXcId = atmXC[x].link_B[0].vcXcId;
-                findLinkB->second.link_B[0].xcType = NPF_F_ATM_EXT_TO_EXT;
-                findLinkB->second.link_B[0].u.mapVcLink = atmXC[x].link_A;
-                
-                pthread_mutex_unlock(&syncMutex);
+                break;
             }
+            UnlockShards(locks);
+            locks = needed;
         }
     }
     
-    if(returnFlag == false)
+    if((strict == true)&&(ValidateXCDelete(delArray, numEntries, data, locks) == false))
     {
+        UnlockShards(locks);
         data.allOK = NPF_FALSE;
         return false;
-    }else
+    }
+    
+    for(unsigned int x = 0; x < numEntries; x++)
     {
-        data.allOK = NPF_TRUE;
-        data.n_resp = 0;
-        return true;
+        data.n_resp += 1;
+        unsigned int shard = XCShard(delArray[x]);
+        XCRecord* findXC = 0;
+        if((shard != ShardDirectory::NONE)&&((locks.mode[shard] & LOCK_XC_WRITE) != 0))
+        {
+            findXC = m_shards[shard].xcTable.Find(delArray[x]);
+        }
+        if(findXC == 0)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::DeleteXC - Cross Connect, %d, Does Not Exist!\n",delArray[x]);
+            returnFlag = RejectXC(data.resp[(data.n_resp - 1)], NPF_E_RESOURCE_NONEXISTENT, delArray[x]);
+            continue;
+        }
+        
+        TableChange change;
+        change.type = TABLE_CHANGE_XC_DELETE;
+        change.u.xcLeg.link_A = findXC->cfg.link_A;
+        change.u.xcLeg.leg = findXC->inlineLinkB;
+        
+        DeleteXCEntry(delArray[x], locks);
+        TableJournal::instance().Record(change);
+        
+        data.resp[(data.n_resp - 1)].error = NPF_NO_ERROR;
+        data.resp[(data.n_resp - 1)].objId.vcXcId = delArray[x];
     }
+    
+    UnlockShards(locks);
+    ChangeNotifier::instance().Publish();
+    
+    data.allOK = (returnFlag == true) ? NPF_TRUE : NPF_FALSE;
+    return returnFlag;
 }
 
-//Test Operations for printing table contents
-void TableManager::printIf()
+/**
+ * Function Definition: DeleteVCEntry(unsigned int vcLinkId, 
+ *                                    const ShardLocks& locks)
+ */
+void TableManager::DeleteVCEntry(unsigned int vcLinkId, const ShardLocks& locks)
 {
-    IFIterator atmIfIter = m_ATMInterfaceTable.begin();
-    do{
-        NPF_F_ATM_ConfigMgr_IfCfg_t interface = atmIfIter->second;
-        printf("IfID: %d\n", interface.ifID);
-        printf("IfType: %d\n", interface.ifType);
-        printf("\n");
-        printf("\n");
-        atmIfIter++;
-    }while(atmIfIter != m_ATMInterfaceTable.end());
+    APISimTrace(3,"Trace Level 3: TableManager::DeleteVCEntry(%d)\n",vcLinkId);
+    VCRecord* findVC = FindVC(vcLinkId, locks);
+    if(findVC == 0)
+    {
+        return;
+    }
+    
+    // Tear down the cross connects first, they clear link_B on this VC. A
+    // root loses every leg, a leaf only its own.
+    if(findVC->xcRole == VC_XC_ROOT)
+    {
+        while(findVC->cfg.numLink_B != 0)
+        {
+            DeleteXCEntry(findVC->cfg.link_B[findVC->cfg.numLink_B - 1].vcXcId, locks);
+        }
+    }else if(findVC->xcRole == VC_XC_LEAF)
+    {
+        DeleteXCEntry(findVC->cfg.link_B[0].vcXcId, locks);
+    }
+    
+    NPF_F_ATM_ConfigMgr_Vc_t& vc = findVC->cfg;
+    TableShard& shard = m_shards[ShardOf(vc.ifId)];
+    shard.addressIndex.Erase(vc.ifId, vc.vc.vpi, vc.vc.vci);
+    UnlinkVC(findVC);
+    
+    NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+    event.type = NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED;
+    event.u.vcCfg = vc;
+    event.u.vcCfg.numLink_B = 0;
+    event.u.vcCfg.link_B = 0;
+    ChangeNotifier::instance().Collect(event);
+    
+    m_vcIndex.Clear(vcLinkId);
+    shard.vcTable.Erase(vcLinkId);
+    if(_IX_CC_ATM_FAPI_TABLE_SHARDS > 1)
+    {
+        m_vcShards.Release(vcLinkId);
+    }
+    __atomic_sub_fetch(&m_numVCs, 1, __ATOMIC_SEQ_CST);
 }
 
-void TableManager::printVc()
+/**
+ * Function Definition: DeleteXCEntry(unsigned int vcXcId, 
+ *                                    const ShardLocks& locks)
+ */
+void TableManager::DeleteXCEntry(unsigned int vcXcId, const ShardLocks& locks)
 {
-    VCIterator atmVCIter = m_ATMVCTable.begin();
-    do{
-        NPF_F_ATM_ConfigMgr_Vc_t vc = atmVCIter->second;
-        printf("LinkID: %d\n",vc.vcLinkId);
-        printf("VPI: %d\n", vc.vc.vpi);
-        printf("VCI: %d\n", vc.vc.vci);
-        printf("XC num link B: %d\n",vc.numLink_B);
-        if(vc.link_B!=0)
+    APISimTrace(3,"Trace Level 3: TableManager::DeleteXCEntry(%d)\n",vcXcId);
+    unsigned int xcShard = XCShard(vcXcId);
+    if(xcShard == ShardDirectory::NONE)
+    {
+        return;
+    }
+    TableShard& shard = m_shards[xcShard];
+    XCRecord* findXC = shard.xcTable.Find(vcXcId);
+    if(findXC == 0)
+    {
+        return;
+    }
+    
+    VCRecord* findLeaf = FindVC(findXC->inlineLinkB.u.mapVcLink, locks);
+    if(findLeaf != 0)
+    {
+        ClearLinkB(findLeaf);
+    }
+    
+    // The leg is swapped with the last leg of the root, which is held by 
+    // the same shard as the leg. A root left with one leg moves it back 
+    // inline.
+    VCRecord* findRoot = FindVC(findXC->cfg.link_A, locks);
+    if(findRoot != 0)
+    {
+        NPF_F_ATM_ConfigMgr_Vc_t& root = findRoot->cfg;
+        for(unsigned int y = 0; y < root.numLink_B; y++)
+        {
+            if(root.link_B[y].vcXcId == vcXcId)
+            {
+                root.link_B[y] = root.link_B[root.numLink_B - 1];
+                root.numLink_B--;
+                break;
+            }
+        }
+        if(root.numLink_B == 0)
+        {
+            ClearLinkB(findRoot);
+        }else if((root.numLink_B == 1)&&(findRoot->linkBSize > 1))
         {
-            printf("XC ID: %d\n", vc.link_B[0].vcXcId);
-            printf("XC Type: %d\n", vc.link_B[0].xcType);
-            printf("XC Link B: %d\n", vc.link_B[0].u.mapVcLink);      
+            findRoot->inlineLinkB = root.link_B[0];
+            shard.linkBPool.Release(root.link_B, findRoot->linkBSize);
+            root.link_B = &findRoot->inlineLinkB;
+            findRoot->linkBSize = 1;
         }
-        printf("\n");
-        printf("\n");
-        atmVCIter++;
-    }while(atmVCIter != m_ATMVCTable.end());
+    }
+    
+    NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+    event.type = NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED;
+    event.u.xcLeg.link_A = findXC->cfg.link_A;
+    event.u.xcLeg.leg = findXC->inlineLinkB;
+    ChangeNotifier::instance().Collect(event);
+    
+    shard.xcTable.Erase(vcXcId);
+    if(_IX_CC_ATM_FAPI_TABLE_SHARDS > 1)
+    {
+        m_xcShards.Release(vcXcId);
+    }
 }
 
-void TableManager::printXc()
+/**
+ * Function Definition: ValidateIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, 
+ *                                 NPF_uint32_t numEntries,
+ *                                 NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+ */
+bool TableManager::ValidateIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
 {
-    XCIterator atmXCIter = m_ATMXCTable.begin();
-    do{
-        NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = atmXCIter->second;
-        printf("Link A: %d\n",xc.link_A);
-        printf("Num Link B: %d\n",xc.numLink_B);
-        printf("XC ID: %d\n",xc.link_B[0].vcXcId);
-        printf("XC Type: %d\n",xc.link_B[0].xcType);
-        printf("Link B: %d\n",xc.link_B[0].u.mapVcLink);
-      
-        printf("\n");
-        printf("\n");
-        atmXCIter++;
-    }while(atmXCIter != m_ATMXCTable.end());
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateIf(..,%d,..)\n",numEntries);
+    vector<IFCheck> checks;
+    BatchKeySet keys;
+    vector<unsigned int> numAdded(_IX_CC_ATM_FAPI_TABLE_SHARDS, 0);
+    NPF_error_t errorCode;
+    
+    CheckIfs(atmInterface, numEntries, checks, keys);
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        errorCode = NPF_NO_ERROR;
+        unsigned int shard = ShardOf(atmInterface[x].ifID);
+        IFTable& ifTable = m_shards[shard].ifTable;
+        
+        if(checks[x].error != NPF_NO_ERROR)
+        {
+            errorCode = checks[x].error;
+        }else if(keys.First(checks[x].keySlot) != x)
+        {
+            errorCode = NPF_E_RESOURCE_EXISTS;
+        }else if(numAdded[shard] >= (ifTable.Capacity() - ifTable.Size()))
+        {
+            errorCode = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }else
+        {
+            numAdded[shard]++;
+        }
+        
+        if(errorCode != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateIf - Interface, %d, Cannot Be Added!\n",atmInterface[x].ifID);
+            data.n_resp += 1;
+            data.resp[(data.n_resp - 1)].error = errorCode;
+            data.resp[(data.n_resp - 1)].objId.ifID = atmInterface[x].ifID;
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: ValidateIfDelete(NPF_F_ATM_IfID_t *delArray, 
+ *                                       NPF_uint32_t numEntries,
+ *                                       NPF_boolean_t delContainedObjs,
+ *                                       NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+ */
+bool TableManager::ValidateIfDelete(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_boolean_t delContainedObjs, NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateIfDelete(..,%d,%d,..)\n",numEntries,delContainedObjs);
+    vector<NPF_error_t> errors(numEntries, NPF_NO_ERROR);
+    vector<BatchKey> keys(numEntries);
+    NPF_error_t errorCode;
+    
+    // An interface named twice no longer exists when the second entry is
+    // applied.
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        keys[x] = BatchKey(delArray[x], x);
+    }
+    MarkRepeatedKeys(keys, errors, NPF_E_RESOURCE_NONEXISTENT);
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        errorCode = NPF_NO_ERROR;
+        IFRecord* atmIf = m_shards[ShardOf(delArray[x])].ifTable.Find(delArray[x]);
+        
+        if(atmIf == 0)
+        {
+            errorCode = NPF_E_RESOURCE_NONEXISTENT;
+        }else if(errors[x] != NPF_NO_ERROR)
+        {
+            errorCode = errors[x];
+        }else if((atmIf->numVCs != 0)&&(delContainedObjs == NPF_FALSE))
+        {
+            errorCode = NPF_ATM_F_E_CONT_OBJS_EXIST;
+        }
+        
+        if(errorCode != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateIfDelete - Interface, %d, Cannot Be Deleted!\n",delArray[x]);
+            data.n_resp += 1;
+            data.resp[(data.n_resp - 1)].error = errorCode;
+            data.resp[(data.n_resp - 1)].objId.ifID = delArray[x];
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: ValidateVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, 
+ *                                 NPF_uint32_t numEntries,
+ *                                 NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+ *                                 const ShardLocks& locks)
+ */
+bool TableManager::ValidateVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateVC(..,%d,..)\n",numEntries);
+    vector<VCCheck> checks;
+    BatchKeySet addresses;
+    BatchKeySet links;
+    vector<unsigned int> shardAdded(_IX_CC_ATM_FAPI_TABLE_SHARDS, 0);
+    unsigned int numAdded = 0;
+    NPF_error_t errorCode;
+    
+    // Both the VC address and the VC Link ID must be unique in the batch.
+    CheckVCs(atmVC, numEntries, true, locks, checks, addresses, links);
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        errorCode = NPF_NO_ERROR;
+        unsigned int shard = ShardOf(atmVC[x].ifId);
+        TableShard& vcShard = m_shards[shard];
+        
+        if(checks[x].atmIf == 0)
+        {
+            errorCode = NPF_E_UNKNOWN;
+        }else if(checks[x].addressUsed == true)
+        {
+            errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS;
+        }else if((__atomic_load_n(&m_numVCs, __ATOMIC_SEQ_CST) + numAdded) >= _IX_CC_ATM_FAPI_VC_LINK_MAX)
+        {
+            errorCode = NPF_E_UNKNOWN;
+        }else if(checks[x].linkError != NPF_NO_ERROR)
+        {
+            errorCode = checks[x].linkError;
+        }else if((addresses.First(checks[x].addressSlot) != x)||(links.First(checks[x].linkSlot) != x))
+        {
+            errorCode = NPF_ATM_F_E_INVALID_VC_ADDRESS;
+        }else if(shardAdded[shard] >= (vcShard.vcTable.Capacity() - vcShard.vcTable.Size()))
+        {
+            errorCode = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }else
+        {
+            numAdded++;
+            shardAdded[shard]++;
+        }
+        
+        if(errorCode != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateVC - Virtual Link, %d, Cannot Be Added!\n",atmVC[x].vcLinkId);
+            data.n_resp += 1;
+            data.resp[(data.n_resp - 1)].error = errorCode; 
+            data.resp[(data.n_resp - 1)].objId.linkId.atm_linkID_t = atmVC[x].vcLinkId;
+            data.resp[(data.n_resp - 1)].objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: ValidateXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, 
+ *                                 NPF_uint32_t numEntries,
+ *                                 NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+ *                                 const ShardLocks& locks)
+ */
+bool TableManager::ValidateXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateXC(..,%d,..)\n",numEntries);
+    vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t> batchErrors(numEntries);
+    vector<BatchKey> linkKeys;
+    vector<BatchKey> xcKeys;
+    unsigned int numAdded = 0;
+    
+    // Every VC named by the batch is keyed with its entry number shifted 
+    // left by one, the low bit set when the VC is a leaf. Entries whose 
+    // legs cannot be read are left to CheckXCEntry().
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        batchErrors[x].error = NPF_NO_ERROR;
+        if((atmXC[x].numLink_B == 0)||(atmXC[x].link_B == 0)||(atmXC[x].numLink_B > _IX_CC_ATM_FAPI_XC_LEGS_MAX))
+        {
+            continue;
+        }
+        linkKeys.push_back(BatchKey(atmXC[x].link_A, x << 1));
+        for(unsigned int y = 0; y < atmXC[x].numLink_B; y++)
+        {
+            linkKeys.push_back(BatchKey(atmXC[x].link_B[y].u.mapVcLink, (x << 1) | 1));
+            xcKeys.push_back(BatchKey(atmXC[x].link_B[y].vcXcId, x));
+        }
+    }
+    sort(linkKeys.begin(), linkKeys.end());
+    sort(xcKeys.begin(), xcKeys.end());
+    
+    // A leaf VC cannot appear in any other entry. A root VC can be named by
+    // several entries as long as its legs stay within 
+    // _IX_CC_ATM_FAPI_XC_LEGS_MAX. Repeats inside one entry are left to 
+    // CheckXCEntry().
+    for(unsigned int first = 0, last = 0; first < linkKeys.size(); first = last)
+    {
+        bool leaf = false;
+        for(last = first; (last < linkKeys.size())&&(linkKeys[last].first == linkKeys[first].first); last++)
+        {
+            leaf = leaf || ((linkKeys[last].second & 1) != 0);
+        }
+        
+        VCRecord* findRoot = FindVC(linkKeys[first].first, locks);
+        unsigned int numLegs = ((findRoot != 0)&&(findRoot->xcRole == VC_XC_ROOT)) ? findRoot->cfg.numLink_B : 0;
+        for(unsigned int k = first; k < last; k++)
+        {
+            unsigned int x = linkKeys[k].second >> 1;
+            if((k > first)&&(x == (linkKeys[k - 1].second >> 1)))
+            {
+                continue;
+            }
+            numLegs += atmXC[x].numLink_B;
+            if(((leaf == true)&&(x != (linkKeys[first].second >> 1)))||
+               ((leaf == false)&&(numLegs > _IX_CC_ATM_FAPI_XC_LEGS_MAX)))
+            {
+                if(batchErrors[x].error == NPF_NO_ERROR)
+                {
+                    RejectLink(batchErrors[x], NPF_ATM_F_E_INVALID_ATTRIBUTE, linkKeys[k].first);
+                }
+            }
+        }
+    }
+    for(unsigned int k = 1; k < xcKeys.size(); k++)
+    {
+        unsigned int x = xcKeys[k].second;
+        if((xcKeys[k].first == xcKeys[k - 1].first)&&(x != xcKeys[k - 1].second)&&(batchErrors[x].error == NPF_NO_ERROR))
+        {
+            RejectXC(batchErrors[x], NPF_E_RESOURCE_EXISTS, xcKeys[k].first);
+        }
+    }
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        if(CheckXCEntry(atmXC[x], numAdded, data.resp[data.n_resp], locks) == false)
+        {
+            data.n_resp += 1;
+        }else if(batchErrors[x].error != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateXC - Entry %d Conflicts With An Earlier Entry!\n",x);
+            data.resp[data.n_resp] = batchErrors[x];
+            data.n_resp += 1;
+        }else
+        {
+            numAdded += atmXC[x].numLink_B;
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: ValidateVCDelete(NPF_uint32_t* delArray, 
+ *                                       NPF_uint32_t numEntries,
+ *                                       NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+ *                                       const ShardLocks& locks)
+ */
+bool TableManager::ValidateVCDelete(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateVCDelete(..,%d,..)\n",numEntries);
+    vector<NPF_error_t> errors(numEntries, NPF_NO_ERROR);
+    vector<BatchKey> keys(numEntries);
+    NPF_error_t errorCode;
+    
+    // A VC named twice no longer exists when the second entry is applied.
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        keys[x] = BatchKey(delArray[x], x);
+    }
+    MarkRepeatedKeys(keys, errors, NPF_E_RESOURCE_NONEXISTENT);
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        errorCode = NPF_NO_ERROR;
+        VCRecord* findVC = FindVC(delArray[x], locks);
+        
+        if(findVC == 0)
+        {
+            errorCode = NPF_E_RESOURCE_NONEXISTENT;
+        }else if(errors[x] != NPF_NO_ERROR)
+        {
+            errorCode = errors[x];
+        }else if(findVC->xcRole != VC_XC_NONE)
+        {
+            errorCode = NPF_ATM_F_E_CONT_OBJS_EXIST;
+        }
+        
+        if(errorCode != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateVCDelete - Virtual Link, %d, Cannot Be Deleted!\n",delArray[x]);
+            RejectLink(data.resp[data.n_resp], errorCode, delArray[x]);
+            data.n_resp += 1;
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: ValidateXCDelete(NPF_uint32_t* delArray, 
+ *                                       NPF_uint32_t numEntries,
+ *                                       NPF_F_ATM_ConfigMgr_CallbackData_t& data,
+ *                                       const ShardLocks& locks)
+ */
+bool TableManager::ValidateXCDelete(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ValidateXCDelete(..,%d,..)\n",numEntries);
+    vector<NPF_error_t> errors(numEntries, NPF_NO_ERROR);
+    vector<BatchKey> keys(numEntries);
+    
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        keys[x] = BatchKey(delArray[x], x);
+    }
+    MarkRepeatedKeys(keys, errors, NPF_E_RESOURCE_NONEXISTENT);
+    
+    // locks is what LockShards() has taken, a leg in a shard outside it is
+    // not read and is reported as missing.
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        unsigned int shard = XCShard(delArray[x]);
+        if((shard == ShardDirectory::NONE)||((locks.mode[shard] & LOCK_XC_WRITE) == 0)||
+           (m_shards[shard].xcTable.Find(delArray[x]) == 0))
+        {
+            errors[x] = NPF_E_RESOURCE_NONEXISTENT;
+        }
+        
+        if(errors[x] != NPF_NO_ERROR)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::ValidateXCDelete - Cross Connect, %d, Cannot Be Deleted!\n",delArray[x]);
+            RejectXC(data.resp[data.n_resp], errors[x], delArray[x]);
+            data.n_resp += 1;
+        }
+    }
+    
+    return (data.n_resp == 0);
+}
+
+/**
+ * Function Definition: MarkRepeatedKeys(vector<BatchKey>& keys, 
+ *                                       vector<NPF_error_t>& errors,
+ *                                       NPF_error_t error)
+ */
+void TableManager::MarkRepeatedKeys(vector<BatchKey>& keys, vector<NPF_error_t>& errors, NPF_error_t error)
+{
+    // Sorting on (key, entry) puts the earliest use of each key first.
+    sort(keys.begin(), keys.end());
+    for(unsigned int x = 1; x < keys.size(); x++)
+    {
+        if((keys[x].first == keys[x - 1].first)&&(errors[keys[x].second] == NPF_NO_ERROR))
+        {
+            errors[keys[x].second] = error;
+        }
+    }
+}
+
+/**
+ * Function Definition: CheckIfs(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, 
+ *                               NPF_uint32_t numEntries,
+ *                               vector<IFCheck>& checks, BatchKeySet& keys)
+ */
+void TableManager::CheckIfs(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, vector<IFCheck>& checks, BatchKeySet& keys)
+{
+    checks.resize(numEntries);
+    keys.Reset(numEntries);
+    ifCheckJob job = { this, atmInterface, &checks[0], &keys };
+    BatchValidator::instance().Run(CheckIfRange, &job, numEntries);
+}
+
+/**
+ * Function Definition: CheckVCs(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, 
+ *                               NPF_uint32_t numEntries, bool checkLinks,
+ *                               const ShardLocks& locks,
+ *                               vector<VCCheck>& checks, 
+ *                               BatchKeySet& addresses, BatchKeySet& links)
+ */
+void TableManager::CheckVCs(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, bool checkLinks, const ShardLocks& locks,
+                            vector<VCCheck>& checks, BatchKeySet& addresses, BatchKeySet& links)
+{
+    checks.resize(numEntries);
+    addresses.Reset(numEntries);
+    links.Reset((checkLinks == true) ? numEntries : 0);
+    vcCheckJob job = { this, atmVC, checkLinks, &locks, &checks[0], &addresses, &links };
+    BatchValidator::instance().Run(CheckVCRange, &job, numEntries);
+}
+
+/**
+ * Function Definition: CheckIfRange(void* context, unsigned int first,
+ *                                   unsigned int last)
+ */
+void TableManager::CheckIfRange(void* context, unsigned int first, unsigned int last)
+{
+    ifCheckJob* job = static_cast<ifCheckJob*>(context);
+    NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface = job->atmInterface;
+    
+    // Runs on the BatchValidator threads, so nothing is traced here.
+    for(unsigned int x = first; x < last; x++)
+    {
+        IFTable& ifTable = job->tables->m_shards[job->tables->ShardOf(atmInterface[x].ifID)].ifTable;
+        IFCheck& check = job->checks[x];
+        
+        if((atmInterface[x].ifType != NPF_F_ATM_IF_UNI)&&(atmInterface[x].ifType != NPF_F_ATM_IF_NNI))
+        {
+            check.error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }else if(ifTable.ValidKey(atmInterface[x].ifID) == false)
+        {
+            check.error = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }else if(ifTable.Find(atmInterface[x].ifID) != 0)
+        {
+            check.error = NPF_E_RESOURCE_EXISTS;
+        }else
+        {
+            check.error = NPF_NO_ERROR;
+        }
+        check.keySlot = job->keys->Insert(atmInterface[x].ifID, x);
+    }
+}
+
+/**
+ * Function Definition: CheckVCRange(void* context, unsigned int first,
+ *                                   unsigned int last)
+ */
+void TableManager::CheckVCRange(void* context, unsigned int first, unsigned int last)
+{
+    vcCheckJob* job = static_cast<vcCheckJob*>(context);
+    NPF_F_ATM_ConfigMgr_Vc_t* atmVC = job->atmVC;
+    
+    // Runs on the BatchValidator threads, so nothing is traced here.
+    for(unsigned int x = first; x < last; x++)
+    {
+        TableShard& vcShard = job->tables->m_shards[job->tables->ShardOf(atmVC[x].ifId)];
+        VCCheck& check = job->checks[x];
+        
+        check.atmIf = vcShard.ifTable.Find(atmVC[x].ifId);
+        check.addressUsed = (check.atmIf != 0)&&
+                            (vcShard.addressIndex.Find(atmVC[x].ifId, atmVC[x].vc.vpi, atmVC[x].vc.vci, 0) == true);
+        check.addressSlot = job->addresses->Insert(VCAddressIndex::MakeKey(atmVC[x].ifId, atmVC[x].vc.vpi, atmVC[x].vc.vci), x);
+        check.linkError = NPF_NO_ERROR;
+        check.linkSlot = 0;
+        if(job->checkLinks == false)
+        {
+            continue;
+        }
+        if(vcShard.vcTable.ValidKey(atmVC[x].vcLinkId) == false)
+        {
+            check.linkError = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }else if(job->tables->FindVC(atmVC[x].vcLinkId, *job->locks) != 0)
+        {
+            check.linkError = NPF_ATM_F_E_INVALID_VC_ADDRESS;
+        }
+        check.linkSlot = job->links->Insert(atmVC[x].vcLinkId, x);
+    }
+}
+
+/**
+ * Function Definition: SaveSnapshot(const char* path)
+ */
+bool TableManager::SaveSnapshot(const char* path)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::SaveSnapshot(%s)\n",path);
+    if(path == 0)
+    {
+        return false;
+    }
+    
+    // The snapshot is written next to the target and renamed over it once
+    // it is complete.
+    string tempPath = string(path) + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(file == 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::SaveSnapshot - Cannot Create %s!\n",tempPath.c_str());
+        return false;
+    }
+    
+    TableSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, _IX_CC_ATM_FAPI_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = _IX_CC_ATM_FAPI_SNAPSHOT_VERSION;
+    header.headerSize = sizeof(TableSnapshotHeader);
+    header.ifRecordSize = sizeof(NPF_F_ATM_ConfigMgr_IfCfg_t);
+    header.vcRecordSize = sizeof(NPF_F_ATM_ConfigMgr_Vc_t);
+    header.xcRecordSize = sizeof(TableSnapshotXC);
+    
+    // The header is written again with the counts and checksum at the end.
+    size_t offset = 0;
+    unsigned long long checksum = 0;
+    bool written = SnapshotWrite(file, &header, sizeof(header), offset, checksum);
+    checksum = SnapshotHash(0, 0, 0);
+    
+    // Every shard is locked so the snapshot is consistent across them. The
+    // records are written shard by shard.
+    ShardLocks locks;
+    SetLocks(locks, LOCK_IF_READ | LOCK_VC_READ | LOCK_XC_READ);
+    LockShards(locks);
+    
+    header.numIf = 0;
+    header.numVC = 0;
+    header.numXC = 0;
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        header.numIf += m_shards[s].ifTable.Size();
+        header.numVC += m_shards[s].vcTable.Size();
+        header.numXC += m_shards[s].xcTable.Size();
+    }
+    header.journalSequence = TableJournal::instance().GetSequence();
+    
+    const unsigned char padding[_IX_CC_ATM_FAPI_SNAPSHOT_ALIGN] = { 0 };
+    written = written && SnapshotWrite(file, padding, SnapshotAlign(offset) - offset, offset, checksum);
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        IFTable& ifTable = m_shards[s].ifTable;
+        for(IFIterator atmIfIter = ifTable.begin(); atmIfIter != ifTable.end(); atmIfIter++)
+        {
+            written = written && SnapshotWrite(file, &atmIfIter->second.cfg, sizeof(NPF_F_ATM_ConfigMgr_IfCfg_t), offset, checksum);
+        }
+    }
+    
+    written = written && SnapshotWrite(file, padding, SnapshotAlign(offset) - offset, offset, checksum);
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        VCTable& vcTable = m_shards[s].vcTable;
+        for(VCIterator atmVCIter = vcTable.begin(); atmVCIter != vcTable.end(); atmVCIter++)
+        {
+            NPF_F_ATM_ConfigMgr_Vc_t record = atmVCIter->second.cfg;
+            record.numLink_B = 0;
+            record.link_B = 0;
+            written = written && SnapshotWrite(file, &record, sizeof(record), offset, checksum);
+        }
+    }
+    
+    written = written && SnapshotWrite(file, padding, SnapshotAlign(offset) - offset, offset, checksum);
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        XCTable& xcTable = m_shards[s].xcTable;
+        for(XCIterator atmXCIter = xcTable.begin(); atmXCIter != xcTable.end(); atmXCIter++)
+        {
+            TableSnapshotXC record;
+            memset(&record, 0, sizeof(record));
+            record.cfg = atmXCIter->second.cfg;
+            record.cfg.link_B = 0;
+            record.leg = atmXCIter->second.inlineLinkB;
+            written = written && SnapshotWrite(file, &record, sizeof(record), offset, checksum);
+        }
+    }
+    
+    UnlockShards(locks);
+    
+    header.checksum = checksum;
+    written = written && (fseek(file, 0, SEEK_SET) == 0)&&
+              (fwrite(&header, sizeof(header), 1, file) == 1)&&
+              (fflush(file) == 0)&&(fsync(fileno(file)) == 0);
+    if(fclose(file) != 0)
+    {
+        written = false;
+    }
+    if(written == true)
+    {
+        written = (rename(tempPath.c_str(), path) == 0);
+    }
+    
+    if(written == false)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::SaveSnapshot - Cannot Write %s!\n",path);
+        unlink(tempPath.c_str());
+    }
+    return written;
+}
+
+/**
+ * Function Definition: RestoreSnapshot(const char* path)
+ */
+bool TableManager::RestoreSnapshot(const char* path)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::RestoreSnapshot(%s)\n",path);
+    if(path == 0)
+    {
+        return false;
+    }
+    
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreSnapshot - Cannot Open %s!\n",path);
+        return false;
+    }
+    
+    struct stat info;
+    if((fstat(fd, &info) != 0)||((size_t)info.st_size < sizeof(TableSnapshotHeader)))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreSnapshot - Snapshot Truncated!\n");
+        close(fd);
+        return false;
+    }
+    
+    size_t size = (size_t)info.st_size;
+    void* image = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreSnapshot - Cannot Map %s!\n",path);
+        return false;
+    }
+    
+    bool restored = RestoreImage(static_cast<const unsigned char*>(image), size);
+    munmap(image, size);
+    return restored;
+}
+
+/**
+ * Function Definition: RestoreImage(const unsigned char* image, size_t size)
+ */
+bool TableManager::RestoreImage(const unsigned char* image, size_t size)
+{
+    const TableSnapshotHeader* header = reinterpret_cast<const TableSnapshotHeader*>(image);
+    
+    if((memcmp(header->magic, _IX_CC_ATM_FAPI_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0)||
+       (header->version != _IX_CC_ATM_FAPI_SNAPSHOT_VERSION)||
+       (header->headerSize != sizeof(TableSnapshotHeader))||
+       (header->ifRecordSize != sizeof(NPF_F_ATM_ConfigMgr_IfCfg_t))||
+       (header->vcRecordSize != sizeof(NPF_F_ATM_ConfigMgr_Vc_t))||
+       (header->xcRecordSize != sizeof(TableSnapshotXC)))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Snapshot Layout Does Not Match!\n");
+        return false;
+    }
+    
+    // The counts are bounded by the tables before the offsets are worked 
+    // out, so the arithmetic below cannot overflow.
+    if((header->numIf > size)||(header->numVC > _IX_CC_ATM_FAPI_VC_LINK_MAX)||(header->numXC > _IX_CC_ATM_FAPI_XC_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Snapshot Counts Invalid!\n");
+        return false;
+    }
+    size_t ifOffset = SnapshotAlign(sizeof(TableSnapshotHeader));
+    size_t vcOffset = SnapshotAlign(ifOffset + (size_t)header->numIf * header->ifRecordSize);
+    size_t xcOffset = SnapshotAlign(vcOffset + (size_t)header->numVC * header->vcRecordSize);
+    if((xcOffset + (size_t)header->numXC * header->xcRecordSize) != size)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Snapshot Size Does Not Match!\n");
+        return false;
+    }
+    if(SnapshotHash(image + sizeof(TableSnapshotHeader), size - sizeof(TableSnapshotHeader), SnapshotHash(0, 0, 0)) != header->checksum)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Snapshot Checksum Does Not Match!\n");
+        return false;
+    }
+    
+    const NPF_F_ATM_ConfigMgr_IfCfg_t* ifRecords = reinterpret_cast<const NPF_F_ATM_ConfigMgr_IfCfg_t*>(image + ifOffset);
+    const NPF_F_ATM_ConfigMgr_Vc_t* vcRecords = reinterpret_cast<const NPF_F_ATM_ConfigMgr_Vc_t*>(image + vcOffset);
+    const TableSnapshotXC* xcRecords = reinterpret_cast<const TableSnapshotXC*>(image + xcOffset);
+    bool restored = true;
+    bool empty = true;
+    
+    ShardLocks locks;
+    SetLocks(locks, LOCK_IF_WRITE | LOCK_VC_WRITE | LOCK_XC_WRITE);
+    LockShards(locks);
+    
+    // The journal numbers the cross connects added below, the sequence is
+    // set to that of the snapshot once it is loaded.
+    unsigned long long previousSequence = TableJournal::instance().GetSequence();
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        empty = empty && (m_shards[s].ifTable.Size() == 0)&&(m_shards[s].vcTable.Size() == 0)&&(m_shards[s].xcTable.Size() == 0);
+    }
+    if((empty == false)||(TableJournal::instance().IsOpen() == true))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Tables Not Empty Or Journal Open!\n");
+        UnlockShards(locks);
+        return false;
+    }
+    
+    for(unsigned int x = 0; (restored == true)&&(x < header->numIf); x++)
+    {
+        IFRecord atmIf;
+        atmIf.cfg = ifRecords[x];
+        atmIf.firstVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+        atmIf.numVCs = 0;
+        
+        restored = ((atmIf.cfg.ifType == NPF_F_ATM_IF_UNI)||(atmIf.cfg.ifType == NPF_F_ATM_IF_NNI))&&
+                   (m_shards[ShardOf(atmIf.cfg.ifID)].ifTable.Insert(atmIf.cfg.ifID, atmIf).second == true);
+    }
+    
+    for(unsigned int x = 0; (restored == true)&&(x < header->numVC); x++)
+    {
+        VCRecord atmVC;
+        atmVC.cfg = vcRecords[x];
+        atmVC.cfg.numLink_B = 0;
+        atmVC.cfg.link_B = 0;
+        atmVC.prevVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+        atmVC.nextVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+        atmVC.xcRole = VC_XC_NONE;
+        atmVC.linkBSize = 0;
+        
+        TableShard& shard = m_shards[ShardOf(atmVC.cfg.ifId)];
+        IFRecord* findIF = shard.ifTable.Find(atmVC.cfg.ifId);
+        if((findIF == 0)||(shard.addressIndex.Find(atmVC.cfg.ifId, atmVC.cfg.vc.vpi, atmVC.cfg.vc.vci, 0) == true))
+        {
+            restored = false;
+            break;
+        }
+        VCInsertPair insertReturn = shard.vcTable.Insert(atmVC.cfg.vcLinkId, atmVC);
+        if(insertReturn.second == false)
+        {
+            restored = false;
+            break;
+        }
+        if((_IX_CC_ATM_FAPI_TABLE_SHARDS > 1)&&(m_vcShards.Claim(atmVC.cfg.vcLinkId, ShardOf(atmVC.cfg.ifId)) == false))
+        {
+            shard.vcTable.Erase(atmVC.cfg.vcLinkId);
+            restored = false;
+            break;
+        }
+        shard.addressIndex.Insert(atmVC.cfg.ifId, atmVC.cfg.vc.vpi, atmVC.cfg.vc.vci, atmVC.cfg.vcLinkId);
+        m_vcIndex.Set(atmVC.cfg.vcLinkId, insertReturn.first);
+        LinkVC(findIF, insertReturn.first);
+        __atomic_add_fetch(&m_numVCs, 1, __ATOMIC_SEQ_CST);
+    }
+    
+    // Each leg is checked and added like a single leg VcLinkXcSet entry.
+    for(unsigned int x = 0; (restored == true)&&(x < header->numXC); x++)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg = xcRecords[x].leg;
+        NPF_F_ATM_ConfigMgr_VcLinkXc_t atmXC = xcRecords[x].cfg;
+        NPF_F_ATM_ConfigMgr_AsyncResponse_t resp;
+        atmXC.numLink_B = 1;
+        atmXC.link_B = &leg;
+        
+        restored = (CheckXCEntry(atmXC, 0, resp, locks) == true)&&(ClaimXCEntry(atmXC, resp) == true);
+        if(restored == true)
+        {
+            AddXCEntry(atmXC, locks);
+        }
+    }
+    
+    if(restored == false)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::RestoreImage - Snapshot Records Invalid!\n");
+        ClearTables(locks);
+        TableJournal::instance().SetSequence(previousSequence);
+    }
+    else
+    {
+        APISimTrace(3,"Trace Level 3: TableManager::RestoreImage - Restored %d Interfaces, %d VCs, %d Cross Connects\n",
+                    header->numIf,header->numVC,header->numXC);
+        TableJournal::instance().SetSequence(header->journalSequence);
+    }
+    
+    UnlockShards(locks);
+    // A restore is not reported to change subscribers, the cross connects
+    // it added and the entries removed on failure are dropped.
+    ChangeNotifier::instance().Discard();
+    
+    return restored;
+}
+
+/**
+ * Function Definition: ReplayJournal(const char* path)
+ */
+bool TableManager::ReplayJournal(const char* path)
+{
+    APISimTrace(3,"Trace Level 3: TableManager::ReplayJournal(%s)\n",path);
+    if(TableJournal::instance().IsOpen() == true)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::ReplayJournal - Journal Open!\n");
+        return false;
+    }
+    
+    bool replayed = TableJournal::Read(path, ReplayChange, this);
+    APISimTrace(3,"Trace Level 3: TableManager::ReplayJournal - Tables At Change %llu\n",TableJournal::instance().GetSequence());
+    return replayed;
+}
+
+/**
+ * Function Definition: ReplayChange(const TableChange& change, void* context)
+ */
+bool TableManager::ReplayChange(const TableChange& change, void* context)
+{
+    unsigned long long sequence = TableJournal::instance().GetSequence();
+    if(change.sequence <= sequence)
+    {
+        return true;
+    }
+    if(change.sequence != (sequence + 1))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::ReplayChange - Journal Skips From %llu To %llu!\n",sequence,change.sequence);
+        return false;
+    }
+    
+    // Applying the change records it, which moves the sequence on to it.
+    if(static_cast<TableManager*>(context)->ApplyChange(change) == false)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::ReplayChange - Change %llu Cannot Be Applied!\n",change.sequence);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function Definition: ApplyChange(const TableChange& change)
+ */
+bool TableManager::ApplyChange(const TableChange& change)
+{
+    NPF_F_ATM_ConfigMgr_AsyncResponse_t resp;
+    NPF_F_ATM_ConfigMgr_CallbackData_t data;
+    data.allOK = NPF_TRUE;
+    data.n_resp = 0;
+    data.resp = &resp;
+    
+    TableChange entry = change;
+    switch(entry.type)
+    {
+        case TABLE_CHANGE_IF_ADD:
+            return AddATMIf(&entry.u.ifCfg, 1, data);
+        case TABLE_CHANGE_IF_DELETE:
+            return DeleteIf(&entry.u.ifDelete.ifId, 1, entry.u.ifDelete.delContainedObjs, data);
+        case TABLE_CHANGE_VC_ADD:
+            return AddATMVC(&entry.u.vcCfg, 1, data);
+        case TABLE_CHANGE_XC_ADD:
+        {
+            NPF_F_ATM_ConfigMgr_VcLinkXc_t atmXC;
+            atmXC.link_A = entry.u.xcLeg.link_A;
+            atmXC.numLink_B = 1;
+            atmXC.link_B = &entry.u.xcLeg.leg;
+            return AddATMXC(&atmXC, 1, data);
+        }
+        case TABLE_CHANGE_VC_DELETE:
+            return DeleteVC(&entry.u.vcCfg.vcLinkId, 1, data);
+        case TABLE_CHANGE_XC_DELETE:
+            return DeleteXC(&entry.u.xcLeg.leg.vcXcId, 1, data);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Function Definition: ClearTables(const ShardLocks& locks)
+ */
+void TableManager::ClearTables(const ShardLocks& locks)
+{
+    // Deleting a VC also deletes the cross connects it is part of, in any
+    // shard.
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        TableShard& shard = m_shards[s];
+        while(shard.vcTable.begin() != shard.vcTable.end())
+        {
+            DeleteVCEntry(shard.vcTable.begin()->first, locks);
+        }
+        while(shard.ifTable.begin() != shard.ifTable.end())
+        {
+            shard.ifTable.Erase(shard.ifTable.begin()->first);
+        }
+    }
+}
+
+/**
+ * Function Definition: SnapshotAlign(size_t offset)
+ */
+size_t TableManager::SnapshotAlign(size_t offset)
+{
+    return (offset + _IX_CC_ATM_FAPI_SNAPSHOT_ALIGN - 1) & ~(size_t)(_IX_CC_ATM_FAPI_SNAPSHOT_ALIGN - 1);
+}
+
+/**
+ * Function Definition: SnapshotHash(const void* data, size_t length,
+ *                                   unsigned long long hash)
+ */
+unsigned long long TableManager::SnapshotHash(const void* data, size_t length, unsigned long long hash)
+{
+    // 64 bit FNV-1a, a length of 0 with a hash of 0 returns the offset basis.
+    if((length == 0)&&(hash == 0))
+    {
+        return 14695981039346656037ULL;
+    }
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t x = 0; x < length; x++)
+    {
+        hash ^= bytes[x];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Function Definition: SnapshotWrite(FILE* file, const void* data, 
+ *                                    size_t length, size_t& offset,
+ *                                    unsigned long long& checksum)
+ */
+bool TableManager::SnapshotWrite(FILE* file, const void* data, size_t length, size_t& offset, unsigned long long& checksum)
+{
+    if(length == 0)
+    {
+        return true;
+    }
+    if(fwrite(data, length, 1, file) != 1)
+    {
+        return false;
+    }
+    offset += length;
+    checksum = SnapshotHash(data, length, checksum);
+    return true;
+}
+
+/**
+ * Function Definition: CheckXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, 
+ *                                   unsigned int numAdded,
+ *                                   NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp,
+ *                                   const ShardLocks& locks)
+ */
+bool TableManager::CheckXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, unsigned int numAdded, NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, const ShardLocks& locks)
+{
+    if((atmXC.numLink_B == 0)||(atmXC.link_B == 0)||(atmXC.numLink_B > _IX_CC_ATM_FAPI_XC_LEGS_MAX))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Invalid Number Of Link B!\n");
+        return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+    }
+    
+    // Check if link A exists and it is not a leaf of any other cross connect
+    VCRecord* findLinkA = FindVC(atmXC.link_A, locks); 
+    if(findLinkA == 0)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A Does Not Exist!\n");
+        return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+    }
+    if(findLinkA->xcRole == VC_XC_LEAF)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A Is Already Part Of A Cross Connect!\n");
+        return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+    }
+    if((findLinkA->cfg.numLink_B + atmXC.numLink_B) > _IX_CC_ATM_FAPI_XC_LEGS_MAX)
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A Has Too Many Legs!\n");
+        return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+    }
+    
+    // The legs are held by the shard of link A.
+    XCTable& xcTable = m_shards[ShardOf(findLinkA->cfg.ifId)].xcTable;
+    if((numAdded + atmXC.numLink_B) > (xcTable.Capacity() - xcTable.Size()))
+    {
+        APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Cross Connect Table Full!\n");
+        return RejectXC(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_B[0].vcXcId);
+    }
+    
+    for(unsigned int y = 0; y < atmXC.numLink_B; y++)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t& leg = atmXC.link_B[y];
+        
+        // Check if the cross connect type is valid
+        if((leg.xcType != NPF_F_ATM_EXT_TO_EXT)&&(leg.xcType != NPF_F_ATM_EXT_TO_INT)&&
+           (leg.xcType != NPF_F_ATM_EXT_TO_BACK)&&(leg.xcType != NPF_F_ATM_BACK_TO_INT))
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Invlaid Cross Connection Type!\n");
+            return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+        }
+        
+        // Check to see if link A and link B match
+        if(leg.u.mapVcLink == atmXC.link_A)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link A and Link B Are The Same!\n");
+            return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, atmXC.link_A);
+        }
+        
+        // Check if link B exists and it is not part of any other cross connect
+        VCRecord* findLinkB = FindVC(leg.u.mapVcLink, locks);
+        if(findLinkB == 0)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link B Does Not Exist!\n");
+            return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, leg.u.mapVcLink);
+        }
+        if(findLinkB->xcRole != VC_XC_NONE)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link B Is Already Part Of A Cross Connect!\n");
+            return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, leg.u.mapVcLink);
+        }
+        
+        if(xcTable.ValidKey(leg.vcXcId) == false)
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Invalid Cross Connect Id!\n");
+            return RejectXC(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, leg.vcXcId);
+        }
+        // With one shard the directory is not kept, the table is checked.
+        if(((_IX_CC_ATM_FAPI_TABLE_SHARDS == 1)&&(xcTable.Find(leg.vcXcId) != 0))||
+           ((_IX_CC_ATM_FAPI_TABLE_SHARDS > 1)&&(XCShard(leg.vcXcId) != ShardDirectory::NONE)))
+        {
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Cross Connect Exists!\n");
+            return RejectXC(resp, NPF_E_RESOURCE_EXISTS, leg.vcXcId);
+        }
+        
+        // The legs of one entry must name different leaves and cross 
+        // connects.
+        for(unsigned int z = 0; z < y; z++)
+        {
+            if(atmXC.link_B[z].u.mapVcLink == leg.u.mapVcLink)
+            {
+                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Link B Repeated!\n");
+                return RejectLink(resp, NPF_ATM_F_E_INVALID_ATTRIBUTE, leg.u.mapVcLink);
+            }
+            if(atmXC.link_B[z].vcXcId == leg.vcXcId)
+            {
+                APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Cross Connect Id Repeated!\n");
+                return RejectXC(resp, NPF_E_RESOURCE_EXISTS, leg.vcXcId);
+            }
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * Function Definition: ClaimXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC,
+ *                                   NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp)
+ */
+bool TableManager::ClaimXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp)
+{
+    if(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1)
+    {
+        return true;
+    }
+    
+    unsigned int shard = LinkShard(atmXC.link_A);
+    for(unsigned int y = 0; y < atmXC.numLink_B; y++)
+    {
+        unsigned int vcXcId = atmXC.link_B[y].vcXcId;
+        if(m_xcShards.Claim(vcXcId, shard) == false)
+        {
+            // Added by another shard since the entry was checked.
+            while(y > 0)
+            {
+                y--;
+                m_xcShards.Release(atmXC.link_B[y].vcXcId);
+            }
+            APISimTrace(1,"Trace Level 1: TableManager::AddATMXC - Cross Connect Exists!\n");
+            return RejectXC(resp, NPF_E_RESOURCE_EXISTS, vcXcId);
+        }
+    }
+    return true;
+}
+
+/**
+ * Function Definition: AddXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC,
+ *                                 const ShardLocks& locks)
+ */
+void TableManager::AddXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, const ShardLocks& locks)
+{
+    VCRecord* findLinkA = FindVC(atmXC.link_A, locks);
+    XCTable& xcTable = m_shards[ShardOf(findLinkA->cfg.ifId)].xcTable;
+    ReserveLinkB(findLinkA, findLinkA->cfg.numLink_B + atmXC.numLink_B);
+    findLinkA->xcRole = VC_XC_ROOT;
+    
+    for(unsigned int y = 0; y < atmXC.numLink_B; y++)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t& leg = atmXC.link_B[y];
+        
+        XCRecord atmXCEntry;
+        atmXCEntry.cfg = atmXC;
+        atmXCEntry.cfg.numLink_B = 1;
+        atmXCEntry.inlineLinkB = leg;
+        XCRecord* insertXC = xcTable.Insert(leg.vcXcId, atmXCEntry).first;
+        insertXC->cfg.link_B = &insertXC->inlineLinkB;
+        
+        findLinkA->cfg.link_B[findLinkA->cfg.numLink_B] = leg;
+        findLinkA->cfg.numLink_B++;
+        
+        VCRecord* findLinkB = FindVC(leg.u.mapVcLink, locks);
+        ReserveLinkB(findLinkB, 1);
+        findLinkB->xcRole = VC_XC_LEAF;
+        findLinkB->cfg.numLink_B = 1;
+        findLinkB->cfg.link_B[0].vcXcId = leg.vcXcId;
+        findLinkB->cfg.link_B[0].xcType = leg.xcType;
+        findLinkB->cfg.link_B[0].u.mapVcLink = atmXC.link_A;
+        
+        TableChange change;
+        change.type = TABLE_CHANGE_XC_ADD;
+        change.u.xcLeg.link_A = atmXC.link_A;
+        change.u.xcLeg.leg = leg;
+        TableJournal::instance().Record(change);
+        
+        NPF_F_ATM_ConfigMgr_ChangeEvent_t event;
+        event.type = NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED;
+        event.u.xcLeg.link_A = atmXC.link_A;
+        event.u.xcLeg.leg = leg;
+        ChangeNotifier::instance().Collect(event);
+    }
+}
+
+/**
+ * Function Definition: RejectLink(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp,
+ *                                 NPF_error_t error, unsigned int vcLinkId)
+ */
+bool TableManager::RejectLink(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, NPF_error_t error, unsigned int vcLinkId)
+{
+    resp.error = error;
+    resp.objId.linkId.atm_linkID_t = vcLinkId;
+    resp.objId.linkId.atm_linkType_t = NPF_F_ATM_VC_LINK;
+    return false;
+}
+
+/**
+ * Function Definition: RejectXC(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp,
+ *                               NPF_error_t error, unsigned int vcXcId)
+ */
+bool TableManager::RejectXC(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, NPF_error_t error, unsigned int vcXcId)
+{
+    resp.error = error;
+    resp.objId.vcXcId = vcXcId;
+    return false;
+}
+
+/**
+ * Function Definition: LockShards(const ShardLocks& locks)
+ */
+void TableManager::LockShards(const ShardLocks& locks)
+{
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        TableShard& shard = m_shards[s];
+        unsigned char mode = locks.mode[s];
+        if((mode & LOCK_IF_WRITE) != 0)
+        {
+            FAPIMetrics::WriteLock(&shard.ifLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF);
+        }else if((mode & LOCK_IF_READ) != 0)
+        {
+            FAPIMetrics::ReadLock(&shard.ifLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF);
+        }
+        if((mode & LOCK_VC_WRITE) != 0)
+        {
+            FAPIMetrics::WriteLock(&shard.vcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC);
+        }else if((mode & LOCK_VC_READ) != 0)
+        {
+            FAPIMetrics::ReadLock(&shard.vcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC);
+        }
+        if((mode & LOCK_XC_WRITE) != 0)
+        {
+            FAPIMetrics::WriteLock(&shard.xcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_XC);
+        }else if((mode & LOCK_XC_READ) != 0)
+        {
+            FAPIMetrics::ReadLock(&shard.xcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_XC);
+        }
+    }
+}
+
+/**
+ * Function Definition: UnlockShards(const ShardLocks& locks)
+ */
+void TableManager::UnlockShards(const ShardLocks& locks)
+{
+    for(unsigned int s = _IX_CC_ATM_FAPI_TABLE_SHARDS; s > 0; s--)
+    {
+        TableShard& shard = m_shards[s - 1];
+        unsigned char mode = locks.mode[s - 1];
+        if((mode & (LOCK_XC_READ | LOCK_XC_WRITE)) != 0)
+        {
+            pthread_rwlock_unlock(&shard.xcLock);
+        }
+        if((mode & (LOCK_VC_READ | LOCK_VC_WRITE)) != 0)
+        {
+            pthread_rwlock_unlock(&shard.vcLock);
+        }
+        if((mode & (LOCK_IF_READ | LOCK_IF_WRITE)) != 0)
+        {
+            pthread_rwlock_unlock(&shard.ifLock);
+        }
+    }
+}
+
+/**
+ * Function Definition: SetLocks(ShardLocks& locks, unsigned char mode)
+ */
+void TableManager::SetLocks(ShardLocks& locks, unsigned char mode)
+{
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        locks.mode[s] = mode;
+    }
+}
+
+/**
+ * Function Definition: ShardOf(NPF_F_ATM_IfID_t ifId)
+ */
+unsigned int TableManager::ShardOf(NPF_F_ATM_IfID_t ifId)
+{
+    return (unsigned int)(ifId % _IX_CC_ATM_FAPI_TABLE_SHARDS);
+}
+
+/**
+ * Function Definition: LinkShard(unsigned int vcLinkId)
+ */
+unsigned int TableManager::LinkShard(unsigned int vcLinkId)
+{
+    // A single shard holds every VC, the directory is not kept.
+    if(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1)
+    {
+        return 0;
+    }
+    return m_vcShards.Find(vcLinkId);
+}
+
+/**
+ * Function Definition: XCShard(unsigned int vcXcId)
+ */
+unsigned int TableManager::XCShard(unsigned int vcXcId)
+{
+    if(_IX_CC_ATM_FAPI_TABLE_SHARDS == 1)
+    {
+        return 0;
+    }
+    return m_xcShards.Find(vcXcId);
+}
+
+/**
+ * Function Definition: FindVC(unsigned int vcLinkId, const ShardLocks& locks)
+ */
+TableManager::VCRecord* TableManager::FindVC(unsigned int vcLinkId, const ShardLocks& locks)
+{
+    unsigned int shard = LinkShard(vcLinkId);
+    if((shard == ShardDirectory::NONE)||((locks.mode[shard] & (LOCK_VC_READ | LOCK_VC_WRITE)) == 0))
+    {
+        return 0;
+    }
+    return ShardVC(m_shards[shard], vcLinkId);
+}
+
+/**
+ * Function Definition: ShardVC(TableShard& shard, unsigned int vcLinkId)
+ */
+TableManager::VCRecord* TableManager::ShardVC(TableShard& shard, unsigned int vcLinkId)
+{
+    if(m_vcIndex.Covers(vcLinkId) == true)
+    {
+        return m_vcIndex.Find(vcLinkId);
+    }
+    return shard.vcTable.Find(vcLinkId);
+}
+
+/**
+ * Function Definition: AddXCShards(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC,
+ *                                  NPF_uint32_t numEntries, 
+ *                                  ShardLocks& locks)
+ */
+bool TableManager::AddXCShards(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, ShardLocks& locks)
+{
+    bool added = false;
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        // Entries whose legs cannot be read are left to CheckXCEntry().
+        unsigned int numLegs = atmXC[x].numLink_B;
+        if((atmXC[x].link_B == 0)||(numLegs > _IX_CC_ATM_FAPI_XC_LEGS_MAX))
+        {
+            numLegs = 0;
+        }
+        for(unsigned int y = 0; y <= numLegs; y++)
+        {
+            unsigned int shard = LinkShard((y == 0) ? atmXC[x].link_A : atmXC[x].link_B[y - 1].u.mapVcLink);
+            if((shard != ShardDirectory::NONE)&&((locks.mode[shard] & LOCK_VC_WRITE) == 0))
+            {
+                locks.mode[shard] |= (LOCK_VC_WRITE | LOCK_XC_WRITE);
+                added = true;
+            }
+        }
+    }
+    return added;
+}
+
+/**
+ * Function Definition: DeleteVCShards(NPF_uint32_t* delArray, 
+ *                                     NPF_uint32_t numEntries, 
+ *                                     ShardLocks& locks)
+ */
+bool TableManager::DeleteVCShards(NPF_uint32_t* delArray, NPF_uint32_t numEntries, ShardLocks& locks)
+{
+    bool added = false;
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        unsigned int shard = LinkShard(delArray[x]);
+        if((shard != ShardDirectory::NONE)&&((locks.mode[shard] & LOCK_VC_WRITE) == 0))
+        {
+            locks.mode[shard] |= (LOCK_IF_READ | LOCK_VC_WRITE);
+            added = true;
+        }
+    }
+    return added;
+}
+
+/**
+ * Function Definition: DeleteXCShards(NPF_uint32_t* delArray, 
+ *                                     NPF_uint32_t numEntries, 
+ *                                     const ShardLocks& held,
+ *                                     ShardLocks& locks)
+ */
+bool TableManager::DeleteXCShards(NPF_uint32_t* delArray, NPF_uint32_t numEntries, const ShardLocks& held, ShardLocks& locks)
+{
+    bool added = false;
+    for(unsigned int x = 0; x < numEntries; x++)
+    {
+        unsigned int shard = XCShard(delArray[x]);
+        if(shard == ShardDirectory::NONE)
+        {
+            continue;
+        }
+        if((locks.mode[shard] & LOCK_XC_WRITE) == 0)
+        {
+            locks.mode[shard] |= (LOCK_VC_WRITE | LOCK_XC_WRITE);
+            added = true;
+        }
+        
+        // A shard asked for by an earlier entry of this pass is in locks 
+        // but not yet taken, the leg is only read from a shard in held.
+        if((held.mode[shard] & LOCK_XC_WRITE) == 0)
+        {
+            continue;
+        }
+        XCRecord* findXC = m_shards[shard].xcTable.Find(delArray[x]);
+        if(findXC == 0)
+        {
+            continue;
+        }
+        unsigned int leafShard = LinkShard(findXC->inlineLinkB.u.mapVcLink);
+        if((leafShard != ShardDirectory::NONE)&&((locks.mode[leafShard] & LOCK_VC_WRITE) == 0))
+        {
+            locks.mode[leafShard] |= LOCK_VC_WRITE;
+            added = true;
+        }
+    }
+    return added;
+}
+
+/**
+ * Function Definition: ReserveLinkB(VCRecord* atmVC, unsigned int numLegs)
+ */
+void TableManager::ReserveLinkB(VCRecord* atmVC, unsigned int numLegs)
+{
+    if(numLegs <= atmVC->linkBSize)
+    {
+        return;
+    }
+    if(numLegs == 1)
+    {
+        atmVC->cfg.link_B = &atmVC->inlineLinkB;
+        atmVC->linkBSize = 1;
+        return;
+    }
+    
+    LinkBPool& linkBPool = m_shards[ShardOf(atmVC->cfg.ifId)].linkBPool;
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t* legs = linkBPool.Acquire(numLegs);
+    for(unsigned int y = 0; y < atmVC->cfg.numLink_B; y++)
+    {
+        legs[y] = atmVC->cfg.link_B[y];
+    }
+    if(atmVC->linkBSize > 1)
+    {
+        linkBPool.Release(atmVC->cfg.link_B, atmVC->linkBSize);
+    }
+    atmVC->cfg.link_B = legs;
+    atmVC->linkBSize = LinkBPool::Capacity(numLegs);
+}
+
+/**
+ * Function Definition: ClearLinkB(VCRecord* atmVC)
+ */
+void TableManager::ClearLinkB(VCRecord* atmVC)
+{
+    if(atmVC->linkBSize > 1)
+    {
+        m_shards[ShardOf(atmVC->cfg.ifId)].linkBPool.Release(atmVC->cfg.link_B, atmVC->linkBSize);
+    }
+    atmVC->cfg.link_B = 0;
+    atmVC->cfg.numLink_B = 0;
+    atmVC->linkBSize = 0;
+    atmVC->xcRole = VC_XC_NONE;
+}
+
+/**
+ * Function Definition: LinkVC(IFRecord* atmIf, VCRecord* atmVC)
+ */
+void TableManager::LinkVC(IFRecord* atmIf, VCRecord* atmVC)
+{
+    // New VCs go to the head of the interface list.
+    atmVC->prevVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+    atmVC->nextVC = atmIf->firstVC;
+    if(atmIf->firstVC != _IX_CC_ATM_FAPI_NULL_LINK_ID)
+    {
+        ShardVC(m_shards[ShardOf(atmIf->cfg.ifID)], atmIf->firstVC)->prevVC = atmVC->cfg.vcLinkId;
+    }
+    atmIf->firstVC = atmVC->cfg.vcLinkId;
+    atmIf->numVCs++;
+}
+
+/**
+ * Function Definition: UnlinkVC(VCRecord* atmVC)
+ */
+void TableManager::UnlinkVC(VCRecord* atmVC)
+{
+    TableShard& shard = m_shards[ShardOf(atmVC->cfg.ifId)];
+    IFRecord* atmIf = shard.ifTable.Find(atmVC->cfg.ifId);
+    if(atmIf == 0)
+    {
+        return;
+    }
+    
+    if(atmVC->prevVC == _IX_CC_ATM_FAPI_NULL_LINK_ID)
+    {
+        atmIf->firstVC = atmVC->nextVC;
+    }else
+    {
+        ShardVC(shard, atmVC->prevVC)->nextVC = atmVC->nextVC;
+    }
+    if(atmVC->nextVC != _IX_CC_ATM_FAPI_NULL_LINK_ID)
+    {
+        ShardVC(shard, atmVC->nextVC)->prevVC = atmVC->prevVC;
+    }
+    atmVC->prevVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+    atmVC->nextVC = _IX_CC_ATM_FAPI_NULL_LINK_ID;
+    atmIf->numVCs--;
+}
+
+/**
+ * Function Definition: QueryVCs(unsigned int lastLinkId, 
+ *                               unsigned int& cursor, VCInfo* vcs,
+ *                               unsigned int maxEntries)
+ */
+unsigned int TableManager::QueryVCs(unsigned int lastLinkId, unsigned int& cursor, VCInfo* vcs, unsigned int maxEntries)
+{
+    if((vcs == 0)||(maxEntries == 0)||(cursor == _IX_CC_ATM_FAPI_QUERY_END))
+    {
+        return 0;
+    }
+    
+    unsigned int found = 0;
+    unsigned int vcLinkId = cursor;
+    unsigned int shardLinkId[_IX_CC_ATM_FAPI_TABLE_SHARDS];
+    VCRecord* shardVC[_IX_CC_ATM_FAPI_TABLE_SHARDS];
+    VCRecord* findVC = 0;
+    ShardLocks locks;
+    SetLocks(locks, LOCK_VC_READ);
+    
+    // Every shard is walked in VC Link ID order, the next VC of the range 
+    // is the lowest of the next VCs of the shards.
+    LockShards(locks);
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        shardLinkId[s] = cursor;
+        shardVC[s] = m_shards[s].vcTable.FindNext(shardLinkId[s]);
+    }
+    for(;;)
+    {
+        unsigned int next = _IX_CC_ATM_FAPI_TABLE_SHARDS;
+        for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+        {
+            if((shardVC[s] != 0)&&((next == _IX_CC_ATM_FAPI_TABLE_SHARDS)||(shardLinkId[s] < shardLinkId[next])))
+            {
+                next = s;
+            }
+        }
+        if(next == _IX_CC_ATM_FAPI_TABLE_SHARDS)
+        {
+            findVC = 0;
+            break;
+        }
+        
+        findVC = shardVC[next];
+        vcLinkId = shardLinkId[next];
+        if((vcLinkId > lastLinkId)||(found == maxEntries))
+        {
+            break;
+        }
+        MakeVCInfo(*findVC, vcs[found++]);
+        if(vcLinkId == lastLinkId)
+        {
+            findVC = 0;
+            break;
+        }
+        shardLinkId[next] = vcLinkId + 1;
+        shardVC[next] = m_shards[next].vcTable.FindNext(shardLinkId[next]);
+    }
+    UnlockShards(locks);
+    
+    // The loop only stops on a VC inside the range when vcs is full.
+    cursor = ((findVC != 0)&&(vcLinkId <= lastLinkId)) ? vcLinkId : _IX_CC_ATM_FAPI_QUERY_END;
+    return found;
+}
+
+/**
+ * Function Definition: QueryIfVCs(NPF_F_ATM_IfID_t ifId, 
+ *                                 unsigned int& cursor, VCInfo* vcs,
+ *                                 unsigned int maxEntries)
+ */
+unsigned int TableManager::QueryIfVCs(NPF_F_ATM_IfID_t ifId, unsigned int& cursor, VCInfo* vcs, unsigned int maxEntries)
+{
+    if((vcs == 0)||(maxEntries == 0)||(cursor == _IX_CC_ATM_FAPI_QUERY_END))
+    {
+        return 0;
+    }
+    
+    unsigned int found = 0;
+    bool more = false;
+    
+    // The interface and its VCs are held by one shard.
+    TableShard& shard = m_shards[ShardOf(ifId)];
+    FAPIMetrics::ReadLock(&shard.ifLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF);
+    FAPIMetrics::ReadLock(&shard.vcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC);
+    
+    IFRecord* findIF = shard.ifTable.Find(ifId);
+    if(findIF == 0)
+    {
+        pthread_rwlock_unlock(&shard.vcLock);
+        pthread_rwlock_unlock(&shard.ifLock);
+        cursor = _IX_CC_ATM_FAPI_QUERY_END;
+        return 0;
+    }
+    
+    // The interface list is not kept in VC Link ID order, so vcs is used as 
+    // a max heap holding the lowest VC Link IDs from cursor seen so far.
+    for(unsigned int vcLinkId = findIF->firstVC; vcLinkId != _IX_CC_ATM_FAPI_NULL_LINK_ID; )
+    {
+        VCRecord* findVC = ShardVC(shard, vcLinkId);
+        if(vcLinkId >= cursor)
+        {
+            if(found < maxEntries)
+            {
+                MakeVCInfo(*findVC, vcs[found++]);
+                push_heap(vcs, vcs + found, VCInfoLess);
+            }else
+            {
+                more = true;
+                if(vcLinkId < vcs[0].vcLinkId)
+                {
+                    pop_heap(vcs, vcs + found, VCInfoLess);
+                    MakeVCInfo(*findVC, vcs[found - 1]);
+                    push_heap(vcs, vcs + found, VCInfoLess);
+                }
+            }
+        }
+        vcLinkId = findVC->nextVC;
+    }
+    
+    pthread_rwlock_unlock(&shard.vcLock);
+    pthread_rwlock_unlock(&shard.ifLock);
+    
+    sort_heap(vcs, vcs + found, VCInfoLess);
+    cursor = (more == true) ? (vcs[found - 1].vcLinkId + 1) : _IX_CC_ATM_FAPI_QUERY_END;
+    return found;
+}
+
+/**
+ * Function Definition: QueryLinkXCs(unsigned int vcLinkId, 
+ *                                   unsigned int& cursor, XCInfo* xcs,
+ *                                   unsigned int maxEntries)
+ */
+unsigned int TableManager::QueryLinkXCs(unsigned int vcLinkId, unsigned int& cursor, XCInfo* xcs, unsigned int maxEntries)
+{
+    if((xcs == 0)||(maxEntries == 0)||(cursor == _IX_CC_ATM_FAPI_QUERY_END))
+    {
+        return 0;
+    }
+    
+    unsigned int found = 0;
+    bool more = false;
+    
+    // The legs are read from the link_B array of the VC, which holds the 
+    // same vcXcId and type as the cross connect table. The shard of the VC
+    // is looked up again once it is locked, the VC may have been deleted
+    // and added to another shard in between.
+    unsigned int shard = LinkShard(vcLinkId);
+    VCRecord* findVC = 0;
+    while(shard != ShardDirectory::NONE)
+    {
+        FAPIMetrics::ReadLock(&m_shards[shard].vcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC);
+        if(LinkShard(vcLinkId) == shard)
+        {
+            findVC = ShardVC(m_shards[shard], vcLinkId);
+            break;
+        }
+        pthread_rwlock_unlock(&m_shards[shard].vcLock);
+        shard = LinkShard(vcLinkId);
+    }
+    if(findVC == 0)
+    {
+        if(shard != ShardDirectory::NONE)
+        {
+            pthread_rwlock_unlock(&m_shards[shard].vcLock);
+        }
+        cursor = _IX_CC_ATM_FAPI_QUERY_END;
+        return 0;
+    }
+    
+    for(unsigned int y = 0; y < findVC->cfg.numLink_B; y++)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t& leg = findVC->cfg.link_B[y];
+        if(leg.vcXcId < cursor)
+        {
+            continue;
+        }
+        if(found == maxEntries)
+        {
+            more = true;
+            if(leg.vcXcId > xcs[0].vcXcId)
+            {
+                continue;
+            }
+            pop_heap(xcs, xcs + found, XCInfoLess);
+            found--;
+        }
+        
+        XCInfo& info = xcs[found++];
+        info.vcXcId = leg.vcXcId;
+        info.xcType = leg.xcType;
+        if(findVC->xcRole == VC_XC_LEAF)
+        {
+            info.link_A = leg.u.mapVcLink;
+            info.link_B = vcLinkId;
+        }else
+        {
+            info.link_A = vcLinkId;
+            info.link_B = leg.u.mapVcLink;
+        }
+        push_heap(xcs, xcs + found, XCInfoLess);
+    }
+    
+    pthread_rwlock_unlock(&m_shards[shard].vcLock);
+    
+    sort_heap(xcs, xcs + found, XCInfoLess);
+    cursor = (more == true) ? (xcs[found - 1].vcXcId + 1) : _IX_CC_ATM_FAPI_QUERY_END;
+    return found;
+}
+
+/**
+ * Function Definition: MakeVCInfo(const VCRecord& atmVC, VCInfo& info)
+ */
+void TableManager::MakeVCInfo(const VCRecord& atmVC, VCInfo& info)
+{
+    info.vcLinkId = atmVC.cfg.vcLinkId;
+    info.ifId = atmVC.cfg.ifId;
+    info.vc = atmVC.cfg.vc;
+    info.xcRole = atmVC.xcRole;
+    info.numLegs = (unsigned short)atmVC.cfg.numLink_B;
+}
+
+/**
+ * Function Definition: VCInfoLess(const VCInfo& first, const VCInfo& second)
+ */
+bool TableManager::VCInfoLess(const VCInfo& first, const VCInfo& second)
+{
+    return (first.vcLinkId < second.vcLinkId);
+}
+
+/**
+ * Function Definition: XCInfoLess(const XCInfo& first, const XCInfo& second)
+ */
+bool TableManager::XCInfoLess(const XCInfo& first, const XCInfo& second)
+{
+    return (first.vcXcId < second.vcXcId);
+}
+
+//Test Operations for printing table contents
+void TableManager::printIf()
+{
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        TableShard& shard = m_shards[s];
+        FAPIMetrics::ReadLock(&shard.ifLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_IF);
+        for(IFIterator atmIfIter = shard.ifTable.begin(); atmIfIter != shard.ifTable.end(); atmIfIter++)
+        {
+            const NPF_F_ATM_ConfigMgr_IfCfg_t& interface = atmIfIter->second.cfg;
+            printf("IfID: %d\n", interface.ifID);
+            printf("IfType: %d\n", interface.ifType);
+            printf("\n");
+            printf("\n");
+        }
+        pthread_rwlock_unlock(&shard.ifLock);
+    }
+}
+
+void TableManager::printVc()
+{
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        TableShard& shard = m_shards[s];
+        FAPIMetrics::ReadLock(&shard.vcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC);
+        for(VCIterator atmVCIter = shard.vcTable.begin(); atmVCIter != shard.vcTable.end(); atmVCIter++)
+        {
+            const NPF_F_ATM_ConfigMgr_Vc_t& vc = atmVCIter->second.cfg;
+            printf("LinkID: %d\n",vc.vcLinkId);
+            printf("VPI: %d\n", vc.vc.vpi);
+            printf("VCI: %d\n", vc.vc.vci);
+            printf("XC num link B: %d\n",vc.numLink_B);
+            for(unsigned int y = 0; y < vc.numLink_B; y++)
+            {
+                printf("XC ID: %d\n", vc.link_B[y].vcXcId);
+                printf("XC Type: %d\n", vc.link_B[y].xcType);
+                printf("XC Link B: %d\n", vc.link_B[y].u.mapVcLink);      
+            }
+            printf("\n");
+            printf("\n");
+        }
+        pthread_rwlock_unlock(&shard.vcLock);
+    }
+}
+
+void TableManager::printXc()
+{
+    for(unsigned int s = 0; s < _IX_CC_ATM_FAPI_TABLE_SHARDS; s++)
+    {
+        TableShard& shard = m_shards[s];
+        FAPIMetrics::ReadLock(&shard.xcLock, NPF_F_ATM_CONFIGMGR_LOCK_TABLE_XC);
+        for(XCIterator atmXCIter = shard.xcTable.begin(); atmXCIter != shard.xcTable.end(); atmXCIter++)
+        {
+            const NPF_F_ATM_ConfigMgr_VcLinkXc_t& xc = atmXCIter->second.cfg;
+            printf("Link A: %d\n",xc.link_A);
+            printf("Num Link B: %d\n",xc.numLink_B);
+            printf("XC ID: %d\n",xc.link_B[0].vcXcId);
+            printf("XC Type: %d\n",xc.link_B[0].xcType);
+            printf("Link B: %d\n",xc.link_B[0].u.mapVcLink);
+          
+            printf("\n");
+            printf("\n");
+        }
+        pthread_rwlock_unlock(&shard.xcLock);
+    }
 }
@@ -64,11 +64,21 @@
  */
 #include "npf.h"
 #include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "VCAddressIndex.h"
+#include "TableStorage.h"
+#include "LinkBPool.h"
+#include "ShardDirectory.h"
+#include "LinkIndex.h"
+#include "TableChange.h"
+#include "BatchKeySet.h"
 
 /**
  * Standard defined include files required.
  */
 #include <map>
+#include <vector>
+#include <pthread.h>
+#include <stdio.h>
 using namespace std;
 
 class TableManager  
@@ -92,13 +102,40 @@ public:
     *
     * This function creates an entry in the ATM interface MAP, if a similar entry
     * does not already exist. The ATM inferace ID, stored in the ATM interface
-    * structure, is used as the key.
+    * structure, is used as the key. When strict is set the entries are only
+    * added if every one of them is valid, see ValidateIf().
     *
     * @return bool 
     */    
-    bool AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    bool AddATMIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
 
-    bool DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries,
+    *              NPF_boolean_t delContainedObjs,
+    *              NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+    *
+    * @brief Remove ATM interface entries from the storage MAP.
+    *
+    * @param delArray NPF_F_ATM_IfID_t* [in] - Interfaces to delete.
+    * @param numEntries NPF_uint32_t [in] - Number of entries in delArray.
+    * @param delContainedObjs NPF_boolean_t [in] - When NPF_TRUE the VCs
+    *                                               on the interface, and any
+    *                                               cross connects they are
+    *                                               part of, are deleted too.
+    *
+    *
+    * An interface that still contains VCs is only deleted when 
+    * delContainedObjs is set, otherwise NPF_ATM_F_E_CONT_OBJS_EXIST is 
+    * reported for it. The contained objects are found through the VC list 
+    * kept with each interface, so the cost depends only on the number of 
+    * VCs configured on the interface. When strict is set the interfaces 
+    * are only deleted if every one of them can be.
+    *
+    * @return bool 
+    */
+    bool DeleteIf(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_boolean_t delContainedObjs, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
 
     /** 
     * @ingroup FAPI Simulator
@@ -113,11 +150,12 @@ public:
     *
     * This function creates an entry in the ATM VC MAP, if a similar entry
     * does not already exist. The ATM VC Link ID, stored in the ATM VC structure, 
-    * is used as the key.
+    * is used as the key. When strict is set the entries are only added if
+    * every one of them is valid.
     *
     * @return bool 
     */
-    bool AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    bool AddATMVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
 
     /**
     * @ingroup FAPI Simulator
@@ -130,18 +168,245 @@ public:
     *
     *
     *
-    * This function creates an entry in the ATM XC MAP, if a similar entry
-    * does not already exist. The ATM VC Link ID of link A, stored in the ATM XC structure, 
-    * is used as the key.
+    * Every one of the numLink_B legs of an entry is stored as a cross 
+    * connect of its own, keyed by the vcXcId of the leg, from link A to the
+    * leaf VC named by the leg. Link A becomes the root of a point to 
+    * multipoint cross connect and lists every leg in its link_B array, 
+    * more legs can be added to it by later entries. A leaf VC cannot be 
+    * part of another cross connect. An entry is added as a whole or not at
+    * all. When strict is set the entries are only added if every one of 
+    * them is valid.
     *
     * @return bool 
     */
-    bool AddATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    bool AddATMXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteVC(NPF_uint32_t* delArray, NPF_uint32_t numEntries,
+    *              NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+    *
+    * @brief Remove ATM VC entries from the storage MAP.
+    *
+    * @param delArray NPF_uint32_t* [in] - VC Link IDs of the VCs to delete.
+    * @param numEntries NPF_uint32_t [in] - Number of entries in delArray.
+    *
+    *
+    * A VC is removed from its interface list, the address index, the VC 
+    * link index and the shard directory, each in constant time. A VC that
+    * is still part of a cross connect is not deleted, 
+    * NPF_ATM_F_E_CONT_OBJS_EXIST is reported for it. When strict is set the
+    * VCs are only deleted if every one of them can be.
+    *
+    * @return bool 
+    */
+    bool DeleteVC(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteXC(NPF_uint32_t* delArray, NPF_uint32_t numEntries,
+    *              NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+    *
+    * @brief Remove ATM XC entries from the storage MAP.
+    *
+    * @param delArray NPF_uint32_t* [in] - vcXcIds of the cross connect 
+    *                                        legs to delete.
+    * @param numEntries NPF_uint32_t [in] - Number of entries in delArray.
+    *
+    *
+    * The leaf VC of a leg is no longer cross connected once the leg is 
+    * deleted. The leg is dropped from the link_B array of its root, which
+    * goes back to its inline leg, or to none, as the legs go and returns 
+    * its array to the LinkBPool of its shard. When strict is set the legs 
+    * are only deleted if every one of them exists.
+    *
+    * @return bool 
+    */
+    bool DeleteXC(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, bool strict = false);
  
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn SaveSnapshot(const char* path)
+    *
+    * @brief Writes the interface, VC and cross connect tables to a 
+    *        snapshot file, see TableSnapshot.h.
+    *
+    * @param path const char* [in] - File to write. It is replaced only 
+    *                                  once the new snapshot is complete.
+    *
+    * The tables are read locked while they are written, so the snapshot 
+    * is consistent.
+    *
+    * @return bool - false if the file could not be written.
+    */
+    bool SaveSnapshot(const char* path);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn RestoreSnapshot(const char* path)
+    *
+    * @brief Loads the tables from a snapshot file written by 
+    *        SaveSnapshot().
+    *
+    * @param path const char* [in] - File to load.
+    *
+    * The file is mapped in and its header, size and checksum are checked 
+    * before any table is touched. The records are then validated as they 
+    * are loaded, in one critical section. The tables must be empty. If any
+    * record is rejected the tables are left empty again.
+    *
+    * @return bool - false if the snapshot was not loaded.
+    */
+    bool RestoreSnapshot(const char* path);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ReplayJournal(const char* path)
+    *
+    * @brief Applies the changes of a journal file that follow the last 
+    *        change already held by the tables, see TableJournal.h.
+    *
+    * @param path const char* [in] - Journal file to replay.
+    *
+    * Changes up to TableJournal::GetSequence(), such as those held by a 
+    * snapshot loaded with RestoreSnapshot(), are skipped. Replay stops at
+    * the first change that does not follow on from the tables or cannot be
+    * applied. The journal must not be open while it is replayed.
+    *
+    * @return bool - false if the journal could not be read or a change 
+    *                could not be applied.
+    */
+    bool ReplayJournal(const char* path);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ApplyChange(const TableChange& change)
+    *
+    * @brief Applies a change read from the journal as a configuration call
+    *        with a single entry.
+    *
+    * @return bool - true if the change was applied.
+    */
+    bool ApplyChange(const TableChange& change);
+
+    /**
+    * Part a VC plays in cross connects, see VCInfo.
+    */
+    enum
+    {
+        VC_XC_NONE,
+        VC_XC_ROOT,
+        VC_XC_LEAF
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef VCInfo
+    *
+    * @brief Typedef of the summary of a VC returned by the query functions.
+    *
+    * xcRole is VC_XC_ROOT for link A of a cross connect and VC_XC_LEAF for
+    * a VC named by a leg, numLegs is the number of legs the VC is part of.
+    */
+    typedef struct
+    {
+        unsigned int vcLinkId;
+        NPF_F_ATM_IfID_t ifId;
+        NPF_F_ATM_VcAddr_t vc;
+        unsigned short xcRole;
+        unsigned short numLegs;
+    } VCInfo;
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef XCInfo
+    *
+    * @brief Typedef of a cross connect leg returned by the query functions.
+    *
+    */
+    typedef struct
+    {
+        unsigned int vcXcId;
+        NPF_F_ATM_XcType_t xcType;
+        unsigned int link_A;
+        unsigned int link_B;
+    } XCInfo;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn QueryVCs(unsigned int lastLinkId, unsigned int& cursor,
+    *              VCInfo* vcs, unsigned int maxEntries)
+    *
+    * @brief Returns the VCs with a VC Link ID from cursor up to lastLinkId,
+    *        in VC Link ID order.
+    *
+    * @param lastLinkId unsigned int [in] - Last VC Link ID of the range.
+    * @param cursor unsigned int& [in/out] - First VC Link ID to return. 
+    *                                          Set to where the next call 
+    *                                          continues, or to 
+    *                                          _IX_CC_ATM_FAPI_QUERY_END 
+    *                                          when the range is done.
+    * @param vcs VCInfo* [out] - Receives at most maxEntries VCs.
+    * @param maxEntries unsigned int [in] - Size of vcs.
+    *
+    *
+    * The query functions copy a summary of each entry into the caller's
+    * array under a read lock held for that call only, so a sweep of a 
+    * large table does not hold off configuration calls. The cursor is a 
+    * key rather than a position, so entries added or deleted between calls
+    * never make a sweep repeat or skip an entry that is present for the 
+    * whole of it. QueryIfVCs() and QueryLinkXCs() work the same way.
+    *
+    * @return unsigned int - Number of entries written to vcs.
+    */
+    unsigned int QueryVCs(unsigned int lastLinkId, unsigned int& cursor, VCInfo* vcs, unsigned int maxEntries);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn QueryIfVCs(NPF_F_ATM_IfID_t ifId, unsigned int& cursor,
+    *                VCInfo* vcs, unsigned int maxEntries)
+    *
+    * @brief Returns the VCs configured on an interface, in VC Link ID order
+    *        from cursor.
+    *
+    * Each call walks the VC list of the interface once.
+    *
+    * @return unsigned int - Number of entries written to vcs, 0 with cursor
+    *                        set to _IX_CC_ATM_FAPI_QUERY_END if the 
+    *                        interface does not exist.
+    */
+    unsigned int QueryIfVCs(NPF_F_ATM_IfID_t ifId, unsigned int& cursor, VCInfo* vcs, unsigned int maxEntries);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn QueryLinkXCs(unsigned int vcLinkId, unsigned int& cursor,
+    *                  XCInfo* xcs, unsigned int maxEntries)
+    *
+    * @brief Returns the cross connect legs a VC is part of, in vcXcId order
+    *        from cursor. A root VC has a leg for every leaf, a leaf VC has 
+    *        its own leg only.
+    *
+    * @return unsigned int - Number of entries written to xcs, 0 with cursor
+    *                        set to _IX_CC_ATM_FAPI_QUERY_END if the VC 
+    *                        does not exist.
+    */
+    unsigned int QueryLinkXCs(unsigned int vcLinkId, unsigned int& cursor, XCInfo* xcs, unsigned int maxEntries);
+
     //test
-    void TableManager::printIf();
-    void TableManager::printVc();
-    void TableManager::printXc();
+    void printIf();
+    void printVc();
+    void printXc();
     
 private:
     TableManager();
@@ -149,46 +414,623 @@ private:
     TableManager& operator =(const TableManager&);
 
     /**
-    * TableManager Member Variables.
+    * Locks of one shard, as held in ShardLocks.
+    */
+    enum
+    {
+        LOCK_IF_READ = 0x01,
+        LOCK_IF_WRITE = 0x02,
+        LOCK_VC_READ = 0x04,
+        LOCK_VC_WRITE = 0x08,
+        LOCK_XC_READ = 0x10,
+        LOCK_XC_WRITE = 0x20
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef ShardLocks
+    *
+    * @brief Typedef of the locks an operation holds, a set of LOCK_ flags
+    *        for every shard. See LockShards().
+    *
+    */
+    typedef struct
+    {
+        unsigned char mode[_IX_CC_ATM_FAPI_TABLE_SHARDS];
+    } ShardLocks;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn LockShards(const ShardLocks& locks)
+    *
+    * @brief Takes the locks of every shard in locks.
+    *
+    * Shards are locked in ascending order and the locks of one shard in 
+    * interface, VC, cross connect order, so two operations that need more
+    * than one shard, such as a cross connect between VCs of two shards, 
+    * cannot deadlock. UnlockShards() releases them in the reverse order.
+    *
+    * @return None
+    */
+    void LockShards(const ShardLocks& locks);
+    void UnlockShards(const ShardLocks& locks);
+    static void SetLocks(ShardLocks& locks, unsigned char mode);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ShardOf(NPF_F_ATM_IfID_t ifId)
+    *
+    * @brief Returns the shard that holds an interface and its VCs.
+    *
+    * @return unsigned int
+    */
+    static unsigned int ShardOf(NPF_F_ATM_IfID_t ifId);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn LinkShard(unsigned int vcLinkId)
+    *
+    * @brief Returns the shard that holds a VC, or ShardDirectory::NONE. 
+    *        XCShard() does the same for a cross connect leg, which is held
+    *        by the shard of its root VC.
+    *
+    * The result may change until the shard is locked, see 
+    * ShardDirectory.h. With a single shard the directory is not kept and
+    * 0 is returned for any ID.
+    *
+    * @return unsigned int
+    */
+    unsigned int LinkShard(unsigned int vcLinkId);
+    unsigned int XCShard(unsigned int vcXcId);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn AddXCShards(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, 
+    *                 NPF_uint32_t numEntries, ShardLocks& locks)
+    *
+    * @brief Adds the VC and cross connect write locks of the shards of
+    *        every VC named by a cross connect batch to locks.
+    *
+    * @return bool - true if a shard was added.
+    */
+    bool AddXCShards(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteVCShards(NPF_uint32_t* delArray, NPF_uint32_t numEntries,
+    *                    ShardLocks& locks)
+    *
+    * @brief Adds the interface read and VC write locks of the shard of 
+    *        every VC of a VC delete batch to locks. DeleteXCShards() adds 
+    *        the VC and cross connect write locks of the shard of every leg
+    *        of a cross connect delete batch, and the VC write lock of the 
+    *        shard of its leaf once the shard of the leg is in held, the 
+    *        locks LockShards() has already taken.
+    *
+    * @return bool - true if a shard was added.
+    */
+    bool DeleteVCShards(NPF_uint32_t* delArray, NPF_uint32_t numEntries, ShardLocks& locks);
+    bool DeleteXCShards(NPF_uint32_t* delArray, NPF_uint32_t numEntries, const ShardLocks& held, ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteVCEntry(unsigned int vcLinkId, const ShardLocks& locks)
+    *
+    * @brief Remove a VC, and the cross connect it is part of, from the 
+    *        tables and from every secondary index.
+    *
+    * The interface table must be locked for reading and the VC and cross
+    * connect tables for writing by the caller, in the shard of the VC and
+    * in every shard it is cross connected to.
+    *
+    * @return None
+    */
+    void DeleteVCEntry(unsigned int vcLinkId, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn DeleteXCEntry(unsigned int vcXcId, const ShardLocks& locks)
+    *
+    * @brief Remove a cross connect leg, clear its leaf VC and drop the leg
+    *        from its root VC.
+    *
+    * The VC and cross connect tables must be locked for writing by the
+    * caller, in the shards of the root and of the leaf.
+    *
+    * @return None
+    */
+    void DeleteXCEntry(unsigned int vcXcId, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ValidateIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, 
+    *                NPF_uint32_t numEntries,
+    *                NPF_F_ATM_ConfigMgr_CallbackData_t& data)
+    *
+    * @brief Checks a whole batch of interfaces against the tables without
+    *        changing them.
+    *
+    * Every entry that the batch would fail to apply, including an entry 
+    * that repeats a key used earlier in the same batch, is reported in data
+    * with the error it would get when applied. The locks the batch is 
+    * applied under must be held by the caller, so the result stays valid 
+    * until it is applied. ValidateIfDelete(), ValidateVC(), ValidateXC(),
+    * ValidateVCDelete() and ValidateXCDelete() do the same for the other 
+    * batched operations.
+    *
+    * @return bool - true if every entry can be applied.
+    */
+    bool ValidateIf(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    bool ValidateIfDelete(NPF_F_ATM_IfID_t *delArray, NPF_uint32_t numEntries, NPF_boolean_t delContainedObjs, NPF_F_ATM_ConfigMgr_CallbackData_t& data);
+    bool ValidateVC(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks);
+    bool ValidateXC(NPF_F_ATM_ConfigMgr_VcLinkXc_t* atmXC, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks);
+    bool ValidateVCDelete(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks);
+    bool ValidateXCDelete(NPF_uint32_t* delArray, NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_CallbackData_t& data, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
     * 
-    * ATMInterfaceTable - Map used to store ATM Interface entries, Interface ID 
-    *                     is the used as the key.
+    * @typedef BatchKey
+    *
+    * @brief A key used by a batch entry and the index of the entry.
+    *
+    */
+    typedef pair<unsigned long long, unsigned int> BatchKey;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn MarkRepeatedKeys(vector<BatchKey>& keys, vector<NPF_error_t>& errors,
+    *                      NPF_error_t error)
+    *
+    * @brief Sets error for every entry whose key was already used by an 
+    *        earlier entry of the batch, unless it has an error already.
+    *
+    * @return None
+    */
+    static void MarkRepeatedKeys(vector<BatchKey>& keys, vector<NPF_error_t>& errors, NPF_error_t error);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn CheckXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, 
+    *                  unsigned int numAdded,
+    *                  NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp,
+    *                  const ShardLocks& locks)
+    *
+    * @brief Checks a cross connect entry, and each of its legs, against
+    *        the tables.
+    *
+    * @param numAdded unsigned int [in] - Legs that earlier entries of a 
+    *                                       batch will add to the cross 
+    *                                       connect table.
+    * @param resp NPF_F_ATM_ConfigMgr_AsyncResponse_t& [out] - Receives the
+    *                                                            error of 
+    *                                                            the entry.
+    *
+    * The VC and cross connect tables must be locked by the caller. A VC
+    * held by a shard that is not in locks is taken not to exist.
+    *
+    * @return bool - true if the entry can be added.
+    */
+    bool CheckXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, unsigned int numAdded, NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ClaimXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC,
+    *                  NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp)
+    *
+    * @brief Claims the vcXcId of every leg of an entry that passed 
+    *        CheckXCEntry() in the cross connect directory.
+    *
+    * With more than one shard a vcXcId can be claimed by another shard 
+    * after it was checked. Nothing is claimed if one of the legs cannot be.
+    *
+    * @return bool - true if the entry can be added.
+    */
+    bool ClaimXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn AddXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, 
+    *                const ShardLocks& locks)
+    *
+    * @brief Adds every leg of a cross connect entry that passed 
+    *        CheckXCEntry() and ClaimXCEntry().
+    *
+    * The VC and cross connect tables must be locked for writing by the 
+    * caller.
+    *
+    * @return None
+    */
+    void AddXCEntry(NPF_F_ATM_ConfigMgr_VcLinkXc_t& atmXC, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn RestoreImage(const unsigned char* image, size_t size)
+    *
+    * @brief Checks and loads a snapshot mapped in by RestoreSnapshot().
+    *
+    * @return bool - false if the snapshot was not loaded.
+    */
+    bool RestoreImage(const unsigned char* image, size_t size);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ClearTables(const ShardLocks& locks)
+    *
+    * @brief Removes every entry from every table.
+    *
+    * All three tables of every shard must be locked for writing by the 
+    * caller.
+    *
+    * @return None
+    */
+    void ClearTables(const ShardLocks& locks);
+
+    static bool ReplayChange(const TableChange& change, void* context);
+
+    static size_t SnapshotAlign(size_t offset);
+    static unsigned long long SnapshotHash(const void* data, size_t length, unsigned long long hash);
+    static bool SnapshotWrite(FILE* file, const void* data, size_t length, size_t& offset, unsigned long long& checksum);
+
+    static bool VCInfoLess(const VCInfo& first, const VCInfo& second);
+    static bool XCInfoLess(const XCInfo& first, const XCInfo& second);
+
+    static bool RejectLink(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, NPF_error_t error, unsigned int vcLinkId);
+    static bool RejectXC(NPF_F_ATM_ConfigMgr_AsyncResponse_t& resp, NPF_error_t error, unsigned int vcXcId);
+
+    /**
+    * @ingroup FAPI Simulator
     * 
-    * ATMVCTable - Map used to store VC entries, VCLinkID used as the key.
+    * @typedef IFRecord
+    *
+    * @brief Typedef of a typical entry for the ATM interface table
+    *
+    * firstVC and numVCs describe the list of VCs configured on the 
+    * interface. The list is threaded through the VC records so adding or 
+    * removing a VC never allocates.
     *
     */
-    map<unsigned int, NPF_F_ATM_ConfigMgr_IfCfg_t> m_ATMInterfaceTable;
-    map<unsigned int, NPF_F_ATM_ConfigMgr_Vc_t> m_ATMVCTable;
-    map<unsigned int, NPF_F_ATM_ConfigMgr_VcLinkXc_t>m_ATMXCTable;
+    typedef struct
+    {
+        NPF_F_ATM_ConfigMgr_IfCfg_t cfg;
+        unsigned int firstVC;
+        unsigned int numVCs;
+    } IFRecord;
+
     /**
     * @ingroup FAPI Simulator
     * 
-    * @typedef VCEntry
+    * @typedef VCRecord
     *
-    * @brief Typedef of a typical entry for the ATM VC MAP
+    * @brief Typedef of a typical entry for the ATM VC table
     *
-    */    
-    typedef pair<unsigned int, NPF_F_ATM_ConfigMgr_Vc_t> VCEntry;
+    * prevVC and nextVC link the VCs of one interface together, 
+    * _IX_CC_ATM_FAPI_NULL_LINK_ID terminates the list.
+    *
+    * xcRole tells whether the VC is the root (link A) or a leaf of a cross
+    * connect. cfg.link_B points at inlineLinkB when it holds a single leg, 
+    * otherwise at an array from the LinkBPool. linkBSize is the number of 
+    * legs cfg.link_B has room for.
+    *
+    */
+    typedef struct
+    {
+        NPF_F_ATM_ConfigMgr_Vc_t cfg;
+        unsigned int prevVC;
+        unsigned int nextVC;
+        unsigned short xcRole;
+        unsigned short linkBSize;
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t inlineLinkB;
+    } VCRecord;
 
     /**
     * @ingroup FAPI Simulator
     * 
-    * @typedef interfaceEntry
+    * @typedef XCRecord
     *
-    * @brief Typedef of a typical entry for the ATM interface MAP
+    * @brief Typedef of a typical entry for the ATM XC table, one leg of a 
+    *        cross connect. cfg.link_B always points at inlineLinkB.
     *
     */
-    typedef pair<unsigned int,NPF_F_ATM_ConfigMgr_IfCfg_t> InterfaceEntry;
-    typedef pair<unsigned int,NPF_F_ATM_ConfigMgr_VcLinkXc_t> XCEntry;
-    
-    typedef map<unsigned int, NPF_F_ATM_ConfigMgr_Vc_t>::iterator VCIterator;
-    typedef map<unsigned int, NPF_F_ATM_ConfigMgr_IfCfg_t>::iterator IFIterator;
-    typedef map<unsigned int, NPF_F_ATM_ConfigMgr_VcLinkXc_t>::iterator XCIterator;
-    
-    typedef pair<map<unsigned int, NPF_F_ATM_ConfigMgr_IfCfg_t>::iterator, bool> InterfaceInsertPair;
-    typedef pair<map<unsigned int, NPF_F_ATM_ConfigMgr_Vc_t>::iterator, bool> VCInsertPair;
-    typedef pair<map<unsigned int, NPF_F_ATM_ConfigMgr_VcLinkXc_t>::iterator, bool> XCInsertPair;
+    typedef struct
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXc_t cfg;
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t inlineLinkB;
+    } XCRecord;
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef IFTable, VCTable, XCTable
+    *
+    * @brief Storage backend of each table, selected at compile time.
+    *
+    */
+#if defined(_IX_CC_ATM_FAPI_FLAT_TABLES)
+    typedef SlotTable<IFRecord, _IX_CC_ATM_FAPI_IFACE_MAX, _IX_CC_ATM_FAPI_IFACE_MAX,
+                      NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE> IFTable;
+    typedef SlotTable<VCRecord, _IX_CC_ATM_FAPI_VC_LINK_MAX, _IX_CC_ATM_FAPI_VC_HANDLE_MAX,
+                      NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE> VCTable;
+    typedef SlotTable<XCRecord, _IX_CC_ATM_FAPI_XC_MAX, _IX_CC_ATM_FAPI_VC_HANDLE_MAX,
+                      NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE> XCTable;
+#else
+    typedef MapTable<IFRecord, NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE> IFTable;
+    typedef MapTable<VCRecord, NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE> VCTable;
+    typedef MapTable<XCRecord, NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE> XCTable;
+#endif
+
+    typedef VCTable::iterator VCIterator;
+    typedef IFTable::iterator IFIterator;
+    typedef XCTable::iterator XCIterator;
+
+    typedef pair<IFRecord*, bool> InterfaceInsertPair;
+    typedef pair<VCRecord*, bool> VCInsertPair;
+    typedef pair<XCRecord*, bool> XCInsertPair;
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @class TableShard
+    *
+    * @brief The tables of one shard and their locks.
+    *
+    * A shard holds the interfaces that ShardOf() maps to it, the VCs 
+    * configured on those interfaces, and the cross connect legs whose root
+    * VC it holds. Secondary indexes and link B arrays are kept per shard 
+    * with the VCs they refer to.
+    *
+    * ifLock, vcLock, xcLock - Reader/writer locks of the interface, VC and 
+    *                          cross connect tables of the shard. vcLock 
+    *                          also protects the VCAddressIndex, the 
+    *                          LinkBPool and the VC list fields of the 
+    *                          interface records.
+    *
+    */
+    class TableShard
+    {
+    public:
+        TableShard();
+        ~TableShard();
+
+        pthread_rwlock_t ifLock;
+        pthread_rwlock_t vcLock;
+        pthread_rwlock_t xcLock;
+        IFTable ifTable;
+        VCTable vcTable;
+        XCTable xcTable;
+        VCAddressIndex addressIndex;
+        LinkBPool linkBPool;
 
+    private:
+        TableShard(const TableShard&);
+        TableShard& operator =(const TableShard&);
+    } __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn FindVC(unsigned int vcLinkId, const ShardLocks& locks)
+    *
+    * @brief Returns the record of a VC, or 0 if it does not exist or is 
+    *        held by a shard whose VC table is not in locks.
+    *
+    * @return VCRecord*
+    */
+    VCRecord* FindVC(unsigned int vcLinkId, const ShardLocks& locks);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ShardVC(TableShard& shard, unsigned int vcLinkId)
+    *
+    * @brief Returns the record of a VC held by shard, or 0.
+    *
+    * The VC table of the shard must be locked by the caller. The record is
+    * taken from the VC link index when it covers the VC Link ID.
+    *
+    * @return VCRecord*
+    */
+    VCRecord* ShardVC(TableShard& shard, unsigned int vcLinkId);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn LinkVC(IFRecord* atmIf, VCRecord* atmVC)
+    *
+    * @brief Add a VC to the VC list of its interface.
+    *
+    * The VC table of the shard of the interface must be locked for 
+    * writing by the caller.
+    *
+    * @return None
+    */
+    void LinkVC(IFRecord* atmIf, VCRecord* atmVC);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn UnlinkVC(VCRecord* atmVC)
+    *
+    * @brief Remove a VC from the VC list of its interface.
+    *
+    * The interface table of the shard of the VC must be locked for 
+    * reading and its VC table for writing by the caller.
+    *
+    * @return None
+    */
+    void UnlinkVC(VCRecord* atmVC);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ReserveLinkB(VCRecord* atmVC, unsigned int numLegs)
+    *
+    * @brief Makes room for numLegs legs in the link_B array of a VC, 
+    *        keeping the legs it already has.
+    *
+    * The VC table must be locked for writing by the caller.
+    *
+    * @return None
+    */
+    void ReserveLinkB(VCRecord* atmVC, unsigned int numLegs);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn ClearLinkB(VCRecord* atmVC)
+    *
+    * @brief Releases the link_B array of a VC and leaves it outside any 
+    *        cross connect.
+    *
+    * The VC table must be locked for writing by the caller.
+    *
+    * @return None
+    */
+    void ClearLinkB(VCRecord* atmVC);
+
+    static void MakeVCInfo(const VCRecord& atmVC, VCInfo& info);
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef IFCheck, VCCheck
+    *
+    * @brief Typedef of the result of checking one entry of a batch against
+    *        the tables as they were before the batch, see CheckIfs() and
+    *        CheckVCs().
+    *
+    * error is the first error an interface gets from the tables, keySlot 
+    * the slot of its ID in the BatchKeySet of the batch. For a VC, atmIf is
+    * the record of its interface or 0, addressUsed is set if its address is
+    * in the address index, linkError is the error its VC Link ID gets from
+    * the VC tables, and addressSlot and linkSlot are the slots of its 
+    * address and VC Link ID in the BatchKeySets of the batch.
+    *
+    */
+    typedef struct
+    {
+        NPF_error_t error;
+        unsigned int keySlot;
+    } IFCheck;
+
+    typedef struct
+    {
+        IFRecord* atmIf;
+        bool addressUsed;
+        NPF_error_t linkError;
+        unsigned int addressSlot;
+        unsigned int linkSlot;
+    } VCCheck;
+
+    /**
+    * @ingroup FAPI Simulator
+    * 
+    * @typedef ifCheckJob, vcCheckJob
+    *
+    * @brief Typedef of the batch and the results the range checks handed to
+    *        the BatchValidator work on.
+    *
+    */
+    typedef struct
+    {
+        TableManager* tables;
+        NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface;
+        IFCheck* checks;
+        BatchKeySet* keys;
+    } ifCheckJob;
+
+    typedef struct
+    {
+        TableManager* tables;
+        NPF_F_ATM_ConfigMgr_Vc_t* atmVC;
+        bool checkLinks;
+        const ShardLocks* locks;
+        VCCheck* checks;
+        BatchKeySet* addresses;
+        BatchKeySet* links;
+    } vcCheckJob;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn CheckIfs(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, 
+    *              NPF_uint32_t numEntries, vector<IFCheck>& checks,
+    *              BatchKeySet& keys)
+    *
+    * @brief Checks every entry of a batch of interfaces, on the threads of
+    *        the BatchValidator if the batch is large enough.
+    *
+    * The checks of different entries do not depend on each other and only
+    * read the tables, which the caller must hold locked for the batch. 
+    * CheckVCs() does the same for a batch of VCs. Their VC Link IDs are 
+    * only checked, in every shard, if checkLinks is set, as a partial batch
+    * finds a VC Link ID taken when it inserts the VC.
+    *
+    * @return None
+    */
+    void CheckIfs(NPF_F_ATM_ConfigMgr_IfCfg_t* atmInterface, NPF_uint32_t numEntries, vector<IFCheck>& checks, BatchKeySet& keys);
+    void CheckVCs(NPF_F_ATM_ConfigMgr_Vc_t* atmVC, NPF_uint32_t numEntries, bool checkLinks, const ShardLocks& locks,
+                  vector<VCCheck>& checks, BatchKeySet& addresses, BatchKeySet& links);
+    static void CheckIfRange(void* context, unsigned int first, unsigned int last);
+    static void CheckVCRange(void* context, unsigned int first, unsigned int last);
+
+    /**
+    * TableManager Member Variables.
+    * 
+    * shards - The tables, split by interface, see TableShard. In each 
+    *          shard:
+    *
+    *          ifTable - Table used to store ATM Interface entries, 
+    *                    Interface ID is the used as the key. Each entry 
+    *                    also heads the list of VCs configured on the 
+    *                    interface.
+    * 
+    *          vcTable - Table used to store VC entries, VCLinkID used as
+    *                    the key.
+    *
+    *          xcTable - Table used to store XC entries, one per leg, the 
+    *                    vcXcId of the leg is used as the key.
+    *
+    *          addressIndex - Secondary index of the vcTable keyed on 
+    *                         (ifId, vpi, vci). Must be updated whenever a 
+    *                         VC is added to or removed from the vcTable.
+    *
+    *          linkBPool - Link B arrays of roots with more than one leg.
+    *
+    *          Batched operations lock every shard they touch, with 
+    *          LockShards(), for the whole batch.
+    *
+    * vcShards, xcShards - Shard of every VC link ID and cross connect ID, 
+    *                      only kept when there is more than one shard.
+    *
+    * vcIndex - Record of every VC, by VC Link ID, in whichever shard holds
+    *           it. Set and cleared with the VC table of that shard locked 
+    *           for writing.
+    *
+    * numVCs - Number of VCs in all shards, bounded by
+    *          _IX_CC_ATM_FAPI_VC_LINK_MAX. Updated atomically.
+    *
+    */
+    TableShard m_shards[_IX_CC_ATM_FAPI_TABLE_SHARDS];
+    ShardDirectory m_vcShards;
+    ShardDirectory m_xcShards;
+    LinkIndex<VCRecord> m_vcIndex;
+    unsigned int m_numVCs;
 };
 #endif // #if !defined __TABLEMANAGER_H_
 /**
@@ -0,0 +1,120 @@
+/**
+ * @file TableSnapshot.h
+ *
+ * @date 30 May 2005
+ *
+ * @brief Layout of the TableManager snapshot file.
+ *
+ * A snapshot holds the interface, VC and cross connect tables of the
+ * TableManager as fixed size records, so it can be mapped back in and
+ * loaded without replaying the API calls that built it.
+ *
+ * Design Notes:
+ *    The file starts with a TableSnapshotHeader, followed by numIf
+ *    NPF_F_ATM_ConfigMgr_IfCfg_t records, numVC NPF_F_ATM_ConfigMgr_Vc_t
+ *    records and numXC TableSnapshotXC records, one per cross connect leg.
+ *    Every section starts on a _IX_CC_ATM_FAPI_SNAPSHOT_ALIGN boundary.
+ *    Records are stored in the layout of the build that wrote them, the
+ *    header carries the record sizes so a snapshot from a build with a
+ *    different layout is rejected rather than misread. Pointers are not
+ *    stored, link_B is rebuilt from the cross connect records on restore.
+ *    checksum is a 64 bit FNV-1a hash of everything after the header.
+ *    journalSequence is the sequence number of the last change the
+ *    TableJournal had recorded when the snapshot was taken, replay of a
+ *    journal onto the snapshot starts after it.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __TABLESNAPSHOT_H_
+#define __TABLESNAPSHOT_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "FAPIDefs.h"
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @typedef TableSnapshotHeader
+ *
+ * @brief Typedef of the header at the start of a snapshot file.
+ *
+ */
+typedef struct
+{
+    char magic[8];
+    unsigned int version;
+    unsigned int headerSize;
+    unsigned int ifRecordSize;
+    unsigned int vcRecordSize;
+    unsigned int xcRecordSize;
+    unsigned int numIf;
+    unsigned int numVC;
+    unsigned int numXC;
+    unsigned long long journalSequence;
+    unsigned long long checksum;
+} TableSnapshotHeader;
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @typedef TableSnapshotXC
+ *
+ * @brief Typedef of a cross connect leg as stored in a snapshot. cfg.link_B
+ *        is stored as 0 and leg holds the single leg.
+ *
+ */
+typedef struct
+{
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t cfg;
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+} TableSnapshotXC;
+
+#endif // #if !defined __TABLESNAPSHOT_H_
+/**
+ *@}
+ */
@@ -0,0 +1,434 @@
+/**
+ * @file TableStorage.h
+ *
+ * @date 18 April 2005
+ *
+ * @brief Storage backends for the TableManager tables.
+ *
+ * Two interchangeable table templates are provided. MapTable keeps entries in
+ * a map and places no bound on the key space. SlotTable keeps entries in a
+ * preallocated, cache line aligned slot array with an occupancy bitmap and a
+ * direct key to slot index, so lookups are two array accesses and inserts do
+ * not allocate. The TableManager selects one of them at compile time, see
+ * _IX_CC_ATM_FAPI_FLAT_TABLES in FAPIDefs.h.
+ *
+ * Design Notes:
+ *    Both templates expose the same operations: Find() returns a pointer to
+ *    the stored value or 0, Insert() returns the stored value and whether it
+ *    was inserted, Erase() removes by key, and begin()/end() iterate over
+ *    entries with first (key) and second (value) members like a map.
+ *    Insert() on a SlotTable returns a 0 value pointer when the key is out
+ *    of range or every slot is in use, ValidKey() and Capacity() let a
+ *    caller check this before inserting. SlotTable iterates in slot order,
+ *    not key order.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __TABLESTORAGE_H_
+#define __TABLESTORAGE_H_
+
+/**
+ * User defined include files required.
+ */
+#include "FAPIDefs.h"
+#include "FAPIMemory.h"
+
+/**
+ * Standard defined include files required.
+ */
+#include <map>
+using namespace std;
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Map backed table, the default TableManager storage. Its entries
+ *        are counted at MemSite, see FAPIMemory.h.
+ */
+template<class Value, unsigned int MemSite>
+class MapTable
+{
+public:
+    typedef typename map<unsigned int, Value>::iterator iterator;
+
+    MapTable()
+    {
+    }
+
+    ~MapTable()
+    {
+        for(unsigned int x = 0; x < m_table.size(); x++)
+        {
+            FAPIMemory::Release(SITE, ENTRY_BYTES);
+        }
+    }
+
+    Value* Find(unsigned int key)
+    {
+        iterator findIter = m_table.find(key);
+        if(findIter == m_table.end())
+        {
+            return 0;
+        }
+        return &findIter->second;
+    }
+
+    /**
+     * Returns the entry with the lowest key at or above 'key' and sets 'key'
+     * to it, or 0.
+     */
+    Value* FindNext(unsigned int& key)
+    {
+        iterator findIter = m_table.lower_bound(key);
+        if(findIter == m_table.end())
+        {
+            return 0;
+        }
+        key = findIter->first;
+        return &findIter->second;
+    }
+
+    pair<Value*, bool> Insert(unsigned int key, const Value& value)
+    {
+        pair<iterator, bool> insertReturn = m_table.insert(pair<unsigned int, Value>(key, value));
+        if(insertReturn.second == true)
+        {
+            FAPIMemory::Acquire(SITE, ENTRY_BYTES);
+        }
+        return pair<Value*, bool>(&insertReturn.first->second, insertReturn.second);
+    }
+
+    bool Erase(unsigned int key)
+    {
+        if(m_table.erase(key) == 0)
+        {
+            return false;
+        }
+        FAPIMemory::Release(SITE, ENTRY_BYTES);
+        return true;
+    }
+
+    unsigned int Size() const
+    {
+        return (unsigned int)m_table.size();
+    }
+
+    bool ValidKey(unsigned int) const
+    {
+        return true;
+    }
+
+    unsigned int Capacity() const
+    {
+        return ~0U;
+    }
+
+    iterator begin()
+    {
+        return m_table.begin();
+    }
+
+    iterator end()
+    {
+        return m_table.end();
+    }
+
+private:
+    MapTable(const MapTable&);
+    MapTable& operator =(const MapTable&);
+
+    static const NPF_F_ATM_ConfigMgr_MemSite_t SITE = (NPF_F_ATM_ConfigMgr_MemSite_t)MemSite;
+
+    // A map node holds the entry, three links and its colour.
+    static const unsigned long long ENTRY_BYTES = sizeof(typename map<unsigned int, Value>::value_type) +
+                                                  4 * sizeof(void*);
+
+    map<unsigned int, Value> m_table;
+};
+
+/**
+ * @ingroup FAPI Simulator
+ *
+ * @brief Preallocated slot array table for keys below KeyMax, holding at
+ *        most SlotMax entries. The whole array is counted as reserved at
+ *        MemSite and each entry as taken from it, see FAPIMemory.h.
+ */
+template<class Value, unsigned int SlotMax, unsigned int KeyMax, unsigned int MemSite>
+class SlotTable
+{
+public:
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef Slot
+    *
+    * @brief A stored entry, laid out like a map value_type.
+    *
+    */
+    struct Slot
+    {
+        unsigned int first;
+        Value second;
+    };
+
+    class iterator
+    {
+    public:
+        iterator() : m_owner(0), m_slot(0) {}
+        iterator(SlotTable* owner, unsigned int slot) : m_owner(owner), m_slot(slot) {}
+
+        Slot& operator*() const { return m_owner->m_slots[m_slot]; }
+        Slot* operator->() const { return &m_owner->m_slots[m_slot]; }
+
+        iterator& operator++()
+        {
+            m_slot = m_owner->NextOccupied(m_slot + 1);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator previous = *this;
+            m_slot = m_owner->NextOccupied(m_slot + 1);
+            return previous;
+        }
+
+        bool operator==(const iterator& other) const { return m_slot == other.m_slot; }
+        bool operator!=(const iterator& other) const { return m_slot != other.m_slot; }
+
+    private:
+        SlotTable* m_owner;
+        unsigned int m_slot;
+    };
+
+    SlotTable()
+    : m_size(0), m_freeHint(0)
+    {
+        for(unsigned int x = 0; x < KeyMax; x++)
+        {
+            m_index[x] = 0;
+        }
+        for(unsigned int x = 0; x < BITMAP_WORDS; x++)
+        {
+            m_occupied[x] = 0;
+        }
+        // Mark the bits past SlotMax as used so they are never allocated.
+        if((SlotMax % 64) != 0)
+        {
+            m_occupied[BITMAP_WORDS - 1] = ~0ULL << (SlotMax % 64);
+        }
+        FAPIMemory::Reserve(SITE, (long long)sizeof(SlotTable));
+    }
+
+    ~SlotTable()
+    {
+        FAPIMemory::Reserve(SITE, -(long long)(sizeof(SlotTable) - m_size * sizeof(Slot)));
+        for(unsigned int x = 0; x < m_size; x++)
+        {
+            FAPIMemory::Release(SITE, sizeof(Slot));
+        }
+    }
+
+    Value* Find(unsigned int key)
+    {
+        if((key >= KeyMax)||(m_index[key] == 0))
+        {
+            return 0;
+        }
+        return &m_slots[m_index[key] - 1].second;
+    }
+
+    /**
+     * Returns the entry with the lowest key at or above 'key' and sets 'key'
+     * to it, or 0.
+     */
+    Value* FindNext(unsigned int& key)
+    {
+        for(unsigned int x = key; x < KeyMax; x++)
+        {
+            if(m_index[x] != 0)
+            {
+                key = x;
+                return &m_slots[m_index[x] - 1].second;
+            }
+        }
+        return 0;
+    }
+
+    pair<Value*, bool> Insert(unsigned int key, const Value& value)
+    {
+        if(key >= KeyMax)
+        {
+            return pair<Value*, bool>(0, false);
+        }
+        if(m_index[key] != 0)
+        {
+            return pair<Value*, bool>(&m_slots[m_index[key] - 1].second, false);
+        }
+        if(m_size == SlotMax)
+        {
+            return pair<Value*, bool>(0, false);
+        }
+
+        unsigned int slot = AllocSlot();
+        m_slots[slot].first = key;
+        m_slots[slot].second = value;
+        m_index[key] = (unsigned short)(slot + 1);
+        m_size++;
+        FAPIMemory::Reserve(SITE, -(long long)sizeof(Slot));
+        FAPIMemory::Acquire(SITE, sizeof(Slot));
+        return pair<Value*, bool>(&m_slots[slot].second, true);
+    }
+
+    bool Erase(unsigned int key)
+    {
+        if((key >= KeyMax)||(m_index[key] == 0))
+        {
+            return false;
+        }
+        unsigned int slot = m_index[key] - 1;
+        m_index[key] = 0;
+        m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
+        if((slot / 64) < m_freeHint)
+        {
+            m_freeHint = slot / 64;
+        }
+        m_size--;
+        FAPIMemory::Release(SITE, sizeof(Slot));
+        FAPIMemory::Reserve(SITE, (long long)sizeof(Slot));
+        return true;
+    }
+
+    unsigned int Size() const
+    {
+        return m_size;
+    }
+
+    bool ValidKey(unsigned int key) const
+    {
+        return (key < KeyMax);
+    }
+
+    unsigned int Capacity() const
+    {
+        return SlotMax;
+    }
+
+    iterator begin()
+    {
+        return iterator(this, NextOccupied(0));
+    }
+
+    iterator end()
+    {
+        return iterator(this, SlotMax);
+    }
+
+private:
+    SlotTable(const SlotTable&);
+    SlotTable& operator =(const SlotTable&);
+
+    enum { BITMAP_WORDS = (SlotMax + 63) / 64 };
+
+    static const NPF_F_ATM_ConfigMgr_MemSite_t SITE = (NPF_F_ATM_ConfigMgr_MemSite_t)MemSite;
+
+    // The key index stores slot + 1 in 16 bits.
+    typedef char SlotMaxCheck[(SlotMax < 0xFFFF) ? 1 : -1];
+
+    /**
+     * Returns the first occupied slot at or after 'from', or SlotMax.
+     */
+    unsigned int NextOccupied(unsigned int from) const
+    {
+        while(from < SlotMax)
+        {
+            unsigned long long word = m_occupied[from / 64] >> (from % 64);
+            if(word != 0)
+            {
+                from += __builtin_ctzll(word);
+                return (from < SlotMax) ? from : SlotMax;
+            }
+            from = (from / 64 + 1) * 64;
+        }
+        return SlotMax;
+    }
+
+    /**
+     * Claims a free slot. The caller has checked that one exists.
+     */
+    unsigned int AllocSlot()
+    {
+        unsigned int word = m_freeHint;
+        while(m_occupied[word] == ~0ULL)
+        {
+            word = (word + 1) % BITMAP_WORDS;
+        }
+        unsigned int bit = __builtin_ctzll(~m_occupied[word]);
+        m_occupied[word] |= (1ULL << bit);
+        m_freeHint = word;
+        return word * 64 + bit;
+    }
+
+    /**
+    * SlotTable Member Variables.
+    *
+    * m_slots - The stored entries, aligned to a cache line.
+    *
+    * m_index - Slot number plus one for every key, 0 when the key is unused.
+    *
+    * m_occupied - One bit per slot, set when the slot holds an entry.
+    *
+    * m_freeHint - Bitmap word at which the search for a free slot starts.
+    *
+    */
+    Slot m_slots[SlotMax] __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+    unsigned short m_index[KeyMax];
+    unsigned long long m_occupied[BITMAP_WORDS];
+    unsigned int m_size;
+    unsigned int m_freeHint;
+};
+#endif // #if !defined __TABLESTORAGE_H_
+/**
+ *@}
+ */
@@ -0,0 +1,462 @@
+/**
+ * @file TraceBuffer.cpp
+ *
+ * @date 23 May 2005
+ *
+ * @brief The TraceBuffer collects simulator trace without formatting it on
+ *        the calling thread.
+ *
+ * Implementation of the per thread trace rings, the drain thread and the
+ * deferred formatter.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "TraceBuffer.h"
+
+/*
+ * System defined include files required.
+ */
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Ring of the calling thread, 0 until it first traces.
+ */
+static __thread void* t_traceRing = 0;
+
+TraceBuffer::TraceBuffer()
+: m_output(stdout), m_drainStarted(false), m_stopping(0), m_droppedUnattached(0)
+{
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_TRACE_THREADS_MAX; x++)
+    {
+        m_rings[x] = 0;
+    }
+    pthread_key_create(&m_ringKey, ReleaseRing);
+    pthread_mutex_init(&m_attachLock, 0);
+    pthread_mutex_init(&m_drainLock, 0);
+}
+
+TraceBuffer::~TraceBuffer()
+{
+    // The rings are left allocated, threads that outlive static
+    // destruction may still be tracing into them. A ring would otherwise
+    // be destroyed with ~TraceRing() and its memory returned with free().
+}
+
+TraceBuffer& TraceBuffer::instance()
+{
+    // Singleton Pattern
+    static TraceBuffer instance;
+    return instance;
+}
+
+/**
+ * Function Definition: Reserve()
+ */
+TraceBuffer::TraceRecord* TraceBuffer::Reserve()
+{
+    TraceRing* ring = static_cast<TraceRing*>(t_traceRing);
+    if(ring == 0)
+    {
+        ring = instance().AttachRing();
+        if(ring == 0)
+        {
+            return 0;
+        }
+    }
+
+    unsigned int tail = ring->tail;
+    if((tail - ring->cachedHead) >= _IX_CC_ATM_FAPI_TRACE_RING_SIZE)
+    {
+        ring->cachedHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if((tail - ring->cachedHead) >= _IX_CC_ATM_FAPI_TRACE_RING_SIZE)
+        {
+            __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+    }
+
+    TraceRecord* record = &ring->records[tail % _IX_CC_ATM_FAPI_TRACE_RING_SIZE];
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record->timestamp = (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    return record;
+}
+
+/**
+ * Function Definition: Commit()
+ */
+void TraceBuffer::Commit()
+{
+    TraceRing* ring = static_cast<TraceRing*>(t_traceRing);
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Function Definition: Store(TraceRecord* record, unsigned int index, const char* value)
+ */
+void TraceBuffer::Store(TraceRecord* record, unsigned int index, const char* value)
+{
+    record->types[index] = ARG_STRING;
+    record->args[index].u = record->textUsed;
+
+    if(value == 0)
+    {
+        value = "(null)";
+    }
+    // Strings share the text area, the last one is cut short when it runs
+    // out.
+    unsigned int space = _IX_CC_ATM_FAPI_TRACE_TEXT_MAX - record->textUsed;
+    if(space == 0)
+    {
+        record->args[index].u = _IX_CC_ATM_FAPI_TRACE_TEXT_MAX - 1;
+        return;
+    }
+    unsigned int length = strlen(value);
+    if(length >= space)
+    {
+        length = space - 1;
+    }
+    memcpy(&record->text[record->textUsed], value, length);
+    record->text[record->textUsed + length] = '\0';
+    record->textUsed += length + 1;
+}
+
+/**
+ * Function Definition: AttachRing()
+ */
+TraceBuffer::TraceRing* TraceBuffer::AttachRing()
+{
+    TraceRing* ring = 0;
+
+    pthread_mutex_lock(&m_attachLock);
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_TRACE_THREADS_MAX; x++)
+    {
+        if(m_rings[x] == 0)
+        {
+            // new of an over aligned type needs C++17, the ring is placed
+            // in memory taken with the alignment it asks for instead.
+            void* memory = 0;
+            if(posix_memalign(&memory, alignof(TraceRing), sizeof(TraceRing)) != 0)
+            {
+                break;
+            }
+            m_rings[x] = new (memory) TraceRing;
+            m_rings[x]->tail = 0;
+            m_rings[x]->cachedHead = 0;
+            m_rings[x]->head = 0;
+            m_rings[x]->dropped = 0;
+            ring = m_rings[x];
+            break;
+        }
+        // A released ring is reused once its records have been drained.
+        if((__atomic_load_n(&m_rings[x]->owned, __ATOMIC_ACQUIRE) == 0)&&
+           (__atomic_load_n(&m_rings[x]->head, __ATOMIC_ACQUIRE) == m_rings[x]->tail))
+        {
+            ring = m_rings[x];
+            ring->cachedHead = ring->head;
+            break;
+        }
+    }
+
+    if(ring == 0)
+    {
+        m_droppedUnattached++;
+        pthread_mutex_unlock(&m_attachLock);
+        return 0;
+    }
+
+    __atomic_store_n(&ring->owned, 1, __ATOMIC_RELEASE);
+    t_traceRing = ring;
+    pthread_setspecific(m_ringKey, ring);
+
+    if(m_drainStarted == false)
+    {
+        m_drainStarted = true;
+        if(pthread_create(&m_drainThread, 0, DrainThread, this) == 0)
+        {
+            atexit(DrainAtExit);
+        }
+    }
+    pthread_mutex_unlock(&m_attachLock);
+    return ring;
+}
+
+/**
+ * Function Definition: ReleaseRing(void* ring)
+ */
+void TraceBuffer::ReleaseRing(void* ring)
+{
+    // Called as the owning thread exits, its records are still drained.
+    __atomic_store_n(&static_cast<TraceRing*>(ring)->owned, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Function Definition: Drain(FILE* out)
+ */
+void TraceBuffer::Drain(FILE* out)
+{
+    TraceRing* rings[_IX_CC_ATM_FAPI_TRACE_THREADS_MAX];
+    unsigned int tails[_IX_CC_ATM_FAPI_TRACE_THREADS_MAX];
+    unsigned int numRings = 0;
+
+    pthread_mutex_lock(&m_drainLock);
+
+    pthread_mutex_lock(&m_attachLock);
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_TRACE_THREADS_MAX; x++)
+    {
+        if(m_rings[x] != 0)
+        {
+            rings[numRings] = m_rings[x];
+            tails[numRings] = __atomic_load_n(&m_rings[x]->tail, __ATOMIC_ACQUIRE);
+            numRings++;
+        }
+    }
+    pthread_mutex_unlock(&m_attachLock);
+
+    // Merge the rings by timestamp, up to the tails seen above.
+    for(;;)
+    {
+        TraceRing* oldest = 0;
+        for(unsigned int x = 0; x < numRings; x++)
+        {
+            if(rings[x]->head == tails[x])
+            {
+                continue;
+            }
+            const TraceRecord& record = rings[x]->records[rings[x]->head % _IX_CC_ATM_FAPI_TRACE_RING_SIZE];
+            if((oldest == 0)||
+               (record.timestamp < oldest->records[oldest->head % _IX_CC_ATM_FAPI_TRACE_RING_SIZE].timestamp))
+            {
+                oldest = rings[x];
+            }
+        }
+        if(oldest == 0)
+        {
+            break;
+        }
+        Format(oldest->records[oldest->head % _IX_CC_ATM_FAPI_TRACE_RING_SIZE], out);
+        __atomic_store_n(&oldest->head, oldest->head + 1, __ATOMIC_RELEASE);
+    }
+    fflush(out);
+
+    pthread_mutex_unlock(&m_drainLock);
+}
+
+/**
+ * Function Definition: Format(const TraceRecord& record, FILE* out)
+ */
+void TraceBuffer::Format(const TraceRecord& record, FILE* out)
+{
+    const char* format = record.format;
+    unsigned int argIndex = 0;
+    char spec[32];
+    char text[256];
+
+    while(*format != '\0')
+    {
+        if(*format != '%')
+        {
+            const char* next = strchr(format, '%');
+            size_t length = (next == 0) ? strlen(format) : (size_t)(next - format);
+            fwrite(format, 1, length, out);
+            format += length;
+            continue;
+        }
+        if(format[1] == '%')
+        {
+            fputc('%', out);
+            format += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision, drop any length modifier, the
+        // stored type decides it.
+        const char* start = format++;
+        size_t specLength = 1;
+        spec[0] = '%';
+        while((*format != '\0')&&(strchr("-+ #0123456789.", *format) != 0)&&(specLength < sizeof(spec) - 4))
+        {
+            spec[specLength++] = *format++;
+        }
+        while((*format != '\0')&&(strchr("hlLqjzt", *format) != 0))
+        {
+            format++;
+        }
+        char conversion = *format;
+        if((conversion == '\0')||(strchr("diouxXcsfFeEgGaAp", conversion) == 0)||(argIndex >= record.numArgs))
+        {
+            // Unsupported or missing argument, print the text as written.
+            size_t length = (conversion == '\0') ? (size_t)(format - start) : (size_t)(format - start + 1);
+            fwrite(start, 1, length, out);
+            format += (conversion == '\0') ? 0 : 1;
+            continue;
+        }
+        format++;
+
+        unsigned char type = record.types[argIndex];
+        long long signedValue = (type == ARG_DOUBLE) ? (long long)record.args[argIndex].d :
+                                (type == ARG_POINTER) ? (long long)(unsigned long)record.args[argIndex].p :
+                                record.args[argIndex].s;
+
+        switch(conversion)
+        {
+            case 'd':
+            case 'i':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                if(type == ARG_UNSIGNED)
+                {
+                    // Reinterpreted at the width it was passed with.
+                    snprintf(text, sizeof(text), spec, (long long)record.args[argIndex].u);
+                }else
+                {
+                    snprintf(text, sizeof(text), spec, signedValue);
+                }
+            break;
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                snprintf(text, sizeof(text), spec, (unsigned long long)signedValue);
+            break;
+            case 'c':
+                spec[specLength++] = 'c';
+                spec[specLength] = '\0';
+                snprintf(text, sizeof(text), spec, (int)signedValue);
+            break;
+            case 's':
+                spec[specLength++] = 's';
+                spec[specLength] = '\0';
+                snprintf(text, sizeof(text), spec,
+                         (type == ARG_STRING) ? &record.text[record.args[argIndex].u] : "(?)");
+            break;
+            case 'p':
+                spec[specLength++] = 'p';
+                spec[specLength] = '\0';
+                snprintf(text, sizeof(text), spec, (type == ARG_POINTER) ?
+                         record.args[argIndex].p : (const void*)(unsigned long)signedValue);
+            break;
+            default:
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                snprintf(text, sizeof(text), spec, (type == ARG_DOUBLE) ?
+                         record.args[argIndex].d : (double)signedValue);
+            break;
+        }
+        fputs(text, out);
+        argIndex++;
+    }
+}
+
+/**
+ * Function Definition: Dump(FILE* out)
+ */
+void TraceBuffer::Dump(FILE* out)
+{
+    Drain(out);
+}
+
+void TraceBuffer::SetOutput(FILE* out)
+{
+    pthread_mutex_lock(&m_drainLock);
+    m_output = out;
+    pthread_mutex_unlock(&m_drainLock);
+}
+
+unsigned long long TraceBuffer::GetDropped()
+{
+    unsigned long long dropped = 0;
+
+    pthread_mutex_lock(&m_attachLock);
+    dropped = m_droppedUnattached;
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_TRACE_THREADS_MAX; x++)
+    {
+        if(m_rings[x] != 0)
+        {
+            dropped += __atomic_load_n(&m_rings[x]->dropped, __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&m_attachLock);
+    return dropped;
+}
+
+/**
+ * Function Definition: DrainThread(void* arg)
+ */
+void* TraceBuffer::DrainThread(void* arg)
+{
+    TraceBuffer* buffer = static_cast<TraceBuffer*>(arg);
+    struct timespec interval;
+    interval.tv_sec = 0;
+    interval.tv_nsec = _IX_CC_ATM_FAPI_TRACE_DRAIN_MS * 1000000L;
+
+    while(__atomic_load_n(&buffer->m_stopping, __ATOMIC_ACQUIRE) == 0)
+    {
+        nanosleep(&interval, 0);
+        pthread_mutex_lock(&buffer->m_drainLock);
+        FILE* out = buffer->m_output;
+        pthread_mutex_unlock(&buffer->m_drainLock);
+        buffer->Drain(out);
+    }
+    return 0;
+}
+
+/**
+ * Function Definition: DrainAtExit()
+ */
+void TraceBuffer::DrainAtExit()
+{
+    TraceBuffer& buffer = instance();
+    __atomic_store_n(&buffer.m_stopping, 1, __ATOMIC_RELEASE);
+    pthread_join(buffer.m_drainThread, 0);
+
+    pthread_mutex_lock(&buffer.m_drainLock);
+    FILE* out = buffer.m_output;
+    pthread_mutex_unlock(&buffer.m_drainLock);
+    buffer.Drain(out);
+}
@@ -0,0 +1,312 @@
+/**
+ * @file TraceBuffer.h
+ *
+ * @date 23 May 2005
+ *
+ * @brief The TraceBuffer collects simulator trace without formatting it on
+ *        the calling thread.
+ *
+ * The TraceBuffer is a singleton behind the APISimTrace macro. A trace call
+ * stores its level, a timestamp, the format string and its arguments as a
+ * fixed size binary record in a ring owned by the calling thread. A drain
+ * thread formats the records and writes them out, Dump() does the same on
+ * demand.
+ *
+ * Design Notes:
+ *    Every thread that traces is given its own single producer, single
+ *    consumer ring the first time it traces, so recording takes no lock and
+ *    touches no shared cache line. A thread's ring is released for reuse
+ *    when the thread exits. Format strings are stored by address, they must
+ *    be literals. String arguments are copied into the record. When a ring
+ *    is full the record is dropped and counted rather than blocking the
+ *    caller. Records from different threads are merged by timestamp when
+ *    they are drained.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __TRACEBUFFER_H_
+#define __TRACEBUFFER_H_
+
+/**
+ * User defined include files required.
+ */
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <type_traits>
+
+class TraceBuffer
+{
+public:
+    virtual ~TraceBuffer();
+
+    static TraceBuffer& instance();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Record(unsigned int level, const char* format, Args... args)
+    *
+    * @brief Stores a trace record in the calling thread's ring.
+    *
+    * @param level unsigned int [in] - Trace level of the record.
+    * @param format const char* [in] - printf style format, must be a
+    *                                    string literal.
+    * @param args Args [in] - Up to _IX_CC_ATM_FAPI_TRACE_ARGS_MAX integer,
+    *                           floating point, pointer or string arguments.
+    *
+    * @return None
+    */
+    template<typename... Args>
+    static void Record(unsigned int level, const char* format, Args... args)
+    {
+        TraceRecord* record = Reserve();
+        if(record == 0)
+        {
+            return;
+        }
+        record->level = level;
+        record->format = format;
+        record->numArgs = 0;
+        record->textUsed = 0;
+        StoreArgs(record, args...);
+        Commit();
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Dump(FILE* out)
+    *
+    * @brief Formats and writes every record traced so far.
+    *
+    * @param out FILE* [in] - Stream the trace is written to.
+    *
+    * @return None
+    */
+    void Dump(FILE* out);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn SetOutput(FILE* out)
+    *
+    * @brief Sets the stream the drain thread writes to, stdout by default.
+    *
+    * @return None
+    */
+    void SetOutput(FILE* out);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn GetDropped()
+    *
+    * @brief Number of records dropped because a ring was full.
+    *
+    * @return unsigned long long
+    */
+    unsigned long long GetDropped();
+
+private:
+    TraceBuffer();
+    TraceBuffer(const TraceBuffer&);
+    TraceBuffer& operator =(const TraceBuffer&);
+
+    enum
+    {
+        ARG_SIGNED,
+        ARG_UNSIGNED,
+        ARG_DOUBLE,
+        ARG_POINTER,
+        ARG_STRING
+    };
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef TraceRecord
+    *
+    * @brief Typedef of one trace call as it is kept in a ring. String
+    *        arguments hold an offset into text.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long timestamp;
+        const char* format;
+        unsigned int level;
+        unsigned short numArgs;
+        unsigned short textUsed;
+        unsigned char types[_IX_CC_ATM_FAPI_TRACE_ARGS_MAX];
+        union
+        {
+            long long s;
+            unsigned long long u;
+            double d;
+            const void* p;
+        } args[_IX_CC_ATM_FAPI_TRACE_ARGS_MAX];
+        char text[_IX_CC_ATM_FAPI_TRACE_TEXT_MAX];
+    } TraceRecord;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef TraceRing
+    *
+    * @brief Typedef of a per thread ring. tail is only written by the
+    *        owning thread, head only by the thread draining the ring.
+    *
+    */
+    typedef struct
+    {
+        unsigned int tail __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+        unsigned int cachedHead;
+        unsigned int head __attribute__((aligned(_IX_CC_ATM_FAPI_CACHE_LINE)));
+        unsigned int owned;
+        unsigned long long dropped;
+        TraceRecord records[_IX_CC_ATM_FAPI_TRACE_RING_SIZE];
+    } TraceRing;
+
+    static TraceRecord* Reserve();
+    static void Commit();
+    static void ReleaseRing(void* ring);
+    static void* DrainThread(void* arg);
+    static void DrainAtExit();
+
+    TraceRing* AttachRing();
+    void Drain(FILE* out);
+    void Format(const TraceRecord& record, FILE* out);
+
+    /*
+     * Argument capture, every argument is stored with its category so the
+     * drain thread can format it whatever conversion the format names.
+     */
+    static void StoreArgs(TraceRecord*)
+    {
+    }
+
+    template<typename T, typename... Rest>
+    static void StoreArgs(TraceRecord* record, T value, Rest... rest)
+    {
+        if(record->numArgs < _IX_CC_ATM_FAPI_TRACE_ARGS_MAX)
+        {
+            Store(record, record->numArgs, value);
+            record->numArgs++;
+        }
+        StoreArgs(record, rest...);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    Store(TraceRecord* record, unsigned int index, T value)
+    {
+        if(std::is_signed<T>::value || std::is_enum<T>::value)
+        {
+            record->types[index] = ARG_SIGNED;
+            record->args[index].s = (long long)value;
+        }else
+        {
+            record->types[index] = ARG_UNSIGNED;
+            record->args[index].u = (unsigned long long)value;
+        }
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    Store(TraceRecord* record, unsigned int index, T value)
+    {
+        record->types[index] = ARG_DOUBLE;
+        record->args[index].d = (double)value;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_pointer<T>::value>::type
+    Store(TraceRecord* record, unsigned int index, T value)
+    {
+        record->types[index] = ARG_POINTER;
+        record->args[index].p = (const void*)value;
+    }
+
+    static void Store(TraceRecord* record, unsigned int index, const char* value);
+    static void Store(TraceRecord* record, unsigned int index, char* value)
+    {
+        Store(record, index, (const char*)value);
+    }
+
+    /**
+    * TraceBuffer Member Variables.
+    *
+    * m_rings - Ring slots, allocated the first time a thread needs one.
+    *
+    * m_ringKey - Thread specific key whose destructor releases the ring of
+    *             an exiting thread.
+    *
+    * m_attachLock - Serialises ring attachment and thread start up.
+    *
+    * m_drainLock - Serialises the drain thread and Dump().
+    *
+    * m_output - Stream the drain thread writes to.
+    *
+    * m_drainStarted, m_stopping - Drain thread state.
+    *
+    */
+    TraceRing* m_rings[_IX_CC_ATM_FAPI_TRACE_THREADS_MAX];
+    pthread_key_t m_ringKey;
+    pthread_mutex_t m_attachLock;
+    pthread_mutex_t m_drainLock;
+    pthread_t m_drainThread;
+    FILE* m_output;
+    bool m_drainStarted;
+    unsigned int m_stopping;
+    unsigned long long m_droppedUnattached;
+};
+#endif // #if !defined __TRACEBUFFER_H_
+/**
+ *@}
+ */
@@ -3,7 +3,22 @@
 #include "iostream.h"
 
 
-#define APISimTrace(level, format, args...)(level > 4) ? :  printf(format, ##args)
+/* Highest trace level compiled in. A trace above it is a constant false
+   branch and generates no code. */
+#ifndef APISIM_TRACE_LEVEL
+#define APISIM_TRACE_LEVEL 4
+#endif
+
+#if defined(APISIM_TRACE_DIRECT)
+/* Format and print on the calling thread, nothing is lost on a crash. */
+#define APISimTrace(level, format, args...) \
+    do { if((level) <= APISIM_TRACE_LEVEL) printf(format, ##args); } while(0)
+#else
+/* Record into the calling thread's ring, see TraceBuffer.h. */
+#include "TraceBuffer.h"
+#define APISimTrace(level, format, args...) \
+    do { if((level) <= APISIM_TRACE_LEVEL) TraceBuffer::Record((level), format, ##args); } while(0)
+#endif
 
 
 
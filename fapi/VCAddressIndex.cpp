@@ -0,0 +1,182 @@
+/**
+ * @file VCAddressIndex.cpp
+ *
+ * @date 11 April 2005
+ *
+ * @brief Secondary index of ATM VC addresses used by the TableManager.
+ *
+ * Maps an (interface ID, VPI, VCI) triple onto the owning VC Link ID using a
+ * fixed size open addressing hash table.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "VCAddressIndex.h"
+#include "TraceMacro.h"
+
+VCAddressIndex::VCAddressIndex()
+: m_size(0)
+{
+    for(unsigned int x = 0; x < _IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE; x++)
+    {
+        m_entries[x].used = false;
+    }
+}
+
+VCAddressIndex::~VCAddressIndex()
+{
+}
+
+/**
+ * Function Definition: MakeKey(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+ */
+unsigned long long VCAddressIndex::MakeKey(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+{
+    // VPI is at most 12 bits (NNI) and VCI 16 bits, so the packed key is exact.
+    return ((unsigned long long)ifId << 32) |
+           ((unsigned long long)(vpi & 0xFFFF) << 16) |
+           (unsigned long long)(vci & 0xFFFF);
+}
+
+/**
+ * Function Definition: HomeSlot(unsigned long long key)
+ */
+unsigned int VCAddressIndex::HomeSlot(unsigned long long key)
+{
+    // Fibonacci hashing, the top bits of the product select the slot.
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> (64 - _IX_CC_ATM_FAPI_VC_ADDR_INDEX_BITS));
+}
+
+/**
+ * Function Definition: Find(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+ *                           unsigned int* vcLinkId)
+ */
+bool VCAddressIndex::Find(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+                          unsigned int* vcLinkId) const
+{
+    unsigned long long key = MakeKey(ifId, vpi, vci);
+    unsigned int slot = HomeSlot(key);
+
+    while(m_entries[slot].used == true)
+    {
+        if(m_entries[slot].key == key)
+        {
+            if(vcLinkId != 0)
+            {
+                *vcLinkId = m_entries[slot].vcLinkId;
+            }
+            return true;
+        }
+        slot = (slot + 1) & (_IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE - 1);
+    }
+    return false;
+}
+
+/**
+ * Function Definition: Insert(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+ *                             unsigned int vcLinkId)
+ */
+bool VCAddressIndex::Insert(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+                            unsigned int vcLinkId)
+{
+    if(m_size >= _IX_CC_ATM_FAPI_VC_LINK_MAX)
+    {
+        APISimTrace(1,"Trace Level 1: VCAddressIndex::Insert - Index Full!\n");
+        return false;
+    }
+
+    unsigned long long key = MakeKey(ifId, vpi, vci);
+    unsigned int slot = HomeSlot(key);
+
+    while(m_entries[slot].used == true)
+    {
+        if(m_entries[slot].key == key)
+        {
+            return false;
+        }
+        slot = (slot + 1) & (_IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE - 1);
+    }
+
+    m_entries[slot].key = key;
+    m_entries[slot].vcLinkId = vcLinkId;
+    m_entries[slot].used = true;
+    m_size++;
+    return true;
+}
+
+/**
+ * Function Definition: Erase(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+ */
+bool VCAddressIndex::Erase(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+{
+    const unsigned int mask = _IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE - 1;
+    unsigned long long key = MakeKey(ifId, vpi, vci);
+    unsigned int slot = HomeSlot(key);
+
+    while((m_entries[slot].used == true)&&(m_entries[slot].key != key))
+    {
+        slot = (slot + 1) & mask;
+    }
+    if(m_entries[slot].used == false)
+    {
+        return false;
+    }
+
+    // Backward shift deletion: pull later members of the probe run into
+    // the hole as long as that does not move them before their home slot.
+    unsigned int hole = slot;
+    unsigned int next = (hole + 1) & mask;
+    while(m_entries[next].used == true)
+    {
+        unsigned int home = HomeSlot(m_entries[next].key);
+        if(((next - home) & mask) >= ((next - hole) & mask))
+        {
+            m_entries[hole] = m_entries[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    m_entries[hole].used = false;
+    m_size--;
+    return true;
+}
+
+unsigned int VCAddressIndex::Size() const
+{
+    return m_size;
+}
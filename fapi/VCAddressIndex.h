@@ -0,0 +1,174 @@
+/**
+ * @file VCAddressIndex.h
+ *
+ * @date 11 April 2005
+ *
+ * @brief Secondary index of ATM VC addresses used by the TableManager.
+ *
+ * The VCAddressIndex maps an (interface ID, VPI, VCI) triple onto the VC Link
+ * ID that owns it. It lets the TableManager reject a duplicate VC address in
+ * constant time instead of walking the whole ATM VC table.
+ *
+ * Design Notes:
+ *    The index is a fixed size open addressing hash table with linear
+ *    probing. Its capacity is derived from _IX_CC_ATM_FAPI_VC_LINK_MAX so
+ *    the load factor never exceeds one half and no memory is allocated
+ *    after construction. Entries are removed with backward shift deletion,
+ *    so no tombstones build up under VC churn.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __VCADDRESSINDEX_H_
+#define __VCADDRESSINDEX_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "FAPIDefs.h"
+
+class VCAddressIndex
+{
+public:
+    VCAddressIndex();
+    virtual ~VCAddressIndex();
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Find(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+    *          unsigned int* vcLinkId)
+    *
+    * @brief Looks up the VC Link ID registered for a VC address.
+    *
+    * @param ifId NPF_F_ATM_IfID_t [in] - Interface the VC belongs to.
+    * @param vpi unsigned int [in] - Virtual path identifier.
+    * @param vci unsigned int [in] - Virtual channel identifier.
+    * @param vcLinkId unsigned int* [out] - VC Link ID owning the address,
+    *                                         may be NULL.
+    *
+    * @return bool - true if the address is in use.
+    */
+    bool Find(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+              unsigned int* vcLinkId) const;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Insert(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+    *            unsigned int vcLinkId)
+    *
+    * @brief Records the VC Link ID owning a VC address.
+    *
+    * The insert fails if the address is already present or if the index
+    * already holds _IX_CC_ATM_FAPI_VC_LINK_MAX addresses.
+    *
+    * @return bool - true if the address was added.
+    */
+    bool Insert(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci,
+                unsigned int vcLinkId);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn Erase(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+    *
+    * @brief Removes a VC address from the index.
+    *
+    * @return bool - true if the address was present.
+    */
+    bool Erase(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci);
+
+    unsigned int Size() const;
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn MakeKey(NPF_F_ATM_IfID_t ifId, unsigned int vpi, unsigned int vci)
+    *
+    * @brief Packs a VC address into the key the index stores. Two 
+    *        addresses are equal when their keys are.
+    *
+    * @return unsigned long long
+    */
+    static unsigned long long MakeKey(NPF_F_ATM_IfID_t ifId, unsigned int vpi,
+                                      unsigned int vci);
+
+private:
+    VCAddressIndex(const VCAddressIndex&);
+    VCAddressIndex& operator =(const VCAddressIndex&);
+
+    static unsigned int HomeSlot(unsigned long long key);
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @typedef IndexEntry
+    *
+    * @brief A single slot of the open addressing table.
+    *
+    */
+    typedef struct
+    {
+        unsigned long long key;
+        unsigned int vcLinkId;
+        bool used;
+    } IndexEntry;
+
+    /**
+    * VCAddressIndex Member Variables.
+    *
+    * m_entries - Slot array, _IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE entries.
+    *
+    * m_size - Number of addresses currently stored.
+    *
+    */
+    IndexEntry m_entries[_IX_CC_ATM_FAPI_VC_ADDR_INDEX_SIZE];
+    unsigned int m_size;
+};
+#endif // #if !defined __VCADDRESSINDEX_H_
+/**
+ *@}
+ */
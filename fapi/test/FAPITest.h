@@ -0,0 +1,382 @@
+/**
+ * @file FAPITest.h
+ *
+ * @date 24 June 2005
+ *
+ * @brief Checks and a configuration client shared by the FAPI simulator
+ *        tests.
+ *
+ * Each test in this directory is an executable run by ctest that returns 0
+ * when every FAPI_CHECK() held. The FAPITestClient registers a callback
+ * handle with the callbacks delivered on the calling thread, so the
+ * responses of a call, whatever number of chunks they came in, are all
+ * known when the call returns.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/**
+ * @defgroup FAPI Simulator
+ *
+ * @brief FAPI Simulator mimics the behaviour of the control plane interface,
+ *             by a client, to the FWM product, through standard NPF APIs.
+ *
+ * @{
+ */
+#if !defined __FAPITEST_H_
+#define __FAPITEST_H_
+
+/**
+ * User defined include files required.
+ */
+#include "npf.h"
+#include "NPF_F_ATM_CONFIGURATION_MANAGER.h"
+#include "NPF_F_ATM_ConfigMgr_Ext.h"
+#include "CallBackHandler.h"
+#include "TableManager.h"
+#include "FAPIDefs.h"
+
+/**
+ * System defined include files required.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * Reports 'cond' with its place in the test if it does not hold. The test
+ * carries on, FAPITestResult() tells whether every check held.
+ */
+#define FAPI_CHECK(cond) FAPITestCheck((cond), #cond, __FILE__, __LINE__)
+
+static unsigned int fapiTestFailures = 0;
+
+static bool FAPITestCheck(bool held, const char* cond, const char* file, int line)
+{
+    if(held == false)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, cond);
+        fapiTestFailures++;
+    }
+    return held;
+}
+
+/*
+ * Returns the exit status of the test and reports how it went.
+ */
+static int FAPITestResult(const char* test)
+{
+    if(fapiTestFailures != 0)
+    {
+        fprintf(stderr, "%s: %u checks failed\n", test, fapiTestFailures);
+        return 1;
+    }
+    fprintf(stderr, "%s: passed\n", test);
+    return 0;
+}
+
+/*
+ * Every VC in VC Link ID order and the legs of every root in the order of
+ * the root, as the TableManager queries return them.
+ */
+struct FAPITestTables
+{
+    std::vector<TableManager::VCInfo> vcs;
+    std::vector<TableManager::XCInfo> legs;
+};
+
+inline FAPITestTables FAPITestReadTables()
+{
+    FAPITestTables tables;
+    TableManager::VCInfo vcs[64];
+    TableManager::XCInfo legs[_IX_CC_ATM_FAPI_XC_LEGS_MAX];
+    unsigned int cursor = 0;
+    while(cursor != _IX_CC_ATM_FAPI_QUERY_END)
+    {
+        unsigned int found = TableManager::instance().QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, vcs, 64);
+        tables.vcs.insert(tables.vcs.end(), vcs, vcs + found);
+    }
+    for(unsigned int x = 0; x < tables.vcs.size(); x++)
+    {
+        if(tables.vcs[x].xcRole != TableManager::VC_XC_ROOT)
+        {
+            continue;
+        }
+        cursor = 0;
+        while(cursor != _IX_CC_ATM_FAPI_QUERY_END)
+        {
+            unsigned int found = TableManager::instance().QueryLinkXCs(tables.vcs[x].vcLinkId, cursor, legs,
+                                                                       _IX_CC_ATM_FAPI_XC_LEGS_MAX);
+            tables.legs.insert(tables.legs.end(), legs, legs + found);
+        }
+    }
+    return tables;
+}
+
+inline bool FAPITestSameTables(const FAPITestTables& a, const FAPITestTables& b)
+{
+    if((a.vcs.size() != b.vcs.size())||(a.legs.size() != b.legs.size()))
+    {
+        return false;
+    }
+    for(unsigned int x = 0; x < a.vcs.size(); x++)
+    {
+        const TableManager::VCInfo& vcA = a.vcs[x];
+        const TableManager::VCInfo& vcB = b.vcs[x];
+        if((vcA.vcLinkId != vcB.vcLinkId)||(vcA.ifId != vcB.ifId)||(vcA.vc.vpi != vcB.vc.vpi)||
+           (vcA.vc.vci != vcB.vc.vci)||(vcA.xcRole != vcB.xcRole)||(vcA.numLegs != vcB.numLegs))
+        {
+            return false;
+        }
+    }
+    for(unsigned int x = 0; x < a.legs.size(); x++)
+    {
+        const TableManager::XCInfo& legA = a.legs[x];
+        const TableManager::XCInfo& legB = b.legs[x];
+        if((legA.vcXcId != legB.vcXcId)||(legA.xcType != legB.xcType)||(legA.link_A != legB.link_A)||
+           (legA.link_B != legB.link_B))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The interfaces, VCs and cross connect legs held by the tables.
+ */
+inline unsigned long long FAPITestTableObjects()
+{
+    unsigned long long objects = 0;
+    for(unsigned int x = NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE; x <= NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE; x++)
+    {
+        NPF_F_ATM_ConfigMgr_MemInfo_t info;
+        NPF_F_ATM_ConfigMgr_MemoryGet((NPF_F_ATM_ConfigMgr_MemSite_t)x, &info);
+        objects += info.objects;
+    }
+    return objects;
+}
+
+/*
+ * The memory accounted to every site.
+ */
+inline void FAPITestGetMemory(NPF_F_ATM_ConfigMgr_MemInfo_t info[NPF_F_ATM_CONFIGMGR_MEM_COUNT])
+{
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+    {
+        FAPI_CHECK(NPF_F_ATM_ConfigMgr_MemoryGet((NPF_F_ATM_ConfigMgr_MemSite_t)x, &info[x]) == NPF_NO_ERROR);
+    }
+}
+
+class FAPITestClient
+{
+public:
+    FAPITestClient()
+    : m_handle(0), m_numCallbacks(0), m_allOK(true)
+    {
+        CallBackHandler::instance().setCallbackModeSync();
+        NPF_F_ATM_ConfigMgr_Register(this, Completion, &m_handle);
+    }
+
+    virtual ~FAPITestClient()
+    {
+        NPF_F_ATM_ConfigMgr_Deregister(m_handle);
+    }
+
+    /**
+    * @ingroup FAPI Simulator
+    *
+    * @fn IfSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_IfCfg_t* cfgArray,
+    *           NPF_errorReporting_t errorReporting)
+    *
+    * @brief Makes the FAPI call of the same name with the handle of the
+    *        client and collects its responses. The other calls do the same.
+    *
+    * @return NPF_error_t - What the FAPI call returned.
+    */
+    NPF_error_t IfSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_IfCfg_t* cfgArray,
+                      NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_IfSet(m_handle, 0, errorReporting, 0, 0, numEntries, cfgArray);
+    }
+
+    NPF_error_t IfDelete(NPF_boolean_t delContainedObjs, NPF_uint32_t numEntries, NPF_F_ATM_IfID_t* delArray,
+                         NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_IfDelete(m_handle, 0, errorReporting, 0, 0, delContainedObjs, numEntries, delArray);
+    }
+
+    NPF_error_t VcSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_Vc_t* cfgArray,
+                      NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_VcSet(m_handle, 0, errorReporting, 0, 0, numEntries, cfgArray);
+    }
+
+    NPF_error_t VcLinkXcSet(NPF_uint32_t numEntries, NPF_F_ATM_ConfigMgr_VcLinkXc_t* vcLinkXc,
+                            NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_VcLinkXcSet(m_handle, 0, errorReporting, 0, 0, numEntries, vcLinkXc);
+    }
+
+    NPF_error_t VcDelete(NPF_uint32_t numEntries, NPF_F_ATM_VcLinkId_t* delArray,
+                         NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_VcDelete(m_handle, 0, errorReporting, 0, 0, numEntries, delArray);
+    }
+
+    NPF_error_t VcLinkXcDelete(NPF_uint32_t numEntries, NPF_F_ATM_VcXcId_t* delArray,
+                               NPF_errorReporting_t errorReporting = NPF_REPORT_ALL)
+    {
+        Start();
+        return NPF_F_ATM_ConfigMgr_VcLinkXcDelete(m_handle, 0, errorReporting, 0, 0, numEntries, delArray);
+    }
+
+    /*
+     * The responses of the last call, its number of callbacks and whether
+     * every callback had allOK set.
+     */
+    const std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t>& Responses() const
+    {
+        return m_responses;
+    }
+
+    unsigned int NumCallbacks() const
+    {
+        return m_numCallbacks;
+    }
+
+    bool AllOK() const
+    {
+        return m_allOK;
+    }
+
+    /*
+     * The error reported for the last call's entry on 'objId', or ~0 if
+     * no response names it. IDs of every kind are held in the same place.
+     */
+    NPF_error_t ErrorOf(NPF_uint32_t objId) const
+    {
+        for(unsigned int x = 0; x < m_responses.size(); x++)
+        {
+            if(m_responses[x].objId.vcXcId == objId)
+            {
+                return m_responses[x].error;
+            }
+        }
+        return (NPF_error_t)~0;
+    }
+
+    NPF_callbackHandle_t Handle() const
+    {
+        return m_handle;
+    }
+
+    /*
+     * Records for the tests to fill in.
+     */
+    static NPF_F_ATM_ConfigMgr_IfCfg_t If(NPF_F_ATM_IfID_t ifId)
+    {
+        NPF_F_ATM_ConfigMgr_IfCfg_t cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.ifID = ifId;
+        cfg.ifType = NPF_F_ATM_IF_UNI;
+        return cfg;
+    }
+
+    static NPF_F_ATM_ConfigMgr_Vc_t Vc(NPF_F_ATM_VcLinkId_t vcLinkId, NPF_F_ATM_IfID_t ifId,
+                                       NPF_uint16_t vpi, NPF_uint16_t vci)
+    {
+        NPF_F_ATM_ConfigMgr_Vc_t cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.vcLinkId = vcLinkId;
+        cfg.ifId = ifId;
+        cfg.vc.vpi = vpi;
+        cfg.vc.vci = vci;
+        return cfg;
+    }
+
+    static NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t Leg(NPF_F_ATM_VcXcId_t vcXcId, NPF_F_ATM_VcLinkId_t leaf)
+    {
+        NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg;
+        memset(&leg, 0, sizeof(leg));
+        leg.vcXcId = vcXcId;
+        leg.xcType = NPF_F_ATM_EXT_TO_EXT;
+        leg.u.mapVcLink = leaf;
+        return leg;
+    }
+
+private:
+    FAPITestClient(const FAPITestClient&);
+    FAPITestClient& operator =(const FAPITestClient&);
+
+    void Start()
+    {
+        m_responses.clear();
+        m_numCallbacks = 0;
+        m_allOK = true;
+    }
+
+    static void Completion(NPF_userContext_t userContext, NPF_correlator_t,
+                           NPF_F_ATM_ConfigMgr_CallbackData_t data)
+    {
+        FAPITestClient* client = static_cast<FAPITestClient*>(userContext);
+        client->m_numCallbacks++;
+        client->m_allOK = (client->m_allOK == true)&&(data.allOK == NPF_TRUE);
+        client->m_responses.insert(client->m_responses.end(), data.resp, data.resp + data.n_resp);
+    }
+
+    /**
+    * FAPITestClient Member Variables.
+    *
+    * m_handle - The callback handle of the client.
+    *
+    * m_responses, m_numCallbacks, m_allOK - What the callbacks of the last
+    *                                        call delivered.
+    *
+    */
+    NPF_callbackHandle_t m_handle;
+    std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t> m_responses;
+    unsigned int m_numCallbacks;
+    bool m_allOK;
+};
+#endif // #if !defined __FAPITEST_H_
+/**
+ *@}
+ */
@@ -0,0 +1,183 @@
+/**
+ * @file TestChurn.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Adds and deletes the same VCs and cross connects over and over and
+ *        checks the simulator returns to the memory it started from.
+ *
+ * Every round adds VCs on interfaces of every shard, joins them in cross
+ * connects whose legs need link_B arrays from the LinkBPool, deletes the
+ * cross connects and then the VCs. After each round the bytes and objects
+ * in use at every place must be those before the first round, and the
+ * memory held unused, the LinkBPool free lists among it, must be that after
+ * the first round. The rounds also check that a cross connected VC cannot
+ * be deleted and that a leg named twice in one batch is only deleted once.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+enum
+{
+    CHURN_IFACES = 4,
+    CHURN_ROOTS = 4,
+    CHURN_LEGS = 3,
+    CHURN_VCS = CHURN_ROOTS * (CHURN_LEGS + 1),
+    CHURN_ROUNDS = 50
+};
+
+/*
+ * One round, with the root of each cross connect on one interface and its
+ * leaves on the others.
+ */
+static void Round(FAPITestClient& client, bool strict)
+{
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[CHURN_VCS];
+    NPF_F_ATM_VcLinkId_t vcIds[CHURN_VCS];
+    for(unsigned int v = 0; v < CHURN_VCS; v++)
+    {
+        vcIds[v] = 1 + v;
+        vcs[v] = FAPITestClient::Vc(vcIds[v], 1 + v % CHURN_IFACES, 0, 32 + v);
+    }
+    FAPI_CHECK(client.VcSet(CHURN_VCS, vcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[CHURN_ROOTS][CHURN_LEGS];
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xcs[CHURN_ROOTS];
+    NPF_F_ATM_VcXcId_t xcIds[CHURN_ROOTS * CHURN_LEGS];
+    for(unsigned int r = 0; r < CHURN_ROOTS; r++)
+    {
+        for(unsigned int l = 0; l < CHURN_LEGS; l++)
+        {
+            NPF_F_ATM_VcLinkId_t leaf = vcIds[r * (CHURN_LEGS + 1) + 1 + l];
+            legs[r][l] = FAPITestClient::Leg(leaf, leaf);
+            xcIds[r * CHURN_LEGS + l] = leaf;
+        }
+        xcs[r].link_A = vcIds[r * (CHURN_LEGS + 1)];
+        xcs[r].numLink_B = CHURN_LEGS;
+        xcs[r].link_B = legs[r];
+    }
+    FAPI_CHECK(client.VcLinkXcSet(CHURN_ROOTS, xcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    // A root or a leaf still in a cross connect is not deleted.
+    NPF_F_ATM_VcLinkId_t connected[2] = { vcIds[0], vcIds[1] };
+    FAPI_CHECK(client.VcDelete(2, connected) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == false);
+    FAPI_CHECK(client.ErrorOf(vcIds[0]) == NPF_ATM_F_E_CONT_OBJS_EXIST);
+    FAPI_CHECK(client.ErrorOf(vcIds[1]) == NPF_ATM_F_E_CONT_OBJS_EXIST);
+
+    // The first leg is named twice. A strict batch is refused as a whole,
+    // otherwise the first entry deletes the leg and the second finds none.
+    NPF_F_ATM_VcXcId_t repeated[CHURN_ROOTS * CHURN_LEGS + 1];
+    memcpy(repeated, xcIds, sizeof(xcIds));
+    repeated[CHURN_ROOTS * CHURN_LEGS] = xcIds[0];
+    FAPI_CHECK(client.VcLinkXcDelete(CHURN_ROOTS * CHURN_LEGS + 1, repeated) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == false);
+    if(strict == true)
+    {
+        FAPI_CHECK(client.Responses().size() == 1);
+        FAPI_CHECK(client.ErrorOf(xcIds[0]) == NPF_E_RESOURCE_NONEXISTENT);
+        FAPI_CHECK(client.VcLinkXcDelete(CHURN_ROOTS * CHURN_LEGS, xcIds) == NPF_NO_ERROR);
+        FAPI_CHECK(client.AllOK() == true);
+    }else if(FAPI_CHECK(client.Responses().size() == CHURN_ROOTS * CHURN_LEGS + 1) == true)
+    {
+        FAPI_CHECK(client.Responses()[0].error == NPF_NO_ERROR);
+        FAPI_CHECK(client.Responses()[CHURN_ROOTS * CHURN_LEGS].error == NPF_E_RESOURCE_NONEXISTENT);
+    }
+
+    FAPI_CHECK(client.VcDelete(CHURN_VCS, vcIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+}
+
+int main()
+{
+    // Responses come in several callbacks.
+    CallBackHandler::instance().setResponseChunkSize(5);
+    FAPITestClient client;
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[CHURN_IFACES];
+    for(unsigned int i = 0; i < CHURN_IFACES; i++)
+    {
+        ifs[i] = FAPITestClient::If(1 + i);
+    }
+    FAPI_CHECK(client.IfSet(CHURN_IFACES, ifs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    NPF_F_ATM_ConfigMgr_MemInfo_t start[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    NPF_F_ATM_ConfigMgr_MemInfo_t warm[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    NPF_F_ATM_ConfigMgr_MemInfo_t now[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    FAPITestGetMemory(start);
+
+    for(unsigned int round = 0; round < CHURN_ROUNDS; round++)
+    {
+        bool strict = ((round % 2) == 1);
+        NPF_F_ATM_ConfigMgr_SetBatchMode(client.Handle(), (strict == true) ? NPF_F_ATM_CONFIGMGR_BATCH_STRICT :
+                                                                             NPF_F_ATM_CONFIGMGR_BATCH_PARTIAL);
+        Round(client, strict);
+
+        // The pools have grown to the workload once the first round of
+        // each batch mode is over.
+        FAPITestGetMemory(now);
+        if(round == 1)
+        {
+            memcpy(warm, now, sizeof(warm));
+        }
+        for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+        {
+            FAPI_CHECK(now[x].objects == start[x].objects);
+            FAPI_CHECK(now[x].bytes == start[x].bytes);
+            if(round > 1)
+            {
+                FAPI_CHECK(now[x].reservedBytes == warm[x].reservedBytes);
+            }
+        }
+    }
+    FAPI_CHECK(now[NPF_F_ATM_CONFIGMGR_MEM_LINK_B].peakObjects == CHURN_ROOTS);
+
+    NPF_F_ATM_IfID_t ifIds[CHURN_IFACES];
+    for(unsigned int i = 0; i < CHURN_IFACES; i++)
+    {
+        ifIds[i] = 1 + i;
+    }
+    FAPI_CHECK(client.IfDelete(NPF_FALSE, CHURN_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    return FAPITestResult("fapi_test_churn");
+}
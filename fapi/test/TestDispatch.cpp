@@ -0,0 +1,166 @@
+/**
+ * @file TestDispatch.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Delivers callbacks on one dispatcher thread with a queue of four,
+ *        and from the completion of an IfSet makes calls on the same handle
+ *        that respond with more callbacks than the queue holds: a VcSet
+ *        repeated, whose every entry then fails and is reported in chunks.
+ *
+ * The nested calls return, every callback is delivered once and the
+ * callbacks of the handle keep the order of the calls that produced them.
+ * A dispatcher waiting on itself would never deliver the last callbacks,
+ * so the test gives up after a timeout instead of hanging.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+enum
+{
+    DISPATCH_VCS = 1000,
+    DISPATCH_CHUNK = 100,
+    DISPATCH_CALLBACKS = 1 + 1 + DISPATCH_VCS / DISPATCH_CHUNK + 1
+};
+
+/*
+ * The correlators of the calls, in the order they are made.
+ */
+enum
+{
+    CALL_IF_SET = 1,
+    CALL_VC_SET = 2,
+    CALL_VC_SET_AGAIN = 3,
+    CALL_LAST_IF_SET = 4
+};
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t delivered = PTHREAD_COND_INITIALIZER;
+static std::vector<NPF_correlator_t> correlators;
+static std::vector<NPF_boolean_t> allOK;
+static bool callsOK = false;
+static NPF_F_ATM_ConfigMgr_Vc_t vcs[DISPATCH_VCS];
+
+static void Completion(NPF_userContext_t userContext, NPF_correlator_t cbCorrelator,
+                       NPF_F_ATM_ConfigMgr_CallbackData_t data)
+{
+    NPF_callbackHandle_t cbHandle = *static_cast<NPF_callbackHandle_t*>(userContext);
+    pthread_mutex_lock(&lock);
+    correlators.push_back(cbCorrelator);
+    allOK.push_back(data.allOK);
+    pthread_cond_broadcast(&delivered);
+    pthread_mutex_unlock(&lock);
+
+    // The lock is not held, the callbacks of the nested calls may be
+    // delivered on this thread before they return.
+    if(cbCorrelator == (NPF_correlator_t)CALL_IF_SET)
+    {
+        NPF_F_ATM_ConfigMgr_IfCfg_t cfg = FAPITestClient::If(2);
+        NPF_error_t vcError = NPF_F_ATM_ConfigMgr_VcSet(cbHandle, (NPF_correlator_t)CALL_VC_SET, NPF_REPORT_ALL,
+                                                        0, 0, DISPATCH_VCS, vcs);
+        NPF_error_t againError = NPF_F_ATM_ConfigMgr_VcSet(cbHandle, (NPF_correlator_t)CALL_VC_SET_AGAIN,
+                                                           NPF_REPORT_ALL, 0, 0, DISPATCH_VCS, vcs);
+        NPF_error_t ifError = NPF_F_ATM_ConfigMgr_IfSet(cbHandle, (NPF_correlator_t)CALL_LAST_IF_SET,
+                                                        NPF_REPORT_ALL, 0, 0, 1, &cfg);
+        pthread_mutex_lock(&lock);
+        callsOK = (vcError == NPF_NO_ERROR)&&(againError == NPF_NO_ERROR)&&(ifError == NPF_NO_ERROR);
+        pthread_mutex_unlock(&lock);
+    }
+}
+
+int main()
+{
+    for(unsigned int v = 0; v < DISPATCH_VCS; v++)
+    {
+        vcs[v] = FAPITestClient::Vc(1 + v, 1, v / 256, 32 + v % 256);
+    }
+    CallBackHandler::instance().setResponseChunkSize(DISPATCH_CHUNK);
+    FAPI_CHECK(CallBackHandler::instance().setCallbackModeDispatch(1, 4) == true);
+    NPF_callbackHandle_t cbHandle = 0;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_Register(&cbHandle, Completion, &cbHandle) == NPF_NO_ERROR);
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t cfg = FAPITestClient::If(1);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_IfSet(cbHandle, (NPF_correlator_t)CALL_IF_SET, NPF_REPORT_ALL, 0, 0, 1, &cfg) ==
+               NPF_NO_ERROR);
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 10;
+    pthread_mutex_lock(&lock);
+    while(correlators.size() < DISPATCH_CALLBACKS)
+    {
+        if(pthread_cond_timedwait(&delivered, &lock, &deadline) != 0)
+        {
+            // The dispatcher thread cannot be stopped, leave without
+            // running the destructors that would wait for it.
+            fprintf(stderr, "fapi_test_dispatch: %u of %u callbacks delivered\n",
+                    (unsigned int)correlators.size(), (unsigned int)DISPATCH_CALLBACKS);
+            _exit(1);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    CallBackHandler::instance().setCallbackModeSync();
+    FAPI_CHECK(correlators.size() == DISPATCH_CALLBACKS);
+    FAPI_CHECK(callsOK == true);
+    FAPI_CHECK((correlators[0] == (NPF_correlator_t)CALL_IF_SET)&&(allOK[0] == NPF_TRUE));
+    FAPI_CHECK((correlators[1] == (NPF_correlator_t)CALL_VC_SET)&&(allOK[1] == NPF_TRUE));
+    for(unsigned int x = 2; x < DISPATCH_CALLBACKS - 1; x++)
+    {
+        FAPI_CHECK((correlators[x] == (NPF_correlator_t)CALL_VC_SET_AGAIN)&&(allOK[x] == NPF_FALSE));
+    }
+    FAPI_CHECK(correlators[DISPATCH_CALLBACKS - 1] == (NPF_correlator_t)CALL_LAST_IF_SET);
+    FAPI_CHECK(allOK[DISPATCH_CALLBACKS - 1] == NPF_TRUE);
+    FAPI_CHECK(FAPITestTableObjects() == 2 + DISPATCH_VCS);
+
+    NPF_F_ATM_IfID_t ifIds[2] = { 1, 2 };
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_IfDelete(cbHandle, 0, NPF_REPORT_NONE, 0, 0, NPF_TRUE, 2, ifIds) ==
+               NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    NPF_F_ATM_ConfigMgr_Deregister(cbHandle);
+    return FAPITestResult("fapi_test_dispatch");
+}
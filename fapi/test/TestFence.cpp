@@ -0,0 +1,194 @@
+/**
+ * @file TestFence.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Queues a fence with NPF_F_ATM_ConfigMgr_CallbackFence() after a
+ *        call reporting nothing, a call reporting only its errors and a
+ *        call reported in chunks, and checks that each fence is delivered
+ *        after every callback of its call, in sync and in dispatch mode.
+ *
+ * The fence is told apart by its correlator alone: it carries allOK
+ * NPF_TRUE, no responses and a data.type that is no NPF callback type.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+enum
+{
+    FENCE_VCS = 35,
+    FENCE_CHUNK = 10,
+    FENCE_TAG = 100
+};
+
+/*
+ * A delivered callback.
+ */
+struct FenceRecord
+{
+    NPF_correlator_t correlator;
+    NPF_F_ATM_ConfigMgr_CallbackData_t data;
+};
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t delivered = PTHREAD_COND_INITIALIZER;
+static std::vector<FenceRecord> records;
+
+static void Completion(NPF_userContext_t, NPF_correlator_t cbCorrelator, NPF_F_ATM_ConfigMgr_CallbackData_t data)
+{
+    FenceRecord record;
+    record.correlator = cbCorrelator;
+    record.data = data;
+    pthread_mutex_lock(&lock);
+    records.push_back(record);
+    pthread_cond_broadcast(&delivered);
+    pthread_mutex_unlock(&lock);
+}
+
+/*
+ * Queues the fence of call 'call' and waits for it. Returns the callbacks
+ * of the call, checking that they all came before the fence.
+ */
+static std::vector<FenceRecord> Fence(NPF_callbackHandle_t cbHandle, unsigned int call)
+{
+    NPF_correlator_t fence = (NPF_correlator_t)(FENCE_TAG + call);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_CallbackFence(cbHandle, fence) == NPF_NO_ERROR);
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 10;
+    pthread_mutex_lock(&lock);
+    while((records.empty() == true)||(records.back().correlator != fence))
+    {
+        if(pthread_cond_timedwait(&delivered, &lock, &deadline) != 0)
+        {
+            fprintf(stderr, "fapi_test_fence: fence %u not delivered\n", call);
+            _exit(1);
+        }
+    }
+    std::vector<FenceRecord> callbacks(records.begin(), records.end() - 1);
+    FenceRecord last = records.back();
+    records.clear();
+    pthread_mutex_unlock(&lock);
+
+    FAPI_CHECK((last.data.allOK == NPF_TRUE)&&(last.data.n_resp == 0)&&(last.data.resp == NULL));
+    FAPI_CHECK(last.data.type == 0);
+    for(unsigned int x = 0; x < callbacks.size(); x++)
+    {
+        FAPI_CHECK(callbacks[x].correlator == (NPF_correlator_t)call);
+    }
+    return callbacks;
+}
+
+static void Calls(NPF_callbackHandle_t cbHandle)
+{
+    NPF_F_ATM_ConfigMgr_IfCfg_t cfg = FAPITestClient::If(1);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_IfSet(cbHandle, (NPF_correlator_t)1, NPF_REPORT_ALL, 0, 0, 1, &cfg) ==
+               NPF_NO_ERROR);
+    FAPI_CHECK(Fence(cbHandle, 1).size() == 1);
+
+    // Reports nothing, the fence alone tells the call is done.
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[2 * FENCE_VCS];
+    NPF_F_ATM_VcLinkId_t vcIds[2 * FENCE_VCS];
+    for(unsigned int v = 0; v < 2 * FENCE_VCS; v++)
+    {
+        vcIds[v] = 1 + v;
+        vcs[v] = FAPITestClient::Vc(vcIds[v], 1, 0, 32 + v);
+    }
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_VcSet(cbHandle, (NPF_correlator_t)2, NPF_REPORT_NONE, 0, 0, FENCE_VCS, vcs) ==
+               NPF_NO_ERROR);
+    FAPI_CHECK(Fence(cbHandle, 2).empty() == true);
+    FAPI_CHECK(FAPITestTableObjects() == 1 + FENCE_VCS);
+
+    // Two VCs on addresses already taken, only they are reported.
+    vcs[FENCE_VCS + 2].vc.vci = 32;
+    vcs[2 * FENCE_VCS - 1].vc.vci = 33;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_VcSet(cbHandle, (NPF_correlator_t)3, NPF_REPORT_ERRORS, 0, 0, FENCE_VCS,
+                                         &vcs[FENCE_VCS]) == NPF_NO_ERROR);
+    std::vector<FenceRecord> callbacks = Fence(cbHandle, 3);
+    FAPI_CHECK(callbacks.size() == 1);
+    FAPI_CHECK((callbacks[0].data.allOK == NPF_FALSE)&&(callbacks[0].data.n_resp == 2));
+    FAPI_CHECK(FAPITestTableObjects() == 2 * FENCE_VCS - 1);
+
+    // Every entry is reported, one callback a chunk. The chunks of the two
+    // VCs that were not added are not allOK.
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_VcDelete(cbHandle, (NPF_correlator_t)4, NPF_REPORT_ALL, 0, 0, 2 * FENCE_VCS,
+                                            vcIds) == NPF_NO_ERROR);
+    callbacks = Fence(cbHandle, 4);
+    FAPI_CHECK(callbacks.size() == (2 * FENCE_VCS + FENCE_CHUNK - 1) / FENCE_CHUNK);
+    for(unsigned int x = 0; x < callbacks.size(); x++)
+    {
+        FAPI_CHECK(callbacks[x].data.n_resp == FENCE_CHUNK);
+        bool refused = (x == (FENCE_VCS + 2) / FENCE_CHUNK)||(x == (2 * FENCE_VCS - 1) / FENCE_CHUNK);
+        FAPI_CHECK(callbacks[x].data.allOK == (refused ? NPF_FALSE : NPF_TRUE));
+    }
+    FAPI_CHECK(FAPITestTableObjects() == 1);
+
+    NPF_F_ATM_IfID_t ifId = 1;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_IfDelete(cbHandle, (NPF_correlator_t)5, NPF_REPORT_NONE, 0, 0, NPF_FALSE, 1,
+                                            &ifId) == NPF_NO_ERROR);
+    FAPI_CHECK(Fence(cbHandle, 5).empty() == true);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+}
+
+int main()
+{
+    CallBackHandler::instance().setResponseChunkSize(FENCE_CHUNK);
+    CallBackHandler::instance().setCallbackModeSync();
+    NPF_callbackHandle_t cbHandle = 0;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_Register(0, Completion, &cbHandle) == NPF_NO_ERROR);
+    Calls(cbHandle);
+
+    FAPI_CHECK(CallBackHandler::instance().setCallbackModeDispatch(2, 4) == true);
+    Calls(cbHandle);
+    CallBackHandler::instance().setCallbackModeSync();
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_CallbackFence(cbHandle + 1, (NPF_correlator_t)FENCE_TAG) ==
+               NPF_E_BAD_CALLBACK_HANDLE);
+    NPF_F_ATM_ConfigMgr_Deregister(cbHandle);
+    return FAPITestResult("fapi_test_fence");
+}
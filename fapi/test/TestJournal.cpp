@@ -0,0 +1,178 @@
+/**
+ * @file TestJournal.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Records changes in a journal after a snapshot and checks that
+ *        replaying the journal over the restored snapshot gives back the
+ *        tables the changes were made to.
+ *
+ * The journaled changes add and delete interfaces, VCs and cross connect
+ * legs, including legs added to a root of the snapshot and an interface
+ * deleted with its contained objects. An entry that fails is not recorded.
+ * Replaying a journal a second time changes nothing, and a journal that is
+ * opened again is appended to.
+ *
+ * Usage: fapi_test_journal <file prefix>
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+/*
+ * System defined include files required.
+ */
+#include <string>
+
+enum
+{
+    JOURNAL_SAVED_VCS = 6,
+    JOURNAL_ADDED_VCS = 5
+};
+
+/*
+ * Deletes every interface of the test, and with them all it contains.
+ */
+static void ClearTables(FAPITestClient& client)
+{
+    NPF_F_ATM_IfID_t ifIds[3] = { 20, 21, 22 };
+    client.IfDelete(NPF_TRUE, 3, ifIds);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: fapi_test_journal <file prefix>\n");
+        return 1;
+    }
+    std::string snapshot = std::string(argv[1]) + ".snap";
+    std::string journal = std::string(argv[1]) + ".journal";
+    remove(journal.c_str());
+    FAPITestClient client;
+
+    // The tables held by the snapshot.
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[3] = { FAPITestClient::If(20), FAPITestClient::If(21), FAPITestClient::If(22) };
+    FAPI_CHECK(client.IfSet(2, ifs) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_Vc_t saved[JOURNAL_SAVED_VCS];
+    for(unsigned int v = 0; v < JOURNAL_SAVED_VCS; v++)
+    {
+        saved[v] = FAPITestClient::Vc(300 + v, 20 + v % 2, 0, 50 + v);
+    }
+    FAPI_CHECK(client.VcSet(JOURNAL_SAVED_VCS, saved) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t savedLegs[2] = { FAPITestClient::Leg(601, 301), FAPITestClient::Leg(602, 302) };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t savedXC = { 300, 2, savedLegs };
+    FAPI_CHECK(client.VcLinkXcSet(1, &savedXC) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPITestTables atSnapshot = FAPITestReadTables();
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotSave(snapshot.c_str()) == NPF_NO_ERROR);
+
+    // The journaled changes.
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalOpen(journal.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalOpen(journal.c_str()) == NPF_E_UNKNOWN);
+    FAPI_CHECK(client.IfSet(1, &ifs[2]) == NPF_NO_ERROR);
+
+    // The last VC is on the address of VC 300 and is refused.
+    NPF_F_ATM_ConfigMgr_Vc_t added[JOURNAL_ADDED_VCS] =
+    {
+        FAPITestClient::Vc(306, 22, 0, 60), FAPITestClient::Vc(307, 22, 0, 61), FAPITestClient::Vc(308, 20, 0, 62),
+        FAPITestClient::Vc(309, 22, 0, 63), FAPITestClient::Vc(310, 20, 0, 50)
+    };
+    FAPI_CHECK(client.VcSet(JOURNAL_ADDED_VCS, added) == NPF_NO_ERROR);
+    FAPI_CHECK(client.ErrorOf(310) == NPF_ATM_F_E_INVALID_VC_ADDRESS);
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t addedLegs[3] =
+    {
+        FAPITestClient::Leg(603, 303), FAPITestClient::Leg(604, 307), FAPITestClient::Leg(605, 308)
+    };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t addedXCs[2] = { { 300, 1, &addedLegs[0] }, { 306, 2, &addedLegs[1] } };
+    FAPI_CHECK(client.VcLinkXcSet(2, addedXCs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    NPF_F_ATM_VcXcId_t xcId = 601;
+    FAPI_CHECK(client.VcLinkXcDelete(1, &xcId) == NPF_NO_ERROR);
+    NPF_F_ATM_VcLinkId_t vcIds[2] = { 301, 305 };
+    FAPI_CHECK(client.VcDelete(2, vcIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    // Interface 21 still holds VC 303, the leaf of leg 603.
+    NPF_F_ATM_IfID_t ifId = 21;
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, 1, &ifId) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalReplay(journal.c_str()) == NPF_E_UNKNOWN);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalFlush() == NPF_NO_ERROR);
+    FAPITestTables changed = FAPITestReadTables();
+    unsigned long long changedObjects = FAPITestTableObjects();
+    FAPI_CHECK(changed.vcs.size() == 7);
+    FAPI_CHECK(changed.legs.size() == 3);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalClose() == NPF_NO_ERROR);
+
+    // The snapshot and then the journal.
+    ClearTables(client);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotRestore(snapshot.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), atSnapshot) == true);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalReplay(journal.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), changed) == true);
+    FAPI_CHECK(FAPITestTableObjects() == changedObjects);
+
+    // The tables already hold every change of the journal.
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalReplay(journal.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), changed) == true);
+
+    // The replayed tables end with the journal, so it can be added to.
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalOpen(journal.c_str()) == NPF_NO_ERROR);
+    NPF_F_ATM_VcLinkId_t vcId = 309;
+    FAPI_CHECK(client.VcDelete(1, &vcId) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalClose() == NPF_NO_ERROR);
+    FAPITestTables appended = FAPITestReadTables();
+    FAPI_CHECK(appended.vcs.size() == 6);
+
+    ClearTables(client);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotRestore(snapshot.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_JournalReplay(journal.c_str()) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), appended) == true);
+
+    ClearTables(client);
+    remove(snapshot.c_str());
+    remove(journal.c_str());
+    return FAPITestResult("fapi_test_journal");
+}
@@ -0,0 +1,169 @@
+/**
+ * @file TestMemory.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Makes a known sequence of table changes and checks the objects,
+ *        bytes, allocation counts and high water marks of every place the
+ *        simulator accounts memory to.
+ *
+ * Entries are counted one object each, whatever the table storage, so the
+ * bytes of a table are a whole number of entries. A root with more than
+ * one leg takes a link_B array from the LinkBPool, a root with one leg does
+ * not. The high water marks keep the most held until they are reset to
+ * what is held then.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+enum
+{
+    MEM_IFACES = 3,
+    MEM_VCS = 8
+};
+
+/*
+ * Whether a table site holds 'objects' entries of 'entryBytes' each, having
+ * taken 'allocs' and given back 'frees' since 'start'.
+ */
+static bool Holds(const NPF_F_ATM_ConfigMgr_MemInfo_t& info, const NPF_F_ATM_ConfigMgr_MemInfo_t& start,
+                  NPF_uint64_t objects, NPF_uint64_t entryBytes, NPF_uint64_t allocs, NPF_uint64_t frees)
+{
+    return (info.objects == objects)&&(info.bytes == objects * entryBytes)&&
+           (info.allocs - start.allocs == allocs)&&(info.frees - start.frees == frees);
+}
+
+int main()
+{
+    FAPITestClient client;
+    NPF_F_ATM_ConfigMgr_MemInfo_t start[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    NPF_F_ATM_ConfigMgr_MemInfo_t now[NPF_F_ATM_CONFIGMGR_MEM_COUNT];
+    FAPITestGetMemory(start);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    FAPI_CHECK(start[NPF_F_ATM_CONFIGMGR_MEM_LINK_B].objects == 0);
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[MEM_IFACES];
+    NPF_F_ATM_IfID_t ifIds[MEM_IFACES];
+    for(unsigned int i = 0; i < MEM_IFACES; i++)
+    {
+        ifIds[i] = 1 + i;
+        ifs[i] = FAPITestClient::If(ifIds[i]);
+    }
+    FAPI_CHECK(client.IfSet(MEM_IFACES, ifs) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[MEM_VCS];
+    NPF_F_ATM_VcLinkId_t vcIds[MEM_VCS];
+    for(unsigned int v = 0; v < MEM_VCS; v++)
+    {
+        vcIds[v] = 100 + v;
+        vcs[v] = FAPITestClient::Vc(vcIds[v], ifIds[v % MEM_IFACES], 0, 32 + v);
+    }
+    FAPI_CHECK(client.VcSet(MEM_VCS, vcs) == NPF_NO_ERROR);
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[4] =
+    {
+        FAPITestClient::Leg(901, 101), FAPITestClient::Leg(902, 102), FAPITestClient::Leg(903, 103),
+        FAPITestClient::Leg(904, 105)
+    };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xcs[2] = { { 100, 3, &legs[0] }, { 104, 1, &legs[3] } };
+    FAPI_CHECK(client.VcLinkXcSet(2, xcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    FAPITestGetMemory(now);
+    const NPF_F_ATM_ConfigMgr_MemInfo_t& ifMem = now[NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE];
+    const NPF_F_ATM_ConfigMgr_MemInfo_t& vcMem = now[NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE];
+    const NPF_F_ATM_ConfigMgr_MemInfo_t& xcMem = now[NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE];
+    const NPF_F_ATM_ConfigMgr_MemInfo_t& linkBMem = now[NPF_F_ATM_CONFIGMGR_MEM_LINK_B];
+    NPF_uint64_t ifBytes = ifMem.bytes / MEM_IFACES;
+    NPF_uint64_t vcBytes = vcMem.bytes / MEM_VCS;
+    NPF_uint64_t xcBytes = xcMem.bytes / 4;
+    FAPI_CHECK((ifBytes != 0)&&(vcBytes != 0)&&(xcBytes != 0));
+    FAPI_CHECK(Holds(ifMem, start[NPF_F_ATM_CONFIGMGR_MEM_IF_TABLE], MEM_IFACES, ifBytes, MEM_IFACES, 0) == true);
+    FAPI_CHECK(Holds(vcMem, start[NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE], MEM_VCS, vcBytes, MEM_VCS, 0) == true);
+    FAPI_CHECK(Holds(xcMem, start[NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE], 4, xcBytes, 4, 0) == true);
+    FAPI_CHECK(linkBMem.objects == 1);
+    FAPI_CHECK(linkBMem.bytes >= 3 * sizeof(NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t));
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+    {
+        FAPI_CHECK(now[x].allocs - now[x].frees == now[x].objects);
+        FAPI_CHECK((now[x].peakObjects >= now[x].objects)&&(now[x].peakBytes >= now[x].bytes));
+    }
+
+    // The legs and half of the VCs go, the high water marks stay.
+    NPF_F_ATM_VcXcId_t xcIds[4] = { 901, 902, 903, 904 };
+    FAPI_CHECK(client.VcLinkXcDelete(4, xcIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.VcDelete(MEM_VCS / 2, vcIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPITestGetMemory(now);
+    FAPI_CHECK(Holds(vcMem, start[NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE], MEM_VCS / 2, vcBytes, MEM_VCS,
+                     MEM_VCS / 2) == true);
+    FAPI_CHECK(Holds(xcMem, start[NPF_F_ATM_CONFIGMGR_MEM_XC_TABLE], 0, xcBytes, 4, 4) == true);
+    FAPI_CHECK((linkBMem.objects == 0)&&(linkBMem.bytes == 0)&&(linkBMem.frees == linkBMem.allocs));
+    FAPI_CHECK((vcMem.peakObjects == MEM_VCS)&&(vcMem.peakBytes == MEM_VCS * vcBytes));
+    FAPI_CHECK((xcMem.peakObjects == 4)&&(xcMem.peakBytes == 4 * xcBytes));
+    FAPI_CHECK(linkBMem.peakObjects == 1);
+
+    // Once reset the high water marks follow the memory held from then on.
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MemoryResetPeaks() == NPF_NO_ERROR);
+    FAPITestGetMemory(now);
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_MEM_COUNT; x++)
+    {
+        FAPI_CHECK((now[x].peakObjects == now[x].objects)&&(now[x].peakBytes == now[x].bytes));
+    }
+    FAPI_CHECK(client.VcSet(2, vcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, MEM_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPITestGetMemory(now);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    FAPI_CHECK((vcMem.objects == 0)&&(vcMem.bytes == 0));
+    FAPI_CHECK((vcMem.peakObjects == MEM_VCS / 2 + 2)&&(vcMem.peakBytes == (MEM_VCS / 2 + 2) * vcBytes));
+    FAPI_CHECK((ifMem.peakObjects == MEM_IFACES)&&(xcMem.peakObjects == 0)&&(linkBMem.peakObjects == 0));
+
+    // Each call had its callback and response buffer back before it returned.
+    for(unsigned int x = NPF_F_ATM_CONFIGMGR_MEM_CALLBACK; x <= NPF_F_ATM_CONFIGMGR_MEM_RESP; x++)
+    {
+        FAPI_CHECK(now[x].objects == start[x].objects);
+        FAPI_CHECK(now[x].allocs > start[x].allocs);
+        FAPI_CHECK(now[x].allocs - now[x].frees == now[x].objects);
+    }
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MemoryGet(NPF_F_ATM_CONFIGMGR_MEM_COUNT, &now[0]) == NPF_E_UNKNOWN);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MemoryGet(NPF_F_ATM_CONFIGMGR_MEM_VC_TABLE, 0) == NPF_E_UNKNOWN);
+    return FAPITestResult("fapi_test_memory");
+}
@@ -0,0 +1,193 @@
+/**
+ * @file TestMetrics.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Makes a known sequence of configuration calls and checks the call
+ *        and error counts of every operation, then that a reset brings
+ *        them back to zero.
+ *
+ * The sequence has calls refused as a whole, for a bad handle or no
+ * entries, and batches with entries refused one by one, so both kinds of
+ * error count are covered. Each completion callback counts as a dispatch.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+static NPF_F_ATM_ConfigMgr_MetricInfo_t Metric(NPF_F_ATM_ConfigMgr_Metric_t metric)
+{
+    NPF_F_ATM_ConfigMgr_MetricInfo_t info;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MetricsGet(metric, &info) == NPF_NO_ERROR);
+    return info;
+}
+
+/*
+ * The count of one error code, 0 if it was not seen.
+ */
+static NPF_uint64_t ErrorCount(const NPF_F_ATM_ConfigMgr_MetricInfo_t& info, NPF_error_t code)
+{
+    for(unsigned int x = 0; x < info.numErrorCodes; x++)
+    {
+        if(info.errors[x].code == code)
+        {
+            return info.errors[x].count;
+        }
+    }
+    return 0;
+}
+
+static NPF_uint64_t ErrorTotal(const NPF_F_ATM_ConfigMgr_MetricInfo_t& info)
+{
+    NPF_uint64_t total = info.otherErrors;
+    for(unsigned int x = 0; x < info.numErrorCodes; x++)
+    {
+        total += info.errors[x].count;
+    }
+    return total;
+}
+
+static bool Latencies(const NPF_F_ATM_ConfigMgr_MetricInfo_t& info)
+{
+    return (info.totalNs != 0)&&(info.minNs <= info.p50Ns)&&(info.p50Ns <= info.p90Ns)&&
+           (info.p90Ns <= info.p99Ns)&&(info.p99Ns <= info.p999Ns)&&(info.p999Ns <= info.maxNs);
+}
+
+int main()
+{
+    FAPITestClient client;
+    NPF_uint64_t callbacks = 0;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MetricsReset() == NPF_NO_ERROR);
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[2] = { FAPITestClient::If(20), FAPITestClient::If(21) };
+    FAPI_CHECK(client.IfSet(2, ifs) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+    FAPI_CHECK(client.IfSet(0, ifs) == NPF_E_UNKNOWN);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_IfSet(client.Handle() + 1, 0, NPF_REPORT_ALL, 0, 0, 2, ifs) ==
+               NPF_E_BAD_CALLBACK_HANDLE);
+
+    // VCs 502 and 503 are on the address of VC 500.
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[4] =
+    {
+        FAPITestClient::Vc(500, 20, 0, 50), FAPITestClient::Vc(501, 21, 0, 51), FAPITestClient::Vc(502, 20, 0, 50),
+        FAPITestClient::Vc(503, 20, 0, 50)
+    };
+    FAPI_CHECK(client.VcSet(4, vcs) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t leg = FAPITestClient::Leg(801, 501);
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = { 500, 1, &leg };
+    FAPI_CHECK(client.VcLinkXcSet(1, &xc) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+
+    // VC 500 is cross connected and VC 999 does not exist.
+    NPF_F_ATM_VcLinkId_t vcIds[2] = { 500, 999 };
+    FAPI_CHECK(client.VcDelete(2, vcIds) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+
+    NPF_F_ATM_VcXcId_t xcId = 801;
+    FAPI_CHECK(client.VcLinkXcDelete(1, &xcId) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+    FAPI_CHECK(client.VcLinkXcDelete(1, &xcId) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+
+    // Both interfaces still hold a VC.
+    NPF_F_ATM_IfID_t ifIds[2] = { 20, 21 };
+    FAPI_CHECK(client.IfDelete(NPF_FALSE, 2, ifIds) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, 2, ifIds) == NPF_NO_ERROR);
+    callbacks += client.NumCallbacks();
+
+    NPF_F_ATM_ConfigMgr_MetricInfo_t info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_IF_SET);
+    FAPI_CHECK(info.calls == 3);
+    FAPI_CHECK(ErrorCount(info, NPF_E_UNKNOWN) == 1);
+    FAPI_CHECK(ErrorCount(info, NPF_E_BAD_CALLBACK_HANDLE) == 1);
+    FAPI_CHECK(ErrorTotal(info) == 2);
+    FAPI_CHECK(Latencies(info) == true);
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_VC_SET);
+    FAPI_CHECK(info.calls == 1);
+    FAPI_CHECK(ErrorCount(info, NPF_ATM_F_E_INVALID_VC_ADDRESS) == 2);
+    FAPI_CHECK(ErrorTotal(info) == 2);
+    FAPI_CHECK(Latencies(info) == true);
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_SET);
+    FAPI_CHECK((info.calls == 1)&&(ErrorTotal(info) == 0));
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_VC_DELETE);
+    FAPI_CHECK(info.calls == 1);
+    FAPI_CHECK(ErrorCount(info, NPF_ATM_F_E_CONT_OBJS_EXIST) == 1);
+    FAPI_CHECK(ErrorCount(info, NPF_E_RESOURCE_NONEXISTENT) == 1);
+    FAPI_CHECK(ErrorTotal(info) == 2);
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_VC_LINK_XC_DELETE);
+    FAPI_CHECK(info.calls == 2);
+    FAPI_CHECK(ErrorCount(info, NPF_E_RESOURCE_NONEXISTENT) == 1);
+    FAPI_CHECK(ErrorTotal(info) == 1);
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_IF_DELETE);
+    FAPI_CHECK(info.calls == 2);
+    FAPI_CHECK(ErrorCount(info, NPF_ATM_F_E_CONT_OBJS_EXIST) == 2);
+    FAPI_CHECK(ErrorTotal(info) == 2);
+
+    info = Metric(NPF_F_ATM_CONFIGMGR_METRIC_CALLBACK_DISPATCH);
+    FAPI_CHECK(callbacks >= 8);
+    FAPI_CHECK(info.calls == callbacks);
+    FAPI_CHECK(ErrorTotal(info) == 0);
+
+    NPF_F_ATM_ConfigMgr_LockInfo_t lockInfo;
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_LockMetricsGet(NPF_F_ATM_CONFIGMGR_LOCK_TABLE_VC, &lockInfo) == NPF_NO_ERROR);
+    FAPI_CHECK(lockInfo.acquired != 0);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MetricsGet(NPF_F_ATM_CONFIGMGR_METRIC_COUNT, &info) == NPF_E_UNKNOWN);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_LockMetricsGet(NPF_F_ATM_CONFIGMGR_LOCK_COUNT, &lockInfo) == NPF_E_UNKNOWN);
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_MetricsReset() == NPF_NO_ERROR);
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_METRIC_COUNT; x++)
+    {
+        info = Metric((NPF_F_ATM_ConfigMgr_Metric_t)x);
+        FAPI_CHECK((info.calls == 0)&&(info.totalNs == 0)&&(info.maxNs == 0));
+        FAPI_CHECK((info.numErrorCodes == 0)&&(info.otherErrors == 0));
+    }
+    for(unsigned int x = 0; x < NPF_F_ATM_CONFIGMGR_LOCK_COUNT; x++)
+    {
+        NPF_F_ATM_ConfigMgr_LockMetricsGet((NPF_F_ATM_ConfigMgr_Lock_t)x, &lockInfo);
+        FAPI_CHECK((lockInfo.acquired == 0)&&(lockInfo.contended == 0)&&(lockInfo.waitNs == 0));
+    }
+    return FAPITestResult("fapi_test_metrics");
+}
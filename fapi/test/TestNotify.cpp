@@ -0,0 +1,353 @@
+/**
+ * @file TestNotify.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Checks each change subscriber is told of the changes its mask
+ *        selects, in the order they were made and with their contents.
+ *
+ * One subscriber takes every change, one only the VC changes through a
+ * queue of one change, so the configuration calls wait for it, and one only
+ * the cross connect changes. The changes of an interface deleted with its
+ * contained objects come before the interface itself. A refused entry is
+ * not reported, a subscriber that has gone is told nothing more, and a
+ * subscriber whose queue is full is told how many changes it missed.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+/*
+ * System defined include files required.
+ */
+#include <pthread.h>
+#include <time.h>
+
+enum
+{
+    NOTIFY_WAIT_SECONDS = 5,
+    NOTIFY_BURST = 10
+};
+
+/*
+ * The changes delivered to one subscriber. id is the interface, VC Link or
+ * vcXcId the change is about, and owner the interface of a VC or the root
+ * of a leg.
+ */
+struct NotifyChange
+{
+    NPF_F_ATM_ConfigMgr_ChangeType_t type;
+    NPF_uint32_t id;
+    NPF_uint32_t owner;
+};
+
+class NotifyLog
+{
+public:
+    NotifyLog()
+    : m_handle(0), m_numDropped(0), m_numBatches(0), m_seenHandle(0), m_badEvents(0)
+    {
+        pthread_mutex_init(&m_lock, 0);
+        pthread_cond_init(&m_cond, 0);
+    }
+
+    virtual ~NotifyLog()
+    {
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    NPF_error_t Subscribe(NPF_uint32_t changeMask, NPF_F_ATM_ConfigMgr_ChangePolicy_t policy,
+                          NPF_uint32_t queueDepth)
+    {
+        return NPF_F_ATM_ConfigMgr_ChangeSubscribe(this, Changes, changeMask, policy, queueDepth, &m_handle);
+    }
+
+    NPF_error_t Unsubscribe()
+    {
+        return NPF_F_ATM_ConfigMgr_ChangeUnsubscribe(m_handle);
+    }
+
+    /*
+     * Waits until 'count' changes were delivered or dropped, and returns
+     * whether exactly that many were.
+     */
+    bool Wait(unsigned int count)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += NOTIFY_WAIT_SECONDS;
+        pthread_mutex_lock(&m_lock);
+        while(m_changes.size() + m_numDropped < count)
+        {
+            if(pthread_cond_timedwait(&m_cond, &m_lock, &deadline) != 0)
+            {
+                break;
+            }
+        }
+        bool reached = (m_changes.size() + m_numDropped == count);
+        pthread_mutex_unlock(&m_lock);
+        return reached;
+    }
+
+    /*
+     * Whether the changes delivered from 'first' on are 'expected', all
+     * came with the handle of the subscription and were well formed.
+     */
+    bool Delivered(unsigned int first, const NotifyChange* expected, unsigned int numExpected)
+    {
+        pthread_mutex_lock(&m_lock);
+        bool same = (m_changes.size() == first + numExpected)&&(m_seenHandle == m_handle)&&(m_badEvents == 0);
+        for(unsigned int x = 0; (same == true)&&(x < numExpected); x++)
+        {
+            const NotifyChange& change = m_changes[first + x];
+            same = (change.type == expected[x].type)&&(change.id == expected[x].id)&&
+                   (change.owner == expected[x].owner);
+            if(same == false)
+            {
+                fprintf(stderr, "change %d: type %d id %d owner %d, expected type %d id %d owner %d\n",
+                        first + x, change.type, change.id, change.owner, expected[x].type, expected[x].id,
+                        expected[x].owner);
+            }
+        }
+        pthread_mutex_unlock(&m_lock);
+        return same;
+    }
+
+    unsigned int NumDelivered()
+    {
+        pthread_mutex_lock(&m_lock);
+        unsigned int numDelivered = m_changes.size();
+        pthread_mutex_unlock(&m_lock);
+        return numDelivered;
+    }
+
+    unsigned int NumDropped()
+    {
+        pthread_mutex_lock(&m_lock);
+        unsigned int numDropped = m_numDropped;
+        pthread_mutex_unlock(&m_lock);
+        return numDropped;
+    }
+
+    unsigned int NumBatches()
+    {
+        pthread_mutex_lock(&m_lock);
+        unsigned int numBatches = m_numBatches;
+        pthread_mutex_unlock(&m_lock);
+        return numBatches;
+    }
+
+private:
+    static void Changes(NPF_userContext_t userContext, NPF_callbackHandle_t eventHandle, NPF_uint32_t numDropped,
+                        NPF_uint32_t numEvents, NPF_F_ATM_ConfigMgr_ChangeEvent_t* events)
+    {
+        NotifyLog* log = static_cast<NotifyLog*>(userContext);
+        pthread_mutex_lock(&log->m_lock);
+        log->m_seenHandle = eventHandle;
+        log->m_numDropped += numDropped;
+        log->m_numBatches++;
+        for(unsigned int x = 0; x < numEvents; x++)
+        {
+            const NPF_F_ATM_ConfigMgr_ChangeEvent_t& event = events[x];
+            NotifyChange change;
+            change.type = event.type;
+            switch(event.type)
+            {
+                case NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED:
+                    change.id = event.u.ifCfg.ifID;
+                    change.owner = 0;
+                    break;
+                case NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED:
+                    change.id = event.u.ifId;
+                    change.owner = 0;
+                    break;
+                case NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED:
+                case NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED:
+                    change.id = event.u.vcCfg.vcLinkId;
+                    change.owner = event.u.vcCfg.ifId;
+                    log->m_badEvents += (event.u.vcCfg.link_B != 0) ? 1 : 0;
+                    break;
+                default:
+                    change.id = event.u.xcLeg.leg.vcXcId;
+                    change.owner = event.u.xcLeg.link_A;
+                    break;
+            }
+            log->m_changes.push_back(change);
+        }
+        pthread_cond_broadcast(&log->m_cond);
+        pthread_mutex_unlock(&log->m_lock);
+    }
+
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_cond;
+    NPF_callbackHandle_t m_handle;
+    std::vector<NotifyChange> m_changes;
+    unsigned int m_numDropped;
+    unsigned int m_numBatches;
+    NPF_callbackHandle_t m_seenHandle;
+    unsigned int m_badEvents;
+};
+
+int main()
+{
+    FAPITestClient client;
+    NotifyLog all;
+    NotifyLog vcs;
+    NotifyLog xcs;
+    FAPI_CHECK(all.Subscribe(NPF_F_ATM_CONFIGMGR_CHANGE_ALL, NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK, 64) == NPF_NO_ERROR);
+    FAPI_CHECK(vcs.Subscribe(NPF_F_ATM_CONFIGMGR_CHANGE_BIT(NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED) |
+                             NPF_F_ATM_CONFIGMGR_CHANGE_BIT(NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED),
+                             NPF_F_ATM_CONFIGMGR_CHANGE_BLOCK, 1) == NPF_NO_ERROR);
+    FAPI_CHECK(xcs.Subscribe(NPF_F_ATM_CONFIGMGR_CHANGE_BIT(NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED) |
+                             NPF_F_ATM_CONFIGMGR_CHANGE_BIT(NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED),
+                             NPF_F_ATM_CONFIGMGR_CHANGE_DROP, 64) == NPF_NO_ERROR);
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[2] = { FAPITestClient::If(30), FAPITestClient::If(31) };
+    FAPI_CHECK(client.IfSet(2, ifs) == NPF_NO_ERROR);
+
+    // VC 403 is on the address of VC 400 and is refused.
+    NPF_F_ATM_ConfigMgr_Vc_t vcCfgs[4] =
+    {
+        FAPITestClient::Vc(400, 30, 0, 40), FAPITestClient::Vc(401, 30, 0, 41), FAPITestClient::Vc(402, 31, 0, 42),
+        FAPITestClient::Vc(403, 30, 0, 40)
+    };
+    FAPI_CHECK(client.VcSet(4, vcCfgs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.ErrorOf(403) == NPF_ATM_F_E_INVALID_VC_ADDRESS);
+
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[2] = { FAPITestClient::Leg(701, 401), FAPITestClient::Leg(702, 402) };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = { 400, 2, legs };
+    FAPI_CHECK(client.VcLinkXcSet(1, &xc) == NPF_NO_ERROR);
+    NPF_F_ATM_VcXcId_t xcId = 701;
+    FAPI_CHECK(client.VcLinkXcDelete(1, &xcId) == NPF_NO_ERROR);
+
+    // Interface 31 holds VC 402, the leaf of leg 702.
+    NPF_F_ATM_IfID_t ifId = 31;
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, 1, &ifId) == NPF_NO_ERROR);
+    NPF_F_ATM_VcLinkId_t vcIds[2] = { 400, 401 };
+    FAPI_CHECK(client.VcDelete(2, vcIds) == NPF_NO_ERROR);
+    ifId = 30;
+    FAPI_CHECK(client.IfDelete(NPF_FALSE, 1, &ifId) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    static const NotifyChange allChanges[] =
+    {
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED, 30, 0 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED, 31, 0 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 400, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 401, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 402, 31 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED, 701, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED, 702, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED, 701, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED, 702, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 402, 31 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED, 31, 0 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 400, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 401, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_REMOVED, 30, 0 }
+    };
+    static const NotifyChange vcChanges[] =
+    {
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 400, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 401, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_ADDED, 402, 31 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 402, 31 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 400, 30 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_VC_REMOVED, 401, 30 }
+    };
+    static const NotifyChange xcChanges[] =
+    {
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED, 701, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_ADDED, 702, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED, 701, 400 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_XC_REMOVED, 702, 400 }
+    };
+    const unsigned int numAll = sizeof(allChanges) / sizeof(allChanges[0]);
+    const unsigned int numVC = sizeof(vcChanges) / sizeof(vcChanges[0]);
+    const unsigned int numXC = sizeof(xcChanges) / sizeof(xcChanges[0]);
+    FAPI_CHECK(all.Wait(numAll) == true);
+    FAPI_CHECK(all.Delivered(0, allChanges, numAll) == true);
+    FAPI_CHECK(vcs.Wait(numVC) == true);
+    FAPI_CHECK(vcs.Delivered(0, vcChanges, numVC) == true);
+    FAPI_CHECK(xcs.Wait(numXC) == true);
+    FAPI_CHECK(xcs.Delivered(0, xcChanges, numXC) == true);
+    FAPI_CHECK(all.NumDropped() + vcs.NumDropped() + xcs.NumDropped() == 0);
+
+    // A queue of two takes the first two interfaces of a call adding more,
+    // the others are dropped and counted in the same batch.
+    FAPI_CHECK(vcs.Unsubscribe() == NPF_NO_ERROR);
+    FAPI_CHECK(vcs.Unsubscribe() == NPF_E_BAD_CALLBACK_HANDLE);
+    NotifyLog full;
+    FAPI_CHECK(full.Subscribe(NPF_F_ATM_CONFIGMGR_CHANGE_BIT(NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED),
+                              NPF_F_ATM_CONFIGMGR_CHANGE_DROP, 2) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_IfCfg_t burst[NOTIFY_BURST];
+    NPF_F_ATM_IfID_t burstIds[NOTIFY_BURST];
+    for(unsigned int i = 0; i < NOTIFY_BURST; i++)
+    {
+        burstIds[i] = 10 + i;
+        burst[i] = FAPITestClient::If(burstIds[i]);
+    }
+    FAPI_CHECK(client.IfSet(NOTIFY_BURST, burst) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_Vc_t vcCfg = FAPITestClient::Vc(410, 10, 0, 40);
+    FAPI_CHECK(client.VcSet(1, &vcCfg) == NPF_NO_ERROR);
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, NOTIFY_BURST, burstIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    static const NotifyChange fullChanges[] =
+    {
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED, 10, 0 },
+        { NPF_F_ATM_CONFIGMGR_CHANGE_IF_ADDED, 11, 0 }
+    };
+    FAPI_CHECK(full.Wait(NOTIFY_BURST) == true);
+    FAPI_CHECK(full.Delivered(0, fullChanges, 2) == true);
+    FAPI_CHECK(full.NumDropped() == NOTIFY_BURST - 2);
+    FAPI_CHECK(full.NumBatches() == 1);
+
+    // Every change made since went to the subscriber of all changes only.
+    FAPI_CHECK(all.Wait(numAll + 2 * NOTIFY_BURST + 2) == true);
+    FAPI_CHECK(all.NumDropped() == 0);
+    FAPI_CHECK(vcs.NumDelivered() == numVC);
+    FAPI_CHECK(xcs.NumDelivered() == numXC);
+
+    FAPI_CHECK(full.Unsubscribe() == NPF_NO_ERROR);
+    FAPI_CHECK(xcs.Unsubscribe() == NPF_NO_ERROR);
+    FAPI_CHECK(all.Unsubscribe() == NPF_NO_ERROR);
+    return FAPITestResult("fapi_test_notify");
+}
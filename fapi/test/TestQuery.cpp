@@ -0,0 +1,234 @@
+/**
+ * @file TestQuery.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Checks the TableManager queries return the VCs and cross connect
+ *        legs that were configured, in key order, a page at a time.
+ *
+ * The VCs are spread over interfaces of every shard and added out of
+ * order. Every query is read back in pages smaller than its result, and a
+ * range sweep that deletes VCs between pages must still return each VC
+ * present for the whole sweep exactly once.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+enum
+{
+    QUERY_IFACES = 4,
+    QUERY_VCS = 24,
+    QUERY_PAGE = 5
+};
+
+/*
+ * VC Link IDs are 3, 6, .. so that ranges can start and end between them.
+ */
+static unsigned int LinkId(unsigned int v)
+{
+    return 3 * (1 + v);
+}
+
+static bool SameVC(const TableManager::VCInfo& info, const NPF_F_ATM_ConfigMgr_Vc_t& vc,
+                   unsigned short xcRole, unsigned short numLegs)
+{
+    return (info.vcLinkId == vc.vcLinkId)&&(info.ifId == vc.ifId)&&(info.vc.vpi == vc.vc.vpi)&&
+           (info.vc.vci == vc.vc.vci)&&(info.xcRole == xcRole)&&(info.numLegs == numLegs);
+}
+
+int main()
+{
+    FAPITestClient client;
+    TableManager& tables = TableManager::instance();
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[QUERY_IFACES];
+    for(unsigned int i = 0; i < QUERY_IFACES; i++)
+    {
+        ifs[i] = FAPITestClient::If(1 + i);
+    }
+    FAPI_CHECK(client.IfSet(QUERY_IFACES, ifs) == NPF_NO_ERROR);
+
+    // Added from the highest VC Link ID down.
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[QUERY_VCS];
+    NPF_F_ATM_ConfigMgr_Vc_t added[QUERY_VCS];
+    for(unsigned int v = 0; v < QUERY_VCS; v++)
+    {
+        vcs[v] = FAPITestClient::Vc(LinkId(v), 1 + (v * 7) % QUERY_IFACES, 0, 100 + v);
+        added[QUERY_VCS - 1 - v] = vcs[v];
+    }
+    FAPI_CHECK(client.VcSet(QUERY_VCS, added) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    // VC 0 is the root of legs to VCs 1..4, named out of vcXcId order.
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[4] =
+    {
+        FAPITestClient::Leg(904, LinkId(1)), FAPITestClient::Leg(901, LinkId(2)),
+        FAPITestClient::Leg(903, LinkId(3)), FAPITestClient::Leg(902, LinkId(4))
+    };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = { LinkId(0), 4, legs };
+    FAPI_CHECK(client.VcLinkXcSet(1, &xc) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    // The whole table, a page at a time.
+    std::vector<TableManager::VCInfo> found;
+    TableManager::VCInfo page[QUERY_PAGE];
+    unsigned int cursor = 0;
+    unsigned int pages = 0;
+    while((cursor != _IX_CC_ATM_FAPI_QUERY_END)&&(pages++ <= QUERY_VCS))
+    {
+        unsigned int numFound = tables.QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, page, QUERY_PAGE);
+        FAPI_CHECK(numFound <= QUERY_PAGE);
+        found.insert(found.end(), page, page + numFound);
+    }
+    if(FAPI_CHECK(found.size() == QUERY_VCS) == true)
+    {
+        for(unsigned int v = 0; v < QUERY_VCS; v++)
+        {
+            unsigned short xcRole = (v == 0) ? TableManager::VC_XC_ROOT :
+                                    (v <= 4) ? TableManager::VC_XC_LEAF : TableManager::VC_XC_NONE;
+            unsigned short numLegs = (v == 0) ? 4 : (v <= 4) ? 1 : 0;
+            FAPI_CHECK(SameVC(found[v], vcs[v], xcRole, numLegs) == true);
+        }
+    }
+
+    // A range that starts and ends between VC Link IDs.
+    cursor = LinkId(5) - 1;
+    unsigned int numFound = tables.QueryVCs(LinkId(8) + 1, cursor, page, QUERY_PAGE);
+    FAPI_CHECK(numFound == 4);
+    FAPI_CHECK((numFound == 4)&&(page[0].vcLinkId == LinkId(5))&&(page[3].vcLinkId == LinkId(8)));
+    FAPI_CHECK(cursor == _IX_CC_ATM_FAPI_QUERY_END);
+
+    // The VCs of each interface, in VC Link ID order.
+    for(unsigned int i = 0; i < QUERY_IFACES; i++)
+    {
+        std::vector<TableManager::VCInfo> onIf;
+        cursor = 0;
+        pages = 0;
+        while((cursor != _IX_CC_ATM_FAPI_QUERY_END)&&(pages++ <= QUERY_VCS))
+        {
+            numFound = tables.QueryIfVCs(1 + i, cursor, page, 2);
+            onIf.insert(onIf.end(), page, page + numFound);
+        }
+        unsigned int expected = 0;
+        for(unsigned int v = 0; v < QUERY_VCS; v++)
+        {
+            if(vcs[v].ifId != 1 + i)
+            {
+                continue;
+            }
+            FAPI_CHECK((expected < onIf.size())&&(onIf[expected].vcLinkId == vcs[v].vcLinkId));
+            expected++;
+        }
+        FAPI_CHECK(onIf.size() == expected);
+    }
+    cursor = 0;
+    FAPI_CHECK(tables.QueryIfVCs(QUERY_IFACES + 1, cursor, page, QUERY_PAGE) == 0);
+    FAPI_CHECK(cursor == _IX_CC_ATM_FAPI_QUERY_END);
+
+    // The legs of the root in vcXcId order, and of a leaf its own.
+    TableManager::XCInfo xcs[4];
+    std::vector<TableManager::XCInfo> rootLegs;
+    cursor = 0;
+    pages = 0;
+    while((cursor != _IX_CC_ATM_FAPI_QUERY_END)&&(pages++ <= 4))
+    {
+        numFound = tables.QueryLinkXCs(LinkId(0), cursor, xcs, 3);
+        rootLegs.insert(rootLegs.end(), xcs, xcs + numFound);
+    }
+    static const unsigned int legLeaf[4] = { 2, 4, 3, 1 };
+    if(FAPI_CHECK(rootLegs.size() == 4) == true)
+    {
+        for(unsigned int l = 0; l < 4; l++)
+        {
+            FAPI_CHECK(rootLegs[l].vcXcId == 901 + l);
+            FAPI_CHECK(rootLegs[l].xcType == NPF_F_ATM_EXT_TO_EXT);
+            FAPI_CHECK(rootLegs[l].link_A == LinkId(0));
+            FAPI_CHECK(rootLegs[l].link_B == LinkId(legLeaf[l]));
+        }
+    }
+    cursor = 0;
+    numFound = tables.QueryLinkXCs(LinkId(3), cursor, xcs, 4);
+    FAPI_CHECK((numFound == 1)&&(xcs[0].vcXcId == 903)&&(xcs[0].link_A == LinkId(0)));
+    cursor = 0;
+    FAPI_CHECK(tables.QueryLinkXCs(LinkId(QUERY_VCS), cursor, xcs, 4) == 0);
+    FAPI_CHECK(cursor == _IX_CC_ATM_FAPI_QUERY_END);
+
+    // Every other VC from 6 on is deleted after the first page. The VCs
+    // that stay must each be returned once, in order.
+    NPF_F_ATM_VcXcId_t xcIds[4] = { 901, 902, 903, 904 };
+    FAPI_CHECK(client.VcLinkXcDelete(4, xcIds) == NPF_NO_ERROR);
+    found.clear();
+    cursor = 0;
+    numFound = tables.QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, page, QUERY_PAGE);
+    found.insert(found.end(), page, page + numFound);
+    std::vector<NPF_F_ATM_VcLinkId_t> deleted;
+    for(unsigned int v = 6; v < QUERY_VCS; v += 2)
+    {
+        deleted.push_back(LinkId(v));
+    }
+    FAPI_CHECK(client.VcDelete((NPF_uint32_t)deleted.size(), &deleted[0]) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    pages = 0;
+    while((cursor != _IX_CC_ATM_FAPI_QUERY_END)&&(pages++ <= QUERY_VCS))
+    {
+        numFound = tables.QueryVCs(_IX_CC_ATM_FAPI_QUERY_END - 1, cursor, page, QUERY_PAGE);
+        found.insert(found.end(), page, page + numFound);
+    }
+    unsigned int next = 0;
+    for(unsigned int v = 0; v < QUERY_VCS; v++)
+    {
+        if((v >= 6)&&((v % 2) == 0))
+        {
+            continue;
+        }
+        FAPI_CHECK((next < found.size())&&(found[next].vcLinkId == LinkId(v)));
+        next++;
+    }
+    FAPI_CHECK(found.size() == next);
+
+    NPF_F_ATM_IfID_t ifIds[QUERY_IFACES];
+    for(unsigned int i = 0; i < QUERY_IFACES; i++)
+    {
+        ifIds[i] = 1 + i;
+    }
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, QUERY_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    return FAPITestResult("fapi_test_query");
+}
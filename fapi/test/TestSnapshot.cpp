@@ -0,0 +1,168 @@
+/**
+ * @file TestSnapshot.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Saves the tables to a snapshot, restores them into empty tables
+ *        and checks the same interfaces, VCs and cross connects come back.
+ *
+ * The restored tables must also behave as the saved ones: the address and
+ * link indexes are rebuilt, so a VC on a restored address is refused, and
+ * restored cross connects can be deleted. A snapshot is not restored over
+ * tables that are not empty, and a damaged snapshot leaves them empty.
+ *
+ * Usage: fapi_test_snapshot <snapshot file>
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+/*
+ * System defined include files required.
+ */
+#include <string>
+
+enum
+{
+    SNAP_IFACES = 3,
+    SNAP_VCS = 12
+};
+
+/*
+ * Copies the first half of 'from' to 'to'.
+ */
+static bool Truncate(const char* from, const char* to)
+{
+    FILE* in = fopen(from, "rb");
+    FILE* out = fopen(to, "wb");
+    bool copied = ((in != 0)&&(out != 0));
+    if(copied == true)
+    {
+        std::vector<char> data;
+        int c;
+        while((c = fgetc(in)) != EOF)
+        {
+            data.push_back((char)c);
+        }
+        copied = (fwrite(&data[0], 1, data.size() / 2, out) == data.size() / 2);
+    }
+    if(in != 0)
+    {
+        fclose(in);
+    }
+    if(out != 0)
+    {
+        fclose(out);
+    }
+    return copied;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: fapi_test_snapshot <snapshot file>\n");
+        return 1;
+    }
+    const char* path = argv[1];
+    std::string damaged = std::string(path) + ".damaged";
+    FAPITestClient client;
+
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[SNAP_IFACES];
+    NPF_F_ATM_IfID_t ifIds[SNAP_IFACES];
+    for(unsigned int i = 0; i < SNAP_IFACES; i++)
+    {
+        ifIds[i] = 10 + i;
+        ifs[i] = FAPITestClient::If(ifIds[i]);
+    }
+    FAPI_CHECK(client.IfSet(SNAP_IFACES, ifs) == NPF_NO_ERROR);
+
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[SNAP_VCS];
+    for(unsigned int v = 0; v < SNAP_VCS; v++)
+    {
+        vcs[v] = FAPITestClient::Vc(100 + v, ifIds[v % SNAP_IFACES], 1 + v / 4, 40 + v);
+    }
+    FAPI_CHECK(client.VcSet(SNAP_VCS, vcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    // A root with three legs, whose link_B array is pooled, and one with a
+    // single leg held inline.
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[4] =
+    {
+        FAPITestClient::Leg(501, 101), FAPITestClient::Leg(502, 102), FAPITestClient::Leg(503, 103),
+        FAPITestClient::Leg(504, 105)
+    };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xcs[2] = { { 100, 3, &legs[0] }, { 104, 1, &legs[3] } };
+    FAPI_CHECK(client.VcLinkXcSet(2, xcs) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    FAPITestTables saved = FAPITestReadTables();
+    unsigned long long savedObjects = FAPITestTableObjects();
+    FAPI_CHECK(saved.vcs.size() == SNAP_VCS);
+    FAPI_CHECK(saved.legs.size() == 4);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotSave(path) == NPF_NO_ERROR);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotRestore(path) == NPF_E_UNKNOWN);
+
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, SNAP_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+
+    FAPI_CHECK(Truncate(path, damaged.c_str()) == true);
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotRestore(damaged.c_str()) == NPF_E_UNKNOWN);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    remove(damaged.c_str());
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SnapshotRestore(path) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), saved) == true);
+    FAPI_CHECK(FAPITestTableObjects() == savedObjects);
+
+    NPF_F_ATM_ConfigMgr_Vc_t taken = FAPITestClient::Vc(200, vcs[0].ifId, vcs[0].vc.vpi, vcs[0].vc.vci);
+    FAPI_CHECK(client.VcSet(1, &taken) == NPF_NO_ERROR);
+    FAPI_CHECK(client.ErrorOf(200) == NPF_ATM_F_E_INVALID_VC_ADDRESS);
+
+    NPF_F_ATM_VcXcId_t xcIds[4] = { 501, 502, 503, 504 };
+    FAPI_CHECK(client.VcLinkXcDelete(4, xcIds) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+    FAPI_CHECK(FAPITestReadTables().legs.empty() == true);
+
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, SNAP_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    remove(path);
+    return FAPITestResult("fapi_test_snapshot");
+}
@@ -0,0 +1,139 @@
+/**
+ * @file TestStrict.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Makes IfSet, VcSet and VcLinkXcSet calls in strict batch mode with
+ *        one bad entry in an otherwise valid batch, and checks that each
+ *        batch is refused whole: only the bad entry is reported and the
+ *        tables are left as they were.
+ *
+ * Each batch is then made again with the bad entry put right and is
+ * applied in full, so it was the one entry that held the batch back.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+enum
+{
+    STRICT_VCS = 10
+};
+
+/*
+ * Checks that the last call was refused for 'objId' alone with 'error' and
+ * that the tables still hold 'tables' and 'objects'.
+ */
+static void CheckRefused(const FAPITestClient& client, NPF_uint32_t objId, NPF_error_t error,
+                         const FAPITestTables& tables, unsigned long long objects)
+{
+    FAPI_CHECK((client.NumCallbacks() == 1)&&(client.AllOK() == false));
+    FAPI_CHECK(client.Responses().size() == 1);
+    FAPI_CHECK(client.ErrorOf(objId) == error);
+    FAPI_CHECK(FAPITestSameTables(FAPITestReadTables(), tables) == true);
+    FAPI_CHECK(FAPITestTableObjects() == objects);
+}
+
+int main()
+{
+    FAPITestClient client;
+
+    // Two interfaces, their VCs and a root with two legs, made in partial
+    // mode.
+    NPF_F_ATM_ConfigMgr_IfCfg_t ifs[3] = { FAPITestClient::If(1), FAPITestClient::If(2), FAPITestClient::If(3) };
+    FAPI_CHECK(client.IfSet(2, ifs) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_Vc_t vcs[STRICT_VCS];
+    for(unsigned int v = 0; v < STRICT_VCS; v++)
+    {
+        vcs[v] = FAPITestClient::Vc(100 + v, 1 + v % 2, 0, 32 + v);
+    }
+    FAPI_CHECK(client.VcSet(STRICT_VCS, vcs) == NPF_NO_ERROR);
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t legs[2] = { FAPITestClient::Leg(901, 101), FAPITestClient::Leg(902, 102) };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t xc = { 100, 2, legs };
+    FAPI_CHECK(client.VcLinkXcSet(1, &xc) == NPF_NO_ERROR);
+    FAPI_CHECK(client.AllOK() == true);
+
+    FAPI_CHECK(NPF_F_ATM_ConfigMgr_SetBatchMode(client.Handle(), NPF_F_ATM_CONFIGMGR_BATCH_STRICT) ==
+               NPF_NO_ERROR);
+    FAPITestTables tables = FAPITestReadTables();
+    unsigned long long objects = FAPITestTableObjects();
+    FAPI_CHECK(objects == 2 + STRICT_VCS + 2);
+
+    // Interface 3 is new, interface 1 is already there.
+    NPF_F_ATM_ConfigMgr_IfCfg_t newIfs[2] = { ifs[2], ifs[0] };
+    FAPI_CHECK(client.IfSet(2, newIfs) == NPF_NO_ERROR);
+    CheckRefused(client, 1, NPF_E_RESOURCE_EXISTS, tables, objects);
+    FAPI_CHECK(client.IfSet(1, newIfs) == NPF_NO_ERROR);
+    FAPI_CHECK((client.AllOK() == true)&&(FAPITestTableObjects() == objects + 1));
+    objects += 1;
+
+    // The last VC takes the address of VC 100.
+    NPF_F_ATM_ConfigMgr_Vc_t newVcs[3] =
+    {
+        FAPITestClient::Vc(110, 1, 0, 60), FAPITestClient::Vc(111, 3, 0, 61), FAPITestClient::Vc(112, 1, 0, 32)
+    };
+    FAPI_CHECK(client.VcSet(3, newVcs) == NPF_NO_ERROR);
+    CheckRefused(client, 112, NPF_ATM_F_E_INVALID_VC_ADDRESS, tables, objects);
+    newVcs[2].vc.vci = 62;
+    FAPI_CHECK(client.VcSet(3, newVcs) == NPF_NO_ERROR);
+    FAPI_CHECK((client.AllOK() == true)&&(FAPITestTableObjects() == objects + 3));
+    tables = FAPITestReadTables();
+    objects += 3;
+
+    // A leg added to root 100, a new root 103 and a leg on VC Link 999,
+    // which does not exist.
+    NPF_F_ATM_ConfigMgr_VcLinkXcInfo_t newLegs[3] =
+    {
+        FAPITestClient::Leg(903, 104), FAPITestClient::Leg(904, 105), FAPITestClient::Leg(905, 999)
+    };
+    NPF_F_ATM_ConfigMgr_VcLinkXc_t newXcs[3] = { { 100, 1, &newLegs[0] }, { 103, 1, &newLegs[1] },
+                                                 { 106, 1, &newLegs[2] } };
+    FAPI_CHECK(client.VcLinkXcSet(3, newXcs) == NPF_NO_ERROR);
+    CheckRefused(client, 999, NPF_ATM_F_E_INVALID_ATTRIBUTE, tables, objects);
+    newLegs[2].u.mapVcLink = 107;
+    FAPI_CHECK(client.VcLinkXcSet(3, newXcs) == NPF_NO_ERROR);
+    FAPI_CHECK((client.AllOK() == true)&&(FAPITestTableObjects() == objects + 3));
+
+    NPF_F_ATM_VcXcId_t xcIds[5] = { 901, 902, 903, 904, 905 };
+    FAPI_CHECK(client.VcLinkXcDelete(5, xcIds) == NPF_NO_ERROR);
+    NPF_F_ATM_IfID_t ifIds[3] = { 1, 2, 3 };
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, 3, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK((client.AllOK() == true)&&(FAPITestTableObjects() == 0));
+    return FAPITestResult("fapi_test_strict");
+}
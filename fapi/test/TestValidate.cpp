@@ -0,0 +1,179 @@
+/**
+ * @file TestValidate.cpp
+ *
+ * @date 24 June 2005
+ *
+ * @brief Makes IfSet and VcSet calls with more entries than
+ *        _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN, so they are checked in
+ *        parallel, with repeated interfaces, addresses and VC Link IDs, and
+ *        checks the errors and tables against the same entries made in
+ *        calls small enough to be checked one entry at a time.
+ *
+ * The responses of the large calls are passed in several invocations of
+ * the default chunk size, which must not split the batch for validation.
+ * Either way every entry is reported in input order with the error of the
+ * earliest entry it repeats.
+ *
+ *
+ * -- Intel Copyright Notice --
+ *
+ * @par
+ * INTEL CONFIDENTIAL
+ *
+ * @par
+ * Copyright 2005 Intel Corporation All Rights Reserved
+ *
+ * @par
+ * The source code contained or described herein and all documents
+ * related to the source code ("Material") are owned by Intel Corporation
+ * or its suppliers or licensors.  Title to the Material remains with
+ * Intel Corporation or its suppliers and licensors.  The Material
+ * contains trade secrets and proprietary and confidential information of
+ * Intel or its suppliers and licensors.  The Material is protected by
+ * worldwide copyright and trade secret laws and treaty provisions. No
+ * part of the Material may be used, copied, reproduced, modified,
+ * published, uploaded, posted, transmitted, distributed, or disclosed in
+ * any way without Intel's prior express written permission.
+ *
+ * @par
+ * No license under any patent, copyright, trade secret or other
+ * intellectual property right is granted to or conferred upon you by
+ * disclosure or delivery of the Materials, either expressly, by
+ * implication, inducement, estoppel or otherwise.  Any license under
+ * such intellectual property rights must be express and approved by
+ * Intel in writing.
+ *
+ * @par
+ * For further details, please see the file README.TXT distributed with
+ * this software.
+ * -- End Intel Copyright Notice 
+ */
+
+/*
+ * User defined include files required.
+ */
+#include "FAPITest.h"
+
+enum
+{
+    VALIDATE_IFACES = 20,
+    VALIDATE_IF_ENTRIES = _IX_CC_ATM_FAPI_VALIDATE_PARALLEL_MIN + 76,
+    VALIDATE_VCS = 2000,
+    VALIDATE_SMALL = 500
+};
+
+/*
+ * The responses of the calls, made in one call or in calls of at most
+ * 'batch' entries.
+ */
+struct ValidateResult
+{
+    std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t> ifResponses;
+    std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t> vcResponses;
+    FAPITestTables tables;
+    unsigned long long objects;
+};
+
+static ValidateResult Apply(FAPITestClient& client, NPF_F_ATM_ConfigMgr_IfCfg_t* ifs,
+                            NPF_F_ATM_ConfigMgr_Vc_t* vcs, unsigned int batch)
+{
+    ValidateResult result;
+    for(unsigned int first = 0; first < VALIDATE_IF_ENTRIES; first += batch)
+    {
+        unsigned int entries = (VALIDATE_IF_ENTRIES - first < batch) ? (VALIDATE_IF_ENTRIES - first) : batch;
+        FAPI_CHECK(client.IfSet(entries, &ifs[first]) == NPF_NO_ERROR);
+        result.ifResponses.insert(result.ifResponses.end(), client.Responses().begin(), client.Responses().end());
+    }
+    for(unsigned int first = 0; first < VALIDATE_VCS; first += batch)
+    {
+        unsigned int entries = (VALIDATE_VCS - first < batch) ? (VALIDATE_VCS - first) : batch;
+        FAPI_CHECK(client.VcSet(entries, &vcs[first]) == NPF_NO_ERROR);
+        result.vcResponses.insert(result.vcResponses.end(), client.Responses().begin(), client.Responses().end());
+    }
+    result.tables = FAPITestReadTables();
+    result.objects = FAPITestTableObjects();
+
+    NPF_F_ATM_IfID_t ifIds[VALIDATE_IFACES];
+    for(unsigned int i = 0; i < VALIDATE_IFACES; i++)
+    {
+        ifIds[i] = 1 + i;
+    }
+    FAPI_CHECK(client.IfDelete(NPF_TRUE, VALIDATE_IFACES, ifIds) == NPF_NO_ERROR);
+    FAPI_CHECK(FAPITestTableObjects() == 0);
+    return result;
+}
+
+static bool SameResponses(const std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t>& a,
+                          const std::vector<NPF_F_ATM_ConfigMgr_AsyncResponse_t>& b)
+{
+    if(a.size() != b.size())
+    {
+        return false;
+    }
+    for(unsigned int x = 0; x < a.size(); x++)
+    {
+        if((a[x].error != b[x].error)||(a[x].objId.vcXcId != b[x].objId.vcXcId))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    FAPITestClient client;
+
+    // Every interface is repeated, the last entry also has a bad type.
+    static NPF_F_ATM_ConfigMgr_IfCfg_t ifs[VALIDATE_IF_ENTRIES];
+    for(unsigned int x = 0; x < VALIDATE_IF_ENTRIES; x++)
+    {
+        ifs[x] = FAPITestClient::If(1 + x % VALIDATE_IFACES);
+    }
+    ifs[VALIDATE_IF_ENTRIES - 1].ifType = (NPF_F_ATM_IfType_t)0;
+
+    // Four VCs are refused: one on the address of an earlier VC of the
+    // table, one on the VC Link ID of an earlier VC, one on an interface
+    // that does not exist and one on the address of the VC before it.
+    static NPF_F_ATM_ConfigMgr_Vc_t vcs[VALIDATE_VCS];
+    for(unsigned int v = 0; v < VALIDATE_VCS; v++)
+    {
+        vcs[v] = FAPITestClient::Vc(1 + v, 1 + v % VALIDATE_IFACES, v / 256, 32 + v % 256);
+    }
+    vcs[1500].ifId = vcs[10].ifId;
+    vcs[1500].vc = vcs[10].vc;
+    vcs[1600].vcLinkId = vcs[20].vcLinkId;
+    vcs[1700].ifId = VALIDATE_IFACES + 10;
+    vcs[1800].ifId = vcs[1799].ifId;
+    vcs[1800].vc = vcs[1799].vc;
+
+    ValidateResult large = Apply(client, ifs, vcs, VALIDATE_VCS);
+    FAPI_CHECK(large.ifResponses.size() == VALIDATE_IF_ENTRIES);
+    for(unsigned int x = 0; x < large.ifResponses.size(); x++)
+    {
+        NPF_error_t expected = (x < VALIDATE_IFACES) ? NPF_NO_ERROR : NPF_E_RESOURCE_EXISTS;
+        if(x == VALIDATE_IF_ENTRIES - 1)
+        {
+            expected = NPF_ATM_F_E_INVALID_ATTRIBUTE;
+        }
+        FAPI_CHECK((large.ifResponses[x].objId.ifID == ifs[x].ifID)&&(large.ifResponses[x].error == expected));
+    }
+
+    unsigned int refused[4] = { 1500, 1600, 1700, 1800 };
+    NPF_error_t errors[4] = { NPF_ATM_F_E_INVALID_VC_ADDRESS, NPF_ATM_F_E_INVALID_VC_ADDRESS, NPF_E_UNKNOWN,
+                              NPF_ATM_F_E_INVALID_VC_ADDRESS };
+    FAPI_CHECK(large.vcResponses.size() == 4);
+    for(unsigned int x = 0; (x < large.vcResponses.size())&&(x < 4); x++)
+    {
+        FAPI_CHECK(large.vcResponses[x].objId.linkId.atm_linkID_t == vcs[refused[x]].vcLinkId);
+        FAPI_CHECK(large.vcResponses[x].error == errors[x]);
+    }
+    FAPI_CHECK(large.objects == VALIDATE_IFACES + VALIDATE_VCS - 4);
+
+    ValidateResult small = Apply(client, ifs, vcs, VALIDATE_SMALL);
+    FAPI_CHECK(SameResponses(large.ifResponses, small.ifResponses) == true);
+    FAPI_CHECK(SameResponses(large.vcResponses, small.vcResponses) == true);
+    FAPI_CHECK(FAPITestSameTables(large.tables, small.tables) == true);
+    FAPI_CHECK(large.objects == small.objects);
+    return FAPITestResult("fapi_test_validate");
+}